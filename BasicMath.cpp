@@ -17,6 +17,7 @@
 #include "Fit/DiscreteFunction.h"
 #include "Fit/StandardFit.h"
 #include "Fit/DOASVector.h"
+#include "Fit/Convolution.h"
 //#include "windoastools.h"
 //#include "DoubleMonitoredArrayData.h"
 #include <math.h>
@@ -45,43 +46,10 @@ CBasicMath::~CBasicMath()
 
 }
 
-double* CBasicMath::LowPassBinomial(double *fData, int iSize, int iNIterations)
+double* CBasicMath::LowPassBinomial(double *fData, int iSize, int iNIterations, CBinomialFilter::EMethod eMethod)
 {
-	std::vector<double> fBuffer(iSize);
-	double *fOut = fData;
-	double *fIn = fBuffer.data();
-	const int iLast = iSize - 1;
-	const int iFirst = 0;
-
-	int j, i;
-	for(j = 0; j < iNIterations; j++)
-	{
-		// now swap buffers
-		double *fTemp = fIn;
-		fIn = fOut;
-		fOut = fTemp;
+	mBinomialFilter.LowPass(fData, iSize, iNIterations, eMethod);
 
-		for(i = iFirst; i < iSize; i++)
-		{
-			double lMid, lLeft, lRight;
-
-			lMid = fIn[i];
-			if(i == iFirst)
-				lLeft = fIn[i];
-			else
-				lLeft = fIn[i - 1];
-
-			if(i == iLast)
-				lRight = fIn[i];
-			else
-				lRight = fIn[i + 1];
-			fOut[i] = 0.5 * lMid + 0.25 * lLeft + 0.25 * lRight;
-		}
-	}
-	if(fOut != fData) {
-		memcpy(fData, fOut, sizeof(double) * iSize);
-    }
-    
 	return(fData);
 }
 
@@ -102,25 +70,20 @@ double* CBasicMath::LowPassBinomial(double *fData, int iSize, int iNIterations)
 	AddHistory(dispData, LOWPASS);
 }*/
 
-double* CBasicMath::HighPassBinomial(double *fData, int iSize, int iNIterations)
+double* CBasicMath::HighPassBinomial(double *fData, int iSize, int iNIterations, CBinomialFilter::EMethod eMethod)
 {
-	std::vector<double> fBuffer(iSize);
-	int i;
+	if(mHighPassBuffer.size() < (size_t)iSize)
+		mHighPassBuffer.resize(iSize);
+	double *fBuffer = mHighPassBuffer.data();
 
 	// create copy of original data
-	memcpy(fBuffer.data(), fData, sizeof(double) * iSize);
+	memcpy(fBuffer, fData, sizeof(double) * iSize);
 
 	// create low pass filtered data
-	LowPassBinomial(fBuffer.data(), iSize, iNIterations);
+	LowPassBinomial(fBuffer, iSize, iNIterations, eMethod);
 
-	// remove low pass part from data
-	for(i = 0; i < iSize; i++)
-	{
-		if(fBuffer[i] != 0.0)
-			fData[i] /= fBuffer[i];
-		else
-			fData[i] = 0;
-	}
+	// remove low pass part from data, where the low pass part is zero the result is zero
+	CVectorKernels::Div(fData, fBuffer, fData, iSize);
 
 	return(fData);
 }
@@ -142,12 +105,31 @@ double* CBasicMath::HighPassBinomial(double *fData, int iSize, int iNIterations)
 	AddHistory(dispData, HIGHPASS);
 }*/
 
-double* CBasicMath::Log(double *fData, int iSize)
+/**
+ * The same as HighPassBinomial followed by Log, without the second copy of the data.
+ */
+double* CBasicMath::HighPassBinomialLog(double *fData, int iSize, int iNIterations, CBinomialFilter::EMethod eMethod)
 {
-	int i;
+	if(mHighPassBuffer.size() < (size_t)iSize)
+		mHighPassBuffer.resize(iSize);
+	double *fBuffer = mHighPassBuffer.data();
+
+	// create low pass filtered data
+	memcpy(fBuffer, fData, sizeof(double) * iSize);
+	LowPassBinomial(fBuffer, iSize, iNIterations, eMethod);
+
+	// remove low pass part from data and take the logarithm
+	CVectorKernels::Div(fData, fBuffer, fData, iSize);
+	CVectorKernels::Log(fData, fData, iSize);
 
-	for(i = 0; i < iSize; i++)
-		fData[i] = fData[i] <= 0 ? 0.0 : log(fData[i]);
+	return(fData);
+}
+
+double* CBasicMath::Log(double *fData, int iSize)
+{
+	// the logarithm of values which are not positive is zero. The vectorized logarithm is
+	//  within one unit in the last place of the C library
+	CVectorKernels::Log(fData, fData, iSize);
 	return(fData);
 }
 
@@ -170,10 +152,8 @@ double* CBasicMath::Log(double *fData, int iSize)
 
 double* CBasicMath::Delog(double *fData, int iSize)
 {
-	int i;
-
-	for(i = 0; i < iSize; i++)
-		fData[i] = exp(fData[i]);
+	// the vectorized exponential function is within one unit in the last place of the C library
+	CVectorKernels::Exp(fData, fData, iSize);
 	return(fData);
 }
 
@@ -385,21 +365,19 @@ void CBasicMath::Zero(double *fData, int iSize, double fZeroLimit)
 
 void CBasicMath::NormalizeAmplitude(double *fData, int iSize, double fMaxAmplitude)
 {
-	int i;
 	double fMax;
 
 	// search pivot
 	fMax = fData[0];
-	for(i = 1; i < iSize; i++)
-		fMax = std::max(fMax, fabs(fData[i]));
+	if(iSize > 1)
+		fMax = std::max(fMax, CVectorKernels::MaxAbs(fData + 1, iSize - 1));
 
 	// nothing to do here
 	if(fMax == 0)
 		return;
 
 	double fFactor = fMaxAmplitude / fMax;
-	for(i = 0; i < iSize; i++)
-		fData[i] *= fFactor;
+	CVectorKernels::MulScalar(fData, fFactor, fData, iSize);
 }
 
 /*void CBasicMath::NormalizeAmplitude(ISpectrum &dispSpec, double fMaxAmplitude)
@@ -457,10 +435,7 @@ void CBasicMath::NormalizeEnergy(double *fData, int iSize, double fEnergy)
 */
 void CBasicMath::Invert(double *fData, int iSize)
 {
-	int i;
-
-	for(i = 0; i < iSize; i++)
-		fData[i] *= -1;
+	CVectorKernels::MulScalar(fData, -1.0, fData, iSize);
 }
 
 /*void CBasicMath::Invert(ISpectrum &dispSpec)
@@ -482,10 +457,7 @@ void CBasicMath::Invert(double *fData, int iSize)
 
 void CBasicMath::Reciprocal(double *fData, int iSize)
 {
-	int i;
-
-	for(i = 0; i < iSize; i++)
-		fData[i] = 1 / fData[i];
+	CVectorKernels::Reciprocal(fData, fData, iSize);
 }
 
 /*void CBasicMath::Reciprocal(ISpectrum &dispSpec)
@@ -507,33 +479,13 @@ void CBasicMath::Reciprocal(double *fData, int iSize)
 
 void CBasicMath::Convolute(double *fFirst, int iSize, double *fCore, int iCoreSize)
 {
-	int iCoreMid = iCoreSize / 2;
-	int i, j;
-
 	// backup the original data
 	std::vector<double> fBuffer(iSize);
 	memcpy(fBuffer.data(), fFirst, iSize * sizeof(double));
 
-	// process every pixel
-	for(i = 0; i < iSize; i++)
-	{
-		fFirst[i] = 0;
-
-		int iIndex = -iCoreMid;
-
-		// convolute with core, boundaries will be constanstly extended
-		for(j = 0; j < iCoreSize; j++, iIndex++)
-		{
-			// the index to the base data is the core index plus the base index
-			int iRealIndex = iIndex + i;
-			if(iRealIndex < 0)
-				iRealIndex = 0;
-			else if(iRealIndex >= iSize)
-				iRealIndex = iSize - 1;
-
-			fFirst[i] += fBuffer[iRealIndex] * fCore[j];
-		}
-	}
+	// convolute with core, boundaries will be constanstly extended. Large cores are convoluted
+	// using the fast fourier transform
+	CConvolution::Convolute(fBuffer.data(), iSize, fCore, iCoreSize, iCoreSize / 2, fFirst, CConvolution::CONSTANTEXTENSION);
 }
 
 /*void CBasicMath::Convolute(ISpectrum &dispFirst, ISpectrum &dispCore)
@@ -591,17 +543,9 @@ void CBasicMath::Reverse(double *fData, int iSize)
 void CBasicMath::Add(double *fFirst, double *fSec, int iSize, double fFactor)
 {
 	if(fFactor != 0)
-	{
-		int i;
-		for(i = 0; i < iSize; i++)
-			fFirst[i] += fFactor * fSec[i];
-	}
+		CVectorKernels::AddScaled(fFirst, fSec, fFactor, fFirst, iSize);
 	else
-	{
-		int i;
-		for(i = 0; i < iSize; i++)
-			fFirst[i] += fSec[i];
-	}
+		CVectorKernels::Add(fFirst, fSec, fFirst, iSize);
 }
 
 /*void CBasicMath::Add(ISpectrum &dispFirst, ISpectrum &dispSec, int iMode)
@@ -628,9 +572,7 @@ void CBasicMath::Add(double *fFirst, double *fSec, int iSize, double fFactor)
 
 void CBasicMath::Add(double *fFirst, int iSize, double fConst)
 {
-	int i;
-	for(i = 0; i < iSize; i++)
-		fFirst[i] += fConst;
+	CVectorKernels::AddScalar(fFirst, fConst, fFirst, iSize);
 }
 
 /*void CBasicMath::Add(ISpectrum &dispFirst, double fConst)
@@ -652,18 +594,11 @@ void CBasicMath::Add(double *fFirst, int iSize, double fConst)
 
 void CBasicMath::Sub(double *fFirst, double *fSec, int iSize, double fFactor)
 {
+	// adding the negated product is the same as subtracting it
 	if(fFactor != 0)
-	{
-		int i;
-		for(i = 0; i < iSize; i++)
-			fFirst[i] -= fFactor * fSec[i];
-	}
+		CVectorKernels::AddScaled(fFirst, fSec, -fFactor, fFirst, iSize);
 	else
-	{
-		int i;
-		for(i = 0; i < iSize; i++)
-			fFirst[i] -= fSec[i];
-	}
+		CVectorKernels::Sub(fFirst, fSec, fFirst, iSize);
 }
 
 /*void CBasicMath::Sub(ISpectrum &dispFirst, ISpectrum &dispSec, int iMode)
@@ -690,9 +625,7 @@ void CBasicMath::Sub(double *fFirst, double *fSec, int iSize, double fFactor)
 */
 void CBasicMath::Sub(double *fFirst, int iSize, double fConst)
 {
-	int i;
-	for(i = 0; i < iSize; i++)
-		fFirst[i] -= fConst;
+	CVectorKernels::AddScalar(fFirst, -fConst, fFirst, iSize);
 }
 
 /*void CBasicMath::Sub(ISpectrum &dispFirst, double fConst)
@@ -715,17 +648,9 @@ void CBasicMath::Sub(double *fFirst, int iSize, double fConst)
 void CBasicMath::Mul(double *fFirst, double *fSec, int iSize, double fFactor)
 {
 	if(fFactor != 0)
-	{
-		int i;
-		for(i = 0; i < iSize; i++)
-			fFirst[i] *= fFactor * fSec[i];
-	}
+		CVectorKernels::MulScaled(fFirst, fSec, fFactor, fFirst, iSize);
 	else
-	{
-		int i;
-		for(i = 0; i < iSize; i++)
-			fFirst[i] *= fSec[i];
-	}
+		CVectorKernels::Mul(fFirst, fSec, fFirst, iSize);
 }
 
 /*void CBasicMath::Mul(ISpectrum &dispFirst, ISpectrum &dispSec, int iMode)
@@ -752,9 +677,7 @@ void CBasicMath::Mul(double *fFirst, double *fSec, int iSize, double fFactor)
 
 void CBasicMath::Mul(double *fFirst, int iSize, double fConst)
 {
-	int i;
-	for(i = 0; i < iSize; i++)
-		fFirst[i] *= fConst;
+	CVectorKernels::MulScalar(fFirst, fConst, fFirst, iSize);
 }
 
 /*void CBasicMath::Mul(ISpectrum &dispFirst, double fConst)
@@ -776,24 +699,11 @@ void CBasicMath::Mul(double *fFirst, int iSize, double fConst)
 
 void CBasicMath::Div(double *fFirst, double *fSec, int iSize, double fFactor)
 {
+	// the quotients are zero where the divisor is zero
 	if(fFactor != 0)
-	{
-		int i;
-		for(i = 0; i < iSize; i++)
-			if(fSec[i] != 0)
-				fFirst[i] /= fFactor * fSec[i];
-			else
-				fFirst[i] = 0;
-	}
+		CVectorKernels::DivScaled(fFirst, fSec, fFactor, fFirst, iSize);
 	else
-	{
-		int i;
-		for(i = 0; i < iSize; i++)
-			if(fSec[i] != 0)
-				fFirst[i] /= fSec[i];
-			else
-				fFirst[i] = 0;
-	}
+		CVectorKernels::Div(fFirst, fSec, fFirst, iSize);
 }
 
 /*void CBasicMath::Div(ISpectrum &dispFirst, ISpectrum &dispSec, int iMode)
@@ -823,9 +733,7 @@ void CBasicMath::Div(double *fFirst, int iSize, double fConst)
 	if(fConst == 0)
 		return;
 
-	int i;
-	for(i = 0; i < iSize; i++)
-		fFirst[i] /= fConst;
+	CVectorKernels::DivScalar(fFirst, fConst, fFirst, iSize);
 }
 
 /*void CBasicMath::Div(ISpectrum &dispFirst, double fConst)
@@ -1179,29 +1087,27 @@ bool CBasicMath::PolynomialFit(double *fXData, int iNXValues, double *fYData, do
 
 void CBasicMath::CrossCorrelate(double *fFirst, int iLengthFirst, double *fSec, int iLengthSec)
 {
-	std::vector<double> fResult(iLengthFirst);
+	if(iLengthFirst <= 0)
+		return;
+
+	if(mTransformBuffer.size() < (size_t)iLengthFirst)
+		mTransformBuffer.resize(iLengthFirst);
+	double* fResult = mTransformBuffer.data();
+
+	// the sums of the products of the first data and the first 2 * (iLengthSec / 2) values of the second data,
+	// which are centered at the current index. These are calculated using the fast fourier transform for long data.
+	const int iHalfSec = iLengthSec / 2;
+	CConvolution::Convolute(fFirst, iLengthFirst, fSec, 2 * iHalfSec, iHalfSec - 1, fResult, CConvolution::ZEROEXTENSION);
 
 	int i;
 	for(i = 1; i <= iLengthFirst; i++)
 	{
-		double fSum = 0.0;
-
-		int iStartIndexSec = std::max(-iLengthSec / 2, -i);	// we either have to start at the end of the second data array or we can start before the zero index of the first array
-		int iStopIndexSec = std::min(iLengthSec / 2, iLengthFirst - i);	// we can go further than iLengthFirst
-		int iFirstIndex = i + iStartIndexSec;
-		
-		iStartIndexSec += iLengthSec / 2;
-		iStopIndexSec += iLengthSec / 2;
-
-		int iSecIndex;
-		for(iSecIndex = iStartIndexSec; iSecIndex < iStopIndexSec; iFirstIndex++, iSecIndex++) {
-			fSum += fFirst[iFirstIndex] * fSec[iSecIndex];
-		}
+		int iStartIndexSec = std::max(-iHalfSec, -i);	// we either have to start at the end of the second data array or we can start before the zero index of the first array
+		int iStopIndexSec = std::min(iHalfSec, iLengthFirst - i);	// we can go further than iLengthFirst
 
-		fResult[i - 1] = fSum / (double)(iStopIndexSec - iStartIndexSec);
+		// the average of the products inside of the first data
+		fFirst[i - 1] = fResult[i - 1] / (double)(iStopIndexSec - iStartIndexSec);
 	}
-
-	memcpy(fFirst, fResult.data(), sizeof(double) * iLengthFirst);
 }
 
 /*void CBasicMath::CrossCorrelate(ISpectrum &dispFirst, ISpectrum &dispSec)
@@ -1354,66 +1260,6 @@ bool CBasicMath::GaussFit(double *fXData, int iNXValues, double *fYData, double&
 	return(lpSpec);
 }*/
 
-/**
- * dfour1
- *
- * Build the fourier transform or the inverse fourier transform of a given funtcion.
- * The data array will contain the result of the transform.
- * (C) Copr. 1986-92 Numerical Recipes Software. p. 502-510
- *
- * @param	data	Array that contains either 2*nn real values of the real function
- *					or nn complex values of the frequency function
- * @param	nn		The number of values in the array, must be an integer power of 2
- * @param	isign	A value of 1 indicates to do the fourier transfor, set to -1 of inverse.
- */
-void CBasicMath::DFourier(double data[], unsigned long nn, int isign)
-{
-	unsigned long n,mmax,m,j,istep,i;
-	double wtemp,wr,wpr,wpi,wi,theta;
-	double tempr,tempi;
-#define SWAP(a,b) { tempr = (a); (a) = (b); (b) = tempr; }
-
-	n=nn << 1;
-	j=1;
-	for (i=1;i<n;i+=2) {
-		if (j > i) {
-			SWAP(data[j],data[i]);
-			SWAP(data[j+1],data[i+1]);
-		}
-		m=n >> 1;
-		while (m >= 2 && j > m) {
-			j -= m;
-			m >>= 1;
-		}
-		j += m;
-	}
-	mmax=2;
-	while (n > mmax) {
-		istep=mmax << 1;
-		theta=isign*(6.28318530717959/mmax);
-		wtemp=sin(0.5*theta);
-		wpr = -2.0*wtemp*wtemp;
-		wpi=sin(theta);
-		wr=1.0;
-		wi=0.0;
-		for (m=1;m<mmax;m+=2) {
-			for (i=m;i<=n;i+=istep) {
-				j=i+mmax;
-				tempr=wr*data[j]-wi*data[j+1];
-				tempi=wr*data[j+1]+wi*data[j];
-				data[j]=data[i]-tempr;
-				data[j+1]=data[i+1]-tempi;
-				data[i] += tempr;
-				data[i+1] += tempi;
-			}
-			wr=(wtemp=wr)*wpr-wi*wpi+wr;
-			wi=wi*wpr+wtemp*wpi+wi;
-		}
-		mmax=istep;
-	}
-}
-#undef SWAP
-
 /*void CBasicMath::FFT(ISpectrum &dispSpec, ISpectrum &dispReal, ISpectrum &dispImaginary)
 {
 	CDoubleMonitoredArrayData dmadData(dispSpec.Data);
@@ -1437,54 +1283,71 @@ void CBasicMath::DFourier(double data[], unsigned long nn, int isign)
 	dispImaginary.Data = dmadImaginary.GetMonitoredArray();
 }*/
 
+/**
+ * Calculates the spectrum of the real data, whose zero frequency is stored at the index iLength / 2.
+ * The spectrum uses the sign convention F(k) = sum f(j) exp(2 pi i j k / n).
+ */
 void CBasicMath::FFT(double *fData, double *fReal, double *fImaginary, int iLength)
 {
-	std::vector<double> fBuffer(iLength * 2, 0);
-
 	memset(fReal, 0, iLength * sizeof(double));
 	memset(fImaginary, 0, iLength * sizeof(double));
 
-	int i;
-	for(i = 0; i < iLength; i++) {
-		fBuffer[i * 2] = fData[i];
-	}
+	if(iLength <= 0)
+		return;
 
-	DFourier(fBuffer.data(), iLength, 1);
+	// only the lower half of the spectrum is calculated, the upper half contains the conjugates
+	std::shared_ptr<const CRealFourierTransform> plan = CRealFourierTransform::GetPlan(iLength);
+	const int iSpectrumSize = plan->GetSpectrumSize();
+	if(mTransformBuffer.size() < 2 * (size_t)iSpectrumSize)
+		mTransformBuffer.resize(2 * iSpectrumSize);
+	double* fSpectrum = mTransformBuffer.data();
 
-	for(i = 0; i < iLength / 2; i++)
-	{
-		fReal[i + iLength / 2] = fBuffer[i * 2];
-		fImaginary[i + iLength / 2] = fBuffer[i * 2 + 1];
-	}
-	for(i = iLength / 2; i < iLength; i++)
+	plan->Forward(fData, fSpectrum);
+
+	int i;
+	for(i = 0; i < iLength; i++)
 	{
-		fReal[i - iLength / 2] = fBuffer[i * 2];
-		fImaginary[i - iLength / 2] = fBuffer[i * 2 + 1];
+		// the plan uses the sign convention exp(-2 pi i j k / n), which gives the conjugate spectrum
+		const double fRe = i < iSpectrumSize ? fSpectrum[2 * i] : fSpectrum[2 * (iLength - i)];
+		const double fIm = i < iSpectrumSize ? -fSpectrum[2 * i + 1] : fSpectrum[2 * (iLength - i) + 1];
+
+		const int iIndex = i < iLength / 2 ? i + iLength / 2 : i - iLength / 2;
+		fReal[iIndex] = fRe;
+		fImaginary[iIndex] = fIm;
 	}
 }
 
+/**
+ * Calculates the real part of the inverse transform of the spectrum calculated by \Ref{FFT}.
+ */
 void CBasicMath::InverseFFT(double* fReal, double* fImaginary, double* fData, int iLength)
 {
-	std::vector<double> fBuffer(iLength * 2);
+	if(iLength <= 0)
+		return;
 
-	memset(fData, 0, sizeof(double) * iLength);
+	std::shared_ptr<const CRealFourierTransform> plan = CRealFourierTransform::GetPlan(iLength);
+	const int iSpectrumSize = plan->GetSpectrumSize();
+	if(mTransformBuffer.size() < 2 * (size_t)iSpectrumSize)
+		mTransformBuffer.resize(2 * iSpectrumSize);
+	double* fSpectrum = mTransformBuffer.data();
 
+	// the real part of the result only depends on the symmetric part of the spectrum, which is the spectrum of real data.
+	// The conjugates are taken since the plan uses the opposite sign convention.
 	int i;
-	for(i = 0; i < iLength / 2; i++)
+	for(i = 0; i < iSpectrumSize; i++)
 	{
-		fBuffer[i * 2] = fReal[i + iLength / 2];
-		fBuffer[i * 2 + 1] = fImaginary[i + iLength / 2];
-	}
-	for(i = iLength / 2; i < iLength; i++)
-	{
-		fBuffer[i * 2] = fReal[i - iLength / 2];
-		fBuffer[i * 2 + 1] = fImaginary[i - iLength / 2];
+		const int iIndex = i < iLength / 2 ? i + iLength / 2 : i - iLength / 2;
+		const int j = (iLength - i) % iLength;
+		const int iMirrorIndex = j < iLength / 2 ? j + iLength / 2 : j - iLength / 2;
+
+		fSpectrum[2 * i] = 0.5 * (fReal[iIndex] + fReal[iMirrorIndex]);
+		fSpectrum[2 * i + 1] = 0.5 * (fImaginary[iMirrorIndex] - fImaginary[iIndex]);
 	}
 
-	DFourier(fBuffer.data(), iLength, -1);
+	plan->Inverse(fSpectrum, fData);
 
 	for(i = 0; i < iLength; i++) {
-		fData[i] = fBuffer[i * 2] / (double)iLength;
+		fData[i] /= (double)iLength;
 	}
 }
 
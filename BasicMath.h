@@ -5,7 +5,9 @@
 #if !defined(AFX_BASICMATH_H__1DEB20E2_5D81_11D4_866C_00E098701FA6__INCLUDED_)
 #define AFX_BASICMATH_H__1DEB20E2_5D81_11D4_866C_00E098701FA6__INCLUDED_
 
+#include <vector>
 #include "fit/Vector.h"
+#include "fit/BinomialFilter.h"
 #include <SpectralEvaluation/Fit/FitException.h>
 
 #if _MSC_VER > 1000
@@ -83,16 +85,23 @@ public:
 	double* CalcMeasuredSpec(double* fRes, double* fMea, int iMeaScans, double fMeaExpTime, double* fLamp, int iLampScans, double fLampExpTime, double* fBack, int iBackScans, double fBackExpTime, double fOffset, double fOffsetExpTime, int iSize);
 	double* Log(double* fData, int iSize);
 	double* Delog(double* fData, int iSize);
-	double* HighPassBinomial(double* fData, int iSize, int iNIterations);
-	double* LowPassBinomial(double* fData, int iSize, int iNIterations);
+	double* HighPassBinomial(double* fData, int iSize, int iNIterations, CBinomialFilter::EMethod eMethod = CBinomialFilter::AUTOMATIC);
+	double* LowPassBinomial(double* fData, int iSize, int iNIterations, CBinomialFilter::EMethod eMethod = CBinomialFilter::AUTOMATIC);
+	double* HighPassBinomialLog(double* fData, int iSize, int iNIterations, CBinomialFilter::EMethod eMethod = CBinomialFilter::AUTOMATIC);
 //	static int CheckLimits(ISpectrum& dispSpec, int& iLowLimit, int& iHighLimit);
 	CBasicMath();
 	virtual ~CBasicMath();
 
 private:
-	void DFourier(double data[], unsigned long nn, int isign);
 //	double GetCorrectFactor(ISpectrum& dispFirst, ISpectrum& dispSec, int iMode);
 	static bool mDoNotUseMathLimits;
+
+	// the low pass filter and the scratch buffer of the high pass filter, kept between the calls to avoid reallocating them for every spectrum
+	CBinomialFilter mBinomialFilter;
+	std::vector<double> mHighPassBuffer;
+
+	// the spectrum of the fourier transforms and the sums of the cross correlation
+	std::vector<double> mTransformBuffer;
 };
 
 #endif // !defined(AFX_BASICMATH_H__1DEB20E2_5D81_11D4_866C_00E098701FA6__INCLUDED_)
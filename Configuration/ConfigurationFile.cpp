@@ -97,6 +97,7 @@ void ConfigurationFile::Write(CMobileConfiguration& configuration)
     fprintf(f, "\t\t<to>%d</to>\n", configuration.m_offsetTo);
     fprintf(f, "\t</Offset>\n");
     fprintf(f, "\t<noDark>%d</noDark>\n", configuration.m_noDark);
+    fprintf(f, "\t<warmStart>%d</warmStart>\n", configuration.m_warmStart);
 
     // ----------- Calibration ----------------
 
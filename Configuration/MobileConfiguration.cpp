@@ -182,6 +182,12 @@ int CMobileConfiguration::Parse() {
             continue;
         }
 
+        // Whether each fit should start from the result of the previous spectrum
+        if (Equals(szToken, "warmStart")) {
+            Parse_IntItem("/warmStart", m_warmStart);
+            continue;
+        }
+
         // The Fit-window Settings
         if (Equals(szToken, "FitWindow")) {
             ParseFitWindow();
@@ -122,6 +122,10 @@ namespace Configuration {
         /** whether to skip dark measurement (1=true, 0=false)*/
         int m_noDark = 0;
 
+        /** whether each fit should start from the shifts and squeezes
+            of the previous spectrum (1=true, 0=false)*/
+        int m_warmStart = 0;
+
         // --------------- Autmatic Calibration ------------
         struct AutomaticCalibration
         {
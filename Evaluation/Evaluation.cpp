@@ -5,7 +5,9 @@
 #include "stdafx.h"
 //#include "DbSpec.h"
 #include "Evaluation.h"
+#include "FitWorkspace.h"
 #include <iostream>
+#include <algorithm>
 #include <conio.h>
 // include all required fit objects
 #include "../Fit/ReferenceSpectrumFunction.h"
@@ -44,6 +46,18 @@ using namespace Evaluation;
 
 using namespace std;
 
+/** When the fit is started from the result of the last fit, it is done again from the default
+    parameters if its chi square is more than this factor larger than the chi square of the last fit.
+    The fit has then most likely converged to a local minimum. */
+static const double maxWarmStartChiSquareRatio = 1.5;
+
+/** The number of iterations of the binomial filter which removes the broad structures
+    from the spectra in the high pass fit types */
+static const int highPassIterations = 500;
+
+/** The number of iterations of the binomial filter applied if the spectra are low pass filtered */
+static const int lowPassIterations = 5;
+
 
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
@@ -55,6 +69,10 @@ CEvaluation::CEvaluation()
     m_lowPassFiltering = 0;
 
     m_subtractDarkFromSky = true;
+
+    m_warmStart = false;
+
+    m_allocationCount = 0;
 }
 
 CEvaluation::~CEvaluation()
@@ -69,167 +87,91 @@ CEvaluation::~CEvaluation()
 */
 void CEvaluation::Evaluate(const double* darkSpectrum, const double* skySpectrum, const double* measSpectrum, long numSteps)
 {
+    const long allocationsBefore = CAllocationCounter::GetCount();
 
-    CString szOut, szTmp;
-    int iNumSpec = m_window.nRef;
-    int sumChn = m_window.specLength;
-    //////////////////////////////////////////////////////////////////
-    // Define the number of used reference spectra
-    //	const int iNumSpec = 1;//5;
-
-    CVector vXData, vMeas;
-
-    // Copy the spectra to local variables
-    double* measArray = new double[sumChn];
-    memcpy(measArray, measSpectrum, sumChn * sizeof(double));
-
-    double* skyArray = new double[sumChn];
-    memcpy(skyArray, skySpectrum, sumChn * sizeof(double));
-
-    double* darkArray = new double[sumChn];
-    memcpy(darkArray, darkSpectrum, sumChn * sizeof(double));
-
-    // calculate the 'wavelength' column
-    vXData.SetSize(sumChn);
-    for (int i = 0; i < sumChn; ++i)
+    // the model function and the fit object are kept between the evaluations,
+    //  they only need to be built again if the fit settings have changed
+    if (m_workspace == nullptr || !m_workspace->Matches(m_window))
     {
-        vXData.SetAt(i, (TFitData)(1.0f + (double)i));
+        BuildWorkspace();
     }
+    CFitWorkspace& workspace = *m_workspace;
+
+    int iNumSpec = m_window.nRef;
+    int sumChn = m_window.specLength;
 
     //----------------------------------------------------------------
     // --------- prepare the spectrum for evaluation -----------------
     //----------------------------------------------------------------
-    PrepareSpectra(darkArray, skyArray, measArray, m_window); // why not pass in CSpectrum instead of array?
+    // the spectra are read directly, the prepared spectrum is written to the buffer of the workspace
+    //  only the fit window and the pixels it depends on through the filters are prepared
+    double* measArray = workspace.m_meas.data();
+    int preparedFrom, preparedTo;
+    GetPreparedRange(m_window, preparedFrom, preparedTo);
+    PrepareSpectra(darkSpectrum, skySpectrum, measSpectrum, measArray, m_window, preparedFrom, preparedTo);
 
     // Copy the highpass-filtered spectrum to the designated storage
-    m_filteredSpectrum = std::vector<double>(measArray, measArray + sumChn);
+    m_filteredSpectrum.assign(measArray, measArray + sumChn);
 
     // low pass filter
     if (m_lowPassFiltering)
     {
-        LowPassBinomial(measArray, sumChn, 5);
+        LowPassBinomial(measArray + preparedFrom, preparedTo - preparedFrom, lowPassIterations);
     }
 
     //----------------------------------------------------------------
 
-    vMeas.Copy(measArray, sumChn, 1);
-    /////////////////////////////////////////////////////////////////////////////
-    // in order to perform the fit on a certain range within the spectrum, we need to extract the
-    // appropriate wavelength information from the existing vXData vector. Actually its just a subvector
-    // that holds the wavelength values of the fit range
-    //CVector vXSec(iFitHigh - iFitLow);
-    //vXSec.Copy(vXData.SubVector(iFitLow, iFitHigh - iFitLow));
-    CVector vXSec(m_window.fitHigh - m_window.fitLow);
-    vXSec.Copy(vXData.SubVector(m_window.fitLow, m_window.fitHigh - m_window.fitLow));
-
-    ////////////////////////////////////////////////////////////////////////////
-    // now we start building the model function needed for fitting.
-    //
-    // First we create a function object that represents our measured spectrum. Since we do not
-    // need any interpolation on the measured data its enough to use a CDiscreteFunction object.
-    CDiscreteFunction dataTarget;
-
-    // now set the data of the measured spectrum in regard to the wavelength information
-    dataTarget.SetData(vXData, vMeas);
-
-    // since the DOAS model function consists of the sum of all reference spectra and a polynomial,
-    // we first create a summation object
-    CSimpleDOASFunction cRefSum;
-
-    // now we create the required CReferecneSpectrumFunction objects that actually represent the 
-    // reference spectra used in the DOAS model function
-    //	CReferenceSpectrumFunction ref[iNumSpec];
-    CReferenceSpectrumFunction ref[20];
-    for (int i = 0; i < iNumSpec; i++)
+    // set the measured spectrum as the target of the fit. The sizes of the vectors
+    //  do not change, so this only copies the data
+    workspace.m_yData.Copy(measArray, sumChn, 1);
+    workspace.m_target.SetData(workspace.m_xData, workspace.m_yData, workspace.m_error);
+    workspace.m_difference->SetData(workspace.m_xData, workspace.m_yData, workspace.m_error);
+
+    // start the fit from the default parameters, or from the shifts and squeezes of the last fit
+    //  if warm start is enabled. The linear parameters are always determined again from scratch
+    const bool warmStart = m_warmStart && workspace.m_hasLastResult;
+    workspace.m_model.ResetLinearParameter();
+    if (warmStart)
     {
-        // reset all reference's parameters
-        ref[i].ResetLinearParameter();
-        ref[i].ResetNonlinearParameter();
-
-        // enable amplitude normalization. This should normally be done in order to avoid numerical
-        // problems during fitting.
-        ref[i].SetNormalize(true);
-
-        // set the spectral data of the reference spectrum to the object. This also causes an internal
-        // transformation of the spectral data into a B-Spline that will be used to interpolate the 
-        // reference spectrum during shift and squeeze operations
-        if (!ref[i].SetData(vXData.SubVector(0, vnYData[i].GetSize()), vnYData[i]))
-        {
-            Error0("Error initializing spline object!");
-        }
-
-        // Set the column (if wanted)
-        switch (m_window.ref[i].m_columnOption)
-        {
-        case novac::SHIFT_TYPE::SHIFT_FIX:   ref[i].FixParameter(CReferenceSpectrumFunction::CONCENTRATION, m_window.ref[i].m_columnValue * ref[i].GetAmplitudeScale()); break;
-        case novac::SHIFT_TYPE::SHIFT_LINK:  ref[(int)m_window.ref[i].m_columnValue].LinkParameter(CReferenceSpectrumFunction::CONCENTRATION, ref[i], CReferenceSpectrumFunction::CONCENTRATION); break;
-        }
-
-        // Set the shift
-        switch (m_window.ref[i].m_shiftOption)
-        {
-        case novac::SHIFT_TYPE::SHIFT_FIX:   ref[i].FixParameter(CReferenceSpectrumFunction::SHIFT, m_window.ref[i].m_shiftValue); break;
-        case novac::SHIFT_TYPE::SHIFT_LINK:  ref[(int)m_window.ref[i].m_shiftValue].LinkParameter(CReferenceSpectrumFunction::SHIFT, ref[i], CReferenceSpectrumFunction::SHIFT); break;
-        default:          ref[i].SetDefaultParameter(CReferenceSpectrumFunction::SHIFT, (TFitData)0.0);
-            ref[i].SetParameterLimits(CReferenceSpectrumFunction::SHIFT, (TFitData)-5.0, (TFitData)5.0, (TFitData)1e2);
-        }
-
-        // Set the squeeze
-        switch (m_window.ref[i].m_squeezeOption)
-        {
-        case novac::SHIFT_TYPE::SHIFT_FIX:   ref[i].FixParameter(CReferenceSpectrumFunction::SQUEEZE, m_window.ref[i].m_squeezeValue); break;
-        case novac::SHIFT_TYPE::SHIFT_LINK:  ref[(int)m_window.ref[i].m_squeezeValue].LinkParameter(CReferenceSpectrumFunction::SQUEEZE, ref[i], CReferenceSpectrumFunction::SQUEEZE); break;
-        default:          ref[i].SetDefaultParameter(CReferenceSpectrumFunction::SQUEEZE, (TFitData)1.0);
-            ref[i].SetParameterLimits(CReferenceSpectrumFunction::SQUEEZE, (TFitData)0.9, (TFitData)1.1, (TFitData)1e5); break;
-        }
-
-        // another requirement in the example fit scenario is that we need to link the shift parameters of all
-        // references to the shift parameter of the first reference (Fraunhofer) except for the 3 reference spectrum (NO2)
-        //	if(i > 0 && i != 3)//stefans
-        //		ref[0].LinkParameter(CReferenceSpectrumFunction::SHIFT, ref[i], CReferenceSpectrumFunction::SHIFT);
-
-        // at last add the reference to the summation object
-        cRefSum.AddReference(ref[i]);
+        workspace.m_model.SetNonlinearParameter(workspace.m_lastNonlinearParameter);
     }
-
-    // create the additional polynomial with an order of 'polyTime' and add it to the summation object, too
-    CPolynomialFunction cPoly(m_window.polyOrder);
-    cRefSum.AddReference(cPoly);
-
-    // the last step in the model function will be to define how the difference between the measured data and the modeled
-    // data will be determined. In this case we will use the CStandardMetricFunction which actually just calculate the difference
-    // between the measured data and the modeled data channel by channel. The fit will try to minimize these differences.
-    // So we create the metric object and set the measured spectrum function object and the DOAS model function object as parameters
-    CStandardMetricFunction cDiff(dataTarget, cRefSum);
-
-
-    /////////////////////////////////////////////////////////////////
-    // Now its time to create the fit object. The CStandardFit object will 
-    // provide a combination of a linear Least Square Fit and a nonlinear Levenberg-Marquardt Fit, which
-    // should be sufficient for most needs.
-    CStandardFit cFirstFit(cDiff);
-
-    // don't forget to the the already extracted fit range to the fit object!
-    // without a valid fit range you'll get an exception.
-    cFirstFit.SetFitRange(vXSec);
+    else
+    {
+        workspace.m_model.ResetNonlinearParameter();
+    }
+    workspace.m_hasLastResult = false;
 
     // limit the number of fit iteration to 5000. This can still take a long time! More convinient values are
     // between 100 and 1000
-    cFirstFit.GetNonlinearMinimizer().SetMaxFitSteps(numSteps);
+    workspace.m_fit->GetNonlinearMinimizer().SetMaxFitSteps(numSteps);
+
+    CStandardFit& cFirstFit = *workspace.m_fit;
+    CReferenceSpectrumFunction* ref = workspace.m_ref;
 
     try
     {
-        // prepare everything for fitting
-        cFirstFit.PrepareMinimize();
+        bool fitSucceeded = RunFit(cFirstFit);
 
-        // actually do the fitting
-        if (!cFirstFit.Minimize())
+        // if the fit started from the last result did not converge, or converged to a clearly worse
+        //  solution than the last fit, then do the fit again starting from the default parameters
+        if (warmStart && (!fitSucceeded || cFirstFit.GetChiSquare() > maxWarmStartChiSquareRatio * workspace.m_lastChiSquare))
         {
-            MessageBox(NULL, TEXT("fit fail."), TEXT("error"), MB_OK);
+            workspace.m_model.ResetLinearParameter();
+            workspace.m_model.ResetNonlinearParameter();
+            fitSucceeded = RunFit(cFirstFit);
         }
 
-        // finalize the fitting process. This will calculate the error measurements and other statistical stuff
-        cFirstFit.FinishMinimize();
+        if (!fitSucceeded)
+        {
+            MessageBox(NULL, TEXT("fit fail."), TEXT("error"), MB_OK);
+        }
+        else
+        {
+            // remember the result, this is the starting point of the next fit if warm start is enabled
+            workspace.m_lastNonlinearParameter.Copy(workspace.m_model.GetNonlinearParameter());
+            workspace.m_lastChiSquare = cFirstFit.GetChiSquare();
+            workspace.m_hasLastResult = true;
+        }
 
         CDOASVector vResiduum;
 
@@ -247,7 +189,7 @@ void CEvaluation::Evaluate(const double* darkSpectrum, const double* skySpectrum
         // Get the polynomial
         for (int tmpInt = 0; tmpInt < m_window.polyOrder; ++tmpInt)
         {
-            m_result.m_polynomial[tmpInt] = (double)cPoly.GetCoefficient(tmpInt);
+            m_result.m_polynomial[tmpInt] = (double)workspace.m_polynomial.GetCoefficient(tmpInt);
         }
 
         // allocate enough space to fit in all the result-values
@@ -274,13 +216,13 @@ void CEvaluation::Evaluate(const double* darkSpectrum, const double* skySpectrum
             m_fitResult[i].Zero();
 
             // get the final fit result
-            ref[i].GetValues(vXData, m_fitResult[i]);
+            ref[i].GetValues(workspace.m_xData, m_fitResult[i]);
         }
 
         // get the resulting polynomial
         m_fitResult[i].SetSize(sumChn);
         m_fitResult[i].Zero();
-        cPoly.GetValues(vXData, m_fitResult[i]);
+        workspace.m_polynomial.GetValues(workspace.m_xData, m_fitResult[i]);
     }
     catch (CFitException e)
     {
@@ -298,13 +240,168 @@ void CEvaluation::Evaluate(const double* darkSpectrum, const double* skySpectrum
         MessageBox(NULL, TEXT("fit exception"), TEXT("notice"), MB_OK);
     }
 
-    delete[] measArray;
-    delete[] skyArray;
-    delete[] darkArray;
+    m_allocationCount = CAllocationCounter::GetCount() - allocationsBefore;
 
     return;
 }
 
+bool CEvaluation::RunFit(CStandardFit& fit)
+{
+    // prepare everything for fitting
+    fit.PrepareMinimize();
+
+    // actually do the fitting
+    const bool converged = fit.Minimize();
+
+    // finalize the fitting process. This will calculate the error measurements and other statistical stuff
+    fit.FinishMinimize();
+
+    return converged;
+}
+
+void CEvaluation::SetWarmStart(bool warmStart)
+{
+    m_warmStart = warmStart;
+
+    // the next fit starts from the default parameters, also when warm start was already enabled
+    if (m_workspace != nullptr)
+    {
+        m_workspace->m_hasLastResult = false;
+    }
+}
+
+void CEvaluation::BuildWorkspace()
+{
+    int iNumSpec = m_window.nRef;
+    int sumChn = m_window.specLength;
+
+    m_workspace.reset(new CFitWorkspace(m_window.polyOrder));
+    CFitWorkspace& workspace = *m_workspace;
+    workspace.m_specLength = sumChn;
+    workspace.m_nRef = iNumSpec;
+    workspace.m_fitLow = m_window.fitLow;
+    workspace.m_fitHigh = m_window.fitHigh;
+
+    workspace.m_meas.resize(sumChn);
+
+    // calculate the 'wavelength' column
+    workspace.m_xData.SetSize(sumChn);
+    for (int i = 0; i < sumChn; ++i)
+    {
+        workspace.m_xData.SetAt(i, (TFitData)(1.0f + (double)i));
+    }
+
+    // the measured spectrum is set before every fit, it has no error
+    workspace.m_yData.SetSize(sumChn);
+    workspace.m_error.SetSize(sumChn);
+    workspace.m_error.Wedge(1, 0);
+
+    /////////////////////////////////////////////////////////////////////////////
+    // in order to perform the fit on a certain range within the spectrum, we need to extract the
+    // appropriate wavelength information from the existing vXData vector. Actually its just a subvector
+    // that holds the wavelength values of the fit range
+    workspace.m_xFitRange.Copy(workspace.m_xData.SubVector(m_window.fitLow, m_window.fitHigh - m_window.fitLow));
+
+    ////////////////////////////////////////////////////////////////////////////
+    // now we start building the model function needed for fitting.
+    //
+    // First we create a function object that represents our measured spectrum. Since we do not
+    // need any interpolation on the measured data its enough to use a CDiscreteFunction object.
+    workspace.m_target.SetData(workspace.m_xData, workspace.m_yData, workspace.m_error);
+
+    // since the DOAS model function consists of the sum of all reference spectra and a polynomial,
+    // we use a summation object, to which we add the CReferecneSpectrumFunction objects that actually
+    // represent the reference spectra used in the DOAS model function
+    CReferenceSpectrumFunction* ref = workspace.m_ref;
+    bool linkedParameters = false;
+    for (int i = 0; i < iNumSpec; i++)
+    {
+        // use the normalized reference spectrum and its spline, which are shared with all other evaluators
+        // using the same reference. The spline is used to interpolate the reference spectrum during
+        // shift and squeeze operations
+        ref[i].SetBasisFunction(m_reference[i]->GetSpline(), (TFitData)m_reference[i]->GetAmplitudeScale());
+
+        // Set the column (if wanted)
+        switch (m_window.ref[i].m_columnOption)
+        {
+        case novac::SHIFT_TYPE::SHIFT_FIX:   ref[i].FixParameter(CReferenceSpectrumFunction::CONCENTRATION, m_window.ref[i].m_columnValue * ref[i].GetAmplitudeScale()); break;
+        case novac::SHIFT_TYPE::SHIFT_LINK:  ref[(int)m_window.ref[i].m_columnValue].LinkParameter(CReferenceSpectrumFunction::CONCENTRATION, ref[i], CReferenceSpectrumFunction::CONCENTRATION); break;
+        }
+
+        // Set the shift
+        switch (m_window.ref[i].m_shiftOption)
+        {
+        case novac::SHIFT_TYPE::SHIFT_FIX:   ref[i].FixParameter(CReferenceSpectrumFunction::SHIFT, m_window.ref[i].m_shiftValue); break;
+        case novac::SHIFT_TYPE::SHIFT_LINK:  ref[(int)m_window.ref[i].m_shiftValue].LinkParameter(CReferenceSpectrumFunction::SHIFT, ref[i], CReferenceSpectrumFunction::SHIFT); break;
+        default:          ref[i].SetDefaultParameter(CReferenceSpectrumFunction::SHIFT, (TFitData)0.0);
+            ref[i].SetParameterLimits(CReferenceSpectrumFunction::SHIFT, (TFitData)-5.0, (TFitData)5.0, (TFitData)1e2);
+        }
+
+        // Set the squeeze
+        switch (m_window.ref[i].m_squeezeOption)
+        {
+        case novac::SHIFT_TYPE::SHIFT_FIX:   ref[i].FixParameter(CReferenceSpectrumFunction::SQUEEZE, m_window.ref[i].m_squeezeValue); break;
+        case novac::SHIFT_TYPE::SHIFT_LINK:  ref[(int)m_window.ref[i].m_squeezeValue].LinkParameter(CReferenceSpectrumFunction::SQUEEZE, ref[i], CReferenceSpectrumFunction::SQUEEZE); break;
+        default:          ref[i].SetDefaultParameter(CReferenceSpectrumFunction::SQUEEZE, (TFitData)1.0);
+            ref[i].SetParameterLimits(CReferenceSpectrumFunction::SQUEEZE, (TFitData)0.9, (TFitData)1.1, (TFitData)1e5); break;
+        }
+
+        linkedParameters = linkedParameters ||
+            m_window.ref[i].m_columnOption == novac::SHIFT_TYPE::SHIFT_LINK ||
+            m_window.ref[i].m_shiftOption == novac::SHIFT_TYPE::SHIFT_LINK ||
+            m_window.ref[i].m_squeezeOption == novac::SHIFT_TYPE::SHIFT_LINK;
+
+        // another requirement in the example fit scenario is that we need to link the shift parameters of all
+        // references to the shift parameter of the first reference (Fraunhofer) except for the 3 reference spectrum (NO2)
+        //	if(i > 0 && i != 3)//stefans
+        //		ref[0].LinkParameter(CReferenceSpectrumFunction::SHIFT, ref[i], CReferenceSpectrumFunction::SHIFT);
+
+        // at last add the reference to the summation object
+        workspace.m_model.AddReference(ref[i]);
+    }
+
+    // add the additional polynomial with an order of 'polyTime' to the summation object, too
+    workspace.m_model.AddReference(workspace.m_polynomial);
+
+    // the last step in the model function will be to define how the difference between the measured data and the modeled
+    // data will be determined. In this case we use the CStandardMetricFunction which actually just calculate the difference
+    // between the measured data and the modeled data channel by channel. The fit will try to minimize these differences.
+    // For the common numbers of references and polynomial orders a CDoasModelFunction is used instead, which calculates
+    // the same difference but evaluates all references and the polynomial in one loop. It does not handle linked parameters.
+    // The metric object is created with the measured spectrum function object and the DOAS model function object,
+    // so we only need to give it the data of the measured spectrum.
+    workspace.CreateFit(!linkedParameters);
+    workspace.m_difference->SetData(workspace.m_xData, workspace.m_yData, workspace.m_error);
+
+    /////////////////////////////////////////////////////////////////
+    // The CStandardFit object will provide a combination of a linear Least Square Fit
+    // and a nonlinear Levenberg-Marquardt Fit, which should be sufficient for most needs.
+
+    // don't forget to the the already extracted fit range to the fit object!
+    // without a valid fit range you'll get an exception.
+    workspace.m_fit->SetFitRange(workspace.m_xFitRange);
+
+    // the normal equations of both the linear and the nonlinear fit are symmetric and positive definite,
+    // so solve them using the Cholesky decomposition instead of the Gauss-Jordan elimination
+    workspace.m_fit->SetEquationSolver(IMinimizer::CHOLESKY);
+}
+
+bool CEvaluation::CanBuildWorkspace() const
+{
+    if (m_window.specLength <= 0 || m_window.fitHigh <= m_window.fitLow)
+    {
+        return false;
+    }
+    for (int i = 0; i < m_window.nRef; ++i)
+    {
+        if (m_reference[i] == nullptr)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 EvaluationResult CEvaluation::GetResult(int referenceFile) const
 {
     EvaluationResult result;
@@ -325,7 +422,7 @@ EvaluationResult CEvaluation::GetResult(int referenceFile) const
 /**	read data from reference files
 ** @refFileList - the names of the files
 ** @iNumFile - the number of the files
-** iNumFile<=20, because of vnYData[20]
+** iNumFile<=20, because of the 20 reference functions of the fit workspace
 */
 BOOL CEvaluation::ReadRefList(CString* refFileList, int iNumFile, int sumChn)
 {
@@ -371,14 +468,21 @@ BOOL CEvaluation::ReadRefList(CString* refFileList, int iNumFile, int sumChn)
                 break;
             }
         }
-        // it is faster to assign all values to the vector at once than having to grow the vector for every read value
-        vnYData[i].SetSize(valuesReadNum);
-        for (int index = 0; index < valuesReadNum; ++index)
+        fileRef[i].Close();
+
+        // normalize the reference and calculate its spline, this is then shared by all evaluators using this reference
+        m_reference[i] = CPreparedReference::Create(fValue, valuesReadNum);
+        if (m_reference[i] == nullptr)
         {
-            vnYData[i].SetAt(index, (TFitData)fValue[index]);
+            return FALSE;
         }
+    }
 
-        fileRef[i].Close();
+    // the references are now read, build the fit objects if the fit window is also set
+    m_workspace.reset();
+    if (CanBuildWorkspace())
+    {
+        BuildWorkspace();
     }
 
     return TRUE;
@@ -390,6 +494,9 @@ void CEvaluation::SetParameters(int fitLow, int fitHigh, int polynomOrder, int l
     m_window.fitHigh = fitHigh;
     m_window.polyOrder = polynomOrder;
     this->m_lowPassFiltering = lowPassFilter;
+
+    // the fit objects are built again when they are needed
+    m_workspace.reset();
 }
 
 void CEvaluation::SetShiftAndSqueeze(int refNum, novac::SHIFT_TYPE shiftType, double shift, novac::SHIFT_TYPE squeezeType, double squeeze)
@@ -403,6 +510,20 @@ void CEvaluation::SetShiftAndSqueeze(int refNum, novac::SHIFT_TYPE shiftType, do
     m_window.ref[refNum].m_squeezeOption = squeezeType;
     m_window.ref[refNum].m_squeezeValue = squeeze;
 
+    // the fit objects are built again when they are needed
+    m_workspace.reset();
+}
+
+void CEvaluation::UseReferences(const CEvaluation& other)
+{
+    m_window.nRef = other.m_window.nRef;
+    for (int i = 0; i < other.m_window.nRef; ++i)
+    {
+        m_reference[i] = other.m_reference[i];
+    }
+
+    // the fit objects are built again when they are needed
+    m_workspace.reset();
 }
 
 /** Sets the fit window to use */
@@ -423,6 +544,13 @@ void CEvaluation::SetFitWindow(const CFitWindow& window)
     {
         m_window.ref[i] = window.ref[i];
     }
+
+    // build the fit objects if the references have already been read
+    m_workspace.reset();
+    if (CanBuildWorkspace())
+    {
+        BuildWorkspace();
+    }
 }
 
 void CEvaluation::RemoveOffset(double* spectrum, int specLen, int offsetFrom, int offsetTo)
@@ -442,91 +570,120 @@ void CEvaluation::RemoveOffset(double* spectrum, int specLen, int offsetFrom, in
     Sub(spectrum, specLen, avg);
 }
 
-void CEvaluation::PrepareSpectra(double* dark, double* sky, double* meas, const CFitWindow& window)
+double CEvaluation::GetOffset(const double* spectrum, const double* dark, int offsetFrom, int offsetTo)
 {
+    if (offsetFrom == offsetTo)
+    {
+        return 0.0;
+    }
+
+    // the same sum as in 'RemoveOffset', after the dark spectrum has been subtracted
+    double avg = 0;
+    for (int i = offsetFrom; i < offsetTo; i++)
+    {
+        avg += (dark != nullptr) ? spectrum[i] - dark[i] : spectrum[i];
+    }
+    return avg / (double)(offsetTo - offsetFrom);
+}
+
+void CEvaluation::GetPreparedRange(const CFitWindow& window, int& from, int& to) const
+{
+    // the filtered values depend on the pixels within the support of the filters,
+    //  the low pass filter is applied after the high pass filter so the supports add up
+    int margin = 0;
+    if (window.fitType == FIT_HP_DIV || window.fitType == FIT_HP_SUB)
+    {
+        margin += CBinomialFilter::GetSupport(highPassIterations);
+    }
+    if (m_lowPassFiltering)
+    {
+        margin += CBinomialFilter::GetSupport(lowPassIterations);
+    }
+
+    from = std::max(0, std::min(window.fitLow, window.specLength) - margin);
+    to = std::max(from, std::min(window.specLength, window.fitHigh + margin));
+}
+
+void CEvaluation::PrepareSpectra(const double* dark, const double* sky, const double* meas, double* result, const CFitWindow& window, int from, int to)
+{
+    // the pixels outside of the prepared range are not used
+    std::fill(result, result + from, 0.0);
+    std::fill(result + to, result + window.specLength, 0.0);
 
     if (window.fitType == FIT_HP_DIV)
     {
-        return PrepareSpectra_HP_Div(dark, sky, meas, window);
+        return PrepareSpectra_HP_Div(dark, sky, meas, result, window, from, to);
     }
     if (window.fitType == FIT_HP_SUB)
     {
-        return PrepareSpectra_HP_Sub(dark, sky, meas, window);
+        return PrepareSpectra_HP_Sub(dark, sky, meas, result, window, from, to);
     }
     if (window.fitType == FIT_POLY)
     {
-        return PrepareSpectra_Poly(dark, sky, meas, window);
+        return PrepareSpectra_Poly(dark, sky, meas, result, window, from, to);
     }
 }
 
-void CEvaluation::PrepareSpectra_HP_Div(double* darkArray, double* skyArray, double* measArray, const CFitWindow& window)
+void CEvaluation::PrepareSpectra_HP_Div(const double* darkArray, const double* skyArray, const double* measArray, double* result, const CFitWindow& window, int from, int to)
 {
-
-    // 1. Subtract the dark spectrum
-    Sub(measArray, darkArray, window.specLength, 0.0);
-    if (m_subtractDarkFromSky)
+    // 1. the offsets remaining after subtracting the dark spectrum
+    // TODO: subtracting the dark from the sky should never be done in re-evaluation mode or in adaptive mode if in real-time
+    // TEST THIS!!!
+    const double measOffset = GetOffset(measArray, darkArray, window.offsetFrom, window.offsetTo);
+    const double skyOffset = GetOffset(skyArray, m_subtractDarkFromSky ? darkArray : nullptr, window.offsetFrom, window.offsetTo);
+
+    // 2. subtract the dark spectrum and the offsets and divide the measured spectrum with the sky spectrum in one pass
+    for (int i = from; i < to; ++i)
     {
-        // TODO:should never be called in re-evaluation mode or in adaptive mode if in real-time
-        // TEST THIS!!!
-        Sub(skyArray, darkArray, window.specLength, 0.0);
+        const double meas = (measArray[i] - darkArray[i]) - measOffset;
+        const double sky = (m_subtractDarkFromSky ? skyArray[i] - darkArray[i] : skyArray[i]) - skyOffset;
+        result[i] = (sky != 0) ? meas / sky : 0.0;
     }
 
-    //  2. Remove any remaining offset
-    RemoveOffset(measArray, window.specLength, window.offsetFrom, window.offsetTo);
-    RemoveOffset(skyArray, window.specLength, window.offsetFrom, window.offsetTo);
-
-    // 3. Divide the measured spectrum with the sky spectrum
-    Div(measArray, skyArray, window.specLength, 0.0);
-
-    // 4. high pass filter
-    HighPassBinomial(measArray, window.specLength, 500);
-
-    // 5. log(spec)
-    Log(measArray, window.specLength);
+    // 3. high pass filter and log(spec)
+    HighPassBinomialLog(result + from, to - from, highPassIterations);
 }
 
-void CEvaluation::PrepareSpectra_HP_Sub(double* darkArray, double* skyArray, double* measArray, const CFitWindow& window)
+void CEvaluation::PrepareSpectra_HP_Sub(const double* darkArray, const double* skyArray, const double* measArray, double* result, const CFitWindow& window, int from, int to)
 {
+    // 1. the offset remaining after subtracting the dark spectrum
+    const double measOffset = GetOffset(measArray, darkArray, window.offsetFrom, window.offsetTo);
 
-    // 1. spec = measured spectrum - dark spectrum
-    Sub(measArray, darkArray, window.specLength, 0.0);
-
-    // 2. remove any remaining offset in the measured spectrum
-    RemoveOffset(measArray, window.specLength, window.offsetFrom, window.offsetTo);
-
-    // 3. high pass filter
-    HighPassBinomial(measArray, window.specLength, 500);
+    // 2. spec = measured spectrum - dark spectrum - offset
+    for (int i = from; i < to; ++i)
+    {
+        result[i] = (measArray[i] - darkArray[i]) - measOffset;
+    }
 
-    // 4. log(spec)
-    Log(measArray, window.specLength);
+    // 3. high pass filter and log(spec)
+    HighPassBinomialLog(result + from, to - from, highPassIterations);
 }
 
-void CEvaluation::PrepareSpectra_Poly(double* darkArray, double* skyArray, double* measArray, const CFitWindow& window)
+void CEvaluation::PrepareSpectra_Poly(const double* darkArray, const double* skyArray, const double* measArray, double* result, const CFitWindow& window, int from, int to)
 {
+    // 1. the offset in the measured spectrum
+    const double measOffset = GetOffset(measArray, nullptr, window.offsetFrom, window.offsetTo);
 
-    // 1. remove any remaining offset in the measured spectrum
-    RemoveOffset(measArray, window.specLength, window.offsetFrom, window.offsetTo);
-
-    // 2. log(spec)
-    Log(measArray, window.specLength);
-
-    // 3. Multiply the spectrum with -1 to get the correct sign for everything
-    for (int i = 0; i < window.specLength; ++i)
+    // 2. remove the offset, take the log and multiply the spectrum with -1 to get the correct sign for everything
+    for (int i = from; i < to; ++i)
     {
-        measArray[i] *= -1.0;
+        const double meas = measArray[i] - measOffset;
+        result[i] = -((meas <= 0) ? 0.0 : log(meas));
     }
 }
 
 BOOL CEvaluation::IncludeAsReference(double* array, int sumChn, int refNum)
 {
 
+    std::shared_ptr<const CPreparedReference> reference = CPreparedReference::Create(array, sumChn);
+    if (reference == nullptr)
+    {
+        return FALSE;
+    }
+
     if (refNum == -1)
     {
-        vnYData[m_window.nRef].SetSize(sumChn);
-        for (int index = 0; index < sumChn; ++index)
-        {
-            vnYData[index].SetAt(index, (TFitData)array[index]);
-        }
+        m_reference[m_window.nRef] = reference;
 
         ++m_window.nRef;
     }
@@ -537,11 +694,11 @@ BOOL CEvaluation::IncludeAsReference(double* array, int sumChn, int refNum)
             ++m_window.nRef;
         }
 
-        vnYData[refNum].SetSize(sumChn);
-        for (int index = 0; index < sumChn; ++index)
-        {
-            vnYData[refNum].SetAt(index, (TFitData)array[index]);
-        }
+        m_reference[refNum] = reference;
     }
+
+    // the fit objects are built again when they are needed
+    m_workspace.reset();
+
     return TRUE;
 }
@@ -11,14 +11,23 @@
 
 #include "../BasicMath.h"
 #include "../FIT\Vector.h"	// Added by ClassView
+#include <memory>
 
 #include "FitWindow.h"
 #include "EvaluationResult.h"
+#include "PreparedReference.h"
 #include <MobileDoasLib/Definitions.h>
 
+namespace MathFit
+{
+class CStandardFit;
+}
+
 namespace Evaluation
 {
 
+class CFitWorkspace;
+
 struct EvaluationResult
 {
     double column = 0.0;
@@ -46,6 +55,11 @@ public:
             @param sumChn				- the number of data points that we want to have in each file. */
     BOOL ReadRefList(CString* refFileList, int iNumFile, int sumChn);
 
+    /** Uses the same references as the given evaluator, without reading the reference files again.
+        The prepared references are shared between the two evaluators.
+        @param other - the evaluator which has already read the references */
+    void UseReferences(const CEvaluation& other);
+
     // initialize the evaluation. Must be called before 'Evaluate' is called
     void SetParameters(int fitLow, int fitHigh, int polynomOrder, int lowPassFilter = 0);
 
@@ -59,6 +73,17 @@ public:
     /** Evaluate the following spectra, the parameters for the fit are defined in 'm_fitWindow' */
     void Evaluate(const double* darkArray, const double* skyArray, const double* specMem, long numSteps = 400);
 
+    /** Sets whether each fit should start from the shifts and squeezes found in the
+        previous evaluation, instead of from the default values. Consecutive spectra of a traverse
+        have almost the same shift and squeeze, so this reduces the number of iterations of the fit.
+        If the fit then converges to a clearly worse chi square than the previous fit, it is done
+        again from the default values. This is false by default.
+        The previous result is forgotten whenever the fit settings or the references change. */
+    void SetWarmStart(bool warmStart);
+
+    /** Returns true if the fits start from the result of the previous evaluation */
+    bool GetWarmStart() const { return m_warmStart; }
+
     /** Returns the result from the last evaluation.
         If there are more than one referencefile, only the results from evaluating
         referencefile number 'referenceFile' will be returned. */
@@ -73,13 +98,15 @@ public:
     /** Removes the offset from the supplied spectrum */
     void RemoveOffset(double* spectrum, int specLen, int from, int to);
 
+    /** Returns the number of vectors and matrices that were allocated by the
+        fit during the last call to 'Evaluate'. This is zero once the fit workspace
+        has been built and the evaluation is repeated with the same settings. */
+    long GetAllocationCount() const { return m_allocationCount; }
+
     // -------------------------------------------------------------
     // ----------------------- PUBLIC DATA -------------------------
     // -------------------------------------------------------------
 
-    CVector vYData[1];
-    CVector vnYData[100];
-
     /** The fit window object, this defines the parameters for the fit */
     CFitWindow m_window;
 
@@ -90,7 +117,8 @@ public:
     // parameters
     bool m_subtractDarkFromSky; // Whether we should subtract the dark spectrum from the sky or not
 
-    // The high-pass filtered spectrum
+    // The high-pass filtered spectrum. Only the fit window and the pixels
+    //  needed to filter it are prepared, all other pixels are zero
     std::vector<double> m_filteredSpectrum;
 
 private:
@@ -98,17 +126,49 @@ private:
     // -------------------- PRIVATE METHODS ------------------------
     // -------------------------------------------------------------
 
-    // Prepares the spectra for evaluation
-    void PrepareSpectra(double* dark, double* sky, double* meas, const CFitWindow& window);
+    /** Returns the range of pixels which has to be prepared to evaluate the fit window.
+        This is the fit window extended on both sides by the support of the high pass and the
+        low pass filter, such that the prepared spectrum inside the fit window is the same as
+        if the whole spectrum was prepared, up to rounding.
+        @param from - will on return hold the first pixel to prepare
+        @param to - will on return hold the pixel after the last pixel to prepare */
+    void GetPreparedRange(const CFitWindow& window, int& from, int& to) const;
+
+    /** Prepares the spectra for evaluation. The dark, sky and measured spectra are not changed.
+        Each fit type does the dark subtraction, the offset removal and the division
+        in one pass over the spectra, followed by the high pass filter and the log.
+        The offsets are still taken from the offset range of the whole spectra.
+        @param result - will on return hold the prepared measured spectrum, must not be one of the spectra.
+            The pixels outside of [from, to) are set to zero
+        @param from - the first pixel to prepare, see 'GetPreparedRange'
+        @param to - the pixel after the last pixel to prepare */
+    void PrepareSpectra(const double* dark, const double* sky, const double* meas, double* result, const CFitWindow& window, int from, int to);
 
     // Prepares the spectra for evaluation
-    void PrepareSpectra_HP_Div(double* dark, double* sky, double* meas, const CFitWindow& window);
+    void PrepareSpectra_HP_Div(const double* dark, const double* sky, const double* meas, double* result, const CFitWindow& window, int from, int to);
 
     // Prepares the spectra for evaluation
-    void PrepareSpectra_HP_Sub(double* dark, double* sky, double* meas, const CFitWindow& window);
+    void PrepareSpectra_HP_Sub(const double* dark, const double* sky, const double* meas, double* result, const CFitWindow& window, int from, int to);
 
     // Prepares the spectra for evaluation
-    void PrepareSpectra_Poly(double* dark, double* sky, double* meas, const CFitWindow& window);
+    void PrepareSpectra_Poly(const double* dark, const double* sky, const double* meas, double* result, const CFitWindow& window, int from, int to);
+
+    /** Returns the offset which 'RemoveOffset' would remove from the spectrum,
+        after the dark spectrum has been subtracted from it.
+        @param dark - the dark spectrum, or nullptr if no dark spectrum should be subtracted */
+    static double GetOffset(const double* spectrum, const double* dark, int offsetFrom, int offsetTo);
+
+    /** Builds the fit workspace for the current fit window and references.
+        Does nothing if the fit window or the references are not yet complete. */
+    void BuildWorkspace();
+
+    /** Returns true if the fit window and the references are set, such that
+        the fit workspace can be built. */
+    bool CanBuildWorkspace() const;
+
+    /** Runs the given fit from the current parameters of the model.
+        @return true if the fit converged */
+    bool RunFit(MathFit::CStandardFit& fit);
 
     // -------------------------------------------------------------
     // ---------------------- PRIVATE DATA -------------------------
@@ -120,6 +180,10 @@ private:
     /** The fit window object, this holds the parameters for the fitting */
     CFitWindow m_fitWindow;
 
+    /** The references, normalized and prepared for the fit.
+        These are shared with all other evaluators using the same reference files */
+    std::shared_ptr<const CPreparedReference> m_reference[100];
+
     /** resultSet is used as buffer when returning the result of the evaluation */
     double resultSet[6];
 
@@ -127,6 +191,17 @@ private:
             before evaluation. This is by default false. */
     int m_lowPassFiltering;
 
+    /** True if each fit should start from the shifts and squeezes of the previous fit */
+    bool m_warmStart;
+
+    /** The model function, the fit object and the buffers used by 'Evaluate'.
+        This is built when the fit window or the references are set and
+        is released whenever any of the fit settings change. */
+    std::unique_ptr<CFitWorkspace> m_workspace;
+
+    /** The number of vectors and matrices allocated during the last call to 'Evaluate' */
+    long m_allocationCount;
+
 };
 }
 #endif // !defined(AFX_EVALUATION_H__DB88EE51_7ED0_4131_AE07_79F0F0C3106C__INCLUDED_)
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "FitWindow.h"
+
+#include "../Fit/ReferenceSpectrumFunction.h"
+#include "../Fit/SimpleDOASFunction.h"
+#include "../Fit/StandardMetricFunction.h"
+#include "../Fit/DoasModelFunction.h"
+#include "../Fit/StandardFit.h"
+#include "../Fit/PolynomialFunction.h"
+#include "../Fit/DiscreteFunction.h"
+
+namespace Evaluation
+{
+    /** <b>CFitWorkspace</b> holds the model function, the fit object and all the
+        buffers that CEvaluation needs to evaluate one spectrum.
+        The workspace is built once for a given fit window and set of references
+        and is then reused for every spectrum, such that evaluating a spectrum
+        does not need to allocate any memory once the buffers have reached their size. */
+    class CFitWorkspace
+    {
+    public:
+        /** Creates the model function. The fit object is created by CreateFit(),
+            once the references and the polynomial have been added to the model.
+            @param polynomialOrder - the order of the polynomial which is added to the model */
+        CFitWorkspace(int polynomialOrder)
+            : m_polynomial(polynomialOrder)
+        {
+            m_specLength = 0;
+            m_nRef = 0;
+            m_fitLow = 0;
+            m_fitHigh = 0;
+            m_polyOrder = polynomialOrder;
+            m_hasLastResult = false;
+            m_lastChiSquare = 0.0;
+        }
+
+        /** Returns true if this workspace was built for the given fit window */
+        bool Matches(const CFitWindow& window) const
+        {
+            return m_specLength == window.specLength && m_nRef == window.nRef && m_fitLow == window.fitLow &&
+                m_fitHigh == window.fitHigh && m_polyOrder == window.polyOrder;
+        }
+
+        /** Creates the difference between the measured spectrum and the model, and the fit object.
+            The m_nRef references and the polynomial must have been added to the model before.
+            @param useCompiledModel - if true, a CDoasModelFunction is used for the difference when
+                the number of references and the polynomial order are supported by it. This evaluates the
+                whole model in one loop over the channels. It can not be used if parameters of the references are linked. */
+        void CreateFit(bool useCompiledModel)
+        {
+            m_fit.reset();
+            m_difference.reset();
+
+            if (useCompiledModel)
+            {
+                m_difference.reset(CDoasModel::Create(m_target, m_model, m_ref, m_nRef, m_polynomial));
+            }
+            if (m_difference == nullptr)
+            {
+                m_difference.reset(new CStandardMetricFunction(m_target, m_model));
+            }
+
+            m_fit.reset(new CStandardFit(*m_difference));
+        }
+
+        // -------------------------------------------------------------
+        // ------------------- THE FIT WINDOW --------------------------
+        // -------------------------------------------------------------
+
+        /** The fit window parameters that this workspace was built for */
+        int m_specLength;
+        int m_nRef;
+        int m_fitLow;
+        int m_fitHigh;
+        int m_polyOrder;
+
+        // -------------------------------------------------------------
+        // --------------------- THE BUFFERS ---------------------------
+        // -------------------------------------------------------------
+
+        /** The prepared measured spectrum */
+        std::vector<double> m_meas;
+
+        /** The 'wavelength' column, the prepared measured spectrum and its (neutral) error */
+        CVector m_xData;
+        CVector m_yData;
+        CVector m_error;
+
+        /** The 'wavelength' values of the fit range */
+        CVector m_xFitRange;
+
+        // -------------------------------------------------------------
+        // ------------------- THE LAST FIT RESULT ---------------------
+        // -------------------------------------------------------------
+
+        /** True if the last fit converged, such that its nonlinear parameters
+            can be used as the starting point of the next fit */
+        bool m_hasLastResult;
+
+        /** The free nonlinear parameters (shifts and squeezes) of the last converged fit */
+        CVector m_lastNonlinearParameter;
+
+        /** The chi square of the last converged fit */
+        double m_lastChiSquare;
+
+        // -------------------------------------------------------------
+        // ------------------- THE FIT OBJECTS -------------------------
+        // -------------------------------------------------------------
+
+        /** The measured spectrum */
+        CDiscreteFunction m_target;
+
+        /** The DOAS model function, this is the sum of the references and the polynomial */
+        CSimpleDOASFunction m_model;
+
+        /** The reference spectra, the splines of these are calculated when the workspace is built */
+        CReferenceSpectrumFunction m_ref[20];
+
+        /** The polynomial of the model */
+        CPolynomialFunction m_polynomial;
+
+        /** The difference between the measured spectrum and the model */
+        std::unique_ptr<CStandardMetricFunction> m_difference;
+
+        /** The fit object */
+        std::unique_ptr<CStandardFit> m_fit;
+    };
+}
@@ -0,0 +1,48 @@
+#include "StdAfx.h"
+#include "PreparedReference.h"
+
+using namespace Evaluation;
+using namespace MathFit;
+
+CPreparedReference::CPreparedReference()
+{
+    m_length = 0;
+    m_amplitudeScale = 1.0;
+}
+
+std::shared_ptr<const CPreparedReference> CPreparedReference::Create(const double* spectrum, int length)
+{
+    if (spectrum == nullptr || length < 3)
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<CPreparedReference> reference(new CPreparedReference());
+    reference->m_length = length;
+
+    // the 'wavelength' column, this is the same as used for the measured spectra in CEvaluation
+    CVector xData(length);
+    for (int i = 0; i < length; ++i)
+    {
+        xData.SetAt(i, (TFitData)(1.0f + (double)i));
+    }
+
+    // normalize the amplitude of the reference. This should normally be done in order to avoid numerical
+    // problems during fitting.
+    CVector yData(length);
+    for (int i = 0; i < length; ++i)
+    {
+        yData.SetAt(i, (TFitData)spectrum[i]);
+    }
+    reference->m_amplitudeScale = (double)yData.Normalize();
+
+    // transform the spectral data into the spline which is used to interpolate the
+    // reference spectrum during shift and squeeze operations
+    reference->m_spline.reset(new CCubicSplineFunction());
+    if (!reference->m_spline->SetData(xData, yData))
+    {
+        return nullptr;
+    }
+
+    return reference;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <memory>
+
+#include "../Fit/CubicSplineFunction.h"
+
+namespace Evaluation
+{
+    /** <b>CPreparedReference</b> is a reference spectrum which is prepared for fitting.
+        The amplitude of the spectrum is normalized and the coefficients of the cubic spline,
+        used to shift and squeeze the reference during the fit, are calculated.
+        This is done once for every reference file. The object can not be changed afterwards,
+        such that it can be shared by all evaluators (also in different threads) which use the same reference. */
+    class CPreparedReference
+    {
+    public:
+        /** Prepares the given reference spectrum.
+            @param spectrum - the reference spectrum
+            @param length - the number of data points in the spectrum, at least three are needed
+            @return the prepared reference, or nullptr if the spline could not be created */
+        static std::shared_ptr<const CPreparedReference> Create(const double* spectrum, int length);
+
+        /** Returns the number of data points in the reference spectrum */
+        int GetLength() const { return m_length; }
+
+        /** Returns the amplitude of the reference spectrum before the normalization */
+        double GetAmplitudeScale() const { return m_amplitudeScale; }
+
+        /** Returns the cubic spline of the normalized reference spectrum.
+            Evaluating the spline does not change it, so it may be used by several threads at the same time. */
+        MathFit::IFunction& GetSpline() const { return *m_spline; }
+
+    private:
+        CPreparedReference();
+
+        /** The number of data points in the reference spectrum */
+        int m_length;
+
+        /** The amplitude of the reference spectrum before the normalization */
+        double m_amplitudeScale;
+
+        /** The cubic spline of the normalized reference spectrum */
+        std::unique_ptr<MathFit::CCubicSplineFunction> m_spline;
+    };
+}
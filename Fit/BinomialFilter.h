@@ -0,0 +1,216 @@
+/**
+* Contains the binomial low pass filter of spectra.
+*/
+#if !defined(BINOMIALFILTER_H_020523)
+#define BINOMIALFILTER_H_020523
+
+#include <string.h>
+#include <float.h>
+#include <vector>
+#include <math.h>
+#include "FitBasic.h"
+#include "FourierTransform.h"
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+namespace MathFit
+{
+	/**
+	* Smoothes data by repeatedly applying the binomial filter (1/4, 1/2, 1/4).
+	* For every iteration the first and the last value are replicated beyond the data.
+	*
+	* The iterations are either applied one after the other, or all at once in the frequency domain:
+	* Replicating the first and the last value is the same as mirroring the data at its ends,
+	* which gives periodic data with twice the length. One iteration multiplies the spectrum of
+	* the periodic data with cos^2(pi k / (2 n)), so all iterations multiply it with the power
+	* 2 * iterations of the cosine. Both give the same result up to rounding, the relative difference
+	* is about the number of iterations times the machine precision.
+	*
+	* The filtered value depends on the values at most the number of iterations away, but the weights
+	* of the far values are the tail of a binomial distribution and are far below the machine precision.
+	* \Ref{GetSupport} gives the distance beyond which the values do not change the result,
+	* such that a part of the data can be filtered alone if it is extended by that distance on both sides.
+	*
+	* The object keeps its buffers and the last frequency response, so it should be reused for
+	* the spectra of one evaluation. It must not be used by several threads at once.
+	*/
+	class CBinomialFilter
+	{
+	public:
+		/**
+		* The implementation of the filter.
+		*/
+		enum EMethod
+		{
+			/** Selects the faster one of the other methods by the number of iterations. */
+			AUTOMATIC,
+			/** Applies one iteration after the other. */
+			ITERATED,
+			/** Applies all iterations at once in the frequency domain. */
+			FOURIER
+		};
+
+		CBinomialFilter() : mResponseSize(0), mResponseIterations(0)
+		{
+		}
+
+		/**
+		* Smoothes the data in place.
+		*
+		* @param fData			The data.
+		* @param iSize			The number of values.
+		* @param iNIterations	The number of iterations of the binomial filter.
+		* @param eMethod		The implementation of the filter.
+		*/
+		void LowPass(double* fData, int iSize, int iNIterations, EMethod eMethod = AUTOMATIC)
+		{
+			if(eMethod == AUTOMATIC)
+				eMethod = iNIterations > FOURIERLIMIT ? FOURIER : ITERATED;
+
+			if(eMethod == FOURIER && iSize > 1 && iNIterations > 0)
+				LowPassFourier(fData, iSize, iNIterations);
+			else
+				LowPassIterated(fData, iSize, iNIterations);
+		}
+
+		/**
+		* Returns the number of values on each side of a value which influence its filtered value.
+		* The weights of all values further away sum up to less than the machine precision, so
+		* filtering the data extended by this number of values on both sides gives the same result
+		* as filtering all of the data, up to rounding. This is never more than the number of iterations,
+		* for which the iterated filter gives exactly the same result.
+		*
+		* @param iNIterations	The number of iterations of the binomial filter.
+		*
+		* @return	The number of values on each side.
+		*/
+		static int GetSupport(int iNIterations)
+		{
+			if(iNIterations <= 0)
+				return 0;
+
+			// the weight of the value at the distance k is binomial(2n, n + k) / 4^n, relative to the center
+			// weight these are found by the ratio of neighbouring binomial coefficients
+			std::vector<double> vWeight(iNIterations + 1);
+			double fSum = vWeight[0] = 1.0;
+			int k;
+			for(k = 0; k < iNIterations; k++)
+			{
+				vWeight[k + 1] = vWeight[k] * (double)(iNIterations - k) / (double)(iNIterations + k + 1);
+				fSum += 2.0 * vWeight[k + 1];
+			}
+
+			// add up the weights of both tails from the outside until they exceed the precision
+			double fTail = 0;
+			for(k = iNIterations; k > 0; k--)
+			{
+				fTail += 2.0 * vWeight[k];
+				if(fTail > DBL_EPSILON * fSum)
+					return k;
+			}
+			return 0;
+		}
+
+	private:
+		enum
+		{
+			// the number of iterations above which the frequency domain is faster
+			FOURIERLIMIT = 40
+		};
+
+		void LowPassIterated(double* fData, int iSize, int iNIterations)
+		{
+			if(mBuffer.size() < (size_t)iSize)
+				mBuffer.resize(iSize);
+			double *fOut = fData;
+			double *fIn = mBuffer.data();
+			const int iLast = iSize - 1;
+			const int iFirst = 0;
+
+			int j, i;
+			for(j = 0; j < iNIterations; j++)
+			{
+				// now swap buffers
+				double *fTemp = fIn;
+				fIn = fOut;
+				fOut = fTemp;
+
+				for(i = iFirst; i < iSize; i++)
+				{
+					double lMid, lLeft, lRight;
+
+					lMid = fIn[i];
+					if(i == iFirst)
+						lLeft = fIn[i];
+					else
+						lLeft = fIn[i - 1];
+
+					if(i == iLast)
+						lRight = fIn[i];
+					else
+						lRight = fIn[i + 1];
+					fOut[i] = 0.5 * lMid + 0.25 * lLeft + 0.25 * lRight;
+				}
+			}
+			if(fOut != fData)
+				memcpy(fData, fOut, sizeof(double) * iSize);
+		}
+
+		void LowPassFourier(double* fData, int iSize, int iNIterations)
+		{
+			const int iPeriod = 2 * iSize;
+			std::shared_ptr<const CRealFourierTransform> plan = CRealFourierTransform::GetPlan(iPeriod);
+			const int iSpectrumSize = plan->GetSpectrumSize();
+
+			if(mBuffer.size() < (size_t)iPeriod)
+				mBuffer.resize(iPeriod);
+			if(mSpectrum.size() < 2 * (size_t)iSpectrumSize)
+				mSpectrum.resize(2 * iSpectrumSize);
+			double* fPeriodic = mBuffer.data();
+			double* fSpectrum = mSpectrum.data();
+
+			int i;
+			for(i = 0; i < iSize; i++)
+			{
+				fPeriodic[i] = fData[i];
+				fPeriodic[iPeriod - 1 - i] = fData[i];
+			}
+
+			plan->Forward(fPeriodic, fSpectrum);
+
+			// the response including the normalization of the inverse transform, kept for the next call with the same filter
+			if(mResponseSize != iSize || mResponseIterations != iNIterations)
+			{
+				const double fPi = 3.14159265358979323846;
+				mResponse.resize(iSpectrumSize);
+				for(i = 0; i < iSpectrumSize; i++)
+				{
+					const double fCos = cos(fPi * i / iPeriod);
+					mResponse[i] = pow(fCos * fCos, iNIterations) / iPeriod;
+				}
+				mResponseSize = iSize;
+				mResponseIterations = iNIterations;
+			}
+
+			for(i = 0; i < iSpectrumSize; i++)
+			{
+				fSpectrum[2 * i] *= mResponse[i];
+				fSpectrum[2 * i + 1] *= mResponse[i];
+			}
+
+			plan->Inverse(fSpectrum, fPeriodic);
+
+			memcpy(fData, fPeriodic, sizeof(double) * iSize);
+		}
+
+		std::vector<double> mBuffer;
+		std::vector<double> mSpectrum;
+		std::vector<double> mResponse;
+		int mResponseSize;
+		int mResponseIterations;
+	};
+}
+
+#endif
@@ -8,6 +8,9 @@
 #define CONVOLUTEFUNCTION_H_020523
 
 #include "StatisticVector.h"
+#include "VectorView.h"
+#include "Convolution.h"
+#include <limits>
 #include "ParamFunction.h"
 #include "ConvolutionCoreFunction.h"
 
@@ -67,15 +70,16 @@ namespace MathFit
 				fCoreHighBound += fXValue;
 			}
 
-			CVector vXData;
+			CVectorView vXData;
+			CScratchVector vDefaultXData(100);
 			if(mBase.GetXData().GetSize() <= 0)
 			{
 				// if no base data is sampled, assume that 100 samples will do the trick
-				vXData.SetSize(100);
-				vXData.Wedge(fCoreLowBound, (fCoreHighBound - fCoreLowBound) / vXData.GetSize());
+				vDefaultXData.Wedge(fCoreLowBound, (fCoreHighBound - fCoreLowBound) / vDefaultXData.GetSize());
+				vXData.View(vDefaultXData);
 			}
 			else
-				vXData.Attach(mBase.GetXData(), false);
+				vXData.View(mBase.GetXData());
 
 			// get the core windows indicies of the base function
 			int iBaseLowIndex = vXData.FindIndex(fCoreLowBound, CVector::LESS);
@@ -88,10 +92,11 @@ namespace MathFit
 			const int iRangeSize = iBaseHighIndex - iBaseLowIndex + 1;
 
 			// get X range
-			CVector& vRange = vXData.SubVector(iBaseLowIndex, iRangeSize);
+			CVectorView vRange(vXData, iBaseLowIndex, iRangeSize);
 
-			CStatisticVector vBase(iRangeSize);
-			CVector vCore(iRangeSize);
+			// the temporary vectors are taken from the scratch arena of the thread
+			CScratchVector vBase(iRangeSize);
+			CScratchVector vCore(iRangeSize);
 
 			// get values of the base- and the core-function 
 			mBase.GetValues(vRange, vBase);
@@ -103,7 +108,7 @@ namespace MathFit
 
 			// do the convolution in the slow, but simple way
 			vBase.MulSimple(vCore);
-			return vBase.Sum();
+			return CVectorKernels::Sum(vBase.GetSafePtr(), iRangeSize);
 		}
 
 		/**
@@ -122,65 +127,36 @@ namespace MathFit
 
 			// check wheter we should use the base's samples data or the currently given sample vector.
 			// in case we have a higher resolution base, its better to use the base's resolution for convolution.
-			CVector vXData;
-			if(mBase.GetXData().GetSize() <= 0)
-				vXData.Attach(vXValues, false);
-			else
-				vXData.Attach(mBase.GetXData(), false);
+			CVectorView vXData(mBase.GetXData().GetSize() <= 0 ? vXValues : mBase.GetXData());
 
-			CVector vCore;
-			CStatisticVector vBase;
+			// a large core is convoluted with the whole base at once, the result at every X value is then taken from it
+			const int iBaseSize = vXData.GetSize();
+			int iFourierLow, iFourierHigh;
+			CScratchVector vConvoluted(std::max(iBaseSize, 1));
+			const bool bFourier = ConvoluteFourier(vXData, iXSize, vConvoluted, iFourierLow, iFourierHigh);
 
 			int i;
 			for(i = 0; i < iXSize; i++)
 			{
 				// set current center coordinate
 				TFitData fXCenter = vXValues.GetAt(i);
-				mCore.SetCoreCenter(fXCenter);
 
-				// get the data from the convolution core
-				TFitData fCoreLowBound = mCore.GetCoreLowBound();
-				TFitData fCoreHighBound = mCore.GetCoreHighBound();
-				if(fCoreLowBound == fCoreHighBound)
-				{
-					// if the core size is not given, use the maximum and minimum values possible:
-					fCoreLowBound = vXData.GetAt(0);
-					fCoreHighBound = vXData.GetAt(vXData.GetSize() - 1);
-				}
-				else
+				int iBaseLowIndex, iBaseHighIndex;
+				GetCoreWindow(vXData, fXCenter, iBaseLowIndex, iBaseHighIndex);
+
+				if(bFourier)
 				{
-					fCoreLowBound += fXCenter;
-					fCoreHighBound += fXCenter;
+					// the result of the fast convolution can be used if the X value is a sample of the base
+					// and the window of the core is the one used for the fast convolution
+					const int iIndex = std::min(std::max(vXData.FindIndex(fXCenter, CVector::LESSEQUAL), 0), iBaseSize - 1);
+					if(vXData.GetAt(iIndex) == fXCenter && iBaseLowIndex == std::max(iIndex + iFourierLow, 0) && iBaseHighIndex == std::min(iIndex + iFourierHigh, iBaseSize - 1))
+					{
+						vYTargetVector.SetAt(i, vConvoluted.GetAt(iIndex));
+						continue;
+					}
 				}
 
-				// get the core windows indicies of the base function
-				int iBaseLowIndex = vXData.FindIndex(fCoreLowBound, CVector::LESS);
-				if(iBaseLowIndex < 0)
-					iBaseLowIndex = 0;
-				int iBaseHighIndex = vXData.FindIndex(fCoreHighBound, CVector::GREATER);
-				if(iBaseHighIndex < 0)
-					iBaseHighIndex = vXData.GetSize() - 1;
-
-				const int iRangeSize = iBaseHighIndex - iBaseLowIndex + 1;
-				
-				// get X range
-				CVector& vRange = vXData.SubVector(iBaseLowIndex, iRangeSize);
-
-				vBase.SetSize(iRangeSize);
-				vCore.SetSize(iRangeSize);
-
-				// get values of the base function at the given range
-				mBase.GetValues(vRange, vBase);
-
-				// adapt the range of the core extend and get the core values
-				vRange.Sub(fXCenter);
-				mCore.GetValues(vRange, vCore);
-				vRange.Add(fXCenter);
-
-				// do the simple convolution algorithm
-				vBase.MulSimple(vCore);
-
-				vYTargetVector.SetAt(i, vBase.Sum());
+				vYTargetVector.SetAt(i, ConvoluteWindow(vXData, fXCenter, iBaseLowIndex, iBaseHighIndex));
 			}
 
 			return vYTargetVector;
@@ -384,6 +360,139 @@ namespace MathFit
 		}
 
 	private:
+		/**
+		* Sets the core center to the given X value and returns the window of the base samples used by the core.
+		*
+		* @param vXData			The X values of the base samples.
+		* @param fXCenter		The X value at which the convolution is evaluated.
+		* @param iBaseLowIndex	Receives the index of the first base sample in the window.
+		* @param iBaseHighIndex	Receives the index of the last base sample in the window.
+		*/
+		void GetCoreWindow(CVector& vXData, TFitData fXCenter, int& iBaseLowIndex, int& iBaseHighIndex)
+		{
+			mCore.SetCoreCenter(fXCenter);
+
+			// get the data from the convolution core
+			TFitData fCoreLowBound = mCore.GetCoreLowBound();
+			TFitData fCoreHighBound = mCore.GetCoreHighBound();
+			if(fCoreLowBound == fCoreHighBound)
+			{
+				// if the core size is not given, use the maximum and minimum values possible:
+				fCoreLowBound = vXData.GetAt(0);
+				fCoreHighBound = vXData.GetAt(vXData.GetSize() - 1);
+			}
+			else
+			{
+				fCoreLowBound += fXCenter;
+				fCoreHighBound += fXCenter;
+			}
+
+			// get the core windows indicies of the base function
+			iBaseLowIndex = vXData.FindIndex(fCoreLowBound, CVector::LESS);
+			if(iBaseLowIndex < 0)
+				iBaseLowIndex = 0;
+			iBaseHighIndex = vXData.FindIndex(fCoreHighBound, CVector::GREATER);
+			if(iBaseHighIndex < 0)
+				iBaseHighIndex = vXData.GetSize() - 1;
+		}
+
+		/**
+		* Calculates the convolution at the given X value directly from the base samples in the core window.
+		* The core center must have been set by \Ref{GetCoreWindow}.
+		*
+		* @param vXData			The X values of the base samples.
+		* @param fXCenter		The X value at which the convolution is evaluated.
+		* @param iBaseLowIndex	The index of the first base sample in the window.
+		* @param iBaseHighIndex	The index of the last base sample in the window.
+		*
+		* @return	The value of the convolution.
+		*/
+		TFitData ConvoluteWindow(CVector& vXData, TFitData fXCenter, int iBaseLowIndex, int iBaseHighIndex)
+		{
+			const int iRangeSize = iBaseHighIndex - iBaseLowIndex + 1;
+
+			// get X range
+			CVectorView vRange(vXData, iBaseLowIndex, iRangeSize);
+
+			// the temporary vectors are taken from the scratch arena of the thread, which
+			// gets them back at the end of each call
+			CScratchVector vBase(iRangeSize);
+			CScratchVector vCore(iRangeSize);
+
+			// get values of the base function at the given range
+			mBase.GetValues(vRange, vBase);
+
+			// adapt the range of the core extend and get the core values
+			vRange.Sub(fXCenter);
+			mCore.GetValues(vRange, vCore);
+			vRange.Add(fXCenter);
+
+			// do the simple convolution algorithm
+			vBase.MulSimple(vCore);
+
+			return CVectorKernels::Sum(vBase.GetSafePtr(), iRangeSize);
+		}
+
+		/**
+		* Convolutes the whole base with the core using \Ref{CConvolution}, if this is possible and faster than
+		* the direct sums. This needs a core which does not change with its center and equidistant base samples.
+		* The result at a base sample can be used, if the core window of the sample is the window of the
+		* core samples, relative to the base sample and clipped to the base samples.
+		*
+		* @param vXData		The X values of the base samples.
+		* @param iXSize		The number of X values at which the convolution is evaluated.
+		* @param vResult	Receives the convolution at every base sample.
+		* @param iLow		Receives the index of the first core sample relative to the base sample.
+		* @param iHigh		Receives the index of the last core sample relative to the base sample.
+		*
+		* @return	TRUE if the convolution was calculated.
+		*/
+		bool ConvoluteFourier(CVector& vXData, int iXSize, CVector& vResult, int& iLow, int& iHigh)
+		{
+			const int iBaseSize = vXData.GetSize();
+			if(!mCore.IsShiftInvariant() || iBaseSize < 3)
+				return false;
+
+			// check that the base samples are equidistant, up to the rounding of the X values
+			const TFitData fStep = (vXData.GetAt(iBaseSize - 1) - vXData.GetAt(0)) / (iBaseSize - 1);
+			if(!(fStep > 0))
+				return false;
+			const TFitData fTolerance = std::max(fabs(vXData.GetAt(0)), fabs(vXData.GetAt(iBaseSize - 1))) * std::numeric_limits<TFitData>::epsilon() * 8;
+			int i;
+			for(i = 1; i < iBaseSize; i++)
+				if(fabs(vXData.GetAt(i) - vXData.GetAt(i - 1) - fStep) > fTolerance)
+					return false;
+
+			// get the core window at a sample in the middle of the base, where the window is not clipped
+			const int iCenter = iBaseSize / 2;
+			const TFitData fXCenter = vXData.GetAt(iCenter);
+			int iBaseLowIndex, iBaseHighIndex;
+			GetCoreWindow(vXData, fXCenter, iBaseLowIndex, iBaseHighIndex);
+			if(iBaseLowIndex == 0 || iBaseHighIndex == iBaseSize - 1)
+				return false;
+
+			const int iCoreSize = iBaseHighIndex - iBaseLowIndex + 1;
+			if(!CConvolution::IsFourierFaster(iBaseSize, iCoreSize, iXSize))
+				return false;
+			iLow = iBaseLowIndex - iCenter;
+			iHigh = iBaseHighIndex - iCenter;
+
+			// sample the core and the base
+			CScratchVector vCore(iCoreSize);
+			CScratchVector vBase(iBaseSize);
+			{
+				CVectorView vRange(vXData, iBaseLowIndex, iCoreSize);
+				CScratchVector vOffset(iCoreSize);
+				vOffset.Copy(vRange);
+				vOffset.Sub(fXCenter);
+				mCore.GetValues(vOffset, vCore);
+			}
+			mBase.GetValues(vXData, vBase);
+
+			CConvolution::Convolute(vBase.GetSafePtr(), iBaseSize, vCore.GetSafePtr(), iCoreSize, -iLow, vResult.GetSafePtr(), CConvolution::ZEROEXTENSION, CConvolution::FOURIER);
+			return true;
+		}
+
 		/**
 		* Builds the linear parameter vector from the operands parameters.
 		*/
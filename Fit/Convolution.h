@@ -0,0 +1,249 @@
+/**
+* Contains the discrete convolution of sampled data, which is calculated directly or using the fast fourier transform.
+*/
+#if !defined(CONVOLUTION_H_020523)
+#define CONVOLUTION_H_020523
+
+#include <algorithm>
+#include <vector>
+#include <math.h>
+#include "FitBasic.h"
+#include "FourierTransform.h"
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+namespace MathFit
+{
+	/**
+	* Convolutes sampled data with a sampled core.
+	*
+	* \begin{verbatim}result(i) = sum core(j) * data(i + j - center)\end{verbatim}
+	*
+	* The data outside of the given samples is either zero or the first and the last sample, respectively.
+	* Large cores are convoluted by overlap-save using the fast fourier transform, where two blocks of the
+	* data are transformed at once as the real and the imaginary part of one complex transform.
+	* The method is selected automatically by comparing the estimated costs of both methods.
+	* The transforms use the shared plans of \Ref{CFourierTransform}, the buffers are kept per thread.
+	*/
+	class CConvolution
+	{
+	public:
+		/**
+		* The values of the data outside of the samples.
+		*/
+		enum EBoundary
+		{
+			/** The data is zero outside of the samples. */
+			ZEROEXTENSION,
+			/** The first and the last sample are extended constantly. */
+			CONSTANTEXTENSION
+		};
+
+		/**
+		* The method used to calculate the convolution.
+		*/
+		enum EMethod
+		{
+			/** Selects the faster one of the other methods. */
+			AUTOMATIC,
+			/** Calculates every sum directly. */
+			DIRECT,
+			/** Uses the fast fourier transform. */
+			FOURIER
+		};
+
+		/**
+		* Convolutes the data with the given core.
+		*
+		* @param fData			The data samples.
+		* @param iSize			The number of data samples and of results.
+		* @param fCore			The core samples.
+		* @param iCoreSize		The number of core samples.
+		* @param iCoreCenter	The index of the core sample which is multiplied with the data sample at the result's index.
+		* @param fResult		Receives the results. Must not overlap with the data.
+		* @param eBoundary		The values of the data outside of the samples.
+		* @param eMethod		The method used to calculate the convolution.
+		*/
+		template<class TData>
+		static void Convolute(const TData* fData, int iSize, const TData* fCore, int iCoreSize, int iCoreCenter, TData* fResult, EBoundary eBoundary, EMethod eMethod = AUTOMATIC)
+		{
+			if(iSize <= 0)
+				return;
+			if(iCoreSize <= 0)
+			{
+				int i;
+				for(i = 0; i < iSize; i++)
+					fResult[i] = 0;
+				return;
+			}
+
+			if(eMethod == AUTOMATIC)
+				eMethod = IsFourierFaster(iSize, iCoreSize) ? FOURIER : DIRECT;
+
+			if(eMethod == FOURIER)
+				ConvoluteFourier(fData, iSize, fCore, iCoreSize, iCoreCenter, fResult, eBoundary);
+			else
+				ConvoluteDirect(fData, iSize, fCore, iCoreSize, iCoreCenter, fResult, eBoundary);
+		}
+
+		/**
+		* Returns true if the convolution using the fast fourier transform is estimated to be faster than the direct one.
+		*
+		* @param iSize			The number of data samples.
+		* @param iCoreSize		The number of core samples.
+		* @param iResultCount	The number of results which are needed, if the direct sums are calculated only for some of the samples.
+		*						All results are needed if this is negative.
+		*/
+		static bool IsFourierFaster(int iSize, int iCoreSize, int iResultCount = -1)
+		{
+			if(iResultCount < 0 || iResultCount > iSize)
+				iResultCount = iSize;
+
+			// the costs are measured in the number of floating point operations
+			const double fDirectCost = 2.0 * iResultCount * iCoreSize;
+			double fFourierCost;
+			GetBlockSize(iSize, iCoreSize, fFourierCost);
+
+			return fFourierCost < fDirectCost;
+		}
+
+	private:
+		/**
+		* Returns the size of the blocks of the overlap-save convolution with the lowest costs.
+		*
+		* @param iSize			The number of data samples.
+		* @param iCoreSize		The number of core samples.
+		* @param fCost			Receives the estimated costs of the convolution.
+		*
+		* @return	The number of samples of one block.
+		*/
+		static int GetBlockSize(int iSize, int iCoreSize, double& fCost)
+		{
+			int iBest = 0;
+			fCost = 0;
+
+			// blocks larger than the data and the core together do not reduce the number of transforms,
+			// only the lengths with small factors are tried
+			int iBlockSize = CFourierTransform::GetFastSize(2 * iCoreSize);
+			const int iMaxBlockSize = CFourierTransform::GetFastSize(iSize + iCoreSize);
+			for(; iBlockSize <= iMaxBlockSize || iBest == 0; iBlockSize = CFourierTransform::GetFastSize(iBlockSize + 1))
+			{
+				// every transform handles two blocks, each of which gives this number of results
+				const int iStep = iBlockSize - iCoreSize + 1;
+				const int iTransforms = (iSize + 2 * iStep - 1) / (2 * iStep);
+
+				// forward and inverse transform, the product with the core spectrum and the copying
+				const double fLog = log((double)iBlockSize) / log(2.0);
+				const double fBlockCost = iTransforms * (double)iBlockSize * (10.0 * fLog + 16.0);
+				if(iBest == 0 || fBlockCost < fCost)
+				{
+					iBest = iBlockSize;
+					fCost = fBlockCost;
+				}
+			}
+			return iBest;
+		}
+
+		/**
+		* Returns the data sample at the given index, which may be outside of the samples.
+		*/
+		template<class TData>
+		static double GetExtended(const TData* fData, int iSize, int iIndex, EBoundary eBoundary)
+		{
+			if(iIndex < 0)
+				return eBoundary == CONSTANTEXTENSION ? (double)fData[0] : 0.0;
+			if(iIndex >= iSize)
+				return eBoundary == CONSTANTEXTENSION ? (double)fData[iSize - 1] : 0.0;
+			return (double)fData[iIndex];
+		}
+
+		template<class TData>
+		static void ConvoluteDirect(const TData* fData, int iSize, const TData* fCore, int iCoreSize, int iCoreCenter, TData* fResult, EBoundary eBoundary)
+		{
+			int i, j;
+			for(i = 0; i < iSize; i++)
+			{
+				const int iOffset = i - iCoreCenter;
+
+				// the range of the core which is multiplied with the data samples, the sums are done
+				// in the order of the core samples, also outside of that range
+				const int iLow = std::min(std::max(0, -iOffset), iCoreSize);
+				const int iHigh = std::max(std::min(iCoreSize, iSize - iOffset), iLow);
+
+				double fSum = 0;
+				for(j = 0; j < iLow; j++)
+					fSum += (double)fCore[j] * GetExtended(fData, iSize, iOffset + j, eBoundary);
+				for(j = iLow; j < iHigh; j++)
+					fSum += (double)fCore[j] * (double)fData[iOffset + j];
+				for(j = iHigh; j < iCoreSize; j++)
+					fSum += (double)fCore[j] * GetExtended(fData, iSize, iOffset + j, eBoundary);
+				fResult[i] = (TData)fSum;
+			}
+		}
+
+		template<class TData>
+		static void ConvoluteFourier(const TData* fData, int iSize, const TData* fCore, int iCoreSize, int iCoreCenter, TData* fResult, EBoundary eBoundary)
+		{
+			double fCost;
+			const int iBlockSize = GetBlockSize(iSize, iCoreSize, fCost);
+			const int iStep = iBlockSize - iCoreSize + 1;
+			std::shared_ptr<const CFourierTransform> plan = CFourierTransform::GetPlan(iBlockSize);
+
+			static thread_local std::vector<double> vCoreSpectrum;
+			static thread_local std::vector<double> vBlock;
+			if(vCoreSpectrum.size() < 2 * (size_t)iBlockSize)
+			{
+				vCoreSpectrum.resize(2 * iBlockSize);
+				vBlock.resize(2 * iBlockSize);
+			}
+			double* fSpectrum = vCoreSpectrum.data();
+			double* fBlock = vBlock.data();
+
+			// the spectrum of the reversed core, such that the circular convolution gives the sums of the results
+			int i;
+			for(i = 0; i < 2 * iBlockSize; i++)
+				fSpectrum[i] = 0;
+			for(i = 0; i < iCoreSize; i++)
+				fSpectrum[2 * i] = (double)fCore[iCoreSize - 1 - i];
+			plan->Forward(fSpectrum);
+
+			// the inverse transform is not normalized
+			const double fScale = 1.0 / iBlockSize;
+
+			int iFirst;
+			for(iFirst = 0; iFirst < iSize; iFirst += 2 * iStep)
+			{
+				// the real part holds the block of the first results, the imaginary part the following block
+				const int iSecond = iFirst + iStep;
+				for(i = 0; i < iBlockSize; i++)
+				{
+					fBlock[2 * i] = GetExtended(fData, iSize, iFirst + i - iCoreCenter, eBoundary);
+					fBlock[2 * i + 1] = iSecond < iSize ? GetExtended(fData, iSize, iSecond + i - iCoreCenter, eBoundary) : 0.0;
+				}
+
+				plan->Forward(fBlock);
+				for(i = 0; i < iBlockSize; i++)
+				{
+					const double fRe = fBlock[2 * i] * fSpectrum[2 * i] - fBlock[2 * i + 1] * fSpectrum[2 * i + 1];
+					const double fIm = fBlock[2 * i] * fSpectrum[2 * i + 1] + fBlock[2 * i + 1] * fSpectrum[2 * i];
+					fBlock[2 * i] = fRe * fScale;
+					fBlock[2 * i + 1] = fIm * fScale;
+				}
+				plan->Inverse(fBlock);
+
+				// the first iCoreSize - 1 values are wrapped around and are not used
+				const double* fValid = &fBlock[2 * (iCoreSize - 1)];
+				const int iFirstCount = iStep < iSize - iFirst ? iStep : iSize - iFirst;
+				for(i = 0; i < iFirstCount; i++)
+					fResult[iFirst + i] = (TData)fValid[2 * i];
+				const int iSecondCount = iStep < iSize - iSecond ? iStep : iSize - iSecond;
+				for(i = 0; i < iSecondCount; i++)
+					fResult[iSecond + i] = (TData)fValid[2 * i + 1];
+			}
+		}
+	};
+}
+
+#endif
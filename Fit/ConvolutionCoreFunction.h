@@ -9,7 +9,7 @@
 #if !defined(CONVOLUTIONCOREFUNCTION_H_020523)
 #define CONVOLUTIONCOREFUNCTION_H_020523
 
-#include "ParameterVector.h"
+#include "ParamFunction.h"
 
 #if _MSC_VER > 1000
 #pragma once
@@ -83,6 +83,16 @@ namespace MathFit
 			return 0;
 		}
 
+		/**
+		* Returns true if the core values at a given distance from the core center do not depend
+		* on the position of the center. The convolution can then be calculated using the fast
+		* fourier transform. This is false by default.
+		*/
+		virtual bool IsShiftInvariant()
+		{
+			return false;
+		}
+
 	protected:
 		TFitData mXCenter;
 	};
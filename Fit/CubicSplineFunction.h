@@ -11,7 +11,7 @@ namespace MathFit
 		/**
 		* Create an empty object.
 		*/
-		CCubicSplineFunction()
+		CCubicSplineFunction() : mUniform(false), mXFirst(0), mInverseStep(0)
 		{
 		}
 
@@ -21,7 +21,7 @@ namespace MathFit
 		* @param vXValues			The vector containing the X values.
 		* @param vYValues			The vector containing the Y values in regard to the X values.
 		*/
-		CCubicSplineFunction(CVector& vXValues, CVector& vYValues)
+		CCubicSplineFunction(CVector& vXValues, CVector& vYValues) : mUniform(false), mXFirst(0), mInverseStep(0)
 		{
 			CCubicSplineFunction::SetData(vXValues, vYValues);
 		}
@@ -33,7 +33,7 @@ namespace MathFit
 		* @param vYValues			The vector containing the Y values in regard to the X values.
 		* @param vError				The vector containing the errors of the Y values. This vector will not be interpolated!
 		*/
-		CCubicSplineFunction(CVector& vXValues, CVector& vYValues, CVector& vError)
+		CCubicSplineFunction(CVector& vXValues, CVector& vYValues, CVector& vError) : mUniform(false), mXFirst(0), mInverseStep(0)
 		{
 			CCubicSplineFunction::SetData(vXValues, vYValues, vError);
 		}
@@ -117,7 +117,136 @@ namespace MathFit
 			return SlopeSplineVector(vXValues, vSlopeVector);
 		}
 
+		/**
+		* Calculates the values and the first derivatives of the spline at a set of given data points.
+		* The spline polynomials are searched only once for both.
+		*
+		* @param vXValues		A vector object containing the X values at which the function has to be evaluated.
+		* @param vYTargetVector	A vector object which receives the resulting function values.
+		* @param vSlopeVector	A vector object which receives the resulting slopes.
+		*/
+		virtual void GetValuesAndSlopes(CVector& vXValues, CVector& vYTargetVector, CVector& vSlopeVector)
+		{
+			EvaluateSplineAndSlopeVector(vXValues, vYTargetVector, vSlopeVector);
+		}
+
+		/**
+		* Returns the value of the cubic spline at the given X value.
+		* Unlike \Ref{GetValue} the interval of the spline polynomial is not searched from scratch.
+		* The search starts at the interval given, so evaluating the spline at ascending X values
+		* only needs a step or two per value. This is used by models that evaluate several splines
+		* in one loop over the data points.
+		*
+		* @param fXValue	The X value at which to evaluate the spline.
+		* @param iInterval	The index of the upper node of the interval used for the last X value. Receives the index of the interval used for this X value.
+		*
+		* @return	The evaluated spline value.
+		*/
+		TFitData GetValue(TFitData fXValue, int& iInterval)
+		{
+			FindInterval(fXValue, iInterval);
+
+			// linear interpolation coefficient
+			const TFitData fA = (mXData.GetAt(iInterval) - fXValue) / mH.GetAt(iInterval);
+			const TFitData fB = (1 - fA);
+
+			// first interpolate linearily and add the polynomial's coefficients to fulfill the second derivative constrain
+			TFitData fResult = fA * mYData.GetAt(iInterval - 1) + fB * mYData.GetAt(iInterval);
+			fResult += ((fA * fA * fA - fA) * mDeltaHSquareLow.GetAt(iInterval) + (fB * fB * fB - fB) * mDeltaHSquareHigh.GetAt(iInterval));
+
+			return fResult;
+		}
+
+		/**
+		* Returns the value and the first derivative of the cubic spline at the given X value.
+		* The interval of the spline polynomial is searched like in \Ref{GetValue}.
+		*
+		* @param fXValue	The X value at which to evaluate the spline.
+		* @param iInterval	The index of the upper node of the interval used for the last X value. Receives the index of the interval used for this X value.
+		* @param fSlope		Receives the first derivative of the spline.
+		*
+		* @return	The evaluated spline value.
+		*/
+		TFitData GetValueAndSlope(TFitData fXValue, int& iInterval, TFitData& fSlope)
+		{
+			FindInterval(fXValue, iInterval);
+
+			// linear interpolation coefficient
+			const TFitData fA = (mXData.GetAt(iInterval) - fXValue) / mH.GetAt(iInterval);
+			const TFitData fB = (1 - fA);
+
+			// calculate the first derivative
+			fSlope = mSlopeInvariant.GetAt(iInterval) + (((3 * fB * fB - 1) * mSlopeDeltaHSquareHigh.GetAt(iInterval)) - ((3 * fA * fA - 1) * mSlopeDeltaHSquareLow.GetAt(iInterval)));
+
+			TFitData fResult = fA * mYData.GetAt(iInterval - 1) + fB * mYData.GetAt(iInterval);
+			fResult += ((fA * fA * fA - fA) * mDeltaHSquareLow.GetAt(iInterval) + (fB * fB * fB - fB) * mDeltaHSquareHigh.GetAt(iInterval));
+
+			return fResult;
+		}
+
+		/**
+		* Returns true if the spline nodes are equidistant. The interval of an X value is then
+		* calculated directly instead of being searched.
+		*/
+		bool IsUniform() const
+		{
+			return mUniform;
+		}
+
 	private:
+		/**
+		* Moves the given interval to the one that contains the X value.
+		* The interval is given by the index of its upper node. The first and the last interval
+		* are used for X values outside of the spline nodes.
+		* If the nodes are equidistant the given interval is ignored and the interval is calculated
+		* from the X value, the search then only corrects rounding errors.
+		*
+		* @param fXValue	The X value.
+		* @param iInterval	The index of the upper node of the interval to start the search at. Receives the index of the interval found.
+		*/
+		void FindInterval(TFitData fXValue, int& iInterval)
+		{
+			// check wheter we have a valid spline
+			MATHFIT_ASSERT(mY2ndDerivates.GetSize() >= 3);
+
+			const int iMaxIndex = mXData.GetSize() - 1;
+
+			if(mUniform)
+				iInterval = GetUniformInterval(fXValue);
+
+			if(iInterval < 1)
+				iInterval = 1;
+			else if(iInterval > iMaxIndex)
+				iInterval = iMaxIndex;
+
+			while(iInterval < iMaxIndex && mXData.GetAt(iInterval) <= fXValue)
+				iInterval++;
+			while(iInterval > 1 && mXData.GetAt(iInterval - 1) > fXValue)
+				iInterval--;
+		}
+
+		/**
+		* Calculates the interval of the given X value for equidistant nodes.
+		* The interval may be off by one due to rounding.
+		*
+		* @param fXValue	The X value.
+		*
+		* @return	The index of the upper node of the interval, between 1 and the index of the last node.
+		*/
+		int GetUniformInterval(TFitData fXValue) const
+		{
+			const int iMaxIndex = mXData.GetSize() - 1;
+
+			// clamp in floating point, such that the conversion can not overflow
+			TFitData fIndex = (fXValue - mXFirst) * mInverseStep;
+			if(!(fIndex > 0))
+				fIndex = 0;
+			else if(fIndex > (TFitData)(iMaxIndex - 1))
+				fIndex = (TFitData)(iMaxIndex - 1);
+
+			return (int)fIndex + 1;
+		}
+
 		bool InitializeSpline()
 		{
 			// we need at least 3 nodes
@@ -127,6 +256,8 @@ namespace MathFit
 			TFitData fSig;
 			TFitData fP;
 
+			mUniform = false;
+
 			const int iSize = mXData.GetSize();
 			if(iSize <= 3)
 				return false;
@@ -220,9 +351,73 @@ namespace MathFit
 				mSlopeDeltaHSquareHigh.SetAt(i, mY2ndDerivates.GetAt(i) * fTempSlope);
 			}
 
+			// check whether the nodes are equidistant, like the pixels of a spectrum.
+			// The tolerance only decides whether the interval is calculated, \Ref{FindInterval}
+			// corrects a calculated interval which is off by rounding.
+			const TFitData fStep = (mXData.GetAt(iSize - 1) - mXData.GetAt(0)) / (TFitData)(iSize - 1);
+			mUniform = fStep > 0;
+			for(i = 1; i < iSize && mUniform; i++)
+				mUniform = fabs(mH.GetAt(i) - fStep) <= fStep * (TFitData)1e-4;
+			mXFirst = mXData.GetAt(0);
+			mInverseStep = mUniform ? 1 / fStep : 0;
+
 			return true;
 		}
 
+		/**
+		* Calculates the values and/or the first derivatives of the spline with equidistant nodes.
+		* The interval of every X value is calculated directly, so the X values do not need to be sorted.
+		* The results are the same as those of the search in \Ref{EvaluateSplineVector} and \Ref{SlopeSplineVector}.
+		*
+		* @param vXData		The X values at which the spline has to be evaluated.
+		* @param vYData		Receives the values of the spline, if bValues is TRUE.
+		* @param vSlopeData	Receives the first derivatives of the spline, if bSlopes is TRUE.
+		*/
+		template<bool bValues, bool bSlopes>
+		void EvaluateUniformSplineVector(CVector& vXData, CVector& vYData, CVector& vSlopeData)
+		{
+			MATHFIT_ASSERT(mUniform);
+
+			// the tables are accessed directly, they are owned by the spline and have no step size
+			const TFitData* fXNodes = mXData.GetSafePtr();
+			const TFitData* fYNodes = mYData.GetSafePtr();
+			const TFitData* fH = mH.GetSafePtr();
+			const TFitData* fDeltaLow = mDeltaHSquareLow.GetSafePtr();
+			const TFitData* fDeltaHigh = mDeltaHSquareHigh.GetSafePtr();
+			const TFitData* fSlopeInvariant = mSlopeInvariant.GetSafePtr();
+			const TFitData* fSlopeDeltaLow = mSlopeDeltaHSquareLow.GetSafePtr();
+			const TFitData* fSlopeDeltaHigh = mSlopeDeltaHSquareHigh.GetSafePtr();
+			const int iMaxIndex = mXData.GetSize() - 1;
+
+			const int iXEvalSize = vXData.GetSize();
+			int i;
+			for(i = 0; i < iXEvalSize; i++)
+			{
+				const TFitData fXData = vXData.GetAt(i);
+
+				// calculate the interval and correct it, if it is off by rounding
+				int iIndexHigh = GetUniformInterval(fXData);
+				while(iIndexHigh < iMaxIndex && fXNodes[iIndexHigh] <= fXData)
+					iIndexHigh++;
+				while(iIndexHigh > 1 && fXNodes[iIndexHigh - 1] > fXData)
+					iIndexHigh--;
+
+				// linear interpolation coefficient
+				const TFitData fA = (fXNodes[iIndexHigh] - fXData) / fH[iIndexHigh];
+				const TFitData fB = (1 - fA);
+
+				if(bValues)
+				{
+					// first interpolate linearily and add the polynomial's coefficients to fulfill the second derivative constrain
+					TFitData fResult = fA * fYNodes[iIndexHigh - 1] + fB * fYNodes[iIndexHigh];
+					fResult += ((fA * fA * fA - fA) * fDeltaLow[iIndexHigh] + (fB * fB * fB - fB) * fDeltaHigh[iIndexHigh]);
+					vYData.SetAt(i, fResult);
+				}
+				if(bSlopes)
+					vSlopeData.SetAt(i, fSlopeInvariant[iIndexHigh] + (((3 * fB * fB - 1) * fSlopeDeltaHigh[iIndexHigh]) - ((3 * fA * fA - 1) * fSlopeDeltaLow[iIndexHigh])));
+			}
+		}
+
 		TFitData EvaluateSpline(TFitData fXValue)
 		{
 			// check wheter we have a valid spline
@@ -262,6 +457,12 @@ namespace MathFit
 			// check wheter we have a valid spline
 			MATHFIT_ASSERT(mY2ndDerivates.GetSize() >= 3);
 
+			if(mUniform)
+			{
+				EvaluateUniformSplineVector<true, false>(vXData, vYData, vYData);
+				return vYData;
+			}
+
 			// get indicies of the tabulated function coefficients that contain the correct interpolation polynomial
 			int iIndexLow = mXData.FindIndex(vXData.GetAt(0), CVector::LESSEQUAL);
 
@@ -330,6 +531,87 @@ namespace MathFit
 			return vYData;
 		}
 
+		void EvaluateSplineAndSlopeVector(CVector& vXData, CVector& vYData, CVector& vSlopeData)
+		{
+			// check wheter we have a valid spline
+			MATHFIT_ASSERT(mY2ndDerivates.GetSize() >= 3);
+
+			if(mUniform)
+			{
+				EvaluateUniformSplineVector<true, true>(vXData, vYData, vSlopeData);
+				return;
+			}
+
+			// get indicies of the tabulated function coefficients that contain the correct interpolation polynomial
+			int iIndexLow = mXData.FindIndex(vXData.GetAt(0), CVector::LESSEQUAL);
+
+			const int iMaxIndex = mXData.GetSize() - 1;
+
+			// correct the indicies, if necessary
+			if(iIndexLow < 0)
+				iIndexLow = 0;
+			int iIndexHigh = iIndexLow + 1;
+			if(iIndexHigh > iMaxIndex)
+			{
+				iIndexHigh = iMaxIndex;
+				iIndexLow = iIndexHigh - 1;
+			}
+
+			int iCount = 0;
+			const int iXEvalSize = vXData.GetSize();
+			do
+			{
+				// loop invariants
+				const TFitData fXHigh = mXData.GetAt(iIndexHigh);
+				const TFitData fYLow = mYData.GetAt(iIndexLow);
+				const TFitData fYHigh = mYData.GetAt(iIndexHigh);
+
+				// get preprepared coefficients
+				const TFitData fH = mH.GetAt(iIndexHigh);
+				const TFitData fSlopeInvariant = mSlopeInvariant.GetAt(iIndexHigh);
+
+				const TFitData fYDeltaLow = mDeltaHSquareLow.GetAt(iIndexHigh);
+				const TFitData fYDeltaHigh = mDeltaHSquareHigh.GetAt(iIndexHigh);
+				const TFitData fSlopeDeltaLow = mSlopeDeltaHSquareLow.GetAt(iIndexHigh);
+				const TFitData fSlopeDeltaHigh = mSlopeDeltaHSquareHigh.GetAt(iIndexHigh);
+
+				// repeat until we cross the current polynomial's boundaries
+				TFitData fXData = vXData.GetAt(iCount);
+
+				while(fXData < fXHigh || iIndexHigh >= iMaxIndex)
+				{
+					// linear interpolation coefficient
+					const TFitData fA = (fXHigh - fXData) / fH;
+					const TFitData fB = (1 - fA);
+
+					// first interpolate linearily and add the polynomial's coefficients to fulfill the second derivative constrain
+					TFitData fResult = fA * fYLow + fB * fYHigh;
+					fResult += ((fA * fA * fA - fA) * fYDeltaLow + (fB * fB * fB - fB) * fYDeltaHigh);
+					vYData.SetAt(iCount, fResult);
+
+					// calculate the first derivative
+					vSlopeData.SetAt(iCount++, fSlopeInvariant + (((3 * fB * fB - 1) * fSlopeDeltaHigh) - ((3 * fA * fA - 1) * fSlopeDeltaLow)));
+
+					if(iCount >= iXEvalSize)
+						return;
+
+					fXData = vXData.GetAt(iCount);
+				}
+
+				// find next valid indicies
+				do
+				{
+					iIndexHigh++;
+					if(iIndexHigh > iMaxIndex)
+					{
+						iIndexHigh = iMaxIndex;
+						break;
+					}
+				}while(mXData.GetAt(iIndexHigh) < fXData);
+				iIndexLow = iIndexHigh - 1;
+			}while(iCount < iXEvalSize);
+		}
+
 		TFitData SlopeSpline(TFitData fXValue)
 		{
 			// check wheter we have a valid spline
@@ -367,6 +649,12 @@ namespace MathFit
 			// check wheter we have a valid spline
 			MATHFIT_ASSERT(mY2ndDerivates.GetSize() >= 3);
 
+			if(mUniform)
+			{
+				EvaluateUniformSplineVector<false, true>(vXData, vYData, vYData);
+				return vYData;
+			}
+
 			// get indicies of the tabulated function coefficients that contain the correct interpolation polynomial
 			int iIndexLow = mXData.FindIndex(vXData.GetAt(0), CVector::LESSEQUAL);
 
@@ -439,6 +727,14 @@ namespace MathFit
 		CVector mDeltaHSquareHigh;
 		CVector mSlopeDeltaHSquareLow;
 		CVector mSlopeDeltaHSquareHigh;
+
+		/**
+		* True if the nodes are equidistant. The first node and the inverse distance between
+		* two nodes are then used to calculate the interval of an X value.
+		*/
+		bool mUniform;
+		TFitData mXFirst;
+		TFitData mInverseStep;
 	};
 }
 
@@ -88,7 +88,9 @@ namespace MathFit
 
 			MATHFIT_ASSERT(iOffset >= 0 && (iOffset + iLength) <= mLength && iLength > 0);
 
-			return (TFitData)fabs(Max(iOffset, iLength) - Min(iOffset, iLength));
+			TFitData fMin, fMax;
+			MinMax(fMin, fMax, iOffset, iLength);
+			return (TFitData)fabs(fMax - fMin);
 		}
 
 		/**
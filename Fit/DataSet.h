@@ -59,6 +59,13 @@ namespace MathFit
 			IDataSet::SetData(vXValues, vYValues);
 		}
 
+		/**
+		* The objects of the derived classes are deleted through pointers to their interfaces.
+		*/
+		virtual ~IDataSet()
+		{
+		}
+
 		/**
 		* Copies the given data into the object. 
 		* The error is set to one.
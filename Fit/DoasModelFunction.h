@@ -0,0 +1,413 @@
+/**
+ * Contains a standard norm function for DOAS models whose shape is known at compile time.
+ */
+#if !defined(DOASMODELFUNCTION_H_261017)
+#define DOASMODELFUNCTION_H_261017
+
+#include "StandardMetricFunction.h"
+#include "ReferenceSpectrumFunction.h"
+#include "PolynomialFunction.h"
+#include "CubicSplineFunction.h"
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+namespace MathFit
+{
+	/**
+	* Implements the difference between the target data and a DOAS model, which is the sum of NRef reference spectra
+	* followed by a polynomial of the order PolyOrder.
+	*
+	* The model is still built from CReferenceSpectrumFunction and CPolynomialFunction objects added to a
+	* CSimpleDOASFunction, and the parameters, their limits, errors and covariance matrices are kept by these objects.
+	* However, the function values, the first derivatives in regard to the nonlinear parameters and the
+	* A matrix of the linear fit are calculated here in one loop over the data points, which evaluates all references and
+	* the polynomial at each data point. This avoids the virtual calls of every function object and the temporary vectors
+	* which are summed up by the generic model. Since the number of references and the polynomial order are known at compile time
+	* the loops over the references and the polynomial coefficients can be unrolled by the compiler.
+	*
+	* The reference spectra have to use a CCubicSplineFunction as basis function and none of the parameters may be linked.
+	* Use \Ref{CDoasModel::Create} to get an object for a given model.
+	*/
+	template<int NRef, int PolyOrder>
+	class CDoasModelFunction : public CStandardMetricFunction
+	{
+	public:
+		/**
+		* Sets the model function and the target data.
+		*
+		* @param ipfTarget		The data sample to which the model should be fitted
+		* @param ipfModel		The model function object. This must be the sum of the given references followed by the polynomial.
+		* @param pReferences	The array of the NRef reference spectra of the model.
+		* @param pfPolynomial	The polynomial of the model.
+		*/
+		CDoasModelFunction(IFunction& ipfTarget, IParamFunction& ipfModel, CReferenceSpectrumFunction* pReferences, CPolynomialFunction& pfPolynomial) :
+			CStandardMetricFunction(ipfTarget, ipfModel), mReferences(pReferences), mPolynomial(pfPolynomial)
+		{
+			int i;
+			for(i = 0; i < NRef; i++)
+			{
+				mSpline[i] = dynamic_cast<CCubicSplineFunction*>(&pReferences[i].GetBasisFunction());
+				MATHFIT_ASSERT(mSpline[i] != NULL);
+
+				mFirstInterval[i] = 0;
+			}
+
+			mFitRangeLow = 0;
+		}
+
+		/**
+		* Calculates the difference between the target and the model at a set of given data points.
+		*
+		* @param vXValues			A vector object containing the X values at which the function has to be evaluated.
+		* @param vYTargetVector	A vector object which receives the resulting function values.
+		*
+		* @return	A reference to the Y vector object.
+		*/
+		virtual CVector& GetValues(CVector& vXValues, CVector& vYTargetVector)
+		{
+			mTarget.GetValues(vXValues, vYTargetVector);
+
+			EvaluateModel<true, false>(vXValues, vYTargetVector, mDyDaDummy, 0);
+
+			return vYTargetVector;
+		}
+
+		/**
+		* Calculates the first derivatives of the model in regard to the nonlinear parameters,
+		* these are the shift and squeeze of every reference which are not fixed.
+		*
+		* @param vXValues	The data points at which the slope should be determined.
+		* @param mDyDa		The matrix object receiving the derivative values of the function at the given data points.
+		*
+		* @see	IParamFunction::GetNonlinearDyDa
+		*/
+		virtual void GetNonlinearDyDa(CVector& vXValues, CMatrix& mDyDa)
+		{
+			EvaluateModel<false, true>(vXValues, mValuesDummy, mDyDa, 0);
+		}
+
+		/**
+		* Calculates the difference between the target and the model and the first derivatives
+		* in regard to the nonlinear parameters in the same loop over the data points.
+		*
+		* @param vXValues	The data points at which the function should be evaluated.
+		* @param vYValues	The vector object receiving the function values.
+		* @param mDyDa		The matrix object receiving the derivative values of the function at the given data points.
+		* @param iFirstCol	The column of the matrix which receives the derivative of the first nonlinear parameter.
+		*
+		* @see	IParamFunction::GetValuesAndNonlinearDyDa
+		*/
+		virtual void GetValuesAndNonlinearDyDa(CVector& vXValues, CVector& vYValues, CMatrix& mDyDa, int iFirstCol = 0)
+		{
+			mTarget.GetValues(vXValues, vYValues);
+
+			EvaluateModel<true, true>(vXValues, vYValues, mDyDa, iFirstCol);
+		}
+
+		/**
+		* Fills the A matrix of the linear fit with the references and the polynomial basis functions.
+		* The references whose concentration is fixed are subtracted from the target data in the B vector.
+		*
+		* @param vXValues	The vector object containing the X values at which we need the A matrix.
+		* @param mA		The matrix object receiving the resulting matrix.
+		* @param vB		The vector object receiving the constant values of the equations.
+		*
+		* @see	IParamFunction::GetLinearAMatrix
+		*/
+		virtual void GetLinearAMatrix(CVector& vXValues, CMatrix& mA, CVector& vB)
+		{
+			// set the target data as B vector
+			mTarget.GetValues(vXValues, vB);
+
+			UpdateParameters();
+
+			const int iXSize = vXValues.GetSize();
+			const int iPolynomialColumns = mPolynomial.GetLinearParameter().GetSize();
+
+			int iInterval[NRef];
+			int r;
+			for(r = 0; r < NRef; r++)
+				iInterval[r] = mFirstInterval[r];
+
+			int i;
+			for(i = 0; i < iXSize; i++)
+			{
+				const TFitData fXValue = vXValues.GetAt(i);
+				const TFitData fXRel = fXValue - mFitRangeLow;
+				TFitData fB = vB.GetAt(i);
+				int iCol = 0;
+
+				for(r = 0; r < NRef; r++)
+				{
+					// the basis function is just the spline at the shifted and squeezed X value
+					const TFitData fValue = mSpline[r]->GetValue(mSqueeze[r] * fXRel + mShift[r] + mFitRangeLow, iInterval[r]);
+
+					if(mFreeConcentration[r])
+						mA.SetAt(i, iCol++, fValue);
+					else
+						fB -= fValue * mConcentration[r];
+				}
+
+				// the polynomial basis functions are the powers of the X value
+				TFitData fBasisFunction = 1;
+				int k;
+				for(k = 0; k < iPolynomialColumns; k++)
+				{
+					mA.SetAt(i, iCol++, fBasisFunction);
+					fBasisFunction *= fXValue;
+				}
+
+				vB.SetAt(i, fB);
+
+				if(i == 0)
+				{
+					for(r = 0; r < NRef; r++)
+						mFirstInterval[r] = iInterval[r];
+				}
+			}
+		}
+
+		/**
+		* Sets the fit range used during evaluation.
+		*
+		* @param vFitRange	A vector object that represents the fit range.
+		*/
+		virtual void SetFitRange(CVector& vFitRange)
+		{
+			CStandardMetricFunction::SetFitRange(vFitRange);
+
+			mFitRangeLow = vFitRange.GetAt(0);
+		}
+
+	private:
+		/**
+		* Reads the current parameters of the references and the polynomial.
+		*/
+		void UpdateParameters()
+		{
+			int r;
+			for(r = 0; r < NRef; r++)
+			{
+				CParameterVector& pvLinear = mReferences[r].GetLinearParameterVector();
+				CParameterVector& pvNonlinear = mReferences[r].GetNonlinearParameterVector();
+
+				mConcentration[r] = pvLinear.GetAllParameter().GetAt(0);
+				mShift[r] = pvNonlinear.GetAllParameter().GetAt(0);
+				mSqueeze[r] = pvNonlinear.GetAllParameter().GetAt(1);
+
+				mFreeConcentration[r] = !pvLinear.IsParamFixed(0);
+				mFreeShift[r] = !pvNonlinear.IsParamFixed(0);
+				mFreeSqueeze[r] = !pvNonlinear.IsParamFixed(1);
+			}
+
+			CVector& vCoefficients = mPolynomial.GetCoefficients();
+			int k;
+			for(k = 0; k <= PolyOrder; k++)
+				mCoefficients[k] = vCoefficients.GetAt(k);
+		}
+
+		/**
+		* Evaluates all references and the polynomial in one loop over the data points.
+		*
+		* @param vXValues	The data points at which the model should be evaluated.
+		* @param vValues	If bValues is TRUE, the model is subtracted from the values in this vector.
+		* @param mDyDa		If bDyDa is TRUE, this matrix receives the first derivatives in regard to the nonlinear parameters.
+		* @param iFirstCol	The column of the matrix which receives the derivative of the first nonlinear parameter.
+		*/
+		template<bool bValues, bool bDyDa>
+		void EvaluateModel(CVector& vXValues, CVector& vValues, CMatrix& mDyDa, int iFirstCol)
+		{
+			UpdateParameters();
+
+			const int iXSize = vXValues.GetSize();
+
+			int iInterval[NRef];
+			int r;
+			for(r = 0; r < NRef; r++)
+				iInterval[r] = mFirstInterval[r];
+
+			int i;
+			for(i = 0; i < iXSize; i++)
+			{
+				const TFitData fXValue = vXValues.GetAt(i);
+				const TFitData fXRel = fXValue - mFitRangeLow;
+				TFitData fModel = 0;
+				int iCol = iFirstCol;
+
+				for(r = 0; r < NRef; r++)
+				{
+					// the shifted and squeezed X value of the reference
+					const TFitData fX = mSqueeze[r] * fXRel + mShift[r] + mFitRangeLow;
+
+					if(bDyDa)
+					{
+						TFitData fSlope;
+						const TFitData fValue = mSpline[r]->GetValueAndSlope(fX, iInterval[r], fSlope);
+						if(bValues)
+							fModel += fValue * mConcentration[r];
+
+						// df/dshift = c*o'(x) and df/dsqueeze = c*o'(x)*x
+						fSlope *= mConcentration[r];
+						if(mFreeShift[r])
+							mDyDa.SetAt(i, iCol++, fSlope);
+						if(mFreeSqueeze[r])
+							mDyDa.SetAt(i, iCol++, fSlope * fXValue);
+					}
+					else
+						fModel += mSpline[r]->GetValue(fX, iInterval[r]) * mConcentration[r];
+				}
+
+				if(bValues)
+				{
+					// calculate the polynomial using the horner scheme
+					TFitData fPolynomial = mCoefficients[PolyOrder];
+					int k;
+					for(k = PolyOrder - 1; k >= 0; k--)
+						fPolynomial = fPolynomial * fXValue + mCoefficients[k];
+					fModel += fPolynomial;
+
+					vValues.SetAt(i, vValues.GetAt(i) - fModel);
+				}
+
+				if(i == 0)
+				{
+					for(r = 0; r < NRef; r++)
+						mFirstInterval[r] = iInterval[r];
+				}
+			}
+		}
+
+		/**
+		* The reference spectra of the model.
+		*/
+		CReferenceSpectrumFunction* mReferences;
+		/**
+		* The polynomial of the model.
+		*/
+		CPolynomialFunction& mPolynomial;
+		/**
+		* The cubic splines used as basis functions by the references.
+		*/
+		CCubicSplineFunction* mSpline[NRef];
+		/**
+		* The spline intervals used for the first data point of the last evaluation.
+		* The next evaluation starts the search of the intervals there.
+		*/
+		int mFirstInterval[NRef];
+		/**
+		* The current parameters of the references.
+		*/
+		TFitData mConcentration[NRef];
+		TFitData mShift[NRef];
+		TFitData mSqueeze[NRef];
+		bool mFreeConcentration[NRef];
+		bool mFreeShift[NRef];
+		bool mFreeSqueeze[NRef];
+		/**
+		* The current polynomial coefficients.
+		*/
+		TFitData mCoefficients[PolyOrder + 1];
+		/**
+		* The lower bound of the fit range, the references are squeezed around this point.
+		*/
+		TFitData mFitRangeLow;
+		/**
+		* Empty objects passed to EvaluateModel for the output which is not needed.
+		*/
+		CVector mValuesDummy;
+		CMatrix mDyDaDummy;
+	};
+
+	/**
+	* Creates the compiled DOAS model functions for the model shapes which are common in DOAS evaluations.
+	*/
+	class CDoasModel
+	{
+	public:
+		/**
+		* The model shapes for which a CDoasModelFunction can be created.
+		*/
+		enum
+		{
+			MIN_REFERENCES = 1,
+			MAX_REFERENCES = 6,
+			MIN_POLYNOMIAL_ORDER = 2,
+			MAX_POLYNOMIAL_ORDER = 5
+		};
+
+		/**
+		* Checks if a CDoasModelFunction can be created for the given model.
+		*
+		* @param pReferences		The array of the reference spectra of the model.
+		* @param iNumReferences		The number of reference spectra.
+		* @param pfPolynomial		The polynomial of the model.
+		*
+		* @return TRUE if the shape of the model is supported and all references use a cubic spline as basis function.
+		*/
+		static bool IsSupported(CReferenceSpectrumFunction* pReferences, int iNumReferences, CPolynomialFunction& pfPolynomial)
+		{
+			if(iNumReferences < MIN_REFERENCES || iNumReferences > MAX_REFERENCES)
+				return false;
+
+			const int iOrder = pfPolynomial.GetCoefficients().GetSize() - 1;
+			if(iOrder < MIN_POLYNOMIAL_ORDER || iOrder > MAX_POLYNOMIAL_ORDER)
+				return false;
+
+			int i;
+			for(i = 0; i < iNumReferences; i++)
+			{
+				if(dynamic_cast<CCubicSplineFunction*>(&pReferences[i].GetBasisFunction()) == NULL)
+					return false;
+			}
+
+			return true;
+		}
+
+		/**
+		* Creates the difference between the target data and the given DOAS model.
+		* The parameters of the references must not be linked, since the links are only handled by the generic model.
+		*
+		* @param ipfTarget		The data sample to which the model should be fitted
+		* @param ipfModel		The model function object. This must be the sum of the given references followed by the polynomial.
+		* @param pReferences	The array of the reference spectra of the model.
+		* @param iNumReferences	The number of reference spectra.
+		* @param pfPolynomial	The polynomial of the model.
+		*
+		* @return A new CDoasModelFunction object, which has to be deleted by the caller, or NULL if the model is not supported.
+		*/
+		static CStandardMetricFunction* Create(IFunction& ipfTarget, IParamFunction& ipfModel, CReferenceSpectrumFunction* pReferences, int iNumReferences, CPolynomialFunction& pfPolynomial)
+		{
+			if(!IsSupported(pReferences, iNumReferences, pfPolynomial))
+				return NULL;
+
+			const int iOrder = pfPolynomial.GetCoefficients().GetSize() - 1;
+			switch(iNumReferences)
+			{
+			case 1: return Create<1>(ipfTarget, ipfModel, pReferences, pfPolynomial, iOrder);
+			case 2: return Create<2>(ipfTarget, ipfModel, pReferences, pfPolynomial, iOrder);
+			case 3: return Create<3>(ipfTarget, ipfModel, pReferences, pfPolynomial, iOrder);
+			case 4: return Create<4>(ipfTarget, ipfModel, pReferences, pfPolynomial, iOrder);
+			case 5: return Create<5>(ipfTarget, ipfModel, pReferences, pfPolynomial, iOrder);
+			case 6: return Create<6>(ipfTarget, ipfModel, pReferences, pfPolynomial, iOrder);
+			}
+			return NULL;
+		}
+
+	private:
+		template<int NRef>
+		static CStandardMetricFunction* Create(IFunction& ipfTarget, IParamFunction& ipfModel, CReferenceSpectrumFunction* pReferences, CPolynomialFunction& pfPolynomial, int iOrder)
+		{
+			switch(iOrder)
+			{
+			case 2: return new CDoasModelFunction<NRef, 2>(ipfTarget, ipfModel, pReferences, pfPolynomial);
+			case 3: return new CDoasModelFunction<NRef, 3>(ipfTarget, ipfModel, pReferences, pfPolynomial);
+			case 4: return new CDoasModelFunction<NRef, 4>(ipfTarget, ipfModel, pReferences, pfPolynomial);
+			case 5: return new CDoasModelFunction<NRef, 5>(ipfTarget, ipfModel, pReferences, pfPolynomial);
+			}
+			return NULL;
+		}
+	};
+}
+#endif
@@ -91,10 +91,15 @@ namespace MathFit
 			// repeat until the nonlinear fit aborts
 			while(mMinimizer.Minimize())
 			{
-				// do the linear fit
-				while(mLinearMinimizer.Minimize());
+				// do the linear fit, unless the nonlinear minimizer already determined the linear parameters
+				if(!mMinimizer.IsSeparable())
+					while(mLinearMinimizer.Minimize());
 			}
 
+			// bring the linear minimizer up to date with the final nonlinear parameters
+			if(mMinimizer.IsSeparable())
+				while(mLinearMinimizer.Minimize());
+
 			// finish the nonlinear fit
 			if(!mMinimizer.FinishMinimize())
 				return false;
@@ -152,12 +157,21 @@ namespace MathFit
 
 		virtual void SetMinChiSquare(TFitData fMinChiSquare)
 		{
+			mMinChiSquare = fMinChiSquare;
 			mCheckChiSquare = fMinChiSquare;
 
 			mMinimizer.SetMinChiSquare(fMinChiSquare);
 			mLinearMinimizer.SetMinChiSquare(fMinChiSquare);
 		}
 
+		virtual void SetEquationSolver(EEquationSolver eSolver)
+		{
+			mEquationSolver = eSolver;
+
+			mMinimizer.SetEquationSolver(eSolver);
+			mLinearMinimizer.SetEquationSolver(eSolver);
+		}
+
 	private:
 		/**
 		* The nonlinear minimizer object.
@@ -188,6 +188,8 @@ catch(CFitException e)
 namespace MathFit
 {
 	// enable to use single precission data. if disabled double precission is used.
+	// the normal equations, the chi square and the solution of the equation systems always use double precission
+	// (see CDoubleMatrix and CDoubleVector), only the data, the references and the derivatives are stored as float.
 //#define MATHFIT_FITDATAFLOAT
 
 	/**
@@ -237,6 +239,40 @@ namespace MathFit
 #else
 #define MATHFIT_ASSERT(a)
 #endif // defined(_DEBUG)
+
+	/**
+	* Counts the heap allocations done by the vector and matrix objects.
+	* The counter is kept per thread, so the number of allocations done by a fit may be determined
+	* by comparing the counter before and after the fit, even if other threads are fitting, too.
+	*/
+	class CAllocationCounter
+	{
+	public:
+		/**
+		* Returns the number of allocations done by the calling thread so far.
+		*
+		* @return	The number of allocations.
+		*/
+		static long GetCount()
+		{
+			return Counter();
+		}
+
+		/**
+		* Registers a new allocation of the calling thread.
+		*/
+		static void Add()
+		{
+			Counter()++;
+		}
+
+	private:
+		static long& Counter()
+		{
+			static thread_local long lCount = 0;
+			return lCount;
+		}
+	};
 }
 
 #endif // !defined(AFX_FITBASIC_H__127D9ACD_261F_47B2_B62E_796F5487ABCD__INCLUDED_)
@@ -0,0 +1,601 @@
+/**
+* Contains the plan based fast fourier transforms of complex and of real data.
+*/
+#if !defined(FOURIERTRANSFORM_H_020523)
+#define FOURIERTRANSFORM_H_020523
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <math.h>
+#include "FitBasic.h"
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+namespace MathFit
+{
+	/**
+	* A fast fourier transform of complex data of a fixed length.
+	* The length is split into factors, which are handled by special butterflies for the factors 2, 3 and 4
+	* and by a general butterfly for all other factors. Lengths containing only small factors are fast,
+	* for example the usual detector sizes 1024, 2048 and 3648 = 2^6 * 3 * 19.
+	*
+	* The twiddle factors and the factorization are calculated once when the plan is created,
+	* and the work buffer is kept per thread, so a transform does not allocate once the buffer is large enough.
+	* A plan is not changed by a transform, so the same plan can be used by several threads at once.
+	* Plans are shared using \Ref{GetPlan}.
+	*
+	* The complex values are stored interleaved, the real part followed by the imaginary part.
+	*/
+	class CFourierTransform
+	{
+	public:
+		/**
+		* Creates the plan of a transform.
+		*
+		* @param iSize	The number of complex values.
+		*/
+		explicit CFourierTransform(int iSize)
+		{
+			MATHFIT_ASSERT(iSize > 0);
+
+			mSize = iSize;
+			mMaxFactor = 1;
+
+			// radix 4 first, since it needs the fewest operations per value
+			int iRest = iSize;
+			while(iRest % 4 == 0)
+			{
+				mFactors.push_back(4);
+				iRest /= 4;
+			}
+			int iFactor;
+			for(iFactor = 2; iRest > 1; iFactor++)
+			{
+				while(iRest % iFactor == 0)
+				{
+					mFactors.push_back(iFactor);
+					iRest /= iFactor;
+				}
+			}
+			size_t f;
+			for(f = 0; f < mFactors.size(); f++)
+				mMaxFactor = mFactors[f] > mMaxFactor ? mFactors[f] : mMaxFactor;
+
+			// the twiddle factors exp(-2 pi i k / n), calculated directly to avoid accumulating rounding errors
+			mTwiddle.resize(2 * iSize);
+			int i;
+			for(i = 0; i < iSize; i++)
+			{
+				const double fAngle = -6.283185307179586476925 * i / iSize;
+				mTwiddle[2 * i] = cos(fAngle);
+				mTwiddle[2 * i + 1] = sin(fAngle);
+			}
+		}
+
+		/**
+		* Returns the smallest number of values that is at least the given number and contains only the factors 2, 3 and 5.
+		* Transforms of these lengths are fast.
+		*/
+		static int GetFastSize(int iMinSize)
+		{
+			int iSize = iMinSize > 1 ? iMinSize : 1;
+			for(;; iSize++)
+			{
+				int iRest = iSize;
+				while(iRest % 2 == 0)
+					iRest /= 2;
+				while(iRest % 3 == 0)
+					iRest /= 3;
+				while(iRest % 5 == 0)
+					iRest /= 5;
+				if(iRest == 1)
+					return iSize;
+			}
+		}
+
+		/**
+		* Returns a shared plan for the given number of values. The plan is created on the first request.
+		*
+		* @param iSize	The number of complex values.
+		*
+		* @return	The plan.
+		*/
+		static std::shared_ptr<const CFourierTransform> GetPlan(int iSize)
+		{
+			static std::mutex mutex;
+			static std::map<int, std::shared_ptr<const CFourierTransform>> plans;
+
+			std::lock_guard<std::mutex> lock(mutex);
+			std::shared_ptr<const CFourierTransform>& plan = plans[iSize];
+			if(!plan)
+				plan = std::make_shared<const CFourierTransform>(iSize);
+			return plan;
+		}
+
+		/**
+		* Returns the number of complex values of the transform.
+		*/
+		int GetSize() const
+		{
+			return mSize;
+		}
+
+		/**
+		* Transforms the data in place into the frequency domain.
+		*
+		* \begin{verbatim}F(k) = sum f(j) exp(-2 pi i j k / n)\end{verbatim}
+		*
+		* @param fData	The interleaved complex values.
+		*/
+		void Forward(double* fData) const
+		{
+			Transform(fData, 1);
+		}
+
+		/**
+		* Transforms the data in place back from the frequency domain.
+		* The result is not divided by the number of values.
+		*
+		* @param fData	The interleaved complex values.
+		*/
+		void Inverse(double* fData) const
+		{
+			Transform(fData, -1);
+		}
+
+	private:
+		/**
+		* Transforms the data in place.
+		*
+		* @param fData	The interleaved complex values.
+		* @param iSign	1 for the forward transform, -1 for the inverse transform.
+		*/
+		void Transform(double* fData, int iSign) const
+		{
+			if(mFactors.empty())
+				return;
+
+			// the copy of the input followed by the values and the roots of one general butterfly
+			static thread_local std::vector<double> vWork;
+			const size_t iWorkSize = 2 * (size_t)(mSize + 2 * mMaxFactor);
+			if(vWork.size() < iWorkSize)
+				vWork.resize(iWorkSize);
+
+			double* fInput = vWork.data();
+			int i;
+			for(i = 0; i < 2 * mSize; i++)
+				fInput[i] = fData[i];
+
+			Decompose(fData, fInput, 1, 0, iSign, fInput + 2 * mSize);
+		}
+
+		/**
+		* Transforms the values fIn[0], fIn[iStride], ... of the current level, whose length is the
+		* product of the remaining factors, by the decimation in time into the consecutive fOut values.
+		*
+		* @param fOut		Receives the interleaved complex results.
+		* @param fIn		The first interleaved complex input value.
+		* @param iStride	The distance of the input values in complex values.
+		* @param iFactor	The index of the factor of the current level.
+		* @param iSign		1 for the forward transform, -1 for the inverse transform.
+		* @param fTemp		Room for the values and the roots of one general butterfly.
+		*/
+		void Decompose(double* fOut, const double* fIn, int iStride, int iFactor, int iSign, double* fTemp) const
+		{
+			const int iRadix = mFactors[iFactor];
+			const int iCount = mSize / iStride / iRadix;
+
+			int q;
+			if(iCount == 1)
+			{
+				for(q = 0; q < iRadix; q++)
+				{
+					fOut[2 * q] = fIn[2 * q * iStride];
+					fOut[2 * q + 1] = fIn[2 * q * iStride + 1];
+				}
+			}
+			else
+			{
+				for(q = 0; q < iRadix; q++)
+					Decompose(fOut + 2 * q * iCount, fIn + 2 * q * iStride, iStride * iRadix, iFactor + 1, iSign, fTemp);
+			}
+
+			switch(iRadix)
+			{
+			case 2:
+				Butterfly2(fOut, iStride, iCount, iSign);
+				break;
+			case 3:
+				Butterfly3(fOut, iStride, iCount, iSign);
+				break;
+			case 4:
+				Butterfly4(fOut, iStride, iCount, iSign);
+				break;
+			default:
+				ButterflyGeneral(fOut, iStride, iCount, iRadix, iSign, fTemp);
+				break;
+			}
+		}
+
+		/**
+		* Multiplies the value at the given position with the twiddle factor exp(-/+ 2 pi i iIndex / n)
+		* and writes the product to fRe and fIm.
+		*/
+		void Twiddle(const double* fValue, int iIndex, int iSign, double& fRe, double& fIm) const
+		{
+			const double fWr = mTwiddle[2 * iIndex];
+			const double fWi = iSign * mTwiddle[2 * iIndex + 1];
+			fRe = fWr * fValue[0] - fWi * fValue[1];
+			fIm = fWr * fValue[1] + fWi * fValue[0];
+		}
+
+		void Butterfly2(double* fData, int iStride, int iCount, int iSign) const
+		{
+			double* fHigh = fData + 2 * iCount;
+			int k;
+			for(k = 0; k < iCount; k++)
+			{
+				double fTr, fTi;
+				Twiddle(&fHigh[2 * k], k * iStride, iSign, fTr, fTi);
+				fHigh[2 * k] = fData[2 * k] - fTr;
+				fHigh[2 * k + 1] = fData[2 * k + 1] - fTi;
+				fData[2 * k] += fTr;
+				fData[2 * k + 1] += fTi;
+			}
+		}
+
+		void Butterfly3(double* fData, int iStride, int iCount, int iSign) const
+		{
+			// the imaginary part of exp(-/+ 2 pi i / 3)
+			const double fSin = -iSign * 0.86602540378443864676;
+
+			double* fData1 = fData + 2 * iCount;
+			double* fData2 = fData + 4 * iCount;
+			int k;
+			for(k = 0; k < iCount; k++)
+			{
+				double fR1, fI1, fR2, fI2;
+				Twiddle(&fData1[2 * k], k * iStride, iSign, fR1, fI1);
+				Twiddle(&fData2[2 * k], 2 * k * iStride, iSign, fR2, fI2);
+
+				const double fSumRe = fR1 + fR2;
+				const double fSumIm = fI1 + fI2;
+				const double fDiffRe = fSin * (fR1 - fR2);
+				const double fDiffIm = fSin * (fI1 - fI2);
+				const double fMidRe = fData[2 * k] - 0.5 * fSumRe;
+				const double fMidIm = fData[2 * k + 1] - 0.5 * fSumIm;
+
+				fData[2 * k] += fSumRe;
+				fData[2 * k + 1] += fSumIm;
+				fData1[2 * k] = fMidRe - fDiffIm;
+				fData1[2 * k + 1] = fMidIm + fDiffRe;
+				fData2[2 * k] = fMidRe + fDiffIm;
+				fData2[2 * k + 1] = fMidIm - fDiffRe;
+			}
+		}
+
+		void Butterfly4(double* fData, int iStride, int iCount, int iSign) const
+		{
+			double* fData1 = fData + 2 * iCount;
+			double* fData2 = fData + 4 * iCount;
+			double* fData3 = fData + 6 * iCount;
+			int k;
+			for(k = 0; k < iCount; k++)
+			{
+				double fR1, fI1, fR2, fI2, fR3, fI3;
+				Twiddle(&fData1[2 * k], k * iStride, iSign, fR1, fI1);
+				Twiddle(&fData2[2 * k], 2 * k * iStride, iSign, fR2, fI2);
+				Twiddle(&fData3[2 * k], 3 * k * iStride, iSign, fR3, fI3);
+
+				const double fR0 = fData[2 * k];
+				const double fI0 = fData[2 * k + 1];
+				const double fAr = fR0 + fR2, fAi = fI0 + fI2;
+				const double fBr = fR0 - fR2, fBi = fI0 - fI2;
+				const double fCr = fR1 + fR3, fCi = fI1 + fI3;
+				const double fDr = iSign * (fR1 - fR3), fDi = iSign * (fI1 - fI3);
+
+				fData[2 * k] = fAr + fCr;
+				fData[2 * k + 1] = fAi + fCi;
+				fData1[2 * k] = fBr + fDi;
+				fData1[2 * k + 1] = fBi - fDr;
+				fData2[2 * k] = fAr - fCr;
+				fData2[2 * k + 1] = fAi - fCi;
+				fData3[2 * k] = fBr - fDi;
+				fData3[2 * k + 1] = fBi + fDr;
+			}
+		}
+
+		void ButterflyGeneral(double* fData, int iStride, int iCount, int iRadix, int iSign, double* fTemp) const
+		{
+			// all other factors are odd primes, so the values q and radix - q are combined
+			MATHFIT_ASSERT(iRadix % 2 == 1);
+			const int iHalf = iRadix / 2;
+
+			// the roots exp(-/+ 2 pi i q / radix), copied from the table such that they are read consecutively
+			double* fRoot = fTemp + 2 * iRadix;
+			const int iRadixStep = mSize / iRadix;
+			int k, q, r;
+			for(q = 0; q < iRadix; q++)
+			{
+				fRoot[2 * q] = mTwiddle[2 * q * iRadixStep];
+				fRoot[2 * q + 1] = iSign * mTwiddle[2 * q * iRadixStep + 1];
+			}
+
+			// the sums of the values q and radix - q are followed by their differences
+			double* fSum = fTemp;
+			double* fDiff = fTemp + iRadix + 1;
+			for(k = 0; k < iCount; k++)
+			{
+				const double fR0 = fData[2 * k];
+				const double fI0 = fData[2 * k + 1];
+				double fTotalRe = fR0;
+				double fTotalIm = fI0;
+				for(q = 1; q <= iHalf; q++)
+				{
+					double fRq, fIq, fRl, fIl;
+					Twiddle(&fData[2 * (q * iCount + k)], q * k * iStride, iSign, fRq, fIq);
+					Twiddle(&fData[2 * ((iRadix - q) * iCount + k)], (iRadix - q) * k * iStride, iSign, fRl, fIl);
+					fSum[2 * q] = fRq + fRl;
+					fSum[2 * q + 1] = fIq + fIl;
+					fDiff[2 * q] = fRq - fRl;
+					fDiff[2 * q + 1] = fIq - fIl;
+					fTotalRe += fSum[2 * q];
+					fTotalIm += fSum[2 * q + 1];
+				}
+
+				// the real parts of the roots multiply the sums, the imaginary parts the differences,
+				// which gives the results r and radix - r at once
+				for(r = 1; r <= iHalf; r++)
+				{
+					double fAr = fR0, fAi = fI0, fBr = 0, fBi = 0;
+					int iIndex = 0;
+					for(q = 1; q <= iHalf; q++)
+					{
+						iIndex += r;
+						if(iIndex >= iRadix)
+							iIndex -= iRadix;
+
+						const double fWr = fRoot[2 * iIndex];
+						const double fWi = fRoot[2 * iIndex + 1];
+						fAr += fWr * fSum[2 * q];
+						fAi += fWr * fSum[2 * q + 1];
+						fBr += fWi * fDiff[2 * q];
+						fBi += fWi * fDiff[2 * q + 1];
+					}
+					fData[2 * (r * iCount + k)] = fAr - fBi;
+					fData[2 * (r * iCount + k) + 1] = fAi + fBr;
+					fData[2 * ((iRadix - r) * iCount + k)] = fAr + fBi;
+					fData[2 * ((iRadix - r) * iCount + k) + 1] = fAi - fBr;
+				}
+				fData[2 * k] = fTotalRe;
+				fData[2 * k + 1] = fTotalIm;
+			}
+		}
+
+		int mSize;
+		int mMaxFactor;
+		std::vector<int> mFactors;
+		std::vector<double> mTwiddle;
+	};
+
+	/**
+	* A fast fourier transform of real data of a fixed length.
+	* Since the spectrum of real data is symmetric, only the values up to the half of the length are calculated.
+	* For an even length the real data is transformed as a complex transform of half the length,
+	* whose result is split into the spectra of the even and the odd samples.
+	* Plans are shared using \Ref{GetPlan} and can be used by several threads at once.
+	*/
+	class CRealFourierTransform
+	{
+	public:
+		/**
+		* Creates the plan of a transform.
+		*
+		* @param iSize	The number of real values.
+		*/
+		explicit CRealFourierTransform(int iSize)
+		{
+			MATHFIT_ASSERT(iSize > 0);
+
+			mSize = iSize;
+			if(iSize % 2 == 0)
+			{
+				const int iHalf = iSize / 2;
+				mComplex = CFourierTransform::GetPlan(iHalf);
+
+				// the factors exp(-2 pi i k / n) which combine the spectra of the even and the odd samples
+				mTwiddle.resize(2 * (iHalf + 1));
+				int i;
+				for(i = 0; i <= iHalf; i++)
+				{
+					const double fAngle = -6.283185307179586476925 * i / iSize;
+					mTwiddle[2 * i] = cos(fAngle);
+					mTwiddle[2 * i + 1] = sin(fAngle);
+				}
+			}
+			else
+				mComplex = CFourierTransform::GetPlan(iSize);
+		}
+
+		/**
+		* Returns a shared plan for the given number of values. The plan is created on the first request.
+		*
+		* @param iSize	The number of real values.
+		*
+		* @return	The plan.
+		*/
+		static std::shared_ptr<const CRealFourierTransform> GetPlan(int iSize)
+		{
+			static std::mutex mutex;
+			static std::map<int, std::shared_ptr<const CRealFourierTransform>> plans;
+
+			std::lock_guard<std::mutex> lock(mutex);
+			std::shared_ptr<const CRealFourierTransform>& plan = plans[iSize];
+			if(!plan)
+				plan = std::make_shared<const CRealFourierTransform>(iSize);
+			return plan;
+		}
+
+		/**
+		* Returns the number of real values of the transform.
+		*/
+		int GetSize() const
+		{
+			return mSize;
+		}
+
+		/**
+		* Returns the number of complex values of the spectrum, which is the half of the length plus one.
+		*/
+		int GetSpectrumSize() const
+		{
+			return mSize / 2 + 1;
+		}
+
+		/**
+		* Transforms the real data into the frequency domain.
+		*
+		* \begin{verbatim}F(k) = sum f(j) exp(-2 pi i j k / n)\end{verbatim}
+		*
+		* @param fData		The real values.
+		* @param fSpectrum	Receives the interleaved complex values F(0) to F(n / 2). Must not overlap with the data.
+		*/
+		void Forward(const double* fData, double* fSpectrum) const
+		{
+			int i;
+			if(mSize % 2 != 0)
+			{
+				double* fBuffer = GetBuffer();
+				for(i = 0; i < mSize; i++)
+				{
+					fBuffer[2 * i] = fData[i];
+					fBuffer[2 * i + 1] = 0;
+				}
+				mComplex->Forward(fBuffer);
+				for(i = 0; i < 2 * GetSpectrumSize(); i++)
+					fSpectrum[i] = fBuffer[i];
+				return;
+			}
+
+			// the even samples are the real part, the odd samples the imaginary part
+			const int iHalf = mSize / 2;
+			for(i = 0; i < mSize; i++)
+				fSpectrum[i] = fData[i];
+			mComplex->Forward(fSpectrum);
+
+			// the zero and the highest frequency only depend on the first value
+			const double fRe0 = fSpectrum[0];
+			const double fIm0 = fSpectrum[1];
+			fSpectrum[0] = fRe0 + fIm0;
+			fSpectrum[1] = 0;
+			fSpectrum[2 * iHalf] = fRe0 - fIm0;
+			fSpectrum[2 * iHalf + 1] = 0;
+
+			// the values k and n / 2 - k are calculated from each other
+			int k;
+			for(k = 1; 2 * k <= iHalf; k++)
+			{
+				const int l = iHalf - k;
+				const double fZkr = fSpectrum[2 * k], fZki = fSpectrum[2 * k + 1];
+				const double fZlr = fSpectrum[2 * l], fZli = fSpectrum[2 * l + 1];
+
+				// the spectra of the even samples E and of the odd samples O at k, those at n / 2 - k are the conjugates
+				const double fEr = 0.5 * (fZkr + fZlr);
+				const double fEi = 0.5 * (fZki - fZli);
+				const double fOr = 0.5 * (fZki + fZli);
+				const double fOi = -0.5 * (fZkr - fZlr);
+
+				double fTr, fTi;
+				Combine(fOr, fOi, k, 1, fTr, fTi);
+				fSpectrum[2 * k] = fEr + fTr;
+				fSpectrum[2 * k + 1] = fEi + fTi;
+
+				Combine(fOr, -fOi, l, 1, fTr, fTi);
+				fSpectrum[2 * l] = fEr + fTr;
+				fSpectrum[2 * l + 1] = -fEi + fTi;
+			}
+		}
+
+		/**
+		* Transforms the spectrum back into real data.
+		* The result is not divided by the number of values.
+		*
+		* @param fSpectrum	The interleaved complex values F(0) to F(n / 2). The imaginary parts of F(0)
+		*					and for an even length of F(n / 2) are ignored.
+		* @param fData		Receives the real values. Must not overlap with the spectrum.
+		*/
+		void Inverse(const double* fSpectrum, double* fData) const
+		{
+			int i;
+			if(mSize % 2 != 0)
+			{
+				// the symmetric spectrum of real data
+				double* fBuffer = GetBuffer();
+				fBuffer[0] = fSpectrum[0];
+				fBuffer[1] = 0;
+				for(i = 1; i < GetSpectrumSize(); i++)
+				{
+					fBuffer[2 * i] = fBuffer[2 * (mSize - i)] = fSpectrum[2 * i];
+					fBuffer[2 * i + 1] = fSpectrum[2 * i + 1];
+					fBuffer[2 * (mSize - i) + 1] = -fSpectrum[2 * i + 1];
+				}
+				mComplex->Inverse(fBuffer);
+				for(i = 0; i < mSize; i++)
+					fData[i] = fBuffer[2 * i];
+				return;
+			}
+
+			// the spectra of the even samples E and of the odd samples O give the complex values E + i O
+			const int iHalf = mSize / 2;
+			int k;
+			for(k = 0; k < iHalf; k++)
+			{
+				const int l = iHalf - k;
+				const double fXkr = fSpectrum[2 * k], fXki = k == 0 ? 0.0 : fSpectrum[2 * k + 1];
+				const double fXlr = fSpectrum[2 * l], fXli = l == iHalf ? 0.0 : fSpectrum[2 * l + 1];
+
+				const double fEr = fXkr + fXlr;
+				const double fEi = fXki - fXli;
+				double fOr, fOi;
+				Combine(fXkr - fXlr, fXki + fXli, k, -1, fOr, fOi);
+
+				fData[2 * k] = fEr - fOi;
+				fData[2 * k + 1] = fEi + fOr;
+			}
+			mComplex->Inverse(fData);
+		}
+
+	private:
+		/**
+		* Multiplies the complex value with the factor exp(-/+ 2 pi i k / n).
+		*/
+		void Combine(double fRe, double fIm, int k, int iSign, double& fResultRe, double& fResultIm) const
+		{
+			const double fWr = mTwiddle[2 * k];
+			const double fWi = iSign * mTwiddle[2 * k + 1];
+			fResultRe = fWr * fRe - fWi * fIm;
+			fResultIm = fWr * fIm + fWi * fRe;
+		}
+
+		/**
+		* Returns the buffer of the complex transform of odd lengths, which is kept per thread.
+		*/
+		double* GetBuffer() const
+		{
+			static thread_local std::vector<double> vBuffer;
+			if(vBuffer.size() < 2 * (size_t)mSize)
+				vBuffer.resize(2 * mSize);
+			return vBuffer.data();
+		}
+
+		int mSize;
+		std::shared_ptr<const CFourierTransform> mComplex;
+		std::vector<double> mTwiddle;
+	};
+}
+
+#endif
@@ -118,6 +118,21 @@ namespace MathFit
 			return vSlopeVector;
 		}
 
+		/**
+		* Calculates the function values and the first derivatives of the function at a set of given data points.
+		* The default implementation just calls \Ref{GetValues} and \Ref{GetSlopes}. Functions which have to
+		* search the given data points in their own data, like interpolations, should override it to do this only once.
+		*
+		* @param vXValues		A vector object containing the X values at which the function has to be evaluated.
+		* @param vYTargetVector	A vector object which receives the resulting function values.
+		* @param vSlopeVector	A vector object which receives the resulting slopes.
+		*/
+		virtual void GetValuesAndSlopes(CVector& vXValues, CVector& vYTargetVector, CVector& vSlopeVector)
+		{
+			GetValues(vXValues, vYTargetVector);
+			GetSlopes(vXValues, vSlopeVector);
+		}
+
 		/**
 		* Returns the sigma error of the function value at the given point.
 		* If no direct error information is available for the given data point
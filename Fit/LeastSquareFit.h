@@ -8,6 +8,7 @@
 #define LEASTSQUARE_H_011206
 
 #include "Minimizer.h"
+#include "NormalEquations.h"
 
 #if _MSC_VER > 1000
 #pragma once
@@ -52,101 +53,129 @@ namespace MathFit
 
 		/**
 		* Get the solution for the minimization problem.
-		* The leat square method with the pseudo inverse is used for minimization
+		* The leat square method with the normal equations is used for minimization
 		*
 		* @return FALSE when finished successfully.
 		*/
 		virtual bool Minimize()
 		{
-			if(mModel.GetLinearParameter().GetSize() <= 0)
+			const int iParamCount = mModel.GetLinearParameter().GetSize();
+			if(iParamCount <= 0)
 				return false;
 
-			// bring the matrix and vector to their appropriate sizes
-			mA.SetSize(mModel.GetLinearParameter().GetSize(), mFitRange.GetSize());
+			// bring the matrices and vectors to their appropriate sizes. Their buffers are kept between
+			// the calls, so we only have to clear them.
+			mA.SetSize(iParamCount, mFitRange.GetSize());
+			mA.Zero();
 			mB.SetSize(mFitRange.GetSize());
+			mB.Zero();
+			mAtA.SetSize(iParamCount, iParamCount);
+			mAtB.SetSize(iParamCount);
 
 			// get the A matrix and a modified B vector according to the model function
 			mModel.GetLinearAMatrix(mFitRange, mA, mB);
 
-			// add data errors to model matrix
-			CVector vError(mFitRange.GetSize());
-			mModel.GetFunctionErrors(mFitRange, vError);
-			const int iBSize = mB.GetSize();
-			int i;
-			for(i = 0; i < iBSize; i++)
-			{
-				mA.GetRow(i).Div(vError.GetAt(i));
-				mB.SetAt(i, mB.GetAt(i) / vError.GetAt(i));
-			}
+			// build the normal equations At*A*x=At*b weighted by the data errors
+			mModel.GetFunctionErrors(mFitRange, mError);
+			CNormalEquations::Build(mA, mB, mError, mAtA, mAtB);
 
-			// build transposed A matrix
-			// At
-			mTranspose.Copy(mA);
-			mTranspose.Transpose();
-
-			// build the new result vector
-			// At * b
-			mTranspose.Mul(mB);
-
-			// build inverse pseudo
-			// (At*A)
-			mA.PseudoInverse();
+			// fill in the symmetric side of At*A
+			int i, j;
+			for(i = 0; i < iParamCount; i++)
+				for(j = 0; j < i; j++)
+					mAtA.SetAt(j, i, mAtA.GetAt(i, j));
 
 #if defined(MATHFIT_IMPROVEEQSSOLVE)
 			// to apply the iterative solution improvement, we need backups of the original
 			// result vector and EQS matrix
-			CVector vBackupB(mB);
-			CMatrix mBackupA(mA);
+			CDoubleVector vBackupB(mAtB);
+			CDoubleMatrix mBackupA(mAtA);
 #endif
 
 			// Solve linear equations
-#if defined(MATHFIT_USELUDECOMPOSITION)
-			mA.LUDecomposition();
-			mA.LUBacksubstitution(mB);
+			switch(mEquationSolver)
+			{
+			case CHOLESKY:
+				{
+					mAtA.CholeskyDecomposition();
+					mAtA.CholeskyBacksubstitution(mAtB);
 
 #if defined(MATHFIT_IMPROVEEQSSOLVE)
-			// we want to correct the numerical errors by applying
-			// the 'iterative solution improvement' as described in Numerical Recipes.
+					// we want to correct the numerical errors by applying
+					// the 'iterative solution improvement' as described in Numerical Recipes.
 
-			// Use the solution to calculate once again the result vector of the EQS
-			CVector vSolutionError(mB);
-			mBackupA.Mul(vSolutionError);
+					// Use the solution to calculate once again the result vector of the EQS
+					CDoubleVector vSolutionError(mAtB);
+					mBackupA.Mul(vSolutionError);
 
-			// subtract the old result vector from the one calculated using the EQS result
-			// (the result should be nearly zero at all)
-			vSolutionError.Sub(vBackupB);
+					// subtract the old result vector from the one calculated using the EQS result
+					// (the result should be nearly zero at all)
+					vSolutionError.Sub(vBackupB);
 
-			// solve the EQS once again but use the solution error as result vector
-			mA.LUBacksubstitution(vSolutionError);
+					// solve the EQS once again but use the solution error as result vector
+					mAtA.CholeskyBacksubstitution(vSolutionError);
 
-			// subtract the solution error from the original solution
-			mB.Sub(vSolutionError);
+					// subtract the solution error from the original solution
+					mAtB.Sub(vSolutionError);
 #endif
-#else
-			mA.GaussJordanSolve(mB);
+				}
+				break;
+
+			case LUDECOMPOSITION:
+				{
+					mAtA.LUDecomposition();
+					mAtA.LUBacksubstitution(mAtB);
 
 #if defined(MATHFIT_IMPROVEEQSSOLVE)
-			// we want to correct the numerical errors by applying
-			// the 'iterative solution improvement' as described in Numerical Recipes.
+					// we want to correct the numerical errors by applying
+					// the 'iterative solution improvement' as described in Numerical Recipes.
 
-			// Use the solution to calculate once again the result vector of the EQS
-			CVector vSolutionError(mB);
-			mBackupA.Mul(vSolutionError);
+					// Use the solution to calculate once again the result vector of the EQS
+					CDoubleVector vSolutionError(mAtB);
+					mBackupA.Mul(vSolutionError);
 
-			// subtract the old result vector from the one calculated using the EQS result
-			// (the result should be nearly zero at all)
-			vSolutionError.Sub(vBackupB);
+					// subtract the old result vector from the one calculated using the EQS result
+					// (the result should be nearly zero at all)
+					vSolutionError.Sub(vBackupB);
 
-			// solve the EQS once again but use the solution error as result vector
-			mBackupA.GaussJordanSolve(vSolutionError);
+					// solve the EQS once again but use the solution error as result vector
+					mAtA.LUBacksubstitution(vSolutionError);
 
-			// subtract the solution error from the original solution
-			mB.Sub(vSolutionError);
+					// subtract the solution error from the original solution
+					mAtB.Sub(vSolutionError);
 #endif
+				}
+				break;
+
+			default:
+				{
+					mAtA.GaussJordanSolve(mAtB);
+
+#if defined(MATHFIT_IMPROVEEQSSOLVE)
+					// we want to correct the numerical errors by applying
+					// the 'iterative solution improvement' as described in Numerical Recipes.
+
+					// Use the solution to calculate once again the result vector of the EQS
+					CDoubleVector vSolutionError(mAtB);
+					mBackupA.Mul(vSolutionError);
+
+					// subtract the old result vector from the one calculated using the EQS result
+					// (the result should be nearly zero at all)
+					vSolutionError.Sub(vBackupB);
+
+					// solve the EQS once again but use the solution error as result vector
+					mBackupA.GaussJordanSolve(vSolutionError);
+
+					// subtract the solution error from the original solution
+					mAtB.Sub(vSolutionError);
 #endif
+				}
+				break;
+			}
 
 			// and set the result
-			mModel.SetLinearParameter(mB);			
+			mLinearParam.Copy(mAtB);
+			mModel.SetLinearParameter(mLinearParam);
 
 			return false;
 		}
@@ -166,43 +195,53 @@ namespace MathFit
 			mModel.GetValues(mFitRange, mDiff);
 
 			// now calculate the chi square and variance values
-			CVector vErr(mFitRange.GetSize());
-			mModel.GetFunctionErrors(mFitRange, vErr);
+			mModel.GetFunctionErrors(mFitRange, mError);
 
 			// get the sum of squares weighted by the sigma error vector
-			mChiSquare = mDiff.SquareSumErrorWeighted(vErr);
-			mChiSquare += mModel.GetLinearPenalty(mChiSquare);
+			mChiSquare = mDiff.SquareSumErrorWeighted(mError);
+			mChiSquare += mModel.GetLinearPenalty((TFitData)mChiSquare);
 
 			// calculate the normalization factor for all statistical parameters
 			TFitData fNorm = (TFitData)sqrt(mChiSquare / (mDiff.GetSize() - iParams));
 
-			// set the covariance matrix, which is the inverse of A after the Gauss Jordan elimination
-#if defined(MATHFIT_USELUDECOMPOSITION)
-			mA.LUInverse();
-#endif
-			CMatrix mCovar(mA);
+			// set the covariance matrix, which is the inverse of At*A after the Gauss Jordan elimination
+			// and has to be calculated from the decomposition otherwise
+			switch(mEquationSolver)
+			{
+			case CHOLESKY:
+				mAtA.CholeskyInverse();
+				break;
+
+			case LUDECOMPOSITION:
+				mAtA.LUInverse();
+				break;
+
+			default:
+				break;
+			}
+			mCovar.Copy(mAtA);
 
 			// set the covariance matrix
 			mModel.SetLinearCovarMatrix(mCovar);
 
 			// calculate the parameter errors
-			CVector vError(iParams);
+			mParamError.SetSize(iParams);
 			int i;
 			for(i = 0; i < iParams; i++)
-				vError.SetAt(i, (TFitData)sqrt(mCovar.GetAt(i, i)));
+				mParamError.SetAt(i, (TFitData)sqrt(mCovar.GetAt(i, i)));
 
 			// calculate the correlation matrix
-			CMatrix mCorrel(iParams, iParams);
+			mCorrel.SetSize(iParams, iParams);
 
 			int j;
 			for(i = 0; i < iParams; i++)
 				for(j = 0; j < iParams; j++)
-					mCorrel.SetAt(i, j, mCovar.GetAt(i, j) / (vError.GetAt(i) * vError.GetAt(j)));
+					mCorrel.SetAt(i, j, mCovar.GetAt(i, j) / (mParamError.GetAt(i) * mParamError.GetAt(j)));
 			mModel.SetLinearCorrelMatrix(mCorrel);
 
 			// now we have to 'normalize' the parameter errors to chi square.
-			vError.Mul(fNorm);
-			mModel.SetLinearError(vError);
+			mParamError.Mul(fNorm);
+			mModel.SetLinearError(mParamError);
 
 			return true;
 		}
@@ -225,9 +264,17 @@ namespace MathFit
 		*/
 		CVector mB;
 		/**
-		* Contains the transposed A matrix
+		* Contains the normal matrix At*A and its decomposition.
+		*/
+		CDoubleMatrix mAtA;
+		/**
+		* Contains the vector At*b and the solution of the normal equations.
+		*/
+		CDoubleVector mAtB;
+		/**
+		* Contains the solution of the normal equations, converted to the precision of the fit data.
 		*/
-		CMatrix mTranspose;
+		CVector mLinearParam;
 	};
 }
 #endif
@@ -9,6 +9,7 @@
 
 #include <float.h>
 #include "Minimizer.h"
+#include "NormalEquations.h"
 
 #define STARTLAMBDA		0.01
 #define MINLAMBDA		1e-20
@@ -67,6 +68,7 @@ namespace MathFit
 				return false;
 
 			// prepare a lower border for the chi square
+			mCheckChiSquare = mMinChiSquare;
 			if(mCheckChiSquare < 0)
 				mCheckChiSquare = mChiSquare * mCHISQUAREMIN;
 			if(!_finite(mCheckChiSquare))
@@ -106,55 +108,91 @@ namespace MathFit
 			mAlpha.MulDiag(1 + mLambda);
 
 			// solve the linear equations
-#if defined(MATHFIT_USELUDECOMPOSITION)
-			mAlpha.LUDecomposition();
-			mAlpha.LUBacksubstitution(mBeta);
+			switch(mEquationSolver)
+			{
+			case CHOLESKY:
+				{
+					mAlpha.CholeskyDecomposition();
+					mAlpha.CholeskyBacksubstitution(mBeta);
 
 #if defined(MATHFIT_IMPROVEEQSSOLVE)
-			// we want to correct the numerical errors by applying
-			// the 'iterative solution improvement' as described in Numerical Recipes.
+					// we want to correct the numerical errors by applying
+					// the 'iterative solution improvement' as described in Numerical Recipes.
 
-			// Use the solution to calculate once again the result vector of the EQS
-			CVector vSolutionError(mBeta);
-			mAlphaOld.Mul(vSolutionError);
+					// Use the solution to calculate once again the result vector of the EQS
+					CDoubleVector vSolutionError(mBeta);
+					mAlphaOld.Mul(vSolutionError);
 
-			// subtract the old result vector from the one calculated using the EQS result
-			// (the result should be nearly zero at all)
-			vSolutionError.Sub(mBetaOld);
+					// subtract the old result vector from the one calculated using the EQS result
+					// (the result should be nearly zero at all)
+					vSolutionError.Sub(mBetaOld);
 
-			// solve the EQS once again but use the solution error as result vector
-			mAlpha.LUBacksubstitution(vSolutionError);
+					// solve the EQS once again but use the solution error as result vector
+					mAlpha.CholeskyBacksubstitution(vSolutionError);
 
-			// subtract the solution error from the original solution
-			mBeta.Sub(vSolutionError);
+					// subtract the solution error from the original solution
+					mBeta.Sub(vSolutionError);
 #endif
-#else
-			mAlpha.GaussJordanSolve(mBeta);
+				}
+				break;
+
+			case LUDECOMPOSITION:
+				{
+					mAlpha.LUDecomposition();
+					mAlpha.LUBacksubstitution(mBeta);
 
 #if defined(MATHFIT_IMPROVEEQSSOLVE)
-			// we want to correct the numerical errors by applying
-			// the 'iterative solution improvement' as described in Numerical Recipes.
+					// we want to correct the numerical errors by applying
+					// the 'iterative solution improvement' as described in Numerical Recipes.
 
-			// Use the solution to calculate once again the result vector of the EQS
-			CVector vSolutionError(mBeta);
-			mAlphaOld.Mul(vSolutionError);
+					// Use the solution to calculate once again the result vector of the EQS
+					CDoubleVector vSolutionError(mBeta);
+					mAlphaOld.Mul(vSolutionError);
 
-			// subtract the old result vector from the one calculated using the EQS result
-			// (the result should be nearly zero at all)
-			vSolutionError.Sub(mBetaOld);
+					// subtract the old result vector from the one calculated using the EQS result
+					// (the result should be nearly zero at all)
+					vSolutionError.Sub(mBetaOld);
 
-			// solve the EQS once again but use the solution error as result vector
-			CMatrix mBackupAlpha(mAlphaOld);
-			mBackupAlpha.GaussJordanSolve(vSolutionError);
+					// solve the EQS once again but use the solution error as result vector
+					mAlpha.LUBacksubstitution(vSolutionError);
 
-			// subtract the solution error from the original solution
-			mBeta.Sub(vSolutionError);
+					// subtract the solution error from the original solution
+					mBeta.Sub(vSolutionError);
 #endif
+				}
+				break;
+
+			default:
+				{
+					mAlpha.GaussJordanSolve(mBeta);
+
+#if defined(MATHFIT_IMPROVEEQSSOLVE)
+					// we want to correct the numerical errors by applying
+					// the 'iterative solution improvement' as described in Numerical Recipes.
+
+					// Use the solution to calculate once again the result vector of the EQS
+					CDoubleVector vSolutionError(mBeta);
+					mAlphaOld.Mul(vSolutionError);
+
+					// subtract the old result vector from the one calculated using the EQS result
+					// (the result should be nearly zero at all)
+					vSolutionError.Sub(mBetaOld);
+
+					// solve the EQS once again but use the solution error as result vector
+					CDoubleMatrix mBackupAlpha(mAlphaOld);
+					mBackupAlpha.GaussJordanSolve(vSolutionError);
+
+					// subtract the solution error from the original solution
+					mBeta.Sub(vSolutionError);
 #endif
+				}
+				break;
+			}
 
 			// set new parameter vector
 			mModel.BackupNonlinearParameter();
-			mModel.SetNonlinearParameter(mModel.GetNonlinearParameter().Add(mBeta));
+			mStep.Copy(mBeta);
+			mModel.SetNonlinearParameter(mModel.GetNonlinearParameter().Add(mStep));
 
 			// analyze new parameters
 			if(!Analyze())
@@ -174,7 +212,7 @@ namespace MathFit
 					mLambda /= 10;
 
 				// chi square doesn't differ to much anymore, so we're finished
-				TFitData fDiff = (mOldChiSquare - mChiSquare)/mChiSquare;
+				double fDiff = (mOldChiSquare - mChiSquare)/mChiSquare;
 				if(fDiff < mEPSILON)
 					return false;			
 			}
@@ -211,48 +249,57 @@ namespace MathFit
 			mModel.GetValues(mFitRange, mDiff);
 
 			// now calculate the chi square and variance values
-			CVector vErr(mFitRange.GetSize());
-			mModel.GetFunctionErrors(mFitRange, vErr);
+			mModel.GetFunctionErrors(mFitRange, mError);
 
 			// get the sum of squares weighted by the error vector
-			mChiSquare = mDiff.SquareSumErrorWeighted(vErr);
-			mChiSquare += mModel.GetNonlinearPenalty(mChiSquare);
+			mChiSquare = mDiff.SquareSumErrorWeighted(mError);
+			mChiSquare += mModel.GetNonlinearPenalty((TFitData)mChiSquare);
 
 			// calculate the normalization factor for all statistical values
 			TFitData fNorm = (TFitData)sqrt(mChiSquare / (mFitRange.GetSize() - iParams));
 
 			// inverse the alpha matrix
-#if defined(MATHFIT_USELUDECOMPOSITION)
-			if(!mAlpha.IsLUDecomposed())
-				mAlpha.LUDecomposition();
-			mAlpha.LUInverse();
-#else
-			mAlpha.Inverse();
-#endif
+			switch(mEquationSolver)
+			{
+			case CHOLESKY:
+				if(!mAlpha.IsCholeskyDecomposed())
+					mAlpha.CholeskyDecomposition();
+				mAlpha.CholeskyInverse();
+				break;
+
+			case LUDECOMPOSITION:
+				if(!mAlpha.IsLUDecomposed())
+					mAlpha.LUDecomposition();
+				mAlpha.LUInverse();
+				break;
+
+			default:
+				mAlpha.Inverse();
+				break;
+			}
 
 			// set the covariance matrix
-			CMatrix mCovar(iParams, iParams);
 			mCovar.Copy(mAlpha);
 			mModel.SetNonlinearCovarMatrix(mCovar);
 
 			// calculate the parameter errors
-			CVector vError(iParams);
+			mParamError.SetSize(iParams);
 			int i;
 			for(i = 0; i < iParams; i++)
-				vError.SetAt(i, (TFitData)sqrt(mCovar.GetAt(i, i)));
+				mParamError.SetAt(i, (TFitData)sqrt(mCovar.GetAt(i, i)));
 
 			// calculate the correlation matrix
-			CMatrix mCorrel(iParams, iParams);
+			mCorrel.SetSize(iParams, iParams);
 
 			int j;
 			for(i = 0; i < iParams; i++)
 				for(j = 0; j < iParams; j++)
-					mCorrel.SetAt(i, j, mCovar.GetAt(i, j) / (vError.GetAt(i) * vError.GetAt(j)));
+					mCorrel.SetAt(i, j, mCovar.GetAt(i, j) / (mParamError.GetAt(i) * mParamError.GetAt(j)));
 			mModel.SetNonlinearCorrelMatrix(mCorrel);
 
 			// now we have to 'normalize' the parameter errors to chi square.
-			vError.Mul(fNorm);
-			mModel.SetNonlinearError(vError);
+			mParamError.Mul(fNorm);
+			mModel.SetNonlinearError(mParamError);
 
 			return true;
 		}
@@ -264,58 +311,19 @@ namespace MathFit
 		*/
 		bool Analyze()
 		{
-			// get the first derivatives of the model function
-			mModel.GetNonlinearDyDa(mFitRange, mDyDa);
-
 			// setting mBeta, mAlpha to its proper size
 			const int iParamCount = mModel.GetNonlinearParameter().GetSize();
 			mBeta.SetSize(iParamCount);
 			mAlpha.SetSize(iParamCount, iParamCount);
 
-			// initialize to zero
-			mBeta.Zero();
-			mAlpha.Zero();
-
-			mChiSquare = 0;
-
-			int i,j,k;
+			int i,j;
 
+			// get the function values, their errors and the first derivatives of the model function in one pass
 			mDiff.SetSize(mFitRange.GetSize());
-			mModel.GetValues(mFitRange, mDiff);
-			CVector vError(mFitRange.GetSize());
-			mModel.GetFunctionErrors(mFitRange, vError);
-
-			// 1. LOOP
-			// =======
-			// summation over all data
-			const int iDiffSize = mDiff.GetSize();
-			for(i = 0; i < iDiffSize; i++)
-			{
-				// calculate the difference between the real y-values and the modelled y-values
-				TFitData fDifferenceInY = mDiff.GetAt(i) * mDiff.GetAt(i);
+			mModel.GetValuesErrorsAndDyDa(mFitRange, mDiff, mError, mDyDa);
 
-				TFitData fSigmaSquare = vError.GetAt(i) * vError.GetAt(i);
-
-				// chiSquare
-				mChiSquare += fDifferenceInY / fSigmaSquare;
-
-				// 2. LOOP
-				// =======
-				// summation over all parameters
-				for(j = 0; j < iParamCount; j++)
-				{
-					TFitData fWT = mDyDa.GetAt(i, j) / fSigmaSquare;
-
-					// calculating beta
-					mBeta.SetAt(j, mBeta.GetAt(j) + mDiff.GetAt(i) * fWT);
-
-					// 3. LOOP
-					// =======
-					// relevant only for alpha
-					for(k = 0; k <= j; k++)
-						mAlpha.SetAt(j, k, mAlpha.GetAt(j, k) + mDyDa.GetAt(i, k) * fWT);
-				} // end of second loop
-			} // end of first loop	 
+			// build the lower triangle of alpha, beta and the chi square in one pass over all data
+			mChiSquare = CNormalEquations::Build(mDyDa, mDiff, mError, mAlpha, mBeta);
 
 			// fill in the symmetric side of alpha and ensure that we do not have zeros on the diagonal. Otherwise
 			// the LEQ can't be solved!
@@ -329,7 +337,7 @@ namespace MathFit
 			}
 
 			// add the penalyt of the new parameters
-			mChiSquare += mModel.GetNonlinearPenalty(mChiSquare);
+			mChiSquare += mModel.GetNonlinearPenalty((TFitData)mChiSquare);
 
 			return true;
 		}
@@ -338,19 +346,23 @@ namespace MathFit
 		/**
 		* Contains the beta vector of the fit algorithm.
 		*/
-		CVector mBeta;
+		CDoubleVector mBeta;
 		/**
 		* Contains the old beta vector of the fit algorithm.
 		*/
-		CVector mBetaOld;
+		CDoubleVector mBetaOld;
 		/**
 		* Contains the alpha matrix of the algorithm.
 		*/
-		CMatrix mAlpha;
+		CDoubleMatrix mAlpha;
 		/**
 		* Contains the old alpha matrix of the algorithm.
 		*/
-		CMatrix mAlphaOld;
+		CDoubleMatrix mAlphaOld;
+		/**
+		* Contains the parameter step of the current loop, converted to the precision of the fit data.
+		*/
+		CVector mStep;
 		/**
 		* Contains the DyDa matrix of the model function.
 		*/
@@ -362,7 +374,7 @@ namespace MathFit
 		/**
 		* The ChiSquare value of the last loop.
 		*/
-		TFitData mOldChiSquare;
+		double mOldChiSquare;
 		/**
 		* The start value for the lambda parameter.
 		*/
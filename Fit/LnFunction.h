@@ -8,6 +8,7 @@
 #define LNFUNCTION_H_020201
 
 #include "ParamFunction.h"
+#include "VectorView.h"
 
 #if _MSC_VER > 1000
 #pragma once
@@ -153,7 +154,7 @@ namespace MathFit
 			MATHFIT_ASSERT((bFixedID && iParamID >= 0 && iParamID < mNonlinearParams.GetSize()) || (!bFixedID && iParamID >= 0 && iParamID < mNonlinearParams.GetAllSize()));
 
 			// get original function values
-			CVector vOrig(vXValues.GetSize());
+			CScratchVector vOrig(vXValues.GetSize());
 
 			mOperand.GetValues(vXValues, vOrig);
 
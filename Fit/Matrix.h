@@ -106,18 +106,21 @@ namespace MathFit
 
 	/**
 	* Basic methods for working with two dimensional matrices.
+	* The type of the matrix elements is given by the template parameter. Normally the matrices are used
+	* through the \Ref{CMatrix} type, which uses the \Ref{TFitData} elements of the fit.
 	*
 	* @author		\item \URL[Stefan Kraus]{http://stefan@00kraus.de} @ \URL[IWR, Image Processing Group]{http://klimt.iwr.uni-heidelberg.de}
 	* @author		\item \URL[Silke Humbert]{mailto:silke.humbert@iup.uni-heidelberg.de} @ \URL[IUP, Satellite Data Group]{http://giger.iup.uni-heidelberg.de}
 	* @version		1.0 @ 2001/09/09
 	*/
-	class CMatrix
+	template<class TData>
+	class CBasicMatrix
 	{
 	public:
 		/**
 		* Creates an empty matrix object.
 		*/
-		CMatrix()
+		CBasicMatrix()
 		{
 			mRows = nullptr;
 			mCols = nullptr;
@@ -129,6 +132,7 @@ namespace MathFit
 			mDoublePtr = nullptr;
 			mFloatPtr = nullptr;
 			mLUIndex = nullptr;
+			mSymDecomposition = NODECOMPOSITION;
 		}
 
 		/**
@@ -136,7 +140,7 @@ namespace MathFit
 		*
 		* @param mRight	The originating matrix object.
 		*/
-		CMatrix(const CMatrix &mRight)
+		CBasicMatrix(const CBasicMatrix &mRight)
 		{
 			mRows = nullptr;
 			mCols = nullptr;
@@ -148,6 +152,7 @@ namespace MathFit
 			mDoublePtr = nullptr;
 			mFloatPtr = nullptr;
 			mLUIndex = nullptr;
+			mSymDecomposition = NODECOMPOSITION;
 
 			Copy(mRight);
 		}
@@ -158,7 +163,7 @@ namespace MathFit
 		* @param iCols		The number of columns in the matrix.
 		* @param iRows		The number of rows in the matrix.
 		*/
-		CMatrix(int iCols, int iRows)
+		CBasicMatrix(int iCols, int iRows)
 		{
 			mRows = nullptr;
 			mCols = nullptr;
@@ -170,6 +175,7 @@ namespace MathFit
 			mDoublePtr = nullptr;
 			mFloatPtr = nullptr;
 			mLUIndex = nullptr;
+			mSymDecomposition = NODECOMPOSITION;
 
 			SetSize(iCols, iRows);
 		}
@@ -183,7 +189,7 @@ namespace MathFit
 		* @param iCols		The number of columns in the submatrix.
 		* @param iRows		The number of rows in the submatrix.
 		*/
-		CMatrix(CMatrix& mSecond, int iStartCol, int iStartRow, int iCols, int iRows)
+		CBasicMatrix(CBasicMatrix& mSecond, int iStartCol, int iStartRow, int iCols, int iRows)
 		{
 			MATHFIT_ASSERT((iStartCol + iCols) <= mSecond.GetNoColumns() && (iStartRow + iCols) <= mSecond.GetNoRows());
 			MATHFIT_ASSERT(iCols > 0 && iRows > 0);
@@ -191,10 +197,13 @@ namespace MathFit
 			mDoublePtr = nullptr;
 			mFloatPtr = nullptr;
 			mLUIndex = nullptr;
+			mSymDecomposition = NODECOMPOSITION;
 
 			// create new vector array
-			mRows = new CVector[iRows];
-			mCols = new CVector[iCols];
+			mRows = new CBasicVector<TData>[iRows];
+			CAllocationCounter::Add();
+			mCols = new CBasicVector<TData>[iCols];
+			CAllocationCounter::Add();
 
 			// get the subvector objects and attach them to our objects
 			int i;
@@ -215,14 +224,14 @@ namespace MathFit
 		/**
 		* Frees and allocated resources.
 		*/
-		~CMatrix()
+		~CBasicMatrix()
 		{
 			if(mRows)
 				delete[] mRows;
 			if(mCols)
 				delete[] mCols;
 			if(mData && mAutoRelease)
-				delete mData;
+				CVectorKernels::Free(mData);
 			if(mLUIndex && mAutoRelease)
 				delete mLUIndex;
 
@@ -237,27 +246,30 @@ namespace MathFit
 		*
 		* @return A reference to the current object.
 		*/
-		CMatrix& Copy(const CMatrix& mOperand)
+		CBasicMatrix& Copy(const CBasicMatrix& mOperand)
 		{
 			ClearLUDecomposed();
+			ClearCholeskyDecomposed();
 
 			SetSize(mOperand.GetNoColumns(), mOperand.GetNoRows());
 
 			if(mSizeX <= 0 || mSizeY <= 0)
 				return *this;
 
-			memcpy(GetSafePtr(), mOperand.GetSafePtr(), sizeof(TFitData) * mSizeX * mSizeY);
+			memcpy(GetSafePtr(), mOperand.GetSafePtr(), sizeof(TData) * mSizeX * mSizeY);
 			if(mOperand.IsLUDecomposed())
 			{
 				// okay. we also need to copy the LU index
 				mLUIndex = new int[GetNoColumns()];
+				CAllocationCounter::Add();
 				memcpy(mLUIndex, mOperand.mLUIndex, sizeof(int) * GetNoColumns());
 			}
+			mSymDecomposition = mOperand.mSymDecomposition;
 
 			return *this;
 		}
 
-		CMatrix& Copy(TFitData* fData, int iRows, int iCols, bool bRowmajor = true)
+		CBasicMatrix& Copy(TData* fData, int iRows, int iCols, bool bRowmajor = true)
 		{
 			SetSize(iCols, iRows);
 
@@ -267,7 +279,7 @@ namespace MathFit
 #if defined(ROWMATRIX)
 			// check wheter the matrix is in rowmajor style
 			if(bRowmajor)
-				memcpy(GetSafePtr(), fData, sizeof(TFitData) * mSizeX * mSizeY);
+				memcpy(GetSafePtr(), fData, sizeof(TData) * mSizeX * mSizeY);
 			else
 			{
 				// we use columnmajor style, so we have to copy element by element
@@ -279,7 +291,7 @@ namespace MathFit
 #else
 			// the default matrix style is columnmajor here
 			if(!bRowmajor)
-				memcpy(GetSafePtr(), fData, sizeof(TFitData) * mSizeX * mSizeY);
+				memcpy(GetSafePtr(), fData, sizeof(TData) * mSizeX * mSizeY);
 			else
 			{
 				int i, j;
@@ -292,31 +304,53 @@ namespace MathFit
 			return *this;
 		}
 
-#if defined(MATHFIT_FITDATAFLOAT)
-		CMatrix& Copy(double* fData, int iRows, int iCols)
+		/**
+		* Copies a rowmajor array of a different element type into the current object.
+		* Every element is converted to the element type of the matrix.
+		*
+		* @param fData		The array containing the matrix elements.
+		* @param iRows		The number of rows.
+		* @param iCols		The number of columns.
+		*
+		* @return A reference to the current object.
+		*/
+		template<class TOther>
+		CBasicMatrix& Copy(TOther* fData, int iRows, int iCols)
 		{
 			SetSize(iCols, iRows);
 
 			int i, j;
 			for(i = 0; i < iRows; i++)
 				for(j = 0; j < iCols; j++)
-					SetAt(i, j, (TFitData)fData[i * iCols + j]);
+					SetAt(i, j, (TData)fData[i * iCols + j]);
 
 			return *this;
 		}
-#else
-		CMatrix& Copy(float* fData, int iRows, int iCols)
+
+		/**
+		* Copies the content of a matrix of a different element type into the current object.
+		* Every element is converted to the element type of the current matrix. A decomposition of the
+		* originating matrix is not copied.
+		*
+		* @param mOperand	The originating matrix object.
+		*
+		* @return A reference to the current object.
+		*/
+		template<class TOther>
+		CBasicMatrix& Copy(const CBasicMatrix<TOther>& mOperand)
 		{
-			SetSize(iCols, iRows);
+			ClearLUDecomposed();
+			ClearCholeskyDecomposed();
+
+			SetSize(mOperand.GetNoColumns(), mOperand.GetNoRows());
 
 			int i, j;
-			for(i = 0; i < iRows; i++)
-				for(j = 0; j < iCols; j++)
-					SetAt(i, j, (TFitData)fData[i * iCols + j]);
+			for(i = 0; i < mSizeY; i++)
+				for(j = 0; j < mSizeX; j++)
+					SetAt(i, j, (TData)mOperand.GetAt(i, j));
 
 			return *this;
 		}
-#endif
 
 		/**
 		* Attaches the content of another CVector object to the current one
@@ -326,7 +360,7 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CMatrix& Attach(CMatrix& mSecond, bool bAutoRelease = true)
+		CBasicMatrix& Attach(CBasicMatrix& mSecond, bool bAutoRelease = true)
 		{
 			// first clear the old data
 			if(mRows)
@@ -334,7 +368,7 @@ namespace MathFit
 			if(mCols)
 				delete[] mCols;
 			if(mData && mAutoRelease)
-				delete mData;
+				CVectorKernels::Free(mData);
 			if(mLUIndex && mAutoRelease)
 				delete mLUIndex;
 
@@ -343,6 +377,7 @@ namespace MathFit
 			mCols = mSecond.mCols;
 			mData = mSecond.mData;
 			mLUIndex = mSecond.mLUIndex;
+			mSymDecomposition = mSecond.mSymDecomposition;
 			mSizeX = mSecond.mSizeX;
 			mSizeY = mSecond.mSizeY;
 			mLineOffset = mSecond.mLineOffset;
@@ -362,11 +397,12 @@ namespace MathFit
 		* Attaches the content of another CVector object to the current one
 		*
 		* @param mSecond		The originating object.
-		* @param bAutoRelease	If TRUE the matrix data is freed on destructuion.
+		* @param bAutoRelease	If TRUE the matrix data is freed on destructuion. The data must then
+		*						have been allocated by \Ref{CVectorKernels::Allocate}.
 		*
 		* @return	A reference to the current object.
 		*/
-		CMatrix& Attach(TFitData* fData, int iRows, int iCols, bool bAutoRelease = true)
+		CBasicMatrix& Attach(TData* fData, int iRows, int iCols, bool bAutoRelease = true)
 		{
 			// first clear the old data
 			if(mRows)
@@ -374,10 +410,11 @@ namespace MathFit
 			if(mCols)
 				delete[] mCols;
 			if(mData && mAutoRelease)
-				delete mData;
+				CVectorKernels::Free(mData);
 			if(mLUIndex && mAutoRelease)
 				delete mLUIndex;
 			mLUIndex = nullptr;
+			mSymDecomposition = NODECOMPOSITION;
 
 			// get the data pointer
 			mData = fData;
@@ -385,8 +422,10 @@ namespace MathFit
 			mSizeY = iRows;
 			mAutoRelease = bAutoRelease;
 
-			mRows = new CVector[mSizeY];
-			mCols = new CVector[mSizeX];
+			mRows = new CBasicVector<TData>[mSizeY];
+			CAllocationCounter::Add();
+			mCols = new CBasicVector<TData>[mSizeX];
+			CAllocationCounter::Add();
 
 #if defined(ROWMATRIX)
 			mLineOffset = mSizeX;
@@ -415,7 +454,7 @@ namespace MathFit
 		*
 		* @return	A reference to the current object
 		*/
-		CMatrix& Detach()
+		CBasicMatrix& Detach()
 		{
 			mRows = nullptr;
 			mCols = nullptr;
@@ -423,6 +462,7 @@ namespace MathFit
 			mLineOffset = 0;
 			mData = nullptr;
 			mLUIndex = nullptr;
+			mSymDecomposition = NODECOMPOSITION;
 			mAutoRelease = true;
 
 			ReleaseDoublePtr();
@@ -444,9 +484,9 @@ namespace MathFit
 		*
 		* @return	A matrix object representing a submatrix of the given matrix
 		*/
-		CMatrix SubMatrix(int iStartCol, int iStartRow, int iCols, int iRows)
+		CBasicMatrix SubMatrix(int iStartCol, int iStartRow, int iCols, int iRows)
 		{
-			return CMatrix(*this, iStartCol, iStartRow, iCols, iRows);
+			return CBasicMatrix(*this, iStartCol, iStartRow, iCols, iRows);
 		}
 
 		/**
@@ -456,15 +496,16 @@ namespace MathFit
 		*
 		* @return	A reference to the current object
 		*/
-		CMatrix& Exchange(CMatrix& mSecond)
+		CBasicMatrix& Exchange(CBasicMatrix& mSecond)
 		{
 			int iSizeX = mSecond.mSizeX;
 			int iSizeY = mSecond.mSizeY;
 			int iLineOffset = mSecond.mLineOffset;
-			CVector* vRows = mSecond.mRows;
-			CVector* vCols = mSecond.mCols;
-			TFitData* fData = mSecond.mData;
+			CBasicVector<TData>* vRows = mSecond.mRows;
+			CBasicVector<TData>* vCols = mSecond.mCols;
+			TData* fData = mSecond.mData;
 			int* iLUIndex = mSecond.mLUIndex;
+			ESymmetricDecomposition eSymDecomposition = mSecond.mSymDecomposition;
 			bool bAutoRelease = mSecond.mAutoRelease;
 			double* fDoublePtr = mSecond.mDoublePtr;
 			float* fFloatPtr = mSecond.mFloatPtr;
@@ -476,6 +517,7 @@ namespace MathFit
 			mSecond.mCols = mCols;
 			mSecond.mData = mData;
 			mSecond.mLUIndex = mLUIndex;
+			mSecond.mSymDecomposition = mSymDecomposition;
 			mSecond.mAutoRelease = mAutoRelease;
 			mSecond.mDoublePtr = mDoublePtr;
 			mSecond.mFloatPtr = mFloatPtr;
@@ -487,6 +529,7 @@ namespace MathFit
 			mCols = vCols;
 			mData = fData;
 			mLUIndex = iLUIndex;
+			mSymDecomposition = eSymDecomposition;
 			mAutoRelease = bAutoRelease;
 			mDoublePtr = fDoublePtr;
 			mFloatPtr = fFloatPtr;
@@ -502,13 +545,13 @@ namespace MathFit
 		* 
 		* @return	A reference to the current object.
 		*/
-		CMatrix& ExchangeRows(int iFirst, int iSec)
+		CBasicMatrix& ExchangeRows(int iFirst, int iSec)
 		{
 			// we need to physically copy the data. otherwise we get in trouble with some indicies
-			CVector& vFirst = GetRow(iFirst);
-			CVector& vSec = GetRow(iSec);
+			CBasicVector<TData>& vFirst = GetRow(iFirst);
+			CBasicVector<TData>& vSec = GetRow(iSec);
 
-			CVector vTemp(vFirst);
+			CBasicVector<TData> vTemp(vFirst);
 
 			vFirst.Copy(vSec);
 
@@ -525,13 +568,13 @@ namespace MathFit
 		* 
 		* @return	A reference to the current object.
 		*/
-		CMatrix& ExchangeCols(int iFirst, int iSec)
+		CBasicMatrix& ExchangeCols(int iFirst, int iSec)
 		{
 			// we need to physically copy the data. otherwise we get in trouble with some indicies
-			CVector& vFirst = GetCol(iFirst);
-			CVector& vSec = GetCol(iSec);
+			CBasicVector<TData>& vFirst = GetCol(iFirst);
+			CBasicVector<TData>& vSec = GetCol(iSec);
 
-			CVector vTemp(vFirst);
+			CBasicVector<TData> vTemp(vFirst);
 
 			vFirst.Copy(vSec);
 
@@ -547,14 +590,14 @@ namespace MathFit
 		*
 		* @return	A reference to the selected row vector.
 		*/
-		CVector& GetRow(const int iRow) const
+		CBasicVector<TData>& GetRow(const int iRow) const
 		{
 			MATHFIT_ASSERT(iRow >= 0 && iRow < mSizeY);
 
 			return mRows[iRow];
 		}
 
-		CVector& GetCol(const int iCol) const
+		CBasicVector<TData>& GetCol(const int iCol) const
 		{
 			MATHFIT_ASSERT(iCol >= 0 && iCol < mSizeX);
 
@@ -569,7 +612,7 @@ namespace MathFit
 		*
 		* @return	The selected matrix element.
 		*/
-		TFitData GetAt(const int iRow, const int iCol) const
+		TData GetAt(const int iRow, const int iCol) const
 		{
 			MATHFIT_ASSERT(iRow >= 0 && iRow < mSizeY && iCol >= 0 && iCol < mSizeX);
 
@@ -580,7 +623,7 @@ namespace MathFit
 #endif
 		}
 
-		TFitData GetAtSafe(int iRow, int iCol) const
+		TData GetAtSafe(int iRow, int iCol) const
 		{
 			if(iRow < 0)
 				iRow = 0;
@@ -607,7 +650,7 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CMatrix& SetRow(int iRow, CVector& vRow)
+		CBasicMatrix& SetRow(int iRow, CBasicVector<TData>& vRow)
 		{
 			MATHFIT_ASSERT(iRow >= 0 && iRow < mSizeY);
 
@@ -616,7 +659,7 @@ namespace MathFit
 			return *this;
 		}
 
-		CMatrix& SetCol(int iCol, CVector& vCol)
+		CBasicMatrix& SetCol(int iCol, CBasicVector<TData>& vCol)
 		{
 			MATHFIT_ASSERT(iCol >= 0 && iCol < mSizeX);
 
@@ -634,7 +677,7 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CMatrix& SetAt(int iRow, int iCol, TFitData fData)
+		CBasicMatrix& SetAt(int iRow, int iCol, TData fData)
 		{
 			MATHFIT_ASSERT(iRow >= 0 && iRow < mSizeY && iCol >= 0 && iCol < mSizeX);
 
@@ -681,6 +724,7 @@ namespace MathFit
 			if(iYSize != mSizeY || iXSize != mSizeX || !mData)
 			{
 				ClearLUDecomposed();
+				ClearCholeskyDecomposed();
 
 				if(mRows)
 					delete[] mRows;
@@ -689,7 +733,7 @@ namespace MathFit
 					delete[] mCols;
 				mCols = nullptr;
 				if(mData && mAutoRelease)
-					delete mData;
+					CVectorKernels::Free(mData);
 				mData = nullptr;
 
 				mSizeY = iYSize;
@@ -698,9 +742,12 @@ namespace MathFit
 				if(mSizeX <= 0 || mSizeY <= 0)
 					return;
 
-				mRows = new CVector[iYSize];
-				mCols = new CVector[iXSize];
-				mData = new TFitData[iXSize * iYSize];
+				mRows = new CBasicVector<TData>[iYSize];
+				CAllocationCounter::Add();
+				mCols = new CBasicVector<TData>[iXSize];
+				CAllocationCounter::Add();
+				mData = CVectorKernels::Allocate<TData>(iXSize * iYSize);
+				CAllocationCounter::Add();
 
 #if defined(ROWMATRIX)
 				mLineOffset = mSizeX;
@@ -727,7 +774,7 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CMatrix& Idendity()
+		CBasicMatrix& Idendity()
 		{
 			Zero();
 
@@ -749,9 +796,9 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CMatrix& Wedge(TFitData fStart, TFitData fColSlope, TFitData fRowSlope)
+		CBasicMatrix& Wedge(TData fStart, TData fColSlope, TData fRowSlope)
 		{
-			TFitData fVal = fStart;
+			TData fVal = fStart;
 
 			int i;
 			for(i = 0; i < mSizeY; i++, fVal += fRowSlope)
@@ -767,7 +814,7 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CMatrix& Add(CMatrix& mOperant)
+		CBasicMatrix& Add(CBasicMatrix& mOperant)
 		{
 			MATHFIT_ASSERT(mSizeY == mOperant.GetNoRows() && mSizeX == mOperant.GetNoColumns());
 
@@ -785,7 +832,7 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CMatrix& Sub(CMatrix& mOperant)
+		CBasicMatrix& Sub(CBasicMatrix& mOperant)
 		{
 			MATHFIT_ASSERT(mSizeY == mOperant.GetNoRows() && mSizeX == mOperant.GetNoColumns());
 
@@ -803,18 +850,18 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CMatrix& Mul(CMatrix& mOperant)
+		CBasicMatrix& Mul(CBasicMatrix& mOperant)
 		{
 			MATHFIT_ASSERT(mSizeY == mOperant.GetNoColumns() && mSizeX == mOperant.GetNoRows());
 
-			CMatrix mRes(mSizeY, mSizeY);
+			CBasicMatrix mRes(mSizeY, mSizeY);
 
 			int i, j;
 			for(i = 0; i < mSizeY; i++)
 				for(j = 0; j < mSizeY; j++)
 				{
 					int k;
-					TFitData fSum = 0;
+					TData fSum = 0;
 					for(k = 0; k < mSizeX; k++)
 						fSum += GetAt(i, k) * mOperant.GetAt(k, j);
 					mRes.SetAt(i, j, fSum);
@@ -834,16 +881,16 @@ namespace MathFit
 		*
 		* @return	A reference to the given vector object, that will contain the result.
 		*/
-		CVector& Mul(CVector& mOperant)
+		CBasicVector<TData>& Mul(CBasicVector<TData>& mOperant)
 		{
 			MATHFIT_ASSERT(mSizeX == mOperant.GetSize());
 
-			CVector vTemp(mSizeY);
+			CBasicVector<TData> vTemp(mSizeY);
 
 			int i, j;
 			for(i = 0; i < mSizeY; i++)
 			{
-				TFitData fSum = 0;
+				TData fSum = 0;
 				for(j = 0; j < mSizeX; j++)
 					fSum += GetAt(i, j) * mOperant.GetAt(j);
 				vTemp.SetAt(i, fSum);
@@ -862,9 +909,9 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CMatrix& Div(CMatrix& mOperant)
+		CBasicMatrix& Div(CBasicMatrix& mOperant)
 		{
-			CMatrix mTemp(mOperant);
+			CBasicMatrix mTemp(mOperant);
 			mTemp.Inverse();
 			return Mul(mTemp);
 		}
@@ -876,7 +923,7 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CMatrix& Add(TFitData fOperant)
+		CBasicMatrix& Add(TData fOperant)
 		{
 			int i;
 			for(i = 0; i < mSizeY; i++)
@@ -892,7 +939,7 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CMatrix& Sub(TFitData fOperant)
+		CBasicMatrix& Sub(TData fOperant)
 		{
 			int i;
 			for(i = 0; i < mSizeY; i++)
@@ -908,7 +955,7 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CMatrix& Mul(TFitData fOperant)
+		CBasicMatrix& Mul(TData fOperant)
 		{
 			int i;
 			for(i = 0; i < mSizeY; i++)
@@ -924,7 +971,7 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CMatrix& Div(TFitData fOperant)
+		CBasicMatrix& Div(TData fOperant)
 		{
 			int i;
 			for(i = 0; i < mSizeY; i++)
@@ -941,7 +988,7 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CMatrix& Add(CMatrix& mOperant, TFitData fFactor)
+		CBasicMatrix& Add(CBasicMatrix& mOperant, TData fFactor)
 		{
 			MATHFIT_ASSERT(mSizeY == mOperant.GetNoRows() && mSizeX == mOperant.GetNoColumns());
 
@@ -960,7 +1007,7 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CMatrix& Sub(CMatrix& mOperant, TFitData fFactor)
+		CBasicMatrix& Sub(CBasicMatrix& mOperant, TData fFactor)
 		{
 			MATHFIT_ASSERT(mSizeY == mOperant.GetNoRows() && mSizeX == mOperant.GetNoColumns());
 
@@ -978,7 +1025,7 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CMatrix& AddDiag(const CVector& vSec)
+		CBasicMatrix& AddDiag(const CBasicVector<TData>& vSec)
 		{
 			const int iSecSize = vSec.GetSize();
 
@@ -998,7 +1045,7 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CMatrix& SubDiag(const CVector& vSec)
+		CBasicMatrix& SubDiag(const CBasicVector<TData>& vSec)
 		{
 			const int iSecSize = vSec.GetSize();
 
@@ -1018,7 +1065,7 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CMatrix& MulDiag(const CVector& vSec)
+		CBasicMatrix& MulDiag(const CBasicVector<TData>& vSec)
 		{
 			const int iSecSize = vSec.GetSize();
 
@@ -1038,7 +1085,7 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CMatrix& DivDiag(const CVector& vSec)
+		CBasicMatrix& DivDiag(const CBasicVector<TData>& vSec)
 		{
 			const int iSecSize = vSec.GetSize();
 
@@ -1058,7 +1105,7 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CMatrix& AddDiag(const TFitData fSec)
+		CBasicMatrix& AddDiag(const TData fSec)
 		{
 			// matrix needs to be square
 			MATHFIT_ASSERT(mSizeX == mSizeY);
@@ -1077,7 +1124,7 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CMatrix& SubDiag(const TFitData fSec)
+		CBasicMatrix& SubDiag(const TData fSec)
 		{
 			MATHFIT_ASSERT(mSizeX == mSizeY);
 
@@ -1095,7 +1142,7 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CMatrix& MulDiag(const TFitData fSec)
+		CBasicMatrix& MulDiag(const TData fSec)
 		{
 			MATHFIT_ASSERT(mSizeX == mSizeY);
 
@@ -1113,7 +1160,7 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CMatrix& DivDiag(const TFitData fSec)
+		CBasicMatrix& DivDiag(const TData fSec)
 		{
 			MATHFIT_ASSERT(mSizeX == mSizeY);
 
@@ -1141,7 +1188,7 @@ namespace MathFit
 		* @exception CMatrixSolveFailed 
 		* @exception CMatrixNotSquare
 		*/
-		CMatrix& GaussJordanSolve(CMatrix& mBeta)
+		CBasicMatrix& GaussJordanSolve(CBasicMatrix& mBeta)
 		{
 			const int iCols = GetNoColumns();
 			const int iRows = GetNoRows();
@@ -1162,7 +1209,7 @@ namespace MathFit
 			{
 				// find pivot
 				iR = iC = i;
-				TFitData fMag = 0;
+				TData fMag = 0;
 				for(j = 0; j < iRows; j++)
 				{
 					if(iPivotDone[j] != 1)
@@ -1174,7 +1221,7 @@ namespace MathFit
 							{
 								if(fabs(GetAt(j, k)) >= fMag)
 								{
-									fMag = (TFitData)fabs(GetAt(j, k));
+									fMag = (TData)fabs(GetAt(j, k));
 									iR = j;
 									iC = k;
 								}
@@ -1223,7 +1270,7 @@ namespace MathFit
 						continue;
 
 					// get factor to eliminate pivot column
-					TFitData fMag2 = GetAt(i2, iC);
+					TData fMag2 = GetAt(i2, iC);
 					SetAt(i2, iC, 0);
 					GetRow(i2).Sub(GetRow(iC), fMag2);
 					mBeta.GetRow(i2).Sub(mBeta.GetRow(iC), fMag2);
@@ -1253,12 +1300,12 @@ namespace MathFit
 		* @exception CVectorSizeMismatch
 		* @exception CMatrixSolveFailed
 		*/
-		CVector& GaussJordanSolve(CVector& vBeta)
+		CBasicVector<TData>& GaussJordanSolve(CBasicVector<TData>& vBeta)
 		{
 			MATHFIT_ASSERT(vBeta.GetStepSize() == 1);
 
 			// attach the vector to a matrix object with just a single column
-			CMatrix mBeta; 
+			CBasicMatrix mBeta; 
 			mBeta.Attach(vBeta.GetSafePtr(), vBeta.GetSize(), 1, false);
 
 			// die geschichte lsen lassen
@@ -1272,11 +1319,11 @@ namespace MathFit
 		*
 		* @return The inverted matrix.
 		*/
-		CMatrix& Inverse()
+		CBasicMatrix& Inverse()
 		{
 			MATHFIT_ASSERT(mSizeX == mSizeY);
 
-			CMatrix mResult;
+			CBasicMatrix mResult;
 
 			// create idendity matrix
 			mResult.SetSize(1, mSizeY);
@@ -1292,11 +1339,12 @@ namespace MathFit
 		*
 		* @return The cleared matrix.
 		*/
-		CMatrix& Zero()
+		CBasicMatrix& Zero()
 		{
 			MATHFIT_ASSERT(mData != nullptr);
 
 			ClearLUDecomposed();
+			ClearCholeskyDecomposed();
 
 #if defined(ROWMATRIX)
 			int i;
@@ -1331,9 +1379,9 @@ namespace MathFit
 		*
 		* @return The transposed matrix.
 		*/
-		CMatrix& Transpose()
+		CBasicMatrix& Transpose()
 		{
-			CMatrix mNew(mSizeY, mSizeX);
+			CBasicMatrix mNew(mSizeY, mSizeX);
 
 			int iRow, iCol;
 			for(iRow = 0; iRow < mSizeY; iRow++)
@@ -1353,9 +1401,9 @@ namespace MathFit
 		*
 		* @return The transposed matrix.
 		*/
-		CMatrix& PseudoInverse()
+		CBasicMatrix& PseudoInverse()
 		{
-			CMatrix mNew(mSizeX, mSizeX);
+			CBasicMatrix mNew(mSizeX, mSizeX);
 
 			// fill in the upper diagonal matrix
 
@@ -1363,7 +1411,7 @@ namespace MathFit
 			for(iRow = 0; iRow < mSizeX; iRow++)
 				for(iCol = iRow; iCol < mSizeX; iCol++)
 				{
-					TFitData fSum = 0;
+					TData fSum = 0;
 					int k;
 					for(k = 0; k < mSizeY; k++)
 						fSum += GetAt(k, iRow) * GetAt(k, iCol);
@@ -1386,26 +1434,29 @@ namespace MathFit
 		*
 		* @return A matrix that is composed of a lower and an upper triangular matrix
 		*/
-		CMatrix& LUDecomposition()
+		CBasicMatrix& LUDecomposition()
 		{
 			if(GetNoColumns() != GetNoRows())
 				throw(EXCEPTION(CMatrixNotSquareException));
 
 			int i, iMax, j, k;
 			int iN = GetNoColumns();
-			TFitData fBig, fDum, fSum, fTemp;	
+			TData fBig, fDum, fSum, fTemp;	
+
+			ClearCholeskyDecomposed();
 
 			if(mLUIndex && mAutoRelease)
 				delete mLUIndex;
 			mLUIndex = new int[iN];
-			CVector vV(iN);
+			CAllocationCounter::Add();
+			CBasicVector<TData> vV(iN);
 
 			iMax = 0;
 			for(i = 0; i < iN; i++)
 			{
 				fBig = 0.0;
 				for(j = 0; j < iN; j++)
-					if((fTemp = (TFitData)fabs(GetAt(j, i))) > fBig) 
+					if((fTemp = (TData)fabs(GetAt(j, i))) > fBig) 
 						fBig = fTemp;
 				if(fBig == 0.0)
 				{
@@ -1415,7 +1466,7 @@ namespace MathFit
 				}
 
 				// No nonzero largest element
-				vV.SetAt(i, (TFitData)1.0 / fBig);
+				vV.SetAt(i, (TData)1.0 / fBig);
 			}
 
 			for(j = 0; j < iN; j++)
@@ -1435,7 +1486,7 @@ namespace MathFit
 					for(k = 0; k < j; k++) 
 						fSum -= GetAt(i, k) * GetAt(k, j);
 					SetAt(i, j, fSum);
-					if((fDum = vV.GetAt(i) * (TFitData)fabs(fSum)) >= fBig)
+					if((fDum = vV.GetAt(i) * (TData)fabs(fSum)) >= fBig)
 					{
 						fBig = fDum;
 						iMax = i;
@@ -1460,7 +1511,7 @@ namespace MathFit
 
 				if(j != iN - 1)
 				{
-					fDum = (TFitData)1.0 / GetAt(j, j);
+					fDum = (TData)1.0 / GetAt(j, j);
 					for(i = j + 1; i < iN; i++) 
 						SetAt(i, j, GetAt(i, j) * fDum);
 				}
@@ -1478,7 +1529,7 @@ namespace MathFit
 		*
 		* @return Returns the solution vector.
 		*/
-		CVector& LUBacksubstitution(CVector& vResult)
+		CBasicVector<TData>& LUBacksubstitution(CBasicVector<TData>& vResult)
 		{
 			MATHFIT_ASSERT(IsLUDecomposed());
 
@@ -1486,7 +1537,7 @@ namespace MathFit
 			int i, j;
 			int iP;
 			int iI;
-			TFitData fSum;
+			TData fSum;
 
 			// decrement n to keep original structure of program
 			iI = -1;
@@ -1524,14 +1575,14 @@ namespace MathFit
 		*
 		* @return A reference to the current matrix object that now holds the inverse.
 		*/
-		CMatrix& LUInverse()
+		CBasicMatrix& LUInverse()
 		{
 			MATHFIT_ASSERT(IsLUDecomposed());
 
 			int iN, j;
 			iN = GetNoColumns();
 
-			CMatrix mResult(iN, iN);
+			CBasicMatrix mResult(iN, iN);
 			mResult.Zero();
 
 			for(j = 0; j < iN; j++)
@@ -1545,11 +1596,179 @@ namespace MathFit
 			return *this;
 		}
 
+		/**
+		* Decomposes the symmetric matrix in place using the Cholesky decomposition.
+		*
+		* The factorization is calculated square root free as L*D*L^T, reading the original matrix
+		* elements from the upper triangle only. If all pivots D are positive (the matrix is positive definite), 
+		* the factor is scaled to the Cholesky factor L*L^T, which is stored in the lower triangle including the diagonal.
+		* Otherwise the matrix is (nearly) singular and the L*D*L^T factorization is kept as fallback. In this case
+		* the lower triangle holds the unit triangular matrix L and the diagonal holds D. Zero pivots are
+		* replaced by MATHFIT_NEARLYZERO, as it is done by \Ref{LUDecomposition}.
+		*
+		* The upper triangle is not altered, no additional memory is needed.
+		*
+		* @return A reference to the current object that now holds the decomposed matrix.
+		*
+		* @exception CMatrixNotSquareException
+		*/
+		CBasicMatrix& CholeskyDecomposition()
+		{
+			if(GetNoColumns() != GetNoRows())
+				throw(EXCEPTION(CMatrixNotSquareException));
+
+			ClearLUDecomposed();
+
+			const int iN = GetNoColumns();
+			bool bPositiveDefinite = true;
+
+			int i, j, k;
+			for(j = 0; j < iN; j++)
+			{
+				// calculate the pivot d_j = a_jj - sum(l_jk^2 * d_k)
+				TData fPivot = GetAt(j, j);
+				for(k = 0; k < j; k++)
+					fPivot -= GetAt(j, k) * GetAt(j, k) * GetAt(k, k);
+
+				if(fPivot <= 0)
+					bPositiveDefinite = false;
+				if(fPivot == 0)
+					fPivot = MATHFIT_NEARLYZERO;
+				SetAt(j, j, fPivot);
+
+				// calculate column j of L: l_ij = (a_ij - sum(l_ik * d_k * l_jk)) / d_j
+				for(i = j + 1; i < iN; i++)
+				{
+					TData fSum = GetAt(j, i);
+					for(k = 0; k < j; k++)
+						fSum -= GetAt(i, k) * GetAt(k, k) * GetAt(j, k);
+					SetAt(i, j, fSum / fPivot);
+				}
+			}
+
+			if(bPositiveDefinite)
+			{
+				// scale to the Cholesky factor L * sqrt(D)
+				for(j = 0; j < iN; j++)
+				{
+					const TData fRoot = (TData)sqrt(GetAt(j, j));
+					SetAt(j, j, fRoot);
+					for(i = j + 1; i < iN; i++)
+						SetAt(i, j, GetAt(i, j) * fRoot);
+				}
+				mSymDecomposition = CHOLESKYDECOMPOSITION;
+			}
+			else
+				mSymDecomposition = LDLDECOMPOSITION;
+
+			return *this;
+		}
+
+		/**
+		* Solves the linear equation.
+		* Given the decomposed matrix returned by CholeskyDecomposition the linear equation system is solved. 
+		*
+		* @param vResult right-hand side vector, which receives the solution.
+		*
+		* @return Returns the solution vector.
+		*/
+		CBasicVector<TData>& CholeskyBacksubstitution(CBasicVector<TData>& vResult)
+		{
+			MATHFIT_ASSERT(IsCholeskyDecomposed());
+			MATHFIT_ASSERT(vResult.GetSize() == GetNoColumns());
+
+			const int iN = GetNoColumns();
+			const bool bCholesky = (mSymDecomposition == CHOLESKYDECOMPOSITION);
+			int i, k;
+			TData fSum;
+
+			// forward substitution L*y = b
+			for(i = 0; i < iN; i++)
+			{
+				fSum = vResult.GetAt(i);
+				for(k = 0; k < i; k++)
+					fSum -= GetAt(i, k) * vResult.GetAt(k);
+				vResult.SetAt(i, bCholesky ? fSum / GetAt(i, i) : fSum);
+			}
+
+			// backward substitution L^T*x = y (and L^T*x = D^-1*y for the LDL^T fallback)
+			for(i = iN - 1; i >= 0; i--)
+			{
+				fSum = bCholesky ? vResult.GetAt(i) : vResult.GetAt(i) / GetAt(i, i);
+				for(k = i + 1; k < iN; k++)
+					fSum -= GetAt(k, i) * vResult.GetAt(k);
+				vResult.SetAt(i, bCholesky ? fSum / GetAt(i, i) : fSum);
+			}
+
+			return vResult;
+		}
+
+		/**
+		* Calculates the Inverse Matrix.
+		* Given the decomposed matrix returned by CholeskyDecomposition, the inverse matrix
+		* will be computed in place. Therefore the decomposition is no longer avaliable!
+		*
+		* @return A reference to the current object that now holds the inverse.
+		*/
+		CBasicMatrix& CholeskyInverse()
+		{
+			MATHFIT_ASSERT(IsCholeskyDecomposed());
+
+			const int iN = GetNoColumns();
+			const bool bCholesky = (mSymDecomposition == CHOLESKYDECOMPOSITION);
+			int i, j, k;
+			TData fSum;
+
+			// invert the triangular matrix L in place (X = L^-1). The unit diagonal of the
+			// LDL^T factor is implicit, so its diagonal keeps D.
+			for(j = 0; j < iN; j++)
+			{
+				if(bCholesky)
+					SetAt(j, j, 1 / GetAt(j, j));
+
+				for(i = j + 1; i < iN; i++)
+				{
+					fSum = GetAt(i, j) * (bCholesky ? GetAt(j, j) : 1);
+					for(k = j + 1; k < i; k++)
+						fSum += GetAt(i, k) * GetAt(k, j);
+					SetAt(i, j, bCholesky ? -fSum / GetAt(i, i) : -fSum);
+				}
+			}
+
+			// A^-1 = X^T * D^-1 * X. Fill the lower triangle column by column, every element
+			// only depends on elements of X not yet overwritten.
+			for(j = 0; j < iN; j++)
+			{
+				for(i = j; i < iN; i++)
+				{
+					fSum = 0;
+					for(k = i; k < iN; k++)
+					{
+						if(bCholesky)
+							fSum += GetAt(k, i) * GetAt(k, j);
+						else
+							fSum += (k == i ? 1 : GetAt(k, i)) * (k == j ? 1 : GetAt(k, j)) / GetAt(k, k);
+					}
+					SetAt(i, j, fSum);
+				}
+			}
+
+			// mirror to the upper triangle
+			for(j = 0; j < iN; j++)
+				for(i = j + 1; i < iN; i++)
+					SetAt(j, i, GetAt(i, j));
+
+			ClearCholeskyDecomposed();
+
+			return *this;
+		}
+
 		float* GetFloatPtr()
 		{
 			ReleaseFloatPtr();
 
 			mFloatPtr = new float[GetNoColumns() * GetNoRows()];
+			CAllocationCounter::Add();
 
 			for(int i = 0; i < GetNoRows(); i++)
 				for(int j = 0; j < GetNoColumns(); j++)
@@ -1570,6 +1789,7 @@ namespace MathFit
 			ReleaseDoublePtr();
 
 			mDoublePtr = new double[GetNoColumns() * GetNoRows()];
+			CAllocationCounter::Add();
 
 			for(int i = 0; i < GetNoRows(); i++)
 				for(int j = 0; j < GetNoColumns(); j++)
@@ -1585,7 +1805,7 @@ namespace MathFit
 			mDoublePtr = nullptr;
 		}
 
-		TFitData* GetSafePtr() const
+		TData* GetSafePtr() const
 		{
 			MATHFIT_ASSERT(mSizeX > 0 && mSizeY > 0);
 			// MATHFIT_ASSERT(_CrtIsValidPointer(mData, sizeof(mData[0]) * mSizeX * mSizeY, TRUE));
@@ -1605,13 +1825,23 @@ namespace MathFit
 			mLUIndex = nullptr;
 		}
 
+		bool IsCholeskyDecomposed() const
+		{
+			return mSymDecomposition != NODECOMPOSITION;
+		}
+
+		void ClearCholeskyDecomposed()
+		{
+			mSymDecomposition = NODECOMPOSITION;
+		}
+
 		/**
 		 * Assignment operator
 		 *
 		 * This overload is present to prevent the user from accidently assigning matrix objects without knowing
 		 * wheter the content is copied or attached. Please use explicitly Copy or Attach instead.
 		 */
-		CMatrix& operator=(CMatrix& vOp)
+		CBasicMatrix& operator=(CBasicMatrix& vOp)
 		{
 			// !! The direct assignment of matrices is not allowed, since we may get into ambigousity wheter we have to 
 			// !! attach or copy the current matrix.
@@ -1628,7 +1858,7 @@ namespace MathFit
 		*
 		* @return A reference to the output stream itself.
 		*/
-		friend std::ostream& operator<<(std::ostream& os, CMatrix& mMatr)
+		friend std::ostream& operator<<(std::ostream& os, CBasicMatrix& mMatr)
 		{
 			int i;
 			for(i = 0; i < mMatr.GetNoRows(); i++)
@@ -1637,6 +1867,16 @@ namespace MathFit
 		}
 
 	private:
+		/**
+		* Defines the state of the symmetric decomposition done by \Ref{CholeskyDecomposition}.
+		*/
+		enum ESymmetricDecomposition
+		{
+			NODECOMPOSITION,
+			CHOLESKYDECOMPOSITION,
+			LDLDECOMPOSITION
+		};
+
 		/**
 		* The number of columns in the matrix.
 		*/
@@ -1648,14 +1888,26 @@ namespace MathFit
 		/**
 		* Array containing the row vectors.
 		*/
-		CVector* mRows;
-		CVector* mCols;
-		TFitData* mData;
+		CBasicVector<TData>* mRows;
+		CBasicVector<TData>* mCols;
+		TData* mData;
 		bool mAutoRelease;
 		int mLineOffset;
 		double* mDoublePtr;
 		float* mFloatPtr;
 		int* mLUIndex;
+		ESymmetricDecomposition mSymDecomposition;
 	};
+
+	/**
+	* The matrix type used for the data of the fit. The precision of the elements is selected by \Ref{TFitData}.
+	*/
+	typedef CBasicMatrix<TFitData> CMatrix;
+
+	/**
+	* A matrix which always uses double precision elements, independent of \Ref{TFitData}. The normal
+	* equations of the fit are stored and solved using this type.
+	*/
+	typedef CBasicMatrix<double> CDoubleMatrix;
 }
 #endif
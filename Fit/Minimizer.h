@@ -45,6 +45,26 @@ namespace MathFit
 	class IMinimizer 
 	{
 	public:
+		/**
+		* Defines the methods available to solve the linear equation systems built during minimization.
+		*/
+		enum EEquationSolver
+		{
+			/**
+			* Gauss-Jordan elimination with full pivoting.
+			*/
+			GAUSSJORDAN,
+			/**
+			* LU decomposition with partial pivoting.
+			*/
+			LUDECOMPOSITION,
+			/**
+			* Cholesky decomposition of the symmetric normal matrix, with a L*D*L^T fallback for
+			* (nearly) singular matrices. See \Ref{CMatrix::CholeskyDecomposition}.
+			*/
+			CHOLESKY
+		};
+
 		/**
 		* Constructs the object and initializes the variables.
 		*
@@ -53,10 +73,17 @@ namespace MathFit
 		IMinimizer(IParamFunction& ipfModel) : mModel(ipfModel)
 		{
 			mMaxFitSteps = 10000;
+			mMinChiSquare = -1;
 			mCheckChiSquare = -1;
 			mFitSteps = 0;
 			mSolutionFitSteps = 0;
 			mChiSquare = -1;
+
+#if defined(MATHFIT_USELUDECOMPOSITION)
+			mEquationSolver = LUDECOMPOSITION;
+#else
+			mEquationSolver = GAUSSJORDAN;
+#endif
 		}
 
 		/**
@@ -87,16 +114,26 @@ namespace MathFit
 			mModel.GetValues(mFitRange, mDiff);
 
 			// now calculate the chi square and variance values
-			CVector vErr(mFitRange.GetSize());
-			mModel.GetFunctionErrors(mFitRange, vErr);
+			mModel.GetFunctionErrors(mFitRange, mError);
 
-			mChiSquare = mDiff.SquareSumErrorWeighted(vErr);
-			mChiSquare += mModel.GetLinearPenalty(mChiSquare);
-			mChiSquare += mModel.GetNonlinearPenalty(mChiSquare);
+			mChiSquare = mDiff.SquareSumErrorWeighted(mError);
+			mChiSquare += mModel.GetLinearPenalty((TFitData)mChiSquare);
+			mChiSquare += mModel.GetNonlinearPenalty((TFitData)mChiSquare);
 
 			return true;
 		}
 
+		/**
+		* Returns wheter the minimizer determines the linear parameters of the model itself during
+		* each step, so that no separate linear fit is needed between two steps.
+		*
+		* @return TRUE if the linear parameters are solved by the minimizer, FALSE otherwise.
+		*/
+		virtual bool IsSeparable()
+		{
+			return false;
+		}
+
 		/**
 		* Returns the number of fit steps of the last fit done.
 		*
@@ -120,9 +157,9 @@ namespace MathFit
 		/**
 		* Returns ChiSquare of the last fit done.
 		*
-		* @return The ChiSquare value of the last fit.
+		* @return The ChiSquare value of the last fit. It is always calculated in double precision.
 		*/
-		virtual TFitData GetChiSquare ()
+		virtual double GetChiSquare ()
 		{
 			return mChiSquare;
 		}
@@ -144,9 +181,31 @@ namespace MathFit
 		*/
 		virtual void SetMinChiSquare(TFitData fMinChiSquare)
 		{
+			mMinChiSquare = fMinChiSquare;
 			mCheckChiSquare = fMinChiSquare;
 		}
 
+		/**
+		* Sets the method used to solve the linear equation systems.
+		* The default is defined by MATHFIT_USELUDECOMPOSITION.
+		*
+		* @param eSolver	The solver method.
+		*/
+		virtual void SetEquationSolver(EEquationSolver eSolver)
+		{
+			mEquationSolver = eSolver;
+		}
+
+		/**
+		* Returns the method used to solve the linear equation systems.
+		*
+		* @return	The solver method.
+		*/
+		EEquationSolver GetEquationSolver()
+		{
+			return mEquationSolver;
+		}
+
 		/**
 		* Returns the residuum of after the fit.
 		*
@@ -193,15 +252,20 @@ namespace MathFit
 		/**
 		* The ChiSquare value (sum over all samples of the model function).
 		*/
-		TFitData mChiSquare;
+		double mChiSquare;
 		/**
 		* Contains the model function.
 		*/
 		IParamFunction& mModel;
 		/**
-		* The minimum ChiSquare value.
+		* The minimum ChiSquare value given by the user. A negative value lets the minimizer
+		* derive the minimum from the ChiSquare value at the start of each fit.
 		*/
-		TFitData mCheckChiSquare;
+		double mMinChiSquare;
+		/**
+		* The minimum ChiSquare value used by the current fit.
+		*/
+		double mCheckChiSquare;
 		/**
 		* The maximum number of steps.
 		*/
@@ -214,6 +278,26 @@ namespace MathFit
 		* Contains the fit range's support values.
 		*/
 		CVector mFitRange;
+		/**
+		* Contains the errors of the data points within the fit range.
+		*/
+		CVector mError;
+		/**
+		* Receives the covariance matrix of the fitted parameters in \Ref{FinishMinimize}.
+		*/
+		CMatrix mCovar;
+		/**
+		* Receives the correlation matrix of the fitted parameters in \Ref{FinishMinimize}.
+		*/
+		CMatrix mCorrel;
+		/**
+		* Receives the errors of the fitted parameters in \Ref{FinishMinimize}.
+		*/
+		CVector mParamError;
+		/**
+		* The method used to solve the linear equation systems.
+		*/
+		EEquationSolver mEquationSolver;
 	};
 }
 #endif // !defined(AFX_FIT_H__F0C94500_BA3A_42EA_9B39_3BAF247BD44E__INCLUDED_)
@@ -0,0 +1,158 @@
+/**
+* Contains the kernel that builds the normal equations of the nonlinear fit.
+*/
+#if !defined(NORMALEQUATIONS_H_011206)
+#define NORMALEQUATIONS_H_011206
+
+#include "Vector.h"
+#include "Matrix.h"
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+namespace MathFit
+{
+	/**
+	* Builds the weighted normal equations J^T*W*J and J^T*W*r of a least square problem, where
+	* J is the jacobian matrix, W the diagonal matrix of the inverse error squares and r the residual.
+	*
+	* The data points are processed in blocks of BLOCKSIZE elements so that the weights and the weighted
+	* columns of the current block stay in the first level cache. Every sum is then built as a dot product
+	* over contiguous memory by \Ref{CVectorKernels}, which uses vector instructions if the processor supports them.
+	*
+	* The jacobian matrix is expected in the layout delivered by \Ref{IParamFunction::GetNonlinearDyDa}, i.e.
+	* one column per parameter. If the columns are not stored contiguously, a scalar implementation is used.
+	*
+	* The normal equations are always built in double precision. If the fit data is single precision
+	* (MATHFIT_FITDATAFLOAT), only the element-wise products are done in single precision while all
+	* sums are accumulated in double precision.
+	*/
+	class CNormalEquations
+	{
+	public:
+		enum EDefines
+		{
+			/**
+			* The number of data points processed at once. Three blocks of this size have to fit into the
+			* first level cache together with the processed jacobian columns.
+			*/
+			BLOCKSIZE = 256
+		};
+
+		/**
+		* Builds the lower triangle (including the diagonal) of the alpha matrix and the beta vector.
+		* The upper triangle of the alpha matrix is left untouched.
+		*
+		* @param mDyDa		The jacobian matrix. Column j contains the derivatives of the model in respect to parameter j.
+		* @param vDiff		The residual vector.
+		* @param vError		The error of each data point.
+		* @param mAlpha		Receives J^T*W*J. Must have the size of the parameter count.
+		* @param vBeta		Receives J^T*W*r. Must have the size of the parameter count.
+		*
+		* @return	The chi square of the residual.
+		*/
+		static double Build(CMatrix& mDyDa, CVector& vDiff, CVector& vError, CDoubleMatrix& mAlpha, CDoubleVector& vBeta)
+		{
+			const int iParamCount = vBeta.GetSize();
+			const int iSize = vDiff.GetSize();
+
+			MATHFIT_ASSERT(mAlpha.GetNoColumns() == iParamCount && mAlpha.GetNoRows() == iParamCount);
+			MATHFIT_ASSERT(vError.GetSize() == iSize);
+
+			mAlpha.Zero();
+			vBeta.Zero();
+
+			if(iSize <= 0)
+				return 0;
+
+			// the blocked kernel needs contiguous data
+			bool bContiguous = vDiff.GetStepSize() == 1 && vError.GetStepSize() == 1;
+			int j;
+			for(j = 0; j < iParamCount && bContiguous; j++)
+				bContiguous = mDyDa.GetCol(j).GetStepSize() == 1;
+
+			if(!bContiguous)
+				return BuildStrided(mDyDa, vDiff, vError, mAlpha, vBeta);
+
+			const TFitData* fDiff = vDiff.GetSafePtr();
+			const TFitData* fError = vError.GetSafePtr();
+
+			TFitData fWeight[BLOCKSIZE];
+			TFitData fWeightedDiff[BLOCKSIZE];
+			TFitData fWeightedCol[BLOCKSIZE];
+
+			double fChiSquare = 0;
+
+			int iStart;
+			for(iStart = 0; iStart < iSize; iStart += BLOCKSIZE)
+			{
+				const int iLength = std::min((int)BLOCKSIZE, iSize - iStart);
+				const TFitData* fBlockDiff = fDiff + iStart;
+
+				// the weight of each data point is the inverse square of its error
+				int i;
+				for(i = 0; i < iLength; i++)
+				{
+					const TFitData fSigma = fError[iStart + i];
+					fWeight[i] = 1 / (fSigma * fSigma);
+				}
+				CVectorKernels::Mul(fBlockDiff, fWeight, fWeightedDiff, iLength);
+
+				fChiSquare += CVectorKernels::Dot(fBlockDiff, fWeightedDiff, iLength);
+
+				for(j = 0; j < iParamCount; j++)
+				{
+					const TFitData* fColJ = mDyDa.GetCol(j).GetSafePtr() + iStart;
+
+					vBeta.SetAt(j, vBeta.GetAt(j) + CVectorKernels::Dot(fColJ, fWeightedDiff, iLength));
+
+					CVectorKernels::Mul(fColJ, fWeight, fWeightedCol, iLength);
+
+					int k;
+					for(k = 0; k < j; k++)
+					{
+						const TFitData* fColK = mDyDa.GetCol(k).GetSafePtr() + iStart;
+						mAlpha.SetAt(j, k, mAlpha.GetAt(j, k) + CVectorKernels::Dot(fColK, fWeightedCol, iLength));
+					}
+					mAlpha.SetAt(j, j, mAlpha.GetAt(j, j) + CVectorKernels::Dot(fColJ, fWeightedCol, iLength));
+				}
+			}
+
+			return fChiSquare;
+		}
+
+	private:
+		/**
+		* The scalar implementation of \Ref{Build} used for non contiguous data.
+		*/
+		static double BuildStrided(CMatrix& mDyDa, CVector& vDiff, CVector& vError, CDoubleMatrix& mAlpha, CDoubleVector& vBeta)
+		{
+			const int iParamCount = vBeta.GetSize();
+			const int iSize = vDiff.GetSize();
+			double fChiSquare = 0;
+
+			int i, j, k;
+			for(i = 0; i < iSize; i++)
+			{
+				const double fSigmaSquare = (double)vError.GetAt(i) * vError.GetAt(i);
+				const double fDiff = vDiff.GetAt(i);
+
+				fChiSquare += fDiff * fDiff / fSigmaSquare;
+
+				for(j = 0; j < iParamCount; j++)
+				{
+					const double fWT = mDyDa.GetAt(i, j) / fSigmaSquare;
+
+					vBeta.SetAt(j, vBeta.GetAt(j) + fDiff * fWT);
+
+					for(k = 0; k <= j; k++)
+						mAlpha.SetAt(j, k, mAlpha.GetAt(j, k) + mDyDa.GetAt(i, k) * fWT);
+				}
+			}
+
+			return fChiSquare;
+		}
+	};
+}
+#endif
@@ -266,8 +266,8 @@ namespace MathFit
 			MATHFIT_ASSERT((bFixedID && iParamID >= 0 && iParamID < mNonlinearParams.GetSize()) || (!bFixedID && iParamID >= 0 && iParamID < mNonlinearParams.GetAllSize()));
 
 			// get original function values
-			CVector vOrig(vXValues.GetSize());
-			GetValues(vXValues, vOrig);
+			mOrigValues.SetSize(vXValues.GetSize());
+			GetValues(vXValues, mOrigValues);
 
 			// UPD010920 Stefan:
 			// With this loop we autotune the nearly zero parameter. This is neccessary, since
@@ -299,7 +299,7 @@ namespace MathFit
 				SetNonlinearParameter(vNonlinearParams);
 
 				// calculate the numerical difference 
-				vSlopes.Sub(vOrig);
+				vSlopes.Sub(mOrigValues);
 
 #if defined(MATHFIT_AUTOTUNE)
 				// if we only have zeros in the vector, tune our border values
@@ -333,8 +333,8 @@ namespace MathFit
 		virtual void GetNonlinearDyDa(CVector& vXValues, CMatrix& mDyDa)
 		{
 			// get original function values
-			CVector vOrig(vXValues.GetSize());
-			GetValues(vXValues, vOrig);
+			mOrigValues.SetSize(vXValues.GetSize());
+			GetValues(vXValues, mOrigValues);
 
 			CVector& vNonlinearParams = mNonlinearParams.GetParameter();
 
@@ -376,7 +376,7 @@ namespace MathFit
 					SetNonlinearParameter(vNonlinearParams);
 
 					// calc slopes for whole vector
-					vParamColumn.Sub(vOrig);
+					vParamColumn.Sub(mOrigValues);
 
 #if defined(MATHFIT_AUTOTUNE)
 					// if we only have zeros in the vector, tune our border values
@@ -405,6 +405,46 @@ namespace MathFit
 				mStopAutoTune = false;
 		}
 
+		/**
+		* Calculates the function values and the first derivatives in regard to all nonlinear parameters at once.
+		* The default implementation just calls \Ref{GetValues} and \Ref{GetNonlinearParamSlopes} for every parameter.
+		* Functions which need the same intermediate results for both, like the shifted and squeezed X values
+		* of a reference spectrum, should override it so that the data points are processed only once.
+		*
+		* @param vXValues	The data points at which the function should be evaluated.
+		* @param vYValues	The vector object receiving the function values.
+		* @param mDyDa		The matrix object receiving the derivative values of the function at the given data points.
+		* @param iFirstCol	The column of the matrix which receives the derivative of the first nonlinear parameter.
+		*					This allows a sum of functions to collect the derivatives of all operands in one matrix.
+		*/
+		virtual void GetValuesAndNonlinearDyDa(CVector& vXValues, CVector& vYValues, CMatrix& mDyDa, int iFirstCol = 0)
+		{
+			GetValues(vXValues, vYValues);
+
+			const int iParamSize = mNonlinearParams.GetSize();
+
+			int iParamID;
+			for(iParamID = 0; iParamID < iParamSize; iParamID++)
+				GetNonlinearParamSlopes(vXValues, mDyDa.GetCol(iFirstCol + iParamID), iParamID);
+		}
+
+		/**
+		* Calculates everything a nonlinear minimizer needs in each step at once: the function values,
+		* their sigma errors and the first derivatives in regard to all nonlinear parameters.
+		* The default implementation just calls \Ref{GetValues}, \Ref{GetFunctionErrors} and \Ref{GetNonlinearDyDa}.
+		*
+		* @param vXValues	The data points at which the function should be evaluated.
+		* @param vYValues	The vector object receiving the function values.
+		* @param vErrors	The vector object receiving the sigma errors of the function values.
+		* @param mDyDa		The matrix object receiving the derivative values of the function at the given data points.
+		*/
+		virtual void GetValuesErrorsAndDyDa(CVector& vXValues, CVector& vYValues, CVector& vErrors, CMatrix& mDyDa)
+		{
+			GetValues(vXValues, vYValues);
+			GetFunctionErrors(vXValues, vErrors);
+			GetNonlinearDyDa(vXValues, mDyDa);
+		}
+
 		/**
 		* Returns the basis function of the specified linear parameter.
 		* A basis function is defined as the term by which the linear parameter is multiplied.
@@ -957,6 +997,10 @@ namespace MathFit
 		TFitData mDelta;
 		CVector mFitRange;
 		bool mStopAutoTune;
+		/**
+		* Buffer for the unmodified function values used by the difference quotients.
+		*/
+		CVector mOrigValues;
 	};
 }
 #endif // !defined(AFX_IFUNCTION_H__7852C2C7_0389_41DB_B169_3C30252ADD47__INCLUDED_)
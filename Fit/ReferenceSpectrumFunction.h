@@ -9,6 +9,7 @@
 
 #include "ParamFunction.h"
 #include "CubicSplineFunction.h"
+#include "VectorView.h"
 
 #if _MSC_VER > 1000
 #pragma once
@@ -155,7 +156,9 @@ namespace MathFit
 			const int iXSize = vXValues.GetSize();
 
 			// it makes more sens to first modify the X values and then call the B-Spline
-			CVector vBuffer(iXSize);
+			if(mXBuffer.GetSize() < iXSize)
+				mXBuffer.SetSize(iXSize);
+			CVectorView vBuffer(mXBuffer, 0, iXSize);
 
 			int i;
 			for(i = 0; i < iXSize; i++)
@@ -213,7 +216,9 @@ namespace MathFit
 			const int iXSize = vXValues.GetSize();
 
 			// it makes more sens to first modify the X values and then call the B-Spline
-			CVector vBuffer(iXSize);
+			if(mXBuffer.GetSize() < iXSize)
+				mXBuffer.SetSize(iXSize);
+			CVectorView vBuffer(mXBuffer, 0, iXSize);
 
 			int i;
 			for(i = 0; i < iXSize; i++)
@@ -289,7 +294,10 @@ namespace MathFit
 			case 0:
 				{
 					// we want the slope for the shift parameter
-					CVector vXTemp(vXValues);
+					if(mXBuffer.GetSize() < iXSize)
+						mXBuffer.SetSize(iXSize);
+					CVectorView vXTemp(mXBuffer, 0, iXSize);
+					vXTemp.Copy(0, vXValues);
 
 					vXTemp.Sub(mFitRangeLow);
 					int i;
@@ -303,7 +311,10 @@ namespace MathFit
 			case 1:
 				{
 					// and now for the squeeze parameters
-					CVector vXTemp(vXValues);
+					if(mXBuffer.GetSize() < iXSize)
+						mXBuffer.SetSize(iXSize);
+					CVectorView vXTemp(mXBuffer, 0, iXSize);
+					vXTemp.Copy(0, vXValues);
 
 					vXTemp.Sub(mFitRangeLow);
 					int i;
@@ -338,6 +349,57 @@ namespace MathFit
 				GetNonlinearParamSlopes(vXValues, mDyDa.GetCol(iParamID), iParamID);
 		}
 
+		/**
+		* Calculates the function values and the first derivatives in regard to all nonlinear parameters at once.
+		* The X values are shifted and squeezed only once and the basis function is evaluated only once
+		* for the values and the slopes.
+		*
+		* @param vXValues	The data points at which the function should be evaluated.
+		* @param vYValues	The vector object receiving the function values.
+		* @param mDyDa		The matrix object receiving the derivative values of the function at the given data points.
+		* @param iFirstCol	The column of the matrix which receives the derivative of the first nonlinear parameter.
+		*/
+		virtual void GetValuesAndNonlinearDyDa(CVector& vXValues, CVector& vYValues, CMatrix& mDyDa, int iFirstCol = 0)
+		{
+			const int iParamSize = mNonlinearParams.GetSize();
+			const int iXSize = vXValues.GetSize();
+
+			// process shift and squeeze
+			if(mXBuffer.GetSize() < iXSize)
+				mXBuffer.SetSize(iXSize);
+			CVectorView vBuffer(mXBuffer, 0, iXSize);
+
+			int i;
+			for(i = 0; i < iXSize; i++)
+				vBuffer.SetAt(i, mNonlinearParams.GetAllParameter().CalcPoly(vXValues.GetAt(i) - mFitRangeLow) + mFitRangeLow);
+
+			// get the values and the slopes of the basis function and scale both by the linear factor
+			mSlopeBuffer.SetSize(iXSize);
+			mBasisFunction->GetValuesAndSlopes(vBuffer, vYValues, mSlopeBuffer);
+			vYValues.Mul(mLinearParams.GetAllParameter().GetAt(0));
+			mSlopeBuffer.Mul(mLinearParams.GetAllParameter().GetAt(0));
+
+			int iParamID;
+			for(iParamID = 0; iParamID < iParamSize; iParamID++)
+			{
+				CVector& vSlopes = mDyDa.GetCol(iFirstCol + iParamID);
+
+				switch(mNonlinearParams.GetFixed2AllIndex(iParamID))
+				{
+				case 0:
+					// the slope in regard to the shift value is given by df/dw=c*f'(v*x+w)
+					for(i = 0; i < iXSize; i++)
+						vSlopes.SetAt(i, mSlopeBuffer.GetAt(i));
+					break;
+				case 1:
+					// the slope in regard to the squeeze value is given by df/dv=c*f'(v*x+w)*x
+					for(i = 0; i < iXSize; i++)
+						vSlopes.SetAt(i, mSlopeBuffer.GetAt(i) * vXValues.GetAt(i));
+					break;
+				}
+			}
+		}
+
 		/**
 		* Returns the basis function of the specified linear parameter.
 		* A basis function is defined as the term by which the linear parameter is multiplied.
@@ -375,7 +437,9 @@ namespace MathFit
 
 			// we only have one linear parameter: the concentration
 			// therefore we can only fill the vector with the appropriate B-Spline coefficients
-			CVector vBuffer(iXSize);
+			if(mXBuffer.GetSize() < iXSize)
+				mXBuffer.SetSize(iXSize);
+			CVectorView vBuffer(mXBuffer, 0, iXSize);
 
 			// process shift and squeeze
 			int i;
@@ -400,13 +464,13 @@ namespace MathFit
 			// if we have a fixed concentraction value, we only have to subtract the current function from the target vB
 			if(mLinearParams.IsParamFixed(0))
 			{
-				CVector vBuffer(iXSize);
+				mValueBuffer.SetSize(iXSize);
 
 				// get the current function
-				GetValues(vXValues, vBuffer);
+				GetValues(vXValues, mValueBuffer);
 
 				// subtract it from the B vector
-				vB.Sub(vBuffer);
+				vB.Sub(mValueBuffer);
 
 				return;
 			}
@@ -591,6 +655,23 @@ namespace MathFit
 			mBasisFunction = &ifBasisFunction;
 		}
 
+		/**
+		 * Set a basis function object that was already created from the normalized spectral data.
+		 *
+		 * This allows several reference objects to share the same basis function, e.g. a cubic spline
+		 * whose coefficients are calculated only once per reference spectrum. The basis function is only
+		 * evaluated by this object, it is neither copied nor modified. Therefore it has to stay valid as long as
+		 * this object uses it.
+		 *
+		 * @param ifBasisFunction	The basis function object that should be used to evaluate the spectral data.
+		 * @param fAmplitudeScale	The amplitude scale of the spectral data before normalization.
+		 */
+		void SetBasisFunction(IFunction& ifBasisFunction, TFitData fAmplitudeScale)
+		{
+			mBasisFunction = &ifBasisFunction;
+			mAmplitudeScale = fAmplitudeScale;
+		}
+
 		/**
 		 * Returns the basis function object used currently.
 		 */
@@ -628,6 +709,19 @@ namespace MathFit
 		*/
 		CCubicSplineFunction mBSpline;
 		/**
+		* Buffer for the shifted and squeezed X values. It only grows, so that switching between
+		* the fit range and the whole spectrum does not reallocate it.
+		*/
+		CVector mXBuffer;
+		/**
+		* Buffer for the function values.
+		*/
+		CVector mValueBuffer;
+		/**
+		* Buffer for the slopes of the basis function.
+		*/
+		CVector mSlopeBuffer;
+		/**
 		* Holds a reference to the function object that is used as basis function.
 		*/
 		IFunction* mBasisFunction;
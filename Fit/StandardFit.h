@@ -10,6 +10,7 @@
 #include "Fit.h"
 #include "LeastSquareFit.h"
 #include "LevenbergMarquardtFit.h"
+#include "VariableProjectionFit.h"
 #include "ParamFunction.h"
 
 namespace MathFit
@@ -17,16 +18,34 @@ namespace MathFit
 	class CStandardFit : public CFit
 	{
 	public:
-		CStandardFit(IParamFunction& ipfModel) :
-		  mLeastSquare(ipfModel),
+		/**
+		* Defines the algorithms available for the nonlinear fit.
+		*/
+		enum ENonlinearMinimizer
+		{
+			/**
+			* Levenberg-Marquardt fit of the nonlinear parameters alternating with a least square fit of the linear ones.
+			*/
+			LEVENBERGMARQUARDT,
+			/**
+			* Variable projection fit, which eliminates the linear parameters in each step.
+			*/
+			VARIABLEPROJECTION
+		};
+
+		// The base class is constructed before the minimizer members, but CFit only stores the references to them.
+		CStandardFit(IParamFunction& ipfModel, ENonlinearMinimizer eNonlinearMinimizer = LEVENBERGMARQUARDT) :
+		  CFit(ipfModel, mLeastSquare, eNonlinearMinimizer == VARIABLEPROJECTION ? (IMinimizer&)mVariableProjection : (IMinimizer&)mLevenberg),
+			  mLeastSquare(ipfModel),
 			  mLevenberg(ipfModel),
-			  CFit(ipfModel, mLeastSquare, mLevenberg)
+			  mVariableProjection(ipfModel)
 		  {
 		  }
 
 	private:
 		CLeastSquareFit mLeastSquare;
 		CLevenbergMarquardtFit mLevenberg;
+		CVariableProjectionFit mVariableProjection;
 	};
 }
 #endif
\ No newline at end of file
@@ -65,10 +65,10 @@ namespace MathFit
 		{
 			mTarget.GetValues(vXValues, vYTargetVector);
 
-			CVector vTemp(vXValues.GetSize());
-			mModel.GetValues(vXValues, vTemp);
+			mBuffer.SetSize(vXValues.GetSize());
+			mModel.GetValues(vXValues, mBuffer);
 
-			vYTargetVector.Sub(vTemp);
+			vYTargetVector.Sub(mBuffer);
 
 			return vYTargetVector;
 		}
@@ -222,6 +222,44 @@ namespace MathFit
 			mModel.GetNonlinearDyDa(vXValues, mDyDa);
 		}
 
+		/**
+		* Calculates the difference between the target data and the model and the first derivatives of the model at once.
+		* The model calculates its values and derivatives in one call.
+		*
+		* @param vXValues	The data points at which the function should be evaluated.
+		* @param vYValues	The vector object receiving the function values.
+		* @param mDyDa		The matrix object receiving the derivative values of the function at the given data points.
+		* @param iFirstCol	The column of the matrix which receives the derivative of the first nonlinear parameter.
+		*
+		* @see	IParamFunction::GetValuesAndNonlinearDyDa
+		*/
+		virtual void GetValuesAndNonlinearDyDa(CVector& vXValues, CVector& vYValues, CMatrix& mDyDa, int iFirstCol = 0)
+		{
+			mTarget.GetValues(vXValues, vYValues);
+
+			mBuffer.SetSize(vXValues.GetSize());
+			mModel.GetValuesAndNonlinearDyDa(vXValues, mBuffer, mDyDa, iFirstCol);
+
+			vYValues.Sub(mBuffer);
+		}
+
+		/**
+		* Calculates the difference between the target data and the model, its sigma errors and the first derivatives
+		* of the model in one pass over the model.
+		*
+		* @param vXValues	The data points at which the function should be evaluated.
+		* @param vYValues	The vector object receiving the function values.
+		* @param vErrors	The vector object receiving the sigma errors of the function values.
+		* @param mDyDa		The matrix object receiving the derivative values of the function at the given data points.
+		*
+		* @see	IParamFunction::GetValuesErrorsAndDyDa
+		*/
+		virtual void GetValuesErrorsAndDyDa(CVector& vXValues, CVector& vYValues, CVector& vErrors, CMatrix& mDyDa)
+		{
+			GetValuesAndNonlinearDyDa(vXValues, vYValues, mDyDa);
+			GetFunctionErrors(vXValues, vErrors);
+		}
+
 		/**
 		* Maps to model object
 		*
@@ -466,7 +504,7 @@ namespace MathFit
 			mModel.SetFitRange(vFitRange);
 		}
 
-	private:
+	protected:
 		/**
 		* Represents the model function object. Its parameters should be fitted against the given target function values.
 		*/
@@ -475,6 +513,10 @@ namespace MathFit
 		* The target function.
 		*/
 		IFunction& mTarget;
+		/**
+		* Buffer for the model values.
+		*/
+		CVector mBuffer;
 	};
 }
 #endif
@@ -189,6 +189,9 @@ namespace MathFit
 
 			MATHFIT_ASSERT(iOffset >= 0 && (iOffset + iLength) <= mLength && iLength > 0);
 
+			if(mStepSize == 1)
+				return CVectorKernels::Sum(&mData[iOffset], iLength);
+
 			int iOffsetStop = iOffset + iLength;
 			TFitData fSum = 0;
 			int i;
@@ -236,9 +239,9 @@ namespace MathFit
 		* @param iOffset	The index of the first element.
 		* @param iLength	The number of elements to inspect.
 		*
-		* @return	The square sum of the vector elements.
+		* @return	The square sum of the vector elements. The sum is always built in double precision.
 		*/
-		TFitData SquareSum(int iOffset = 0, int iLength = -1)
+		double SquareSum(int iOffset = 0, int iLength = -1)
 		{
 			if(iLength <= 0)
 				iLength = mLength;
@@ -246,10 +249,13 @@ namespace MathFit
 			MATHFIT_ASSERT(iOffset >= 0 && (iOffset + iLength) <= mLength && iLength > 0);
 
 			int iOffsetStop = iOffset + iLength;
-			TFitData fSum = 0;
+			double fSum = 0;
 			int i;
 			for(i = iOffset; i < iOffsetStop; i++)
-				fSum += GetAt(i) * GetAt(i);
+			{
+				const double fData = GetAt(i);
+				fSum += fData * fData;
+			}
 
 			return fSum;
 		}
@@ -263,9 +269,9 @@ namespace MathFit
 		* @param iOffset	The index of the first element.
 		* @param iLength	The number of elements to inspect.
 		*
-		* @return	The square sum of the weighted vector elements.
+		* @return	The square sum of the weighted vector elements. The sum is always built in double precision.
 		*/
-		TFitData SquareSumErrorWeighted(CVector& vError, int iOffset = 0, int iLength = -1)
+		double SquareSumErrorWeighted(CVector& vError, int iOffset = 0, int iLength = -1)
 		{
 			if(iLength <= 0)
 				iLength = mLength;
@@ -274,12 +280,12 @@ namespace MathFit
 			MATHFIT_ASSERT(mLength == vError.GetSize()); 
 
 			int iOffsetStop = iOffset + iLength;
-			TFitData fSum = 0;
+			double fSum = 0;
 			int i;
 			for(i = iOffset; i < iOffsetStop; i++)
 			{
-				const TFitData fSigma = vError.GetAt(i) * vError.GetAt(i);
-				const TFitData fData = GetAt(i) * GetAt(i);
+				const double fSigma = (double)vError.GetAt(i) * vError.GetAt(i);
+				const double fData = (double)GetAt(i) * GetAt(i);
 				fSum += fData / fSigma;
 			}
 
@@ -32,6 +32,10 @@ namespace MathFit
 			mMaxOperands = DEFAULTNOOPERANDS;
 			mOperands = new IParamFunction*[mMaxOperands];
 			mOperandsCount = 0;
+
+			mLinearBlocks = nullptr;
+			mNonlinearBlocks = nullptr;
+			AllocateBlocks();
 		}
 
 		/**
@@ -41,6 +45,10 @@ namespace MathFit
 		{
 			if(mOperands)
 				delete(mOperands);
+			if(mLinearBlocks)
+				delete[] mLinearBlocks;
+			if(mNonlinearBlocks)
+				delete[] mNonlinearBlocks;
 		}
 
 		/**
@@ -70,6 +78,8 @@ namespace MathFit
 
 				// get rid of the old list
 				delete(pTemp);
+
+				AllocateBlocks();
 			}
 
 			// search, wheter the operand already exists
@@ -137,6 +147,8 @@ namespace MathFit
 
 						// get rid of the old list
 						delete(pTemp);
+
+						AllocateBlocks();
 					}
 				}
 
@@ -185,13 +197,13 @@ namespace MathFit
 			vYTargetVector.SetSize(iXSize);
 			vYTargetVector.Zero();
 
-			CVector vBuffer(iXSize);
+			mBuffer.SetSize(iXSize);
 
 			int i;
 			for(i = 0; i < mOperandsCount; i++)
 			{
-				mOperands[i]->GetValues(vXValues, vBuffer);
-				vYTargetVector.Add(vBuffer);
+				mOperands[i]->GetValues(vXValues, mBuffer);
+				vYTargetVector.Add(mBuffer);
 			}
 
 			return vYTargetVector;
@@ -235,13 +247,13 @@ namespace MathFit
 		virtual CVector& GetSlopes(CVector& vXValues, CVector& vSlopeVector)
 		{
 			vSlopeVector.Zero();
-			CVector vBuffer(vXValues.GetSize());
+			mBuffer.SetSize(vXValues.GetSize());
 
 			int i;
 			for(i = 0; i < mOperandsCount; i++)
 			{
-				mOperands[i]->GetSlopes(vXValues, vBuffer);
-				vSlopeVector.Add(vBuffer);
+				mOperands[i]->GetSlopes(vXValues, mBuffer);
+				vSlopeVector.Add(mBuffer);
 			}
 			return vSlopeVector;
 		}
@@ -320,7 +332,7 @@ namespace MathFit
 
 			vSlopes.Zero();
 
-			CVector vBuffer(vXValues.GetSize());
+			mBuffer.SetSize(vXValues.GetSize());
 
 			int i;
 			for(i = 0; i < mOperandsCount; i++)
@@ -335,25 +347,7 @@ namespace MathFit
 				{
 					ipfItem.GetNonlinearParamSlopes(vXValues, vSlopes, iParamID, bFixedID);
 
-					int iSrcParamID = bFixedID ? pvItem.GetFixed2AllIndex(iParamID) : iParamID;
-					int j;
-					for(j = 0; j < mOperandsCount; j++)
-					{
-						if(j != i)
-						{
-							IParamFunction& ipfTarget = *mOperands[i];
-							CParameterVector& pvTarget = ipfTarget.GetNonlinearParameterVector();
-
-							int iTargetParamID = pvItem.GetLinkTargetParamID(iSrcParamID, pvTarget);
-							while(iTargetParamID >= 0)
-							{
-								ipfTarget.GetNonlinearParamSlopes(vXValues, vBuffer, iTargetParamID, false);
-								vSlopes.Add(vBuffer);
-
-								iTargetParamID = pvItem.GetLinkTargetParamID(iSrcParamID, pvTarget, iTargetParamID);
-							}
-						}
-					}
+					AddLinkedNonlinearParamSlopes(vXValues, vSlopes, i, bFixedID ? pvItem.GetFixed2AllIndex(iParamID) : iParamID);
 					break;
 				}
 				else
@@ -361,6 +355,44 @@ namespace MathFit
 			}
 		}
 
+		/**
+		* Calculates the sum of all operands and the first derivatives in regard to all nonlinear parameters at once.
+		* Every operand calculates its values and derivatives in one call, the derivatives are written directly
+		* into the columns of the matrix that belong to the operand.
+		*
+		* @param vXValues	The data points at which the function should be evaluated.
+		* @param vYValues	The vector object receiving the function values.
+		* @param mDyDa		The matrix object receiving the derivative values of the function at the given data points.
+		* @param iFirstCol	The column of the matrix which receives the derivative of the first nonlinear parameter.
+		*/
+		virtual void GetValuesAndNonlinearDyDa(CVector& vXValues, CVector& vYValues, CMatrix& mDyDa, int iFirstCol = 0)
+		{
+			const int iXSize = vXValues.GetSize();
+
+			vYValues.SetSize(iXSize);
+			vYValues.Zero();
+
+			mBuffer.SetSize(iXSize);
+
+			int iCol = iFirstCol;
+			int i;
+			for(i = 0; i < mOperandsCount; i++)
+			{
+				IParamFunction& ipfItem = *mOperands[i];
+				CParameterVector& pvItem = ipfItem.GetNonlinearParameterVector();
+				const int iParamSize = pvItem.GetSize();
+
+				ipfItem.GetValuesAndNonlinearDyDa(vXValues, mBuffer, mDyDa, iCol);
+				vYValues.Add(mBuffer);
+
+				int iParamID;
+				for(iParamID = 0; iParamID < iParamSize; iParamID++)
+					AddLinkedNonlinearParamSlopes(vXValues, mDyDa.GetCol(iCol + iParamID), i, pvItem.GetFixed2AllIndex(iParamID));
+
+				iCol += iParamSize;
+			}
+		}
+
 		/**
 		* Returns the first derivative of the function in regard to all nonlinear parameters.
 		* The matrix is filled using the method to get the slope vector for one nonlinear parameters.
@@ -450,8 +482,8 @@ namespace MathFit
 
 			vBasisFunctions.Zero();
 
-			CVector vBasis(vXValues.GetSize());
-			vBasis.Zero();
+			mBasisBuffer.SetSize(vXValues.GetSize());
+			mBasisBuffer.Zero();
 
 			// the basis function if the sum of all coefficients of the reference spectra in regard
 			// to the parameter
@@ -482,8 +514,8 @@ namespace MathFit
 							int iTargetParamID = pvItem.GetLinkTargetParamID(iSrcParamID, pvTarget);
 							while(iTargetParamID >= 0)
 							{
-								ipfTarget.GetLinearBasisFunctions(vXValues, vBasis, iTargetParamID, false);
-								vBasisFunctions.Add(vBasis);
+								ipfTarget.GetLinearBasisFunctions(vXValues, mBasisBuffer, iTargetParamID, false);
+								vBasisFunctions.Add(mBasisBuffer);
 
 								iTargetParamID = pvItem.GetLinkTargetParamID(iSrcParamID, pvTarget, iTargetParamID);
 							}
@@ -509,7 +541,7 @@ namespace MathFit
 			const int iXSize = vXValues.GetSize();
 
 			// create buffer
-			CVector vBuffer(iXSize);
+			mBuffer.SetSize(iXSize);
 
 			// process every reference given
 			int iParamID = 0;
@@ -532,8 +564,8 @@ namespace MathFit
 				else
 				{
 					// if there are no linear parameters, the reference is just a constant offset, that we have to subtract
-					ipfItem.GetValues(vXValues, vBuffer);
-					vB.Sub(vBuffer);
+					ipfItem.GetValues(vXValues, mBuffer);
+					vB.Sub(mBuffer);
 				}
 			}
 		}
@@ -604,7 +636,7 @@ namespace MathFit
 			{
 				const int iSize = mOperands[i]->GetNonlinearParameter().GetSize();
 				if(iSize > 0)
-					mOperands[i]->SetNonlinearCovarMatrix(mCovar.SubMatrix(iOffset, iOffset, iSize, iSize));
+					mOperands[i]->SetNonlinearCovarMatrix(CopyBlock(mNonlinearBlocks[i], mCovar, iOffset, iSize));
 				iOffset += iSize;
 			}
 		}
@@ -625,7 +657,7 @@ namespace MathFit
 			{
 				const int iSize = mOperands[i]->GetNonlinearParameter().GetSize();
 				if(iSize > 0)
-					mOperands[i]->SetNonlinearCorrelMatrix(mCorrel.SubMatrix(iOffset, iOffset, iSize, iSize));
+					mOperands[i]->SetNonlinearCorrelMatrix(CopyBlock(mNonlinearBlocks[i], mCorrel, iOffset, iSize));
 				iOffset += iSize;
 			}
 		}
@@ -667,7 +699,7 @@ namespace MathFit
 			{
 				const int iSize = mOperands[i]->GetLinearParameter().GetSize();
 				if(iSize > 0)
-					mOperands[i]->SetLinearCovarMatrix(mCovar.SubMatrix(iOffset, iOffset, iSize, iSize));
+					mOperands[i]->SetLinearCovarMatrix(CopyBlock(mLinearBlocks[i], mCovar, iOffset, iSize));
 				iOffset += iSize;
 			}
 		}
@@ -688,7 +720,7 @@ namespace MathFit
 			{
 				const int iSize = mOperands[i]->GetLinearParameter().GetSize();
 				if(iSize > 0)
-					mOperands[i]->SetLinearCorrelMatrix(mCorrel.SubMatrix(iOffset, iOffset, iSize, iSize));
+					mOperands[i]->SetLinearCorrelMatrix(CopyBlock(mLinearBlocks[i], mCorrel, iOffset, iSize));
 				iOffset += iSize;
 			}
 		}
@@ -766,19 +798,62 @@ namespace MathFit
 		}
 
 	private:
+		/**
+		* Adds the slopes of the parameters which are linked to the given nonlinear parameter of an operand.
+		*
+		* @param vXValues		The data points at which the slopes should be determined.
+		* @param vSlopes		The vector object to which the slopes are added.
+		* @param iOperand		The index of the operand which contains the parameter.
+		* @param iSrcParamID	The index of the parameter within all nonlinear parameters of the operand.
+		*/
+		void AddLinkedNonlinearParamSlopes(CVector& vXValues, CVector& vSlopes, int iOperand, int iSrcParamID)
+		{
+			CParameterVector& pvItem = mOperands[iOperand]->GetNonlinearParameterVector();
+
+			int j;
+			for(j = 0; j < mOperandsCount; j++)
+			{
+				if(j != iOperand)
+				{
+					IParamFunction& ipfTarget = *mOperands[iOperand];
+					CParameterVector& pvTarget = ipfTarget.GetNonlinearParameterVector();
+
+					int iTargetParamID = pvItem.GetLinkTargetParamID(iSrcParamID, pvTarget);
+					while(iTargetParamID >= 0)
+					{
+						ipfTarget.GetNonlinearParamSlopes(vXValues, mBuffer, iTargetParamID, false);
+						vSlopes.Add(mBuffer);
+
+						iTargetParamID = pvItem.GetLinkTargetParamID(iSrcParamID, pvTarget, iTargetParamID);
+					}
+				}
+			}
+		}
+
 		/**
 		* Creates the linear parameter vector as sum of all linear parameters of all operands.
 		*/
 		void BuildLinearParameter()
 		{
-			CVector vBuf;
+			int i, iSize;
+			for(iSize = i = 0; i < mOperandsCount; i++)
+				iSize += mOperands[i]->GetLinearParameter().GetSize();
 
-			int i;
-			for(i = 0; i < mOperandsCount; i++)
-				vBuf.Append(mOperands[i]->GetLinearParameter());
+			// collect the parameters in the buffer, so that no allocation is needed when the size stays the same
+			mLinearParamBuffer.SetSize(iSize);
+
+			int iOffset;
+			for(iOffset = i = 0; i < mOperandsCount; i++)
+			{
+				CVector& vParam = mOperands[i]->GetLinearParameter();
+				if(vParam.GetSize() > 0)
+					mLinearParamBuffer.Copy(iOffset, vParam);
+				iOffset += vParam.GetSize();
+			}
 
-			mLinearParams.SetSize(vBuf.GetSize());
-			mLinearParams.SetParameters(vBuf);
+			if(mLinearParams.GetAllSize() != iSize)
+				mLinearParams.SetSize(iSize);
+			mLinearParams.SetParameters(mLinearParamBuffer);
 		}
 
 		/**
@@ -786,14 +861,63 @@ namespace MathFit
 		*/
 		void BuildNonlinearParameter()
 		{
-			CVector vBuf;
+			int i, iSize;
+			for(iSize = i = 0; i < mOperandsCount; i++)
+				iSize += mOperands[i]->GetNonlinearParameter().GetSize();
 
-			int i;
-			for(i = 0; i < mOperandsCount; i++)
-				vBuf.Append(mOperands[i]->GetNonlinearParameter());
+			// collect the parameters in the buffer, so that no allocation is needed when the size stays the same
+			mNonlinearParamBuffer.SetSize(iSize);
+
+			int iOffset;
+			for(iOffset = i = 0; i < mOperandsCount; i++)
+			{
+				CVector& vParam = mOperands[i]->GetNonlinearParameter();
+				if(vParam.GetSize() > 0)
+					mNonlinearParamBuffer.Copy(iOffset, vParam);
+				iOffset += vParam.GetSize();
+			}
 
-			mNonlinearParams.SetSize(vBuf.GetSize());
-			mNonlinearParams.SetParameters(vBuf);
+			if(mNonlinearParams.GetAllSize() != iSize)
+				mNonlinearParams.SetSize(iSize);
+			mNonlinearParams.SetParameters(mNonlinearParamBuffer);
+		}
+
+		/**
+		* Creates the buffers for the covariance and correlation matrices of the operands.
+		* The content of the buffers is only needed while passing the matrices to the operands,
+		* so the old buffers are just replaced.
+		*/
+		void AllocateBlocks()
+		{
+			if(mLinearBlocks)
+				delete[] mLinearBlocks;
+			if(mNonlinearBlocks)
+				delete[] mNonlinearBlocks;
+
+			mLinearBlocks = new CMatrix[mMaxOperands];
+			mNonlinearBlocks = new CMatrix[mMaxOperands];
+		}
+
+		/**
+		* Copies the diagonal block of a covariance or correlation matrix that belongs to one operand.
+		*
+		* @param mBlock		The matrix receiving the block.
+		* @param mSource	The covariance or correlation matrix of all parameters.
+		* @param iOffset	The index of the first parameter of the operand.
+		* @param iSize		The number of parameters of the operand.
+		*
+		* @return	A reference to the block matrix.
+		*/
+		CMatrix& CopyBlock(CMatrix& mBlock, CMatrix& mSource, int iOffset, int iSize)
+		{
+			mBlock.SetSize(iSize, iSize);
+
+			int i, j;
+			for(i = 0; i < iSize; i++)
+				for(j = 0; j < iSize; j++)
+					mBlock.SetAt(i, j, mSource.GetAt(iOffset + i, iOffset + j));
+
+			return mBlock;
 		}
 
 		/**
@@ -819,6 +943,30 @@ namespace MathFit
 		* Maximum number of operands.
 		*/
 		int mMaxOperands;
+		/**
+		* Buffers for the linear covariance and correlation matrices of each operand.
+		*/
+		CMatrix* mLinearBlocks;
+		/**
+		* Buffers for the nonlinear covariance and correlation matrices of each operand.
+		*/
+		CMatrix* mNonlinearBlocks;
+		/**
+		* Buffer for the function values of the operands.
+		*/
+		CVector mBuffer;
+		/**
+		* Buffer for the basis functions of linked parameters.
+		*/
+		CVector mBasisBuffer;
+		/**
+		* Buffer used to collect the linear parameters of all operands.
+		*/
+		CVector mLinearParamBuffer;
+		/**
+		* Buffer used to collect the nonlinear parameters of all operands.
+		*/
+		CVector mNonlinearParamBuffer;
 	};
 }
 #endif // !defined(AFX_DOASFUNCTIONS_H__F778D400_2C41_4092_8BA9_F789F5766579__INCLUDED_)
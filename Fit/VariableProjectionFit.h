@@ -0,0 +1,463 @@
+/**
+* Contains the implementation of the variable projection fit for separable least square problems.
+*/
+#if !defined(VARIABLEPROJECTIONFIT_H_011206)
+#define VARIABLEPROJECTIONFIT_H_011206
+
+#include <float.h>
+#include "Minimizer.h"
+#include "LevenbergMarquardtFit.h"
+#include "NormalEquations.h"
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+namespace MathFit
+{
+	/**
+	* Implements the nonlinear minimizer interface using the variable projection method (Golub-Pereyra)
+	* with the jacobian approximation of Kaufman.
+	*
+	* The model is expected to be separable, i.e. linear in its linear parameters. For every set of nonlinear
+	* parameters the linear parameters are eliminated by solving the linear least square problem
+	* \begin{verbatim}A(a)*c=b\end{verbatim}
+	* and only the nonlinear parameters a are iterated. The iteration is a Levenberg Marquardt loop over the
+	* projected jacobian
+	* \begin{verbatim}J = (I - A*(At*W*A)^-1*At*W) * dy/da\end{verbatim}
+	* where W contains the inverse error squares. Since the chi square of each step is evaluated with the
+	* optimal linear parameters, a step is only accepted if it really improves the fit. This usually needs
+	* less iterations than solving the linear and nonlinear parameters alternately.
+	*
+	* The linear parameters are set in the model object after every step, so no separate linear minimizer
+	* has to be run between the steps (see \Ref{IsSeparable}).
+	*/
+	class CVariableProjectionFit : public IMinimizer
+	{
+	public:
+		/**
+		* Constructs the object and sets the model function.
+		*
+		* @param ipfModel	The model function which parametes should be fitted.
+		*/
+		CVariableProjectionFit(IParamFunction& ipfModel) : IMinimizer(ipfModel),
+			mSTARTLAMBDA((TFitData)STARTLAMBDA),
+			mMINLAMBDA((TFitData)MINLAMBDA),
+			mMAXLAMBDA((TFitData)MAXLAMBDA),
+			mEPSILON((TFitData)EPSILON),
+			mCHISQUAREMIN((TFitData)CHISQUAREMIN)
+		{
+			// nothing to do in here, since everything is done with the constructors
+		}
+
+		virtual bool PrepareMinimize()
+		{
+			if(mModel.GetNonlinearParameter().GetSize() <= 0)
+				return true;
+
+			if(mFitRange.GetSize() <= 0)
+				throw(EXCEPTION(CNoFitRangeException));
+
+			mLambda = mSTARTLAMBDA;
+			mSolutionFitSteps = mFitSteps = 0;
+
+			// set the appropriate matrix sizes
+			mDyDa.SetSize(mModel.GetNonlinearParameter().GetSize(), mFitRange.GetSize());
+
+			// first call of Analyze()
+			if(!Analyze())
+				return false;
+
+			// prepare a lower border for the chi square
+			mCheckChiSquare = mMinChiSquare;
+			if(mCheckChiSquare < 0)
+				mCheckChiSquare = mChiSquare * mCHISQUAREMIN;
+			if(!_finite(mCheckChiSquare))
+				mCheckChiSquare = mCHISQUAREMIN;
+
+			if(mMaxFitSteps < 0)
+				mMaxFitSteps = 1000;
+
+			return true;
+		}
+
+		/**
+		* This is the main function that performs one step in the fitting algorithm.
+		*
+		* @return TRUE if minimization is finished, FALSE otherwise.
+		*/
+		virtual bool Minimize()
+		{
+			if(mModel.GetNonlinearParameter().GetSize() <= 0)
+				return false;
+
+			// check lambda
+			if(mLambda >= mMAXLAMBDA)
+				return false;
+
+			// check for already optimal solution
+			if(mCheckChiSquare > mChiSquare)
+				return false;
+
+			mOldChiSquare = mChiSquare;
+
+			// backup old values
+			mAlphaOld.Copy(mAlpha);
+			mBetaOld.Copy(mBeta);
+			mBackupNonlinear.Copy(mModel.GetNonlinearParameter());
+			mBackupLinear.Copy(mModel.GetLinearParameter());
+
+			// alter alpha by augmenting diagonal elements
+			mAlpha.MulDiag(1 + mLambda);
+
+			// solve the linear equations
+			switch(mEquationSolver)
+			{
+			case CHOLESKY:
+				mAlpha.CholeskyDecomposition();
+				mAlpha.CholeskyBacksubstitution(mBeta);
+				break;
+
+			case LUDECOMPOSITION:
+				mAlpha.LUDecomposition();
+				mAlpha.LUBacksubstitution(mBeta);
+				break;
+
+			default:
+				mAlpha.GaussJordanSolve(mBeta);
+				break;
+			}
+
+			// set new parameter vector
+			mStep.Copy(mBeta);
+			mModel.SetNonlinearParameter(mModel.GetNonlinearParameter().Add(mStep));
+
+			// analyze new parameters. This also determines the new linear parameters.
+			if(!Analyze())
+				return false;
+
+			mFitSteps++;
+
+			if(_finite(mChiSquare) && mOldChiSquare >= mChiSquare)
+			{
+				// keep the current iteration count as best steps
+				mSolutionFitSteps = mFitSteps;
+
+				if(mLambda > mMINLAMBDA)
+					mLambda /= 10;
+
+				// chi square doesn't differ to much anymore, so we're finished
+				double fDiff = (mOldChiSquare - mChiSquare)/mChiSquare;
+				if(fDiff < mEPSILON)
+					return false;
+			}
+			else
+			{
+				// worse result, so restore the linear and nonlinear model parameters and the matrices
+				mModel.SetNonlinearParameter(mBackupNonlinear);
+				mModel.SetLinearParameter(mBackupLinear);
+				mAlpha.Copy(mAlphaOld);
+				mBeta.Copy(mBetaOld);
+				mChiSquare = mOldChiSquare;
+				mLambda *= 10;
+			}
+
+			// check fit steps
+			if(mMaxFitSteps > 0 && mFitSteps >= mMaxFitSteps)
+				return false;
+
+			return true;
+		}
+
+		/**
+		* Sets the covariance matrix, the correlation matrix and the errors of the nonlinear parameters in the model
+		* function object. Since the projected alpha matrix is used, the covariances already include the
+		* correlation with the linear parameters.
+		*
+		* @return Always TRUE.
+		*/
+		virtual bool FinishMinimize()
+		{
+			const int iParams = mModel.GetNonlinearParameter().GetSize();
+			if(iParams <= 0)
+				return true;
+
+			mDiff.SetSize(mFitRange.GetSize());
+			mModel.GetValues(mFitRange, mDiff);
+
+			// now calculate the chi square and variance values
+			mModel.GetFunctionErrors(mFitRange, mError);
+
+			// get the sum of squares weighted by the error vector
+			mChiSquare = mDiff.SquareSumErrorWeighted(mError);
+			mChiSquare += mModel.GetNonlinearPenalty((TFitData)mChiSquare);
+
+			// calculate the normalization factor for all statistical values
+			TFitData fNorm = (TFitData)sqrt(mChiSquare / (mFitRange.GetSize() - iParams));
+
+			// inverse the alpha matrix
+			switch(mEquationSolver)
+			{
+			case CHOLESKY:
+				if(!mAlpha.IsCholeskyDecomposed())
+					mAlpha.CholeskyDecomposition();
+				mAlpha.CholeskyInverse();
+				break;
+
+			case LUDECOMPOSITION:
+				if(!mAlpha.IsLUDecomposed())
+					mAlpha.LUDecomposition();
+				mAlpha.LUInverse();
+				break;
+
+			default:
+				mAlpha.Inverse();
+				break;
+			}
+
+			// set the covariance matrix
+			mCovar.Copy(mAlpha);
+			mModel.SetNonlinearCovarMatrix(mCovar);
+
+			// calculate the parameter errors
+			mParamError.SetSize(iParams);
+			int i;
+			for(i = 0; i < iParams; i++)
+				mParamError.SetAt(i, (TFitData)sqrt(mCovar.GetAt(i, i)));
+
+			// calculate the correlation matrix
+			mCorrel.SetSize(iParams, iParams);
+
+			int j;
+			for(i = 0; i < iParams; i++)
+				for(j = 0; j < iParams; j++)
+					mCorrel.SetAt(i, j, mCovar.GetAt(i, j) / (mParamError.GetAt(i) * mParamError.GetAt(j)));
+			mModel.SetNonlinearCorrelMatrix(mCorrel);
+
+			// now we have to 'normalize' the parameter errors to chi square.
+			mParamError.Mul(fNorm);
+			mModel.SetNonlinearError(mParamError);
+
+			return true;
+		}
+
+		/**
+		* The linear parameters are determined in every step.
+		*
+		* @return Always TRUE.
+		*/
+		virtual bool IsSeparable()
+		{
+			return true;
+		}
+
+		/**
+		* Determines the optimal linear parameters for the current nonlinear parameters, and calculates the
+		* projected alpha matrix and beta vector.
+		*
+		* @return TRUE is successful, FALSE otherwise
+		*/
+		bool Analyze()
+		{
+			const int iSize = mFitRange.GetSize();
+			const int iParamCount = mModel.GetNonlinearParameter().GetSize();
+			const int iLinearCount = mModel.GetLinearParameter().GetSize();
+
+			mError.SetSize(iSize);
+			mModel.GetFunctionErrors(mFitRange, mError);
+
+			int i, j;
+
+			// eliminate the linear parameters first, such that the derivatives and the residual belong to
+			// the optimal linear parameters of the current nonlinear parameters
+			if(iLinearCount > 0)
+				SolveLinear();
+
+			// the residual and the first derivatives of the model function in one pass
+			mDiff.SetSize(iSize);
+			mModel.GetValuesAndNonlinearDyDa(mFitRange, mDiff, mDyDa);
+
+			if(iLinearCount > 0)
+			{
+				// the inverse error squares are needed for the projection
+				mWeight.SetSize(iSize);
+				for(i = 0; i < iSize; i++)
+					mWeight.SetAt(i, 1 / (mError.GetAt(i) * mError.GetAt(i)));
+
+				// project the derivatives onto the orthogonal complement of the linear basis functions
+				mLinearCoeff.SetSize(iLinearCount);
+				for(j = 0; j < iParamCount; j++)
+				{
+					CVector& vCol = mDyDa.GetCol(j);
+
+					int k;
+					for(k = 0; k < iLinearCount; k++)
+					{
+						CVector& vBasis = mA.GetCol(k);
+
+						double fSum = 0;
+						for(i = 0; i < iSize; i++)
+							fSum += (double)vBasis.GetAt(i) * mWeight.GetAt(i) * vCol.GetAt(i);
+						mLinearCoeff.SetAt(k, fSum);
+					}
+
+					mAtA.CholeskyBacksubstitution(mLinearCoeff);
+
+					for(k = 0; k < iLinearCount; k++)
+						vCol.Sub(mA.GetCol(k), (TFitData)mLinearCoeff.GetAt(k));
+				}
+			}
+
+			// setting mBeta, mAlpha to its proper size
+			mBeta.SetSize(iParamCount);
+			mAlpha.SetSize(iParamCount, iParamCount);
+
+			mChiSquare = CNormalEquations::Build(mDyDa, mDiff, mError, mAlpha, mBeta);
+
+			// fill in the symmetric side of alpha and ensure that we do not have zeros on the diagonal. Otherwise
+			// the LEQ can't be solved!
+			for(i = 0; i < iParamCount; i++)
+			{
+				if(mAlpha.GetAt(i, i) == 0)
+					mAlpha.SetAt(i, i, MATHFIT_NEARLYZERO);
+
+				for(j = 0; j < i; j++)
+					mAlpha.SetAt(j, i, mAlpha.GetAt(i, j));
+			}
+
+			// add the penalty of the new parameters
+			mChiSquare += mModel.GetLinearPenalty((TFitData)mChiSquare);
+			mChiSquare += mModel.GetNonlinearPenalty((TFitData)mChiSquare);
+
+			return true;
+		}
+
+	private:
+		/**
+		* Solves the linear least square problem for the current nonlinear parameters and sets the
+		* linear parameters in the model. mAtA keeps the decomposed normal matrix for the projection.
+		*/
+		void SolveLinear()
+		{
+			const int iSize = mFitRange.GetSize();
+			const int iLinearCount = mModel.GetLinearParameter().GetSize();
+
+			mA.SetSize(iLinearCount, iSize);
+			mB.SetSize(iSize);
+			mModel.GetLinearAMatrix(mFitRange, mA, mB);
+
+			mAtA.SetSize(iLinearCount, iLinearCount);
+			mAtB.SetSize(iLinearCount);
+			CNormalEquations::Build(mA, mB, mError, mAtA, mAtB);
+
+			// the normal matrix of the linear problem is always solved using the Cholesky decomposition, since
+			// the decomposition is reused for the projection of the derivatives.
+
+			int i, j;
+			for(i = 0; i < iLinearCount; i++)
+			{
+				if(mAtA.GetAt(i, i) == 0)
+					mAtA.SetAt(i, i, MATHFIT_NEARLYZERO);
+
+				for(j = 0; j < i; j++)
+					mAtA.SetAt(j, i, mAtA.GetAt(i, j));
+			}
+
+			mAtA.CholeskyDecomposition();
+			mAtA.CholeskyBacksubstitution(mAtB);
+
+			mLinearParam.Copy(mAtB);
+			mModel.SetLinearParameter(mLinearParam);
+		}
+
+		/**
+		* Contains the beta vector of the fit algorithm.
+		*/
+		CDoubleVector mBeta;
+		/**
+		* Contains the old beta vector of the fit algorithm.
+		*/
+		CDoubleVector mBetaOld;
+		/**
+		* Contains the alpha matrix of the algorithm.
+		*/
+		CDoubleMatrix mAlpha;
+		/**
+		* Contains the old alpha matrix of the algorithm.
+		*/
+		CDoubleMatrix mAlphaOld;
+		/**
+		* Contains the parameter step of the current loop, converted to the precision of the fit data.
+		*/
+		CVector mStep;
+		/**
+		* Contains the projected DyDa matrix of the model function.
+		*/
+		CMatrix mDyDa;
+		/**
+		* Contains the linear basis functions.
+		*/
+		CMatrix mA;
+		/**
+		* Contains the B vector of the linear problem.
+		*/
+		CVector mB;
+		/**
+		* Contains the decomposed normal matrix of the linear problem.
+		*/
+		CDoubleMatrix mAtA;
+		/**
+		* Contains the solution of the linear problem.
+		*/
+		CDoubleVector mAtB;
+		/**
+		* Contains the solution of the linear problem, converted to the precision of the fit data.
+		*/
+		CVector mLinearParam;
+		/**
+		* Buffer for the coefficients of the projection.
+		*/
+		CDoubleVector mLinearCoeff;
+		/**
+		* Contains the inverse error squares of the data points.
+		*/
+		CVector mWeight;
+		/**
+		* The nonlinear parameters before the last step.
+		*/
+		CVector mBackupNonlinear;
+		/**
+		* The linear parameters before the last step.
+		*/
+		CVector mBackupLinear;
+		/**
+		* The current lambda value.
+		*/
+		TFitData mLambda;
+		/**
+		* The ChiSquare value of the last loop.
+		*/
+		double mOldChiSquare;
+		/**
+		* The start value for the lambda parameter.
+		*/
+		const TFitData mSTARTLAMBDA;
+		/**
+		* The minimum lambda value.
+		*/
+		const TFitData mMINLAMBDA;
+		/**
+		* The maximum lambda value.
+		*/
+		const TFitData mMAXLAMBDA;
+		/**
+		* We abort, of Chi square doesn't differ more than EPSILON anymore.
+		*/
+		const TFitData mEPSILON;
+		/**
+		* we already have an optimal solution, if chi square is smaller than this value.
+		*/
+		const TFitData mCHISQUAREMIN;
+	};
+}
+#endif
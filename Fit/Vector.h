@@ -19,6 +19,7 @@
 #include <iostream>
 #include <math.h>
 #include "FitBasic.h"
+#include "VectorKernels.h"
 #include <SpectralEvaluation/Fit/FitException.h>
 
 #pragma warning (push, 3)
@@ -52,20 +53,24 @@ namespace MathFit
 
 	/**
 	* This class encapsulates the basic functions needed to handle one dimensional vectors.
+	* The type of the vector elements is given by the template parameter. Normally the vectors are used
+	* through the \Ref{CVector} type, which uses the \Ref{TFitData} elements of the fit.
 	*
 	* @author		\URL[Stefan Kraus]{http://stefan@00kraus.de} @ \URL[IWR, Image Processing Group]{http://klimt.iwr.uni-heidelberg.de}
 	* @version		1.0 @ 2001/09/09
 	*/
-	class CVector
+	template<class TData>
+	class CBasicVector
 	{
 	public:
 		/**
 		* Creates an empty vector object.
 		*/
-		CVector()
+		CBasicVector()
 		{
 			mData = nullptr;
 			mLength = 0;
+			mCapacity = 0;
 			mStepSize = 1;
 			mAutoRelease = true;
 
@@ -78,10 +83,11 @@ namespace MathFit
 		*
 		* @param vRight	The originating vector object.
 		*/
-		CVector(const CVector &vRight)
+		CBasicVector(const CBasicVector &vRight)
 		{
 			mData = nullptr;
 			mLength = 0;
+			mCapacity = 0;
 			mStepSize = 1;
 			mAutoRelease = true;
 
@@ -91,15 +97,36 @@ namespace MathFit
 			Copy(vRight);
 		}
 
+		/**
+		* Creates a new vector object which takes over the content of the given vector.
+		* The given vector is empty afterwards.
+		*
+		* @param vRight	The originating vector object.
+		*/
+		CBasicVector(CBasicVector&& vRight)
+		{
+			mData = nullptr;
+			mLength = 0;
+			mCapacity = 0;
+			mStepSize = 1;
+			mAutoRelease = true;
+
+			mFloatPtr = nullptr;
+			mDoublePtr = nullptr;
+
+			Exchange(vRight);
+		}
+
 		/**
 		* Create a vector object with the given size.
 		*
 		* @param iSize		The number of elements in the vector.
 		*/
-		CVector(int iSize)
+		CBasicVector(int iSize)
 		{
 			mData = nullptr;
 			mLength = 0;
+			mCapacity = 0;
 			mStepSize = 1;
 			mAutoRelease = true;
 
@@ -116,7 +143,7 @@ namespace MathFit
 		* @param iOffset	The offset from which the subvector should start
 		* @param iSize		The number of elements in the subvector.
 		*/
-		CVector(CVector& vSecond, int iOffset, int iSize)
+		CBasicVector(CBasicVector& vSecond, int iOffset, int iSize)
 		{
 			MATHFIT_ASSERT(iOffset + iSize <= vSecond.GetSize());
 			MATHFIT_ASSERT(iSize > 0);
@@ -131,6 +158,7 @@ namespace MathFit
 
 			// set new length
 			mLength = iSize;
+			mCapacity = 0;
 
 			// we are not allowed to release the buffer!
 			mAutoRelease = false;
@@ -141,13 +169,15 @@ namespace MathFit
 		*
 		* @param fData			The array containing the data elements.
 		* @param iSize			The number of elements in the array.
-		* @param iStepSize		The offset between two vector elements given in TFitData elements.
-		* @param bAutoRelease	If TRUE the array is freed during destruction of the vector.
+		* @param iStepSize		The offset between two vector elements given in TData elements.
+		* @param bAutoRelease	If TRUE the array is freed during destruction of the vector. The array must then
+		*						have been allocated by \Ref{CVectorKernels::Allocate}.
 		*/
-		CVector(TFitData* fData, int iSize, int iStepSize = 1, bool bAutoRelease = true)
+		CBasicVector(TData* fData, int iSize, int iStepSize = 1, bool bAutoRelease = true)
 		{
 			mData = nullptr;
 			mLength = 0;
+			mCapacity = 0;
 			mStepSize = 1;
 			mAutoRelease = true;
 
@@ -160,10 +190,10 @@ namespace MathFit
 		/**
 		* Frees and allocated resources.
 		*/
-		~CVector()
+		~CBasicVector()
 		{
 			if(mAutoRelease && mData != 0)
-				delete mData;
+				CVectorKernels::Free(mData);
 			ReleaseDoublePtr();
 			ReleaseFloatPtr();
 		}
@@ -175,7 +205,7 @@ namespace MathFit
 		*
 		* @return A reference to the current object.
 		*/
-		CVector& Copy(const CVector& vSecond)
+		CBasicVector& Copy(const CBasicVector& vSecond)
 		{
 			const int iSecSize = vSecond.GetSize();
 
@@ -185,7 +215,7 @@ namespace MathFit
 				return *this;
 
 			if(vSecond.mStepSize == 1 && mStepSize == 1)
-				memcpy(GetSafePtr(), vSecond.GetSafePtr(), sizeof(TFitData) * iSecSize);
+				memcpy(GetSafePtr(), vSecond.GetSafePtr(), sizeof(TData) * iSecSize);
 			else
 			{
 				int i;
@@ -199,12 +229,12 @@ namespace MathFit
 		* Copies the content of the given vector into the current object.
 		*
 		* @param fData			The array containing the data points.
-		* @param iStepSize		The offset between two vector elements given in TFitData elements.
+		* @param iStepSize		The offset between two vector elements given in TData elements.
 		* @param iSize			The number of elements in the array.
 		*
 		* @return A reference to the current object.
 		*/
-		CVector& Copy(TFitData* fData, int iSize, int iStepSize = 1)
+		CBasicVector& Copy(TData* fData, int iSize, int iStepSize = 1)
 		{
 			SetSize(iSize);
 
@@ -212,7 +242,7 @@ namespace MathFit
 				return *this;
 
 			if(iStepSize == 1)
-				memcpy(GetSafePtr(), fData, sizeof(TFitData) * iSize);
+				memcpy(GetSafePtr(), fData, sizeof(TData) * iSize);
 			else
 			{
 				int i;
@@ -222,8 +252,18 @@ namespace MathFit
 			return *this;
 		}
 
-#if defined(MATHFIT_FITDATAFLOAT)
-		CVector& Copy(double* fData, int iSize, int iStepSize = 1)
+		/**
+		* Copies the content of an array of a different element type into the current object.
+		* Every element is converted to the element type of the vector.
+		*
+		* @param fData			The array containing the data points.
+		* @param iStepSize		The offset between two vector elements given in array elements.
+		* @param iSize			The number of elements in the array.
+		*
+		* @return A reference to the current object.
+		*/
+		template<class TOther>
+		CBasicVector& Copy(TOther* fData, int iSize, int iStepSize = 1)
 		{
 			SetSize(iSize);
 
@@ -232,23 +272,30 @@ namespace MathFit
 
 			int i;
 			for(i = 0; i < GetSize(); i++)
-				SetAt(i, (TFitData)fData[i * iStepSize]);
+				SetAt(i, (TData)fData[i * iStepSize]);
 			return *this;
 		}
-#else
-		CVector& Copy(float* fData, int iSize, int iStepSize = 1)
+
+		/**
+		* Copies the content of a vector of a different element type into the current object.
+		* Every element is converted to the element type of the current vector.
+		*
+		* @param vSecond	The originating vector object.
+		*
+		* @return A reference to the current object.
+		*/
+		template<class TOther>
+		CBasicVector& Copy(const CBasicVector<TOther>& vSecond)
 		{
-			SetSize(iSize);
+			const int iSecSize = vSecond.GetSize();
 
-			if(iSize <= 0)
-				return *this;
+			SetSize(iSecSize);
 
 			int i;
-			for(i = 0; i < GetSize(); i++)
-				SetAt(i, (TFitData)fData[i * iStepSize]);
+			for(i = 0; i < iSecSize; i++)
+				SetAt(i, (TData)vSecond.GetAt(i));
 			return *this;
 		}
-#endif
 		/**
 		* Copies the content of a subvetor into the current vector starting at the given offset.
 		*
@@ -257,7 +304,7 @@ namespace MathFit
 		*
 		* @return A reference to the current object.
 		*/
-		CVector& Copy(int iOffset, CVector& vSub)
+		CBasicVector& Copy(int iOffset, CBasicVector& vSub)
 		{
 			const int iSubSize = vSub.GetSize();
 
@@ -267,7 +314,7 @@ namespace MathFit
 			MATHFIT_ASSERT((iOffset + iSubSize) <= mLength);
 
 			if(mStepSize == 1 && vSub.mStepSize == 1)
-				memcpy(&GetSafePtr()[iOffset], vSub.GetSafePtr(), sizeof(TFitData) * iSubSize);
+				memcpy(&GetSafePtr()[iOffset], vSub.GetSafePtr(), sizeof(TData) * iSubSize);
 			else
 			{
 				int i;
@@ -279,18 +326,18 @@ namespace MathFit
 		}
 
 		/**
-		* Attaches the content of another CVector object to the current one
+		* Attaches the content of another CBasicVector object to the current one
 		*
 		* @param vSecond		The originating object.
 		* @param bAutoRelease	If TRUE the vector data is freed on destructuion of the vector.
 		*
 		* @return	A reference to the current object.
 		*/
-		CVector& Attach(CVector& vSecond, bool bAutoRelease = true)
+		CBasicVector& Attach(CBasicVector& vSecond, bool bAutoRelease = true)
 		{
 			// first clear the old data
 			if(mData && mAutoRelease)
-				delete mData;
+				CVectorKernels::Free(mData);
 
 			// get the data pointer
 			mData = vSecond.mData;
@@ -300,35 +347,42 @@ namespace MathFit
 			{
 				// so the current object will no take care about destruction of the vector data
 				mAutoRelease = vSecond.mAutoRelease;
+				mCapacity = vSecond.mCapacity;
 				vSecond.mAutoRelease = false;
+				vSecond.mCapacity = 0;
 			}
 			else
+			{
 				mAutoRelease = false;
+				mCapacity = 0;
+			}
 
 			return *this;
 		}
 
 		/**
-		* Attaches the content of another CVector object to the current one
+		* Attaches the content of another CBasicVector object to the current one
 		*
 		* @param fData			The data array that contains the values.
 		* @param iSize			The number of elements in the array.
-		* @param iStepSize		The offset between two vector elements given in TFitData elements.
-		* @param bAutoRelease	If TRUE the array is freed on destructuion of the vector.
+		* @param iStepSize		The offset between two vector elements given in TData elements.
+		* @param bAutoRelease	If TRUE the array is freed on destructuion of the vector. The array must then
+		*						have been allocated by \Ref{CVectorKernels::Allocate}.
 		*
 		* @return	A reference to the current object.
 		*/
-		CVector& Attach(TFitData* fData, int iSize, int iStepSize = 1, bool bAutoRelease = true)
+		CBasicVector& Attach(TData* fData, int iSize, int iStepSize = 1, bool bAutoRelease = true)
 		{
 			MATHFIT_ASSERT(iSize > 0);
 
 			// first clear the old data
 			if(mData && mAutoRelease)
-				delete mData;
+				CVectorKernels::Free(mData);
 
 			// get the data pointer
 			mData = fData;
 			mLength = iSize;
+			mCapacity = (bAutoRelease && iStepSize == 1) ? iSize : 0;
 			mAutoRelease = bAutoRelease;
 			mStepSize = iStepSize;
 
@@ -340,10 +394,11 @@ namespace MathFit
 		*
 		* @return	A reference to the current object
 		*/
-		CVector& Detach()
+		CBasicVector& Detach()
 		{
 			mData = nullptr;
 			mLength = 0;
+			mCapacity = 0;
 			mStepSize = 1;
 			mAutoRelease = true;
 
@@ -364,10 +419,10 @@ namespace MathFit
 		*
 		* @return	A vector object representing the selected subvector.
 		*/
-		CVector SubVector(int iOffset, int iSize)
+		CBasicVector SubVector(int iOffset, int iSize)
 		{
 			// create new subclassed vector object
-			return CVector(*this, iOffset, iSize);
+			return CBasicVector(*this, iOffset, iSize);
 		}
 
 		/**
@@ -377,16 +432,18 @@ namespace MathFit
 		*
 		* @return	A reference to the current object
 		*/
-		CVector& Exchange(CVector& vSecond)
+		CBasicVector& Exchange(CBasicVector& vSecond)
 		{
 			int iLength = vSecond.mLength;
+			int iCapacity = vSecond.mCapacity;
 			int iStepSize = vSecond.mStepSize;
-			TFitData* fData = vSecond.mData;
+			TData* fData = vSecond.mData;
 			bool bAutoRelease = vSecond.mAutoRelease;
 			double* fDoublePtr = vSecond.mDoublePtr;
 			float* fFloatPtr = vSecond.mFloatPtr;
 
 			vSecond.mLength = mLength;
+			vSecond.mCapacity = mCapacity;
 			vSecond.mStepSize = mStepSize;
 			vSecond.mData = mData;
 			vSecond.mAutoRelease = mAutoRelease;
@@ -394,6 +451,7 @@ namespace MathFit
 			vSecond.mFloatPtr = mFloatPtr;
 
 			mLength = iLength;
+			mCapacity = iCapacity;
 			mStepSize = iStepSize;
 			mData = fData;
 			mAutoRelease = bAutoRelease;
@@ -411,9 +469,9 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CVector& ExchangeElements(int iFirst, int iSec)
+		CBasicVector& ExchangeElements(int iFirst, int iSec)
 		{
-			TFitData fTemp = GetAt(iFirst);
+			TData fTemp = GetAt(iFirst);
 			SetAt(iFirst, GetAt(iSec));
 			SetAt(iSec, fTemp);
 
@@ -425,7 +483,7 @@ namespace MathFit
 		*
 		* @return	A pointer to the data array. NULL if no array is associated.
 		*/
-		TFitData* GetSafePtr() const
+		TData* GetSafePtr() const
 		{
 			MATHFIT_ASSERT(mLength > 0);
 			// MATHFIT_ASSERT(_CrtIsValidPointer(mData, sizeof(mData[0]) * mLength, TRUE));
@@ -440,7 +498,7 @@ namespace MathFit
 		*
 		* @return	A reference to the vector element.
 		*/
-		TFitData GetAt(int iIndex) const
+		TData GetAt(int iIndex) const
 		{
 			MATHFIT_ASSERT(iIndex >= 0 && iIndex < mLength);
 
@@ -456,7 +514,7 @@ namespace MathFit
 		*
 		* @return	A reference to the vector element.
 		*/
-		TFitData GetAtSafe(int iIndex) const
+		TData GetAtSafe(int iIndex) const
 		{
 			// check for boundary condition
 			if(iIndex < 0)
@@ -475,7 +533,7 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CVector& SetAt(int iIndex, TFitData fParam)
+		CBasicVector& SetAt(int iIndex, TData fParam)
 		{
 			MATHFIT_ASSERT(iIndex >= 0 && iIndex < mLength);
 
@@ -494,9 +552,20 @@ namespace MathFit
 			return mLength;
 		}
 
+		/**
+		* Returns the number of elements the vector can hold without reallocating its buffer.
+		*
+		* @return	The number of allocated elements. Zero if the vector does not own its buffer.
+		*/
+		const int GetCapacity() const
+		{
+			return mCapacity;
+		}
+
 		/**
 		* Sets the size of the vector. 
-		* If the vector needs to be resized the neccessary buffer is reallocated.
+		* If the vector needs to be resized the neccessary buffer is reallocated, unless the
+		* allocated buffer is already large enough. The elements are set to zero if the size changes.
 		*
 		* @param iNewSize	The new number of elements.
 		*/
@@ -504,23 +573,17 @@ namespace MathFit
 		{
 			if(iNewSize != mLength || !mData)
 			{
-				if(mData != 0)
-					delete mData;
-				ReleaseFloatPtr();
-				ReleaseDoublePtr();
+				if(iNewSize > 0 && iNewSize <= mCapacity && mStepSize == 1)
+				{
+					ReleaseFloatPtr();
+					ReleaseDoublePtr();
 
-				mData = nullptr;
-				mStepSize = 1;
-				mLength = iNewSize;
-				if(mLength <= 0)
+					mLength = iNewSize;
+					memset(mData, 0, mLength * sizeof(TData));
 					return;
+				}
 
-				mData = new TFitData[mLength];
-
-				// indicate that we have created this data object
-				mAutoRelease = true;
-
-				memset(mData, 0, mLength * sizeof(TFitData));
+				Reallocate(0, iNewSize);
 			}
 		}
 
@@ -528,40 +591,63 @@ namespace MathFit
 		* Resizes the vector and keeps the data content.
 		* If the vector is enlarged, the original elements are copied to the beginning
 		* of the new vector. The newly added elements are set to zero. If the
-		* vector shrinks, only the first \Ref{iNewSize} elements are copied.
+		* vector shrinks, only the first \Ref{iNewSize} elements are kept.
+		* The buffer is only reallocated if the vector grows beyond its capacity.
 		*
 		* @param iNewSize	The new number of elements in the vector.
 		*
 		* @return A reference to the current object.
 		*/
-		CVector& Resize(int iNewSize)
+		CBasicVector& Resize(int iNewSize)
 		{
-			// create a new vector
-			CVector vNew(iNewSize);
+			if(iNewSize > 0 && iNewSize <= mCapacity && mStepSize == 1)
+			{
+				ReleaseFloatPtr();
+				ReleaseDoublePtr();
 
-			// copy the data elements
-			int i;
-			int iNumElem = std::min(iNewSize, GetSize());
-			for(i = 0; i < iNumElem; i++)
-				vNew.SetAt(i, GetAt(i));
+				if(iNewSize > mLength)
+					memset(&mData[mLength], 0, (iNewSize - mLength) * sizeof(TData));
+				mLength = iNewSize;
+				return *this;
+			}
+
+			Reallocate(iNewSize, iNewSize);
+
+			return *this;
+		}
+
+		/**
+		* Makes sure that the vector can hold the given number of elements without reallocating its buffer.
+		* The size and the content of the vector are not changed. If the vector does not own
+		* its buffer, the elements are copied into a new buffer.
+		*
+		* @param iCapacity	The number of elements to allocate.
+		*
+		* @return A reference to the current object.
+		*/
+		CBasicVector& Reserve(int iCapacity)
+		{
+			if(iCapacity <= mCapacity && mStepSize == 1)
+				return *this;
 
-			// exchange the data arrays
-			Attach(vNew);
-			vNew.Detach();
+			Reallocate(mLength, mLength, iCapacity);
 
 			return *this;
 		}
 
 		/**
 		* Appends the given vector to the current one.
+		* The capacity of the vector grows geometrically, such that appending repeatedly
+		* takes amortized constant time per element.
 		*
 		* @param vApp	The vector to be appended to the current vector.
 		*
 		* @return	A reference to the current vector.
 		*/
-		CVector& Append(CVector& vApp)
+		CBasicVector& Append(CBasicVector& vApp)
 		{
 			int iOldSize = GetSize();
+			Grow(iOldSize + vApp.GetSize());
 			Resize(iOldSize + vApp.GetSize());
 			Copy(iOldSize, vApp);
 
@@ -571,14 +657,17 @@ namespace MathFit
 		/**
 		* Appends a single data element to the vector.
 		* The new element will be added after the last index of the current vector.
+		* The capacity of the vector grows geometrically, such that appending repeatedly
+		* takes amortized constant time per element.
 		*
 		* @param fValue	The value of the new vector element.
 		*
 		* @return	A reference to the current vector.
 		*/
-		CVector& Append(TFitData fValue)
+		CBasicVector& Append(TData fValue)
 		{
 			int iOldSize = GetSize();
+			Grow(iOldSize + 1);
 			Resize(iOldSize + 1);
 			SetAt(GetSize() - 1, fValue);
 
@@ -590,12 +679,12 @@ namespace MathFit
 		*
 		* @return The cleared vector.
 		*/
-		CVector& Zero()
+		CBasicVector& Zero()
 		{
 			MATHFIT_ASSERT(mData != nullptr);
 
 			if(mStepSize == 1)
-				memset(mData, 0, sizeof(TFitData) * mLength);
+				memset(mData, 0, sizeof(TData) * mLength);
 			else
 			{
 				int i;
@@ -625,7 +714,7 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CVector& Invert()
+		CBasicVector& Invert()
 		{
 			int i;
 			for(i = 0; i < mLength; i++)
@@ -639,7 +728,7 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CVector& Inverse()
+		CBasicVector& Inverse()
 		{
 			int i;
 			for(i = 0; i < mLength; i++)
@@ -658,9 +747,9 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CVector& Wedge(TFitData fStart, TFitData fSlope)
+		CBasicVector& Wedge(TData fStart, TData fSlope)
 		{
-			TFitData fVal = fStart;
+			TData fVal = fStart;
 			int i;
 			for(i = 0; i < mLength; i++, fVal += fSlope)
 				SetAt(i, fVal);
@@ -675,10 +764,16 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CVector& Add(CVector& vOperant)
+		CBasicVector& Add(CBasicVector& vOperant)
 		{
 			MATHFIT_ASSERT(mLength == vOperant.GetSize());
 
+			if(mStepSize == 1 && vOperant.mStepSize == 1)
+			{
+				CVectorKernels::Add(mData, vOperant.mData, mData, mLength);
+				return *this;
+			}
+
 			int i;
 			for(i = 0; i < mLength; i++)
 				SetAt(i, GetAt(i) + vOperant.GetAt(i));
@@ -694,10 +789,16 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CVector& Add(CVector& vOperant, TFitData fFactor)
+		CBasicVector& Add(CBasicVector& vOperant, TData fFactor)
 		{
 			MATHFIT_ASSERT(mLength == vOperant.GetSize());
 
+			if(mStepSize == 1 && vOperant.mStepSize == 1)
+			{
+				CVectorKernels::AddScaled(mData, vOperant.mData, fFactor, mData, mLength);
+				return *this;
+			}
+
 			int i;
 			for(i = 0; i < mLength; i++)
 				SetAt(i, GetAt(i) + fFactor * vOperant.GetAt(i));
@@ -711,10 +812,16 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CVector& Sub(CVector& vOperant)
+		CBasicVector& Sub(CBasicVector& vOperant)
 		{
 			MATHFIT_ASSERT(mLength == vOperant.GetSize());
 
+			if(mStepSize == 1 && vOperant.mStepSize == 1)
+			{
+				CVectorKernels::Sub(mData, vOperant.mData, mData, mLength);
+				return *this;
+			}
+
 			int i;
 			for(i = 0; i < mLength; i++)
 				SetAt(i, GetAt(i) - vOperant.GetAt(i));
@@ -730,10 +837,17 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CVector& Sub(CVector& vOperant, TFitData fFactor)
+		CBasicVector& Sub(CBasicVector& vOperant, TData fFactor)
 		{
 			MATHFIT_ASSERT(mLength == vOperant.GetSize());
 
+			// a - f * b is the same as a + (-f) * b, since the negation is exact
+			if(mStepSize == 1 && vOperant.mStepSize == 1)
+			{
+				CVectorKernels::AddScaled(mData, vOperant.mData, -fFactor, mData, mLength);
+				return *this;
+			}
+
 			int i;
 			for(i = 0; i < mLength; i++)
 				SetAt(i, GetAt(i) - fFactor * vOperant.GetAt(i));
@@ -747,17 +861,18 @@ namespace MathFit
 		*
 		* @return	The scalar product of the two vectors.
 		*/
-		TFitData Mul(CVector& vOperant)
+		TData Mul(CBasicVector& vOperant)
 		{
 			MATHFIT_ASSERT(mLength == vOperant.GetSize());
 
-			TFitData fResult = 0;
+			// the sum is built in double precision, also for single precision vectors
+			double fResult = 0;
 
 			int i;
 			for(i = 0; i < mLength; i++)
-				fResult += GetAt(i) * vOperant.GetAt(i);
+				fResult += (double)GetAt(i) * vOperant.GetAt(i);
 
-			return fResult;
+			return (TData)fResult;
 		}
 
 		/**
@@ -767,10 +882,16 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CVector& MulSimple(CVector& vOperant)
+		CBasicVector& MulSimple(CBasicVector& vOperant)
 		{
 			MATHFIT_ASSERT(mLength == vOperant.GetSize());
 
+			if(mStepSize == 1 && vOperant.mStepSize == 1)
+			{
+				CVectorKernels::Mul(mData, vOperant.mData, mData, mLength);
+				return *this;
+			}
+
 			int i;
 			for(i = 0; i < mLength; i++)
 				SetAt(i, GetAt(i) * vOperant.GetAt(i));
@@ -784,7 +905,7 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CVector& DivSimple(CVector& vOperant)
+		CBasicVector& DivSimple(CBasicVector& vOperant)
 		{
 			MATHFIT_ASSERT(mLength == vOperant.GetSize());
 
@@ -804,7 +925,7 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CVector& DivSimpleSafe(CVector& vOperant)
+		CBasicVector& DivSimpleSafe(CBasicVector& vOperant)
 		{
 			MATHFIT_ASSERT(mLength == vOperant.GetSize());
 
@@ -825,8 +946,14 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CVector& Add(TFitData fScalar)
+		CBasicVector& Add(TData fScalar)
 		{
+			if(mStepSize == 1)
+			{
+				CVectorKernels::AddScalar(mData, fScalar, mData, mLength);
+				return *this;
+			}
+
 			int i;
 			for(i = 0; i < mLength; i++)
 				SetAt(i, GetAt(i) + fScalar);
@@ -841,8 +968,15 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CVector& Sub(TFitData fScalar)
+		CBasicVector& Sub(TData fScalar)
 		{
+			// a - s is the same as a + (-s)
+			if(mStepSize == 1)
+			{
+				CVectorKernels::AddScalar(mData, (TData)-fScalar, mData, mLength);
+				return *this;
+			}
+
 			int i;
 			for(i = 0; i < mLength; i++)
 				SetAt(i, GetAt(i) - fScalar);
@@ -857,8 +991,14 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CVector& Mul(TFitData fScalar)
+		CBasicVector& Mul(TData fScalar)
 		{
+			if(mStepSize == 1)
+			{
+				CVectorKernels::MulScalar(mData, fScalar, mData, mLength);
+				return *this;
+			}
+
 			int i;
 			for(i = 0; i < mLength; i++)
 				SetAt(i, GetAt(i) * fScalar);
@@ -873,8 +1013,14 @@ namespace MathFit
 		*
 		* @return	A reference to the current object.
 		*/
-		CVector& Div(TFitData fScalar)
+		CBasicVector& Div(TData fScalar)
 		{
+			if(mStepSize == 1)
+			{
+				CVectorKernels::DivScalar(mData, fScalar, mData, mLength);
+				return *this;
+			}
+
 			int i;
 			for(i = 0; i < mLength; i++)
 				SetAt(i, GetAt(i) / fScalar);
@@ -890,9 +1036,9 @@ namespace MathFit
 		*
 		* @return	The polynomial value at the given point.
 		*/
-		TFitData CalcPoly(TFitData fXValue)
+		TData CalcPoly(TData fXValue)
 		{
-			TFitData fRes;
+			TData fRes;
 			int iGrade = GetSize() - 1;
 
 			// if we do not have a polynomial vector at all (#elements == 0) just return the current X value
@@ -915,9 +1061,9 @@ namespace MathFit
 		*
 		* @return	The polynomial derivation value at the given point.
 		*/
-		TFitData CalcPolySlope(TFitData fXValue)
+		TData CalcPolySlope(TData fXValue)
 		{
-			TFitData fRes;
+			TData fRes;
 			int iGrade = GetSize() - 1;
 
 			// if we do not have a polynomial at all (#elements == 0), just return zero
@@ -941,14 +1087,21 @@ namespace MathFit
 		*
 		* @return	The smalles element of the vector.
 		*/
-		TFitData Min(int iOffset = 0, int iLength = -1)
+		TData Min(int iOffset = 0, int iLength = -1)
 		{
 			if(iLength < 0)
 				iLength = mLength;
 
 			MATHFIT_ASSERT(iOffset >= 0 && (iOffset + iLength) <= mLength && iLength > 0);
 
-			TFitData fMin = GetAt(iOffset);
+			TData fMin, fMax;
+			if(mStepSize == 1)
+			{
+				CVectorKernels::MinMax(&mData[iOffset], iLength, fMin, fMax);
+				return fMin;
+			}
+
+			fMin = GetAt(iOffset);
 			int iOffsetStop = iOffset + iLength;
 			int i;
 			for(i = iOffset + 1; i < iOffsetStop; i++)
@@ -967,14 +1120,21 @@ namespace MathFit
 		*
 		* @return	The biggest element of the vector.
 		*/
-		TFitData Max(int iOffset = 0, int iLength = -1)
+		TData Max(int iOffset = 0, int iLength = -1)
 		{
 			if(iLength < 0)
 				iLength = mLength;
 
 			MATHFIT_ASSERT(iOffset >= 0 && (iOffset + iLength) <= mLength && iLength > 0);
 
-			TFitData fMax = GetAt(iOffset);
+			TData fMin, fMax;
+			if(mStepSize == 1)
+			{
+				CVectorKernels::MinMax(&mData[iOffset], iLength, fMin, fMax);
+				return fMax;
+			}
+
+			fMax = GetAt(iOffset);
 			int iOffsetStop = iOffset + iLength;
 			int i;
 			for(i = iOffset + 1; i < iOffsetStop; i++)
@@ -984,6 +1144,32 @@ namespace MathFit
 			return fMax;
 		}
 
+		/**
+		* Returns the smallest and the biggest element of the vector in one pass.
+		* A range can be specified.
+		*
+		* @param fMin		Receives the smallest element.
+		* @param fMax		Receives the biggest element.
+		* @param iOffset	The index of the first element to inspect.
+		* @param iLength	The number of elements to inspect.
+		*/
+		void MinMax(TData& fMin, TData& fMax, int iOffset = 0, int iLength = -1)
+		{
+			if(iLength < 0)
+				iLength = mLength;
+
+			MATHFIT_ASSERT(iOffset >= 0 && (iOffset + iLength) <= mLength && iLength > 0);
+
+			if(mStepSize == 1)
+			{
+				CVectorKernels::MinMax(&mData[iOffset], iLength, fMin, fMax);
+				return;
+			}
+
+			fMin = Min(iOffset, iLength);
+			fMax = Max(iOffset, iLength);
+		}
+
 		/**
 		* Subtracts the minimum value from all vector elements.
 		* This operation causes all vector elements to be positive afterwards.
@@ -995,14 +1181,14 @@ namespace MathFit
 		*
 		* @return	The former minimum value.
 		*/
-		TFitData BiasAdjust(int iOffset = 0, int iLength = -1)
+		TData BiasAdjust(int iOffset = 0, int iLength = -1)
 		{
 			if(iLength < 0)
 				iLength = mLength;
 
 			MATHFIT_ASSERT(iOffset >= 0 && (iOffset + iLength) <= mLength && iLength > 0);
 
-			TFitData fMin = Min(iOffset, iLength);
+			TData fMin = Min(iOffset, iLength);
 			Sub(fMin);
 			return fMin;
 		}
@@ -1019,14 +1205,16 @@ namespace MathFit
 		*
 		* @return	The former maximum value.
 		*/
-		TFitData Normalize(int iOffset = 0, int iLength = -1)
+		TData Normalize(int iOffset = 0, int iLength = -1)
 		{
 			if(iLength < 0)
 				iLength = mLength;
 
 			MATHFIT_ASSERT(iOffset >= 0 && (iOffset + iLength) <= mLength && iLength > 0);
 
-			TFitData fMax = (TFitData)std::max(fabs(Max(iOffset, iLength)), fabs(Min(iOffset, iLength)));
+			TData fMin, fMax;
+			MinMax(fMin, fMax, iOffset, iLength);
+			fMax = (TData)std::max(fabs(fMax), fabs(fMin));
 			Div(fMax);
 			return fMax;
 		}
@@ -1036,6 +1224,7 @@ namespace MathFit
 			ReleaseFloatPtr();
 
 			mFloatPtr = new float[GetSize()];
+			CAllocationCounter::Add();
 
 			int i;
 			for(i = 0; i < GetSize(); i++)
@@ -1056,6 +1245,7 @@ namespace MathFit
 			ReleaseDoublePtr();
 
 			mDoublePtr = new double[GetSize()];
+			CAllocationCounter::Add();
 
 			int i;
 			for(i = 0; i < GetSize(); i++)
@@ -1090,7 +1280,7 @@ namespace MathFit
 			GREATEREQUAL
 		};
 
-		int FindIndex(TFitData fValue, enum EIndexConditions eCondition = EQUAL) const
+		int FindIndex(TData fValue, enum EIndexConditions eCondition = EQUAL) const
 		{
 			int iLow = 0;
 			int iHigh = GetSize() - 1;
@@ -1099,7 +1289,7 @@ namespace MathFit
 			while(iHigh - iLow > 1)
 			{
 				const int iMid = iLow + (iHigh - iLow) / 2;
-				const TFitData fData = GetAt(iMid);
+				const TData fData = GetAt(iMid);
 
 				if(fData >= fValue)
 					iHigh = iMid;
@@ -1107,8 +1297,8 @@ namespace MathFit
 					iLow = iMid;
 			}
 
-			const TFitData fLowData = GetAt(iLow);
-			TFitData fHighData = GetAt(iHigh);
+			const TData fLowData = GetAt(iLow);
+			TData fHighData = GetAt(iHigh);
 
 			// if the data at the higher and lower bound is equal, we need to find
 			// the next high bound value that is greater than the lower bound
@@ -1157,7 +1347,7 @@ namespace MathFit
 		 * This overload is present to prevent the user from accidently assigning vector objects without knowing
 		 * wheter the content is copied or attached. Please use explicitly Copy or Attach instead.
 		 */
-		CVector& operator=(CVector& vOp)
+		CBasicVector& operator=(CBasicVector& vOp)
 		{
 			// !! The direct assignment of vectors is not allowed, since we may get into ambigousity wheter we have to 
 			// !! attach or copy the current vector.
@@ -1166,6 +1356,24 @@ namespace MathFit
 			return vOp;
 		}
 
+		/**
+		 * Move assignment operator
+		 *
+		 * The current object takes over the content of the given temporary vector, the same as \Ref{Attach}.
+		 * Its previous content is released and the given vector is empty afterwards.
+		 */
+		CBasicVector& operator=(CBasicVector&& vOp)
+		{
+			if(this != &vOp)
+			{
+				// the previous content is released when vOld is destroyed
+				CBasicVector vOld;
+				vOld.Exchange(*this);
+				Exchange(vOp);
+			}
+			return *this;
+		}
+
 		/**
 		* Prints the content of the vector to the given out stream.
 		*
@@ -1174,7 +1382,7 @@ namespace MathFit
 		*
 		* @return A reference to the output stream itself.
 		*/
-		friend std::ostream& operator<<(std::ostream& os, CVector& vData)
+		friend std::ostream& operator<<(std::ostream& os, CBasicVector& vData)
 		{
 			const int iSize = vData.GetSize();
 
@@ -1190,14 +1398,74 @@ namespace MathFit
 		}
 
 	protected:
+		/**
+		* Reallocates the buffer of the vector. The first elements are kept, all other elements are set to zero.
+		*
+		* @param iKeepSize	The number of elements to keep.
+		* @param iNewSize	The new number of elements in the vector. The buffer holds at least this many elements.
+		* @param iCapacity	The number of elements to allocate.
+		*/
+		void Reallocate(int iKeepSize, int iNewSize, int iCapacity = 0)
+		{
+			iCapacity = std::max(iCapacity, iNewSize);
+			iKeepSize = std::min(std::min(iKeepSize, iNewSize), mLength);
+
+			TData* fData = nullptr;
+			if(iCapacity > 0)
+			{
+				fData = CVectorKernels::Allocate<TData>(iCapacity);
+				CAllocationCounter::Add();
+
+				if(iKeepSize > 0)
+				{
+					if(mStepSize == 1)
+						memcpy(fData, mData, iKeepSize * sizeof(TData));
+					else
+					{
+						int i;
+						for(i = 0; i < iKeepSize; i++)
+							fData[i] = GetAt(i);
+					}
+				}
+				memset(&fData[iKeepSize], 0, (iCapacity - iKeepSize) * sizeof(TData));
+			}
+
+			if(mData != 0 && mAutoRelease)
+				CVectorKernels::Free(mData);
+			ReleaseFloatPtr();
+			ReleaseDoublePtr();
+
+			// indicate that we have created this data object
+			mData = fData;
+			mLength = std::max(iNewSize, 0);
+			mCapacity = iCapacity;
+			mStepSize = 1;
+			mAutoRelease = true;
+		}
+
+		/**
+		* Enlarges the capacity of the vector geometrically, if it can not hold the given number of elements.
+		*
+		* @param iMinSize	The number of elements the vector must be able to hold.
+		*/
+		void Grow(int iMinSize)
+		{
+			if(iMinSize > mCapacity || mStepSize != 1)
+				Reserve(std::max(iMinSize, std::max(2 * mCapacity, 16)));
+		}
+
 		/**
 		* Contains the length of the vector.
 		*/
 		int mLength;
 		/**
+		* Contains the number of elements allocated in the buffer. This is zero if the buffer is not owned by the vector.
+		*/
+		int mCapacity;
+		/**
 		* Array containing the vector elements.
 		*/
-		TFitData* mData;
+		TData* mData;
 		/**
 		* Contains a flag indicating wheter we have to release the data buffer on destruction or not.
 		* This flag may be set to FALSE if the current object is a sub vector of another object.
@@ -1215,5 +1483,16 @@ namespace MathFit
 		float* mFloatPtr;
 		double* mDoublePtr;
 	};
+
+	/**
+	* The vector type used for the data of the fit. The precision of the elements is selected by \Ref{TFitData}.
+	*/
+	typedef CBasicVector<TFitData> CVector;
+
+	/**
+	* A vector which always uses double precision elements, independent of \Ref{TFitData}. It is used to
+	* accumulate the normal equations of the fit.
+	*/
+	typedef CBasicVector<double> CDoubleVector;
 }
 #endif
@@ -0,0 +1,1019 @@
+/**
+* Contains the element-wise and reduction kernels of the vector class and the allocation of aligned buffers.
+*/
+#if !defined(VECTORKERNELS_H_011206)
+#define VECTORKERNELS_H_011206
+
+#include <new>
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#if defined(_MSC_VER)
+#include <malloc.h>
+#include <intrin.h>
+#endif
+
+// select the vector instruction set. On x86 processors the AVX2 kernels are compiled independent of the
+// compiler settings and are used if the processor supports them, which is checked at runtime.
+// On ARM64 processors NEON is always available.
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MATHFIT_VECTORKERNELS_AVX2
+#if defined(_MSC_VER) && !defined(__clang__)
+#define MATHFIT_VECTORKERNELS_TARGET
+#else
+#define MATHFIT_VECTORKERNELS_TARGET __attribute__((target("avx2")))
+#endif
+#elif (defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define MATHFIT_VECTORKERNELS_NEON
+#define MATHFIT_VECTORKERNELS_TARGET
+#endif
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+namespace MathFit
+{
+#if defined(MATHFIT_VECTORKERNELS_AVX2) || defined(MATHFIT_VECTORKERNELS_NEON)
+	/**
+	* Wraps the vector instructions for one element type, such that the kernels of \Ref{CVectorKernels}
+	* can be written once for all element types and instruction sets.
+	* The comparisons return masks with all bits set where they are true, which are used by Select.
+	* The double registers also split and scale the floating point numbers for the logarithm and the exponential function.
+	*/
+	template<class TData>
+	struct CVectorRegister;
+
+#if defined(MATHFIT_VECTORKERNELS_AVX2)
+	template<>
+	struct CVectorRegister<double>
+	{
+		typedef __m256d TRegister;
+		enum { WIDTH = 4 };
+
+		MATHFIT_VECTORKERNELS_TARGET static TRegister Load(const double* fData) { return _mm256_loadu_pd(fData); }
+		MATHFIT_VECTORKERNELS_TARGET static void Store(double* fData, TRegister vValue) { _mm256_storeu_pd(fData, vValue); }
+		MATHFIT_VECTORKERNELS_TARGET static TRegister Set(double fValue) { return _mm256_set1_pd(fValue); }
+		MATHFIT_VECTORKERNELS_TARGET static TRegister Add(TRegister vFirst, TRegister vSecond) { return _mm256_add_pd(vFirst, vSecond); }
+		MATHFIT_VECTORKERNELS_TARGET static TRegister Sub(TRegister vFirst, TRegister vSecond) { return _mm256_sub_pd(vFirst, vSecond); }
+		MATHFIT_VECTORKERNELS_TARGET static TRegister Mul(TRegister vFirst, TRegister vSecond) { return _mm256_mul_pd(vFirst, vSecond); }
+		MATHFIT_VECTORKERNELS_TARGET static TRegister Div(TRegister vFirst, TRegister vSecond) { return _mm256_div_pd(vFirst, vSecond); }
+		MATHFIT_VECTORKERNELS_TARGET static TRegister Min(TRegister vFirst, TRegister vSecond) { return _mm256_min_pd(vFirst, vSecond); }
+		MATHFIT_VECTORKERNELS_TARGET static TRegister Max(TRegister vFirst, TRegister vSecond) { return _mm256_max_pd(vFirst, vSecond); }
+		MATHFIT_VECTORKERNELS_TARGET static TRegister Abs(TRegister vValue) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), vValue); }
+		MATHFIT_VECTORKERNELS_TARGET static TRegister IsZero(TRegister vValue) { return _mm256_cmp_pd(vValue, _mm256_setzero_pd(), _CMP_EQ_OQ); }
+		MATHFIT_VECTORKERNELS_TARGET static TRegister IsGreater(TRegister vFirst, TRegister vSecond) { return _mm256_cmp_pd(vFirst, vSecond, _CMP_GT_OQ); }
+		MATHFIT_VECTORKERNELS_TARGET static TRegister Select(TRegister vMask, TRegister vTrue, TRegister vFalse) { return _mm256_blendv_pd(vFalse, vTrue, vMask); }
+		MATHFIT_VECTORKERNELS_TARGET static TRegister Round(TRegister vValue) { return _mm256_round_pd(vValue, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+		// true if all elements are within the range, which is false for NaN
+		MATHFIT_VECTORKERNELS_TARGET static bool IsInRange(TRegister vValue, double fLow, double fHigh)
+		{
+			const TRegister vInside = _mm256_and_pd(_mm256_cmp_pd(vValue, _mm256_set1_pd(fLow), _CMP_GE_OQ), _mm256_cmp_pd(vValue, _mm256_set1_pd(fHigh), _CMP_LE_OQ));
+			return _mm256_movemask_pd(vInside) == 0xF;
+		}
+
+		// splits positive normalized numbers into the mantissa in [1, 2), which is returned, and the exponent
+		MATHFIT_VECTORKERNELS_TARGET static TRegister Split(TRegister vValue, TRegister& vExponent)
+		{
+			// the biased exponent becomes the low bits of 2^52, which is then subtracted
+			const __m256i iBits = _mm256_castpd_si256(vValue);
+			const __m256i iExponent = _mm256_or_si256(_mm256_srli_epi64(iBits, 52), _mm256_set1_epi64x(0x4330000000000000LL));
+			vExponent = _mm256_sub_pd(_mm256_castsi256_pd(iExponent), _mm256_set1_pd(4503599627370496.0 + 1023.0));
+			const __m256i iMantissa = _mm256_and_si256(iBits, _mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL));
+			return _mm256_castsi256_pd(_mm256_or_si256(iMantissa, _mm256_set1_epi64x(0x3FF0000000000000LL)));
+		}
+
+		// multiplies with 2^exponent, the exponents must be integers in [-1022, 1023]
+		MATHFIT_VECTORKERNELS_TARGET static TRegister Scale(TRegister vValue, TRegister vExponent)
+		{
+			// the biased exponent is found in the low bits of 2^52 + 1023 + exponent
+			const __m256i iBiased = _mm256_castpd_si256(_mm256_add_pd(vExponent, _mm256_set1_pd(4503599627370496.0 + 1023.0)));
+			return _mm256_mul_pd(vValue, _mm256_castsi256_pd(_mm256_slli_epi64(iBiased, 52)));
+		}
+	};
+
+	template<>
+	struct CVectorRegister<float>
+	{
+		typedef __m256 TRegister;
+		enum { WIDTH = 8 };
+
+		MATHFIT_VECTORKERNELS_TARGET static TRegister Load(const float* fData) { return _mm256_loadu_ps(fData); }
+		MATHFIT_VECTORKERNELS_TARGET static void Store(float* fData, TRegister vValue) { _mm256_storeu_ps(fData, vValue); }
+		MATHFIT_VECTORKERNELS_TARGET static TRegister Set(float fValue) { return _mm256_set1_ps(fValue); }
+		MATHFIT_VECTORKERNELS_TARGET static TRegister Add(TRegister vFirst, TRegister vSecond) { return _mm256_add_ps(vFirst, vSecond); }
+		MATHFIT_VECTORKERNELS_TARGET static TRegister Sub(TRegister vFirst, TRegister vSecond) { return _mm256_sub_ps(vFirst, vSecond); }
+		MATHFIT_VECTORKERNELS_TARGET static TRegister Mul(TRegister vFirst, TRegister vSecond) { return _mm256_mul_ps(vFirst, vSecond); }
+		MATHFIT_VECTORKERNELS_TARGET static TRegister Div(TRegister vFirst, TRegister vSecond) { return _mm256_div_ps(vFirst, vSecond); }
+		MATHFIT_VECTORKERNELS_TARGET static TRegister Min(TRegister vFirst, TRegister vSecond) { return _mm256_min_ps(vFirst, vSecond); }
+		MATHFIT_VECTORKERNELS_TARGET static TRegister Max(TRegister vFirst, TRegister vSecond) { return _mm256_max_ps(vFirst, vSecond); }
+		MATHFIT_VECTORKERNELS_TARGET static TRegister Abs(TRegister vValue) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), vValue); }
+		MATHFIT_VECTORKERNELS_TARGET static TRegister IsZero(TRegister vValue) { return _mm256_cmp_ps(vValue, _mm256_setzero_ps(), _CMP_EQ_OQ); }
+		MATHFIT_VECTORKERNELS_TARGET static TRegister IsGreater(TRegister vFirst, TRegister vSecond) { return _mm256_cmp_ps(vFirst, vSecond, _CMP_GT_OQ); }
+		MATHFIT_VECTORKERNELS_TARGET static TRegister Select(TRegister vMask, TRegister vTrue, TRegister vFalse) { return _mm256_blendv_ps(vFalse, vTrue, vMask); }
+
+		// converts the lower and the upper half of the elements to double precision
+		MATHFIT_VECTORKERNELS_TARGET static void Widen(TRegister vValue, __m256d& vLow, __m256d& vHigh)
+		{
+			vLow = _mm256_cvtps_pd(_mm256_castps256_ps128(vValue));
+			vHigh = _mm256_cvtps_pd(_mm256_extractf128_ps(vValue, 1));
+		}
+	};
+#else
+	template<>
+	struct CVectorRegister<double>
+	{
+		typedef float64x2_t TRegister;
+		enum { WIDTH = 2 };
+
+		static TRegister Load(const double* fData) { return vld1q_f64(fData); }
+		static void Store(double* fData, TRegister vValue) { vst1q_f64(fData, vValue); }
+		static TRegister Set(double fValue) { return vdupq_n_f64(fValue); }
+		static TRegister Add(TRegister vFirst, TRegister vSecond) { return vaddq_f64(vFirst, vSecond); }
+		static TRegister Sub(TRegister vFirst, TRegister vSecond) { return vsubq_f64(vFirst, vSecond); }
+		static TRegister Mul(TRegister vFirst, TRegister vSecond) { return vmulq_f64(vFirst, vSecond); }
+		static TRegister Div(TRegister vFirst, TRegister vSecond) { return vdivq_f64(vFirst, vSecond); }
+		static TRegister Min(TRegister vFirst, TRegister vSecond) { return vminq_f64(vFirst, vSecond); }
+		static TRegister Max(TRegister vFirst, TRegister vSecond) { return vmaxq_f64(vFirst, vSecond); }
+		static TRegister Abs(TRegister vValue) { return vabsq_f64(vValue); }
+		static TRegister IsZero(TRegister vValue) { return vreinterpretq_f64_u64(vceqzq_f64(vValue)); }
+		static TRegister IsGreater(TRegister vFirst, TRegister vSecond) { return vreinterpretq_f64_u64(vcgtq_f64(vFirst, vSecond)); }
+		static TRegister Select(TRegister vMask, TRegister vTrue, TRegister vFalse) { return vbslq_f64(vreinterpretq_u64_f64(vMask), vTrue, vFalse); }
+		static TRegister Round(TRegister vValue) { return vrndnq_f64(vValue); }
+
+		// true if all elements are within the range, which is false for NaN
+		static bool IsInRange(TRegister vValue, double fLow, double fHigh)
+		{
+			const uint64x2_t vInside = vandq_u64(vcgeq_f64(vValue, vdupq_n_f64(fLow)), vcleq_f64(vValue, vdupq_n_f64(fHigh)));
+			return vminvq_u32(vreinterpretq_u32_u64(vInside)) != 0;
+		}
+
+		// splits positive normalized numbers into the mantissa in [1, 2), which is returned, and the exponent
+		static TRegister Split(TRegister vValue, TRegister& vExponent)
+		{
+			const uint64x2_t iBits = vreinterpretq_u64_f64(vValue);
+			vExponent = vsubq_f64(vcvtq_f64_u64(vshrq_n_u64(iBits, 52)), vdupq_n_f64(1023.0));
+			const uint64x2_t iMantissa = vandq_u64(iBits, vdupq_n_u64(0x000FFFFFFFFFFFFFULL));
+			return vreinterpretq_f64_u64(vorrq_u64(iMantissa, vdupq_n_u64(0x3FF0000000000000ULL)));
+		}
+
+		// multiplies with 2^exponent, the exponents must be integers in [-1022, 1023]
+		static TRegister Scale(TRegister vValue, TRegister vExponent)
+		{
+			const int64x2_t iBiased = vaddq_s64(vcvtq_s64_f64(vExponent), vdupq_n_s64(1023));
+			return vmulq_f64(vValue, vreinterpretq_f64_s64(vshlq_n_s64(iBiased, 52)));
+		}
+	};
+
+	template<>
+	struct CVectorRegister<float>
+	{
+		typedef float32x4_t TRegister;
+		enum { WIDTH = 4 };
+
+		static TRegister Load(const float* fData) { return vld1q_f32(fData); }
+		static void Store(float* fData, TRegister vValue) { vst1q_f32(fData, vValue); }
+		static TRegister Set(float fValue) { return vdupq_n_f32(fValue); }
+		static TRegister Add(TRegister vFirst, TRegister vSecond) { return vaddq_f32(vFirst, vSecond); }
+		static TRegister Sub(TRegister vFirst, TRegister vSecond) { return vsubq_f32(vFirst, vSecond); }
+		static TRegister Mul(TRegister vFirst, TRegister vSecond) { return vmulq_f32(vFirst, vSecond); }
+		static TRegister Div(TRegister vFirst, TRegister vSecond) { return vdivq_f32(vFirst, vSecond); }
+		static TRegister Min(TRegister vFirst, TRegister vSecond) { return vminq_f32(vFirst, vSecond); }
+		static TRegister Max(TRegister vFirst, TRegister vSecond) { return vmaxq_f32(vFirst, vSecond); }
+		static TRegister Abs(TRegister vValue) { return vabsq_f32(vValue); }
+		static TRegister IsZero(TRegister vValue) { return vreinterpretq_f32_u32(vceqzq_f32(vValue)); }
+		static TRegister IsGreater(TRegister vFirst, TRegister vSecond) { return vreinterpretq_f32_u32(vcgtq_f32(vFirst, vSecond)); }
+		static TRegister Select(TRegister vMask, TRegister vTrue, TRegister vFalse) { return vbslq_f32(vreinterpretq_u32_f32(vMask), vTrue, vFalse); }
+
+		// converts the lower and the upper half of the elements to double precision
+		static void Widen(TRegister vValue, float64x2_t& vLow, float64x2_t& vHigh)
+		{
+			vLow = vcvt_f64_f32(vget_low_f32(vValue));
+			vHigh = vcvt_high_f64_f32(vValue);
+		}
+	};
+#endif
+#endif
+
+	/**
+	* Implements the element-wise operations and the reductions of \Ref{CBasicVector} on contiguous arrays,
+	* and allocates the aligned buffers of the vectors and matrices.
+	*
+	* Every kernel uses vector instructions if they are available and falls back to a scalar loop otherwise.
+	* On x86 processors the availability of AVX2 is checked once at runtime, so the kernels do not depend on
+	* the instruction set the application is compiled for. The element-wise operations give exactly the same
+	* results as the scalar loops. The sum is built in a different order, so it may differ in the last digits.
+	* The logarithm and the exponential function are approximated by polynomials and differ from the
+	* functions of the C library by at most one unit in the last place.
+	*/
+	class CVectorKernels
+	{
+	public:
+		enum EDefines
+		{
+			/**
+			* The alignment of the allocated buffers in bytes. This is the size of a cache line.
+			* The size of every buffer is padded to a multiple of this.
+			*/
+			ALIGNMENT = 64
+		};
+
+		/**
+		* Allocates an aligned buffer. The buffer must be freed by \Ref{Free}.
+		*
+		* @param iSize	The number of elements.
+		*
+		* @return	The uninitialized buffer.
+		*/
+		template<class TData>
+		static TData* Allocate(int iSize)
+		{
+			const size_t iBytes = ((size_t)iSize * sizeof(TData) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+
+			void* pBuffer;
+#if defined(_MSC_VER)
+			pBuffer = _aligned_malloc(iBytes, ALIGNMENT);
+#else
+			if(posix_memalign(&pBuffer, ALIGNMENT, iBytes) != 0)
+				pBuffer = nullptr;
+#endif
+			if(pBuffer == nullptr)
+				throw std::bad_alloc();
+
+			return (TData*)pBuffer;
+		}
+
+		/**
+		* Frees a buffer allocated by \Ref{Allocate}.
+		*
+		* @param pBuffer	The buffer. May be NULL.
+		*/
+		static void Free(void* pBuffer)
+		{
+#if defined(_MSC_VER)
+			_aligned_free(pBuffer);
+#else
+			free(pBuffer);
+#endif
+		}
+
+		/**
+		* Returns true if the processor supports the vector instructions used by the kernels.
+		*/
+		static bool IsSupported()
+		{
+#if defined(MATHFIT_VECTORKERNELS_NEON) || defined(__AVX2__)
+			return true;
+#elif defined(MATHFIT_VECTORKERNELS_AVX2) && defined(_MSC_VER) && !defined(__clang__)
+			int iInfo[4];
+			__cpuid(iInfo, 0);
+			if(iInfo[0] < 7)
+				return false;
+
+			// the operating system must save the AVX registers
+			__cpuid(iInfo, 1);
+			const int iOsXSaveAndAvx = (1 << 27) | (1 << 28);
+			if((iInfo[2] & iOsXSaveAndAvx) != iOsXSaveAndAvx || (_xgetbv(0) & 6) != 6)
+				return false;
+
+			__cpuidex(iInfo, 7, 0);
+			return (iInfo[1] & (1 << 5)) != 0;
+#elif defined(MATHFIT_VECTORKERNELS_AVX2)
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("avx2") != 0;
+#else
+			return false;
+#endif
+		}
+
+		/**
+		* Returns true if the kernels use vector instructions.
+		*/
+		static bool IsVectorized()
+		{
+			return VectorizedFlag();
+		}
+
+		/**
+		* Selects whether the kernels use vector instructions. This is mainly used to compare
+		* the kernels with the scalar implementation.
+		*
+		* @param bVectorize	If TRUE vector instructions are used, if the processor supports them.
+		*/
+		static void SetVectorized(bool bVectorize)
+		{
+			VectorizedFlag() = bVectorize && IsSupported();
+		}
+
+		/**
+		* Adds two arrays element by element.
+		*
+		* @param fFirst		The first operand.
+		* @param fSecond	The second operand.
+		* @param fResult	Receives the sums. May be the same as one of the operands.
+		* @param iSize		The number of elements in all arrays.
+		*/
+		template<class TData>
+		static void Add(const TData* fFirst, const TData* fSecond, TData* fResult, int iSize)
+		{
+			int i = 0;
+#if defined(MATHFIT_VECTORKERNELS_TARGET)
+			if(IsVectorized())
+				i = AddVectorized(fFirst, fSecond, fResult, iSize);
+#endif
+			for(; i < iSize; i++)
+				fResult[i] = fFirst[i] + fSecond[i];
+		}
+
+		/**
+		* Adds the scaled second array to the first one element by element.
+		*
+		* @param fFirst		The first operand.
+		* @param fSecond	The second operand.
+		* @param fFactor	The factor used to scale the second operand.
+		* @param fResult	Receives the sums. May be the same as one of the operands.
+		* @param iSize		The number of elements in all arrays.
+		*/
+		template<class TData>
+		static void AddScaled(const TData* fFirst, const TData* fSecond, TData fFactor, TData* fResult, int iSize)
+		{
+			int i = 0;
+#if defined(MATHFIT_VECTORKERNELS_TARGET)
+			if(IsVectorized())
+				i = AddScaledVectorized(fFirst, fSecond, fFactor, fResult, iSize);
+#endif
+			for(; i < iSize; i++)
+				fResult[i] = fFirst[i] + fFactor * fSecond[i];
+		}
+
+		/**
+		* Subtracts two arrays element by element.
+		*
+		* @param fFirst		The first operand.
+		* @param fSecond	The second operand, which is subtracted from the first one.
+		* @param fResult	Receives the differences. May be the same as one of the operands.
+		* @param iSize		The number of elements in all arrays.
+		*/
+		template<class TData>
+		static void Sub(const TData* fFirst, const TData* fSecond, TData* fResult, int iSize)
+		{
+			int i = 0;
+#if defined(MATHFIT_VECTORKERNELS_TARGET)
+			if(IsVectorized())
+				i = SubVectorized(fFirst, fSecond, fResult, iSize);
+#endif
+			for(; i < iSize; i++)
+				fResult[i] = fFirst[i] - fSecond[i];
+		}
+
+		/**
+		* Multiplies two arrays element by element.
+		*
+		* @param fFirst		The first operand.
+		* @param fSecond	The second operand.
+		* @param fResult	Receives the products. May be the same as one of the operands.
+		* @param iSize		The number of elements in all arrays.
+		*/
+		template<class TData>
+		static void Mul(const TData* fFirst, const TData* fSecond, TData* fResult, int iSize)
+		{
+			int i = 0;
+#if defined(MATHFIT_VECTORKERNELS_TARGET)
+			if(IsVectorized())
+				i = MulVectorized(fFirst, fSecond, fResult, iSize);
+#endif
+			for(; i < iSize; i++)
+				fResult[i] = fFirst[i] * fSecond[i];
+		}
+
+		/**
+		* Adds a scalar to every element of an array.
+		*
+		* @param fData		The array.
+		* @param fScalar	The scalar.
+		* @param fResult	Receives the sums. May be the same as the array.
+		* @param iSize		The number of elements in the arrays.
+		*/
+		template<class TData>
+		static void AddScalar(const TData* fData, TData fScalar, TData* fResult, int iSize)
+		{
+			int i = 0;
+#if defined(MATHFIT_VECTORKERNELS_TARGET)
+			if(IsVectorized())
+				i = AddScalarVectorized(fData, fScalar, fResult, iSize);
+#endif
+			for(; i < iSize; i++)
+				fResult[i] = fData[i] + fScalar;
+		}
+
+		/**
+		* Multiplies every element of an array by a scalar.
+		*
+		* @param fData		The array.
+		* @param fScalar	The scalar.
+		* @param fResult	Receives the products. May be the same as the array.
+		* @param iSize		The number of elements in the arrays.
+		*/
+		template<class TData>
+		static void MulScalar(const TData* fData, TData fScalar, TData* fResult, int iSize)
+		{
+			int i = 0;
+#if defined(MATHFIT_VECTORKERNELS_TARGET)
+			if(IsVectorized())
+				i = MulScalarVectorized(fData, fScalar, fResult, iSize);
+#endif
+			for(; i < iSize; i++)
+				fResult[i] = fData[i] * fScalar;
+		}
+
+		/**
+		* Divides every element of an array by a scalar.
+		*
+		* @param fData		The array.
+		* @param fScalar	The scalar.
+		* @param fResult	Receives the quotients. May be the same as the array.
+		* @param iSize		The number of elements in the arrays.
+		*/
+		template<class TData>
+		static void DivScalar(const TData* fData, TData fScalar, TData* fResult, int iSize)
+		{
+			int i = 0;
+#if defined(MATHFIT_VECTORKERNELS_TARGET)
+			if(IsVectorized())
+				i = DivScalarVectorized(fData, fScalar, fResult, iSize);
+#endif
+			for(; i < iSize; i++)
+				fResult[i] = fData[i] / fScalar;
+		}
+
+		/**
+		* Multiplies the first array with the scaled second one element by element.
+		*
+		* @param fFirst		The first operand.
+		* @param fSecond	The second operand.
+		* @param fFactor	The factor used to scale the second operand.
+		* @param fResult	Receives the products. May be the same as one of the operands.
+		* @param iSize		The number of elements in all arrays.
+		*/
+		template<class TData>
+		static void MulScaled(const TData* fFirst, const TData* fSecond, TData fFactor, TData* fResult, int iSize)
+		{
+			int i = 0;
+#if defined(MATHFIT_VECTORKERNELS_TARGET)
+			if(IsVectorized())
+				i = MulScaledVectorized(fFirst, fSecond, fFactor, fResult, iSize);
+#endif
+			for(; i < iSize; i++)
+				fResult[i] = fFirst[i] * (fFactor * fSecond[i]);
+		}
+
+		/**
+		* Divides two arrays element by element. The quotient is zero where the divisor is zero.
+		*
+		* @param fFirst		The dividends.
+		* @param fSecond	The divisors.
+		* @param fResult	Receives the quotients. May be the same as one of the operands.
+		* @param iSize		The number of elements in all arrays.
+		*/
+		template<class TData>
+		static void Div(const TData* fFirst, const TData* fSecond, TData* fResult, int iSize)
+		{
+			int i = 0;
+#if defined(MATHFIT_VECTORKERNELS_TARGET)
+			// the product with one does not change the divisors
+			if(IsVectorized())
+				i = DivScaledVectorized(fFirst, fSecond, (TData)1, fResult, iSize);
+#endif
+			for(; i < iSize; i++)
+				fResult[i] = (fSecond[i] != 0) ? fFirst[i] / fSecond[i] : 0;
+		}
+
+		/**
+		* Divides the first array by the scaled second one element by element.
+		* The quotient is zero where the unscaled divisor is zero.
+		*
+		* @param fFirst		The dividends.
+		* @param fSecond	The divisors.
+		* @param fFactor	The factor used to scale the divisors.
+		* @param fResult	Receives the quotients. May be the same as one of the operands.
+		* @param iSize		The number of elements in all arrays.
+		*/
+		template<class TData>
+		static void DivScaled(const TData* fFirst, const TData* fSecond, TData fFactor, TData* fResult, int iSize)
+		{
+			int i = 0;
+#if defined(MATHFIT_VECTORKERNELS_TARGET)
+			if(IsVectorized())
+				i = DivScaledVectorized(fFirst, fSecond, fFactor, fResult, iSize);
+#endif
+			for(; i < iSize; i++)
+				fResult[i] = (fSecond[i] != 0) ? fFirst[i] / (fFactor * fSecond[i]) : 0;
+		}
+
+		/**
+		* Calculates the reciprocal of every element of an array.
+		*
+		* @param fData		The array.
+		* @param fResult	Receives the reciprocals. May be the same as the array.
+		* @param iSize		The number of elements in the arrays.
+		*/
+		template<class TData>
+		static void Reciprocal(const TData* fData, TData* fResult, int iSize)
+		{
+			int i = 0;
+#if defined(MATHFIT_VECTORKERNELS_TARGET)
+			if(IsVectorized())
+				i = ReciprocalVectorized(fData, fResult, iSize);
+#endif
+			for(; i < iSize; i++)
+				fResult[i] = 1 / fData[i];
+		}
+
+		/**
+		* Calculates the natural logarithm of every element of an array.
+		* The logarithm of values which are not positive is zero.
+		*
+		* The vectorized logarithm uses the same approximation as the C library of most systems and
+		* differs from the library function by at most one unit in the last place. Infinite, denormalized
+		* and NaN values are passed to the library function.
+		*
+		* @param fData		The array.
+		* @param fResult	Receives the logarithms. May be the same as the array.
+		* @param iSize		The number of elements in the arrays.
+		*/
+		static void Log(const double* fData, double* fResult, int iSize)
+		{
+			int i = 0;
+#if defined(MATHFIT_VECTORKERNELS_TARGET)
+			if(IsVectorized())
+				i = LogVectorized(fData, fResult, iSize);
+#endif
+			for(; i < iSize; i++)
+				fResult[i] = fData[i] <= 0 ? 0.0 : log(fData[i]);
+		}
+
+		/**
+		* Calculates the exponential function of every element of an array.
+		*
+		* The vectorized exponential function differs from the library function by at most one unit in the
+		* last place. Values whose result would be denormalized or infinite are passed to the library function.
+		*
+		* @param fData		The array.
+		* @param fResult	Receives the results. May be the same as the array.
+		* @param iSize		The number of elements in the arrays.
+		*/
+		static void Exp(const double* fData, double* fResult, int iSize)
+		{
+			int i = 0;
+#if defined(MATHFIT_VECTORKERNELS_TARGET)
+			if(IsVectorized())
+				i = ExpVectorized(fData, fResult, iSize);
+#endif
+			for(; i < iSize; i++)
+				fResult[i] = exp(fData[i]);
+		}
+
+		/**
+		* Finds the biggest absolute value of an array. NaN values are ignored.
+		*
+		* @param fData	The array.
+		* @param iSize	The number of elements in the array.
+		*
+		* @return	The biggest absolute value, or zero if the array is empty.
+		*/
+		template<class TData>
+		static TData MaxAbs(const TData* fData, int iSize)
+		{
+			int i = 0;
+			TData fMax = 0;
+#if defined(MATHFIT_VECTORKERNELS_TARGET)
+			if(IsVectorized())
+				i = MaxAbsVectorized(fData, iSize, fMax);
+#endif
+			for(; i < iSize; i++)
+			{
+				const TData fAbs = fData[i] < 0 ? -fData[i] : fData[i];
+				if(fAbs > fMax)
+					fMax = fAbs;
+			}
+			return fMax;
+		}
+
+		/**
+		* Calculates the sum of an array.
+		*
+		* @param fData	The array.
+		* @param iSize	The number of elements in the array.
+		*
+		* @return	The sum of the elements.
+		*/
+		template<class TData>
+		static TData Sum(const TData* fData, int iSize)
+		{
+			int i = 0;
+			TData fSum = 0;
+#if defined(MATHFIT_VECTORKERNELS_TARGET)
+			if(IsVectorized())
+				i = SumVectorized(fData, iSize, fSum);
+#endif
+			for(; i < iSize; i++)
+				fSum += fData[i];
+			return fSum;
+		}
+
+		/**
+		* Calculates the dot product of two arrays. The products and their sum are calculated in
+		* double precision, also if the arrays are single precision.
+		*
+		* @param fFirst		The first array.
+		* @param fSecond	The second array.
+		* @param iSize		The number of elements in both arrays.
+		*
+		* @return	The sum of the element-wise products.
+		*/
+		template<class TData>
+		static double Dot(const TData* fFirst, const TData* fSecond, int iSize)
+		{
+			int i = 0;
+			double fSum = 0;
+#if defined(MATHFIT_VECTORKERNELS_TARGET)
+			if(IsVectorized())
+				i = DotVectorized(fFirst, fSecond, iSize, fSum);
+#endif
+			for(; i < iSize; i++)
+				fSum += (double)fFirst[i] * (double)fSecond[i];
+			return fSum;
+		}
+
+		/**
+		* Finds the smallest and the biggest element of an array.
+		*
+		* @param fData	The array.
+		* @param iSize	The number of elements in the array. Must be at least one.
+		* @param fMin	Receives the smallest element.
+		* @param fMax	Receives the biggest element.
+		*/
+		template<class TData>
+		static void MinMax(const TData* fData, int iSize, TData& fMin, TData& fMax)
+		{
+			int i = 1;
+			fMin = fMax = fData[0];
+#if defined(MATHFIT_VECTORKERNELS_TARGET)
+			if(IsVectorized())
+				i = MinMaxVectorized(fData, iSize, fMin, fMax);
+#endif
+			for(; i < iSize; i++)
+			{
+				if(fData[i] < fMin)
+					fMin = fData[i];
+				if(fData[i] > fMax)
+					fMax = fData[i];
+			}
+		}
+
+	private:
+		/**
+		* Holds whether the kernels use vector instructions. This is initialized by \Ref{IsSupported}.
+		*/
+		static bool& VectorizedFlag()
+		{
+			static bool bVectorized = IsSupported();
+			return bVectorized;
+		}
+
+#if defined(MATHFIT_VECTORKERNELS_TARGET)
+		// The vectorized kernels process the largest multiple of the register width
+		// and return the number of processed elements. The caller processes the rest.
+
+		template<class TData>
+		MATHFIT_VECTORKERNELS_TARGET static int AddVectorized(const TData* fFirst, const TData* fSecond, TData* fResult, int iSize)
+		{
+			typedef CVectorRegister<TData> R;
+			int i = 0;
+			for(; i + R::WIDTH <= iSize; i += R::WIDTH)
+				R::Store(fResult + i, R::Add(R::Load(fFirst + i), R::Load(fSecond + i)));
+			return i;
+		}
+
+		template<class TData>
+		MATHFIT_VECTORKERNELS_TARGET static int AddScaledVectorized(const TData* fFirst, const TData* fSecond, TData fFactor, TData* fResult, int iSize)
+		{
+			typedef CVectorRegister<TData> R;
+			const typename R::TRegister vFactor = R::Set(fFactor);
+			int i = 0;
+			for(; i + R::WIDTH <= iSize; i += R::WIDTH)
+				R::Store(fResult + i, R::Add(R::Load(fFirst + i), R::Mul(vFactor, R::Load(fSecond + i))));
+			return i;
+		}
+
+		template<class TData>
+		MATHFIT_VECTORKERNELS_TARGET static int SubVectorized(const TData* fFirst, const TData* fSecond, TData* fResult, int iSize)
+		{
+			typedef CVectorRegister<TData> R;
+			int i = 0;
+			for(; i + R::WIDTH <= iSize; i += R::WIDTH)
+				R::Store(fResult + i, R::Sub(R::Load(fFirst + i), R::Load(fSecond + i)));
+			return i;
+		}
+
+		template<class TData>
+		MATHFIT_VECTORKERNELS_TARGET static int MulVectorized(const TData* fFirst, const TData* fSecond, TData* fResult, int iSize)
+		{
+			typedef CVectorRegister<TData> R;
+			int i = 0;
+			for(; i + R::WIDTH <= iSize; i += R::WIDTH)
+				R::Store(fResult + i, R::Mul(R::Load(fFirst + i), R::Load(fSecond + i)));
+			return i;
+		}
+
+		template<class TData>
+		MATHFIT_VECTORKERNELS_TARGET static int AddScalarVectorized(const TData* fData, TData fScalar, TData* fResult, int iSize)
+		{
+			typedef CVectorRegister<TData> R;
+			const typename R::TRegister vScalar = R::Set(fScalar);
+			int i = 0;
+			for(; i + R::WIDTH <= iSize; i += R::WIDTH)
+				R::Store(fResult + i, R::Add(R::Load(fData + i), vScalar));
+			return i;
+		}
+
+		template<class TData>
+		MATHFIT_VECTORKERNELS_TARGET static int MulScalarVectorized(const TData* fData, TData fScalar, TData* fResult, int iSize)
+		{
+			typedef CVectorRegister<TData> R;
+			const typename R::TRegister vScalar = R::Set(fScalar);
+			int i = 0;
+			for(; i + R::WIDTH <= iSize; i += R::WIDTH)
+				R::Store(fResult + i, R::Mul(R::Load(fData + i), vScalar));
+			return i;
+		}
+
+		template<class TData>
+		MATHFIT_VECTORKERNELS_TARGET static int DivScalarVectorized(const TData* fData, TData fScalar, TData* fResult, int iSize)
+		{
+			typedef CVectorRegister<TData> R;
+			const typename R::TRegister vScalar = R::Set(fScalar);
+			int i = 0;
+			for(; i + R::WIDTH <= iSize; i += R::WIDTH)
+				R::Store(fResult + i, R::Div(R::Load(fData + i), vScalar));
+			return i;
+		}
+
+		template<class TData>
+		MATHFIT_VECTORKERNELS_TARGET static int SumVectorized(const TData* fData, int iSize, TData& fSum)
+		{
+			typedef CVectorRegister<TData> R;
+
+			// two independent sums hide the latency of the additions
+			typename R::TRegister vSum0 = R::Set(0);
+			typename R::TRegister vSum1 = R::Set(0);
+			int i = 0;
+			for(; i + 2 * R::WIDTH <= iSize; i += 2 * R::WIDTH)
+			{
+				vSum0 = R::Add(vSum0, R::Load(fData + i));
+				vSum1 = R::Add(vSum1, R::Load(fData + i + R::WIDTH));
+			}
+
+			TData fLanes[R::WIDTH];
+			R::Store(fLanes, R::Add(vSum0, vSum1));
+			int k;
+			for(k = 0; k < R::WIDTH; k++)
+				fSum += fLanes[k];
+			return i;
+		}
+
+		MATHFIT_VECTORKERNELS_TARGET static int DotVectorized(const double* fFirst, const double* fSecond, int iSize, double& fSum)
+		{
+			typedef CVectorRegister<double> R;
+
+			// two independent sums hide the latency of the additions
+			R::TRegister vSum0 = R::Set(0);
+			R::TRegister vSum1 = R::Set(0);
+			int i = 0;
+			for(; i + 2 * R::WIDTH <= iSize; i += 2 * R::WIDTH)
+			{
+				vSum0 = R::Add(vSum0, R::Mul(R::Load(fFirst + i), R::Load(fSecond + i)));
+				vSum1 = R::Add(vSum1, R::Mul(R::Load(fFirst + i + R::WIDTH), R::Load(fSecond + i + R::WIDTH)));
+			}
+
+			double fLanes[R::WIDTH];
+			R::Store(fLanes, R::Add(vSum0, vSum1));
+			int k;
+			for(k = 0; k < R::WIDTH; k++)
+				fSum += fLanes[k];
+			return i;
+		}
+
+		MATHFIT_VECTORKERNELS_TARGET static int DotVectorized(const float* fFirst, const float* fSecond, int iSize, double& fSum)
+		{
+			typedef CVectorRegister<float> R;
+			typedef CVectorRegister<double> D;
+
+			// the elements are converted to double precision before they are multiplied
+			D::TRegister vSum0 = D::Set(0);
+			D::TRegister vSum1 = D::Set(0);
+			int i = 0;
+			for(; i + R::WIDTH <= iSize; i += R::WIDTH)
+			{
+				D::TRegister vFirstLow, vFirstHigh, vSecondLow, vSecondHigh;
+				R::Widen(R::Load(fFirst + i), vFirstLow, vFirstHigh);
+				R::Widen(R::Load(fSecond + i), vSecondLow, vSecondHigh);
+				vSum0 = D::Add(vSum0, D::Mul(vFirstLow, vSecondLow));
+				vSum1 = D::Add(vSum1, D::Mul(vFirstHigh, vSecondHigh));
+			}
+
+			double fLanes[D::WIDTH];
+			D::Store(fLanes, D::Add(vSum0, vSum1));
+			int k;
+			for(k = 0; k < D::WIDTH; k++)
+				fSum += fLanes[k];
+			return i;
+		}
+
+		template<class TData>
+		MATHFIT_VECTORKERNELS_TARGET static int MinMaxVectorized(const TData* fData, int iSize, TData& fMin, TData& fMax)
+		{
+			typedef CVectorRegister<TData> R;
+			if(iSize < R::WIDTH)
+				return 1;
+
+			typename R::TRegister vMin = R::Load(fData);
+			typename R::TRegister vMax = vMin;
+			int i = R::WIDTH;
+			for(; i + R::WIDTH <= iSize; i += R::WIDTH)
+			{
+				const typename R::TRegister vData = R::Load(fData + i);
+				vMin = R::Min(vMin, vData);
+				vMax = R::Max(vMax, vData);
+			}
+
+			TData fMinLanes[R::WIDTH];
+			TData fMaxLanes[R::WIDTH];
+			R::Store(fMinLanes, vMin);
+			R::Store(fMaxLanes, vMax);
+			int k;
+			for(k = 0; k < R::WIDTH; k++)
+			{
+				if(fMinLanes[k] < fMin)
+					fMin = fMinLanes[k];
+				if(fMaxLanes[k] > fMax)
+					fMax = fMaxLanes[k];
+			}
+			return i;
+		}
+
+		template<class TData>
+		MATHFIT_VECTORKERNELS_TARGET static int MulScaledVectorized(const TData* fFirst, const TData* fSecond, TData fFactor, TData* fResult, int iSize)
+		{
+			typedef CVectorRegister<TData> R;
+			const typename R::TRegister vFactor = R::Set(fFactor);
+			int i = 0;
+			for(; i + R::WIDTH <= iSize; i += R::WIDTH)
+				R::Store(fResult + i, R::Mul(R::Load(fFirst + i), R::Mul(vFactor, R::Load(fSecond + i))));
+			return i;
+		}
+
+		template<class TData>
+		MATHFIT_VECTORKERNELS_TARGET static int DivScaledVectorized(const TData* fFirst, const TData* fSecond, TData fFactor, TData* fResult, int iSize)
+		{
+			typedef CVectorRegister<TData> R;
+			const typename R::TRegister vFactor = R::Set(fFactor);
+			const typename R::TRegister vZero = R::Set(0);
+			int i = 0;
+			for(; i + R::WIDTH <= iSize; i += R::WIDTH)
+			{
+				// all elements are divided, the quotients of the zero divisors are replaced afterwards
+				const typename R::TRegister vSecond = R::Load(fSecond + i);
+				const typename R::TRegister vQuotient = R::Div(R::Load(fFirst + i), R::Mul(vFactor, vSecond));
+				R::Store(fResult + i, R::Select(R::IsZero(vSecond), vZero, vQuotient));
+			}
+			return i;
+		}
+
+		template<class TData>
+		MATHFIT_VECTORKERNELS_TARGET static int ReciprocalVectorized(const TData* fData, TData* fResult, int iSize)
+		{
+			typedef CVectorRegister<TData> R;
+			const typename R::TRegister vOne = R::Set(1);
+			int i = 0;
+			for(; i + R::WIDTH <= iSize; i += R::WIDTH)
+				R::Store(fResult + i, R::Div(vOne, R::Load(fData + i)));
+			return i;
+		}
+
+		template<class TData>
+		MATHFIT_VECTORKERNELS_TARGET static int MaxAbsVectorized(const TData* fData, int iSize, TData& fMax)
+		{
+			typedef CVectorRegister<TData> R;
+
+			// the comparison is false for NaN, which keeps the current maximum
+			typename R::TRegister vMax = R::Set(0);
+			int i = 0;
+			for(; i + R::WIDTH <= iSize; i += R::WIDTH)
+			{
+				const typename R::TRegister vAbs = R::Abs(R::Load(fData + i));
+				vMax = R::Select(R::IsGreater(vAbs, vMax), vAbs, vMax);
+			}
+
+			TData fLanes[R::WIDTH];
+			R::Store(fLanes, vMax);
+			int k;
+			for(k = 0; k < R::WIDTH; k++)
+			{
+				if(fLanes[k] > fMax)
+					fMax = fLanes[k];
+			}
+			return i;
+		}
+
+		// the logarithm of positive normalized numbers, see __ieee754_log of fdlibm
+		MATHFIT_VECTORKERNELS_TARGET static CVectorRegister<double>::TRegister LogNormalized(CVectorRegister<double>::TRegister vValue)
+		{
+			typedef CVectorRegister<double> R;
+			const R::TRegister vOne = R::Set(1.0);
+
+			// value = mantissa * 2^exponent with the mantissa in [sqrt(2) / 2, sqrt(2))
+			R::TRegister vExponent;
+			R::TRegister vMantissa = R::Split(vValue, vExponent);
+			const R::TRegister vLarge = R::IsGreater(vMantissa, R::Set(1.41421356237309504880));
+			vMantissa = R::Select(vLarge, R::Mul(vMantissa, R::Set(0.5)), vMantissa);
+			vExponent = R::Select(vLarge, R::Add(vExponent, vOne), vExponent);
+
+			// log(1 + f) = 2 atanh(s) with s = f / (2 + f)
+			const R::TRegister vF = R::Sub(vMantissa, vOne);
+			const R::TRegister vHalfSquare = R::Mul(R::Set(0.5), R::Mul(vF, vF));
+			const R::TRegister vS = R::Div(vF, R::Add(R::Set(2.0), vF));
+			const R::TRegister vZ = R::Mul(vS, vS);
+			const R::TRegister vW = R::Mul(vZ, vZ);
+			const R::TRegister vT1 = R::Mul(vW, R::Add(R::Set(3.999999999940941908e-01), R::Mul(vW, R::Add(R::Set(2.222219843214978396e-01), R::Mul(vW, R::Set(1.531383769920937332e-01))))));
+			const R::TRegister vT2 = R::Mul(vZ, R::Add(R::Set(6.666666666666735130e-01), R::Mul(vW, R::Add(R::Set(2.857142874366239149e-01), R::Mul(vW, R::Add(R::Set(1.818357216161805012e-01), R::Mul(vW, R::Set(1.479819860511658591e-01))))))));
+			const R::TRegister vR = R::Add(vT2, vT1);
+
+			// exponent * ln2_hi - ((hfsq - (s * (hfsq + R) + exponent * ln2_lo)) - f)
+			const R::TRegister vLow = R::Add(R::Mul(vS, R::Add(vHalfSquare, vR)), R::Mul(vExponent, R::Set(1.90821492927058770002e-10)));
+			return R::Sub(R::Mul(vExponent, R::Set(6.93147180369123816490e-01)), R::Sub(R::Sub(vHalfSquare, vLow), vF));
+		}
+
+		MATHFIT_VECTORKERNELS_TARGET static int LogVectorized(const double* fData, double* fResult, int iSize)
+		{
+			typedef CVectorRegister<double> R;
+			const R::TRegister vZero = R::Set(0.0);
+			const R::TRegister vOne = R::Set(1.0);
+			int i = 0;
+			for(; i + R::WIDTH <= iSize; i += R::WIDTH)
+			{
+				// the values which are not positive are replaced by one, such that only the special values remain
+				const R::TRegister vData = R::Load(fData + i);
+				R::TRegister vValue = R::Select(R::IsGreater(vZero, vData), vOne, vData);
+				vValue = R::Select(R::IsZero(vData), vOne, vValue);
+				if(!R::IsInRange(vValue, DBL_MIN, DBL_MAX))
+				{
+					int k;
+					for(k = i; k < i + R::WIDTH; k++)
+						fResult[k] = fData[k] <= 0 ? 0.0 : log(fData[k]);
+					continue;
+				}
+				R::Store(fResult + i, R::Select(R::IsGreater(vData, vZero), LogNormalized(vValue), vZero));
+			}
+			return i;
+		}
+
+		MATHFIT_VECTORKERNELS_TARGET static int ExpVectorized(const double* fData, double* fResult, int iSize)
+		{
+			typedef CVectorRegister<double> R;
+			const R::TRegister vOne = R::Set(1.0);
+			int i = 0;
+			for(; i + R::WIDTH <= iSize; i += R::WIDTH)
+			{
+				// the results of larger values are infinite or denormalized
+				const R::TRegister vData = R::Load(fData + i);
+				if(!R::IsInRange(vData, -708.0, 708.0))
+				{
+					int k;
+					for(k = i; k < i + R::WIDTH; k++)
+						fResult[k] = exp(fData[k]);
+					continue;
+				}
+
+				// value = k * ln(2) + r with |r| <= ln(2) / 2, see __ieee754_exp of fdlibm
+				const R::TRegister vK = R::Round(R::Mul(vData, R::Set(1.44269504088896338700e+00)));
+				const R::TRegister vHigh = R::Sub(vData, R::Mul(vK, R::Set(6.93147180369123816490e-01)));
+				const R::TRegister vLow = R::Mul(vK, R::Set(1.90821492927058770002e-10));
+				const R::TRegister vR = R::Sub(vHigh, vLow);
+				const R::TRegister vT = R::Mul(vR, vR);
+				const R::TRegister vP = R::Add(R::Set(1.66666666666666019037e-01), R::Mul(vT, R::Add(R::Set(-2.77777777770155933842e-03), R::Mul(vT, R::Add(R::Set(6.61375632143793436117e-05), R::Mul(vT, R::Add(R::Set(-1.65339022054652515390e-06), R::Mul(vT, R::Set(4.13813679705723846039e-08)))))))));
+				const R::TRegister vC = R::Sub(vR, R::Mul(vT, vP));
+
+				// exp(r) = 1 - ((lo - (r * c) / (2 - c)) - hi)
+				const R::TRegister vExpR = R::Sub(vOne, R::Sub(R::Sub(vLow, R::Div(R::Mul(vR, vC), R::Sub(R::Set(2.0), vC))), vHigh));
+				R::Store(fResult + i, R::Scale(vExpR, vK));
+			}
+			return i;
+		}
+#endif
+	};
+}
+#endif
@@ -0,0 +1,246 @@
+/**
+* Contains non-owning vector views and the scratch arena used for temporary vectors.
+*/
+#if !defined(VECTORVIEW_H_011206)
+#define VECTORVIEW_H_011206
+
+#include <algorithm>
+#include <vector>
+#include "Vector.h"
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+namespace MathFit
+{
+	/**
+	* A vector object which refers to the elements of another vector or array without owning them.
+	* This is the same as attaching the data with bAutoRelease set to FALSE, but states the intent
+	* in the type. The view must be destroyed before the referenced data is released.
+	* The size of a view must not be changed, since this would allocate a new buffer.
+	*/
+	class CVectorView : public CVector
+	{
+	public:
+		/**
+		* Creates an empty view.
+		*/
+		CVectorView()
+		{
+		}
+
+		/**
+		* Creates a view of all elements of the given vector.
+		*
+		* @param vSecond	The vector object whose elements are referenced.
+		*/
+		explicit CVectorView(CVector& vSecond)
+		{
+			View(vSecond);
+		}
+
+		/**
+		* Creates a view of a sub sequence of the given vector.
+		*
+		* @param vSecond	The vector object whose elements are referenced.
+		* @param iOffset	The index of the first referenced element.
+		* @param iSize		The number of referenced elements.
+		*/
+		CVectorView(CVector& vSecond, int iOffset, int iSize)
+			: CVector(vSecond, iOffset, iSize)
+		{
+		}
+
+		/**
+		* Creates a view of the given array.
+		*
+		* @param fData		The array containing the data elements.
+		* @param iSize		The number of elements in the array.
+		* @param iStepSize	The offset between two vector elements given in TFitData elements.
+		*/
+		CVectorView(TFitData* fData, int iSize, int iStepSize = 1)
+			: CVector(fData, iSize, iStepSize, false)
+		{
+		}
+
+		/**
+		* Makes the view refer to all elements of the given vector.
+		*
+		* @param vSecond	The vector object whose elements are referenced.
+		*
+		* @return	A reference to the current object.
+		*/
+		CVectorView& View(CVector& vSecond)
+		{
+			Attach(vSecond, false);
+			return *this;
+		}
+
+	private:
+		// a view can not be copied, since a copy of a vector object owns its elements
+		CVectorView(const CVectorView&);
+		CVectorView& operator=(const CVectorView&);
+	};
+
+	/**
+	* Provides the memory of temporary vectors, which are needed during the evaluation of the fit functions.
+	* The memory is taken from a few large blocks, which are kept for the next request, such that
+	* the temporary vectors do not allocate once the blocks are large enough.
+	* Memory is handed out and given back in stack order using \Ref{GetMark} and \Ref{Release}.
+	* Every thread uses its own arena, which is returned by \Ref{GetThreadArena}.
+	*/
+	class CScratchArena
+	{
+	public:
+		/**
+		* The position of the arena, which is used to give back all memory taken after it.
+		*/
+		struct SMark
+		{
+			int iBlock;
+			int iUsed;
+		};
+
+		CScratchArena() : mBlock(0), mUsed(0)
+		{
+		}
+
+		~CScratchArena()
+		{
+			for(size_t i = 0; i < mBlocks.size(); i++)
+				CVectorKernels::Free(mBlocks[i].fData);
+		}
+
+		/**
+		* Returns the arena of the calling thread.
+		*/
+		static CScratchArena& GetThreadArena()
+		{
+			static thread_local CScratchArena arena;
+			return arena;
+		}
+
+		/**
+		* Returns the current position of the arena.
+		*/
+		SMark GetMark() const
+		{
+			SMark mark;
+			mark.iBlock = mBlock;
+			mark.iUsed = mUsed;
+			return mark;
+		}
+
+		/**
+		* Gives back all memory taken since the given position was returned by \Ref{GetMark}.
+		*
+		* @param mark	The position of the arena.
+		*/
+		void Release(const SMark& mark)
+		{
+			MATHFIT_ASSERT(mark.iBlock < mBlock || (mark.iBlock == mBlock && mark.iUsed <= mUsed));
+
+			mBlock = mark.iBlock;
+			mUsed = mark.iUsed;
+		}
+
+		/**
+		* Takes an uninitialized array from the arena. The array is aligned like the buffers of the vector objects.
+		*
+		* @param iSize	The number of elements.
+		*
+		* @return	The array. It is valid until the memory is given back using \Ref{Release}.
+		*/
+		TFitData* Allocate(int iSize)
+		{
+			MATHFIT_ASSERT(iSize > 0);
+
+			// keep every array aligned
+			const int iGranularity = CVectorKernels::ALIGNMENT / sizeof(TFitData);
+			const int iRounded = (iSize + iGranularity - 1) / iGranularity * iGranularity;
+
+			if(mBlock < (int)mBlocks.size() && mUsed + iRounded <= mBlocks[mBlock].iSize)
+			{
+				TFitData* fData = mBlocks[mBlock].fData + mUsed;
+				mUsed += iRounded;
+				return fData;
+			}
+
+			// continue with the next block. All blocks after the current one are unused,
+			// so a block which is too small can be replaced.
+			const int iNext = mBlocks.empty() ? 0 : mBlock + 1;
+			if(iNext < (int)mBlocks.size() && mBlocks[iNext].iSize < iRounded)
+			{
+				for(size_t i = iNext; i < mBlocks.size(); i++)
+					CVectorKernels::Free(mBlocks[i].fData);
+				mBlocks.erase(mBlocks.begin() + iNext, mBlocks.end());
+			}
+			if(iNext >= (int)mBlocks.size())
+			{
+				SBlock block;
+				block.iSize = std::max(iRounded, std::max((int)MINBLOCKSIZE, mBlocks.empty() ? 0 : 2 * mBlocks.back().iSize));
+				block.fData = CVectorKernels::Allocate<TFitData>(block.iSize);
+				mBlocks.push_back(block);
+			}
+
+			mBlock = iNext;
+			mUsed = iRounded;
+			return mBlocks[mBlock].fData;
+		}
+
+	private:
+		enum
+		{
+			// the minimum number of elements in a block
+			MINBLOCKSIZE = 16384
+		};
+
+		struct SBlock
+		{
+			TFitData* fData;
+			int iSize;
+		};
+
+		// the arena can not be copied, since it owns the blocks
+		CScratchArena(const CScratchArena&);
+		CScratchArena& operator=(const CScratchArena&);
+
+		std::vector<SBlock> mBlocks;
+		int mBlock;
+		int mUsed;
+	};
+
+	/**
+	* A temporary vector whose elements are taken from the \Ref{CScratchArena} of the current thread.
+	* The elements are not initialized. They are given back to the arena when the object is destroyed,
+	* so scratch vectors must be destroyed in the reverse order of their creation, which is the
+	* case for local variables.
+	*/
+	class CScratchVector : public CVectorView
+	{
+	public:
+		/**
+		* Creates a temporary vector.
+		*
+		* @param iSize		The number of elements.
+		* @param arena		The arena from which the elements are taken.
+		*/
+		explicit CScratchVector(int iSize, CScratchArena& arena = CScratchArena::GetThreadArena())
+			: mArena(arena), mMark(arena.GetMark())
+		{
+			Attach(arena.Allocate(iSize), iSize, 1, false);
+		}
+
+		~CScratchVector()
+		{
+			mArena.Release(mMark);
+		}
+
+	private:
+		CScratchArena& mArena;
+		CScratchArena::SMark mMark;
+	};
+}
+
+#endif
@@ -2,9 +2,51 @@
 #include "measurement_traverse.h"
 #include "../Common/SpectrumIO.h"
 #include <MobileDoasLib/Measurement/SpectrumUtils.h>
+#include <functional>
+#include <memory>
+#include <thread>
 
 extern CString g_exePath;  // <-- This is the path to the executable. This is a global variable and should only be changed in DMSpecView.cpp
 
+/** The number of spectra which can be on their way through the pipeline at the same time.
+    This must not exceed 10, the number of spectra back in time which the check of the GPS-readout compares with. */
+static const int pipelineDepth = 4;
+
+struct CMeasurement_Traverse::PipelineSpectrum
+{
+    /** The collected spectrum */
+    mobiledoas::MeasuredSpectrum scanResult;
+
+    /** The average intensity of each channel of the collected spectrum, summed up while the readouts were added together */
+    double averageIntensity[MAX_N_CHANNELS];
+
+    /** The spectra to write to the .std files, one for each channel */
+    CSpectrum measuredSpectrum[MAX_N_CHANNELS];
+
+    /** The file-names of the .std files, one for each channel */
+    CString stdfileName[MAX_N_CHANNELS];
+
+    /** The number of channels of the spectrum */
+    int numberOfChannels = 0;
+
+    /** The date and time when the collection started */
+    std::string startDate;
+    long startTime = 0;
+
+    /** The time the collection took, in seconds */
+    long elapsedSecond = 0;
+
+    /** The data from the GPS when the collection started, stored in 'm_spectrumGpsData' if 'hasGpsData' is true */
+    mobiledoas::GpsData gpsData;
+    bool hasGpsData = false;
+
+    /** The temperatures of the spectrometer when the collection ended */
+    SpectrometerTemperatures temperatures;
+
+    /** The lines of the evaluation logs with the results of this spectrum */
+    std::vector<EvaluationLogLine> evaluationLog;
+};
+
 CMeasurement_Traverse::CMeasurement_Traverse(
     CView& mainForm,
     std::unique_ptr<mobiledoas::SpectrometerInterface> spectrometerInterface,
@@ -99,8 +141,8 @@ void CMeasurement_Traverse::Run()
         UpdateStatusBarMessage("Measuring the dark spectrum");
     }
 
-    /** --------------------- THE MEASUREMENT LOOP -------------------------- */
-    while (m_isRunning)
+    /** --------------------- THE MEASUREMENT LOOP, for the dark and the sky spectra -------------------------- */
+    while (m_isRunning && m_scanNum <= SKY_SPECTRUM)
     {
 
 #ifdef _DEBUG
@@ -204,15 +246,14 @@ void CMeasurement_Traverse::Run()
 
             UpdateSpectrumAverageIntensity(scanResult);
 
-            for (int i = 0; i < m_NChannels; ++i)
+            // remove the dark spectrum, in one pass over all channels
+            _ASSERT(m_sky.NumberOfChannels() == m_dark.NumberOfChannels());
+            _ASSERT(m_sky.SpectrumLength() == m_dark.SpectrumLength());
+            const mobiledoas::Span<double> sky = m_sky.AllChannels();
+            const mobiledoas::Span<const double> dark = m_dark.AllChannels();
+            for (size_t iterator = 0; iterator < sky.size(); ++iterator)
             {
-                // remove the dark spectrum
-                _ASSERT(m_sky.NumberOfChannels() == m_dark.NumberOfChannels());
-                _ASSERT(m_sky.SpectrumLength() == m_dark.SpectrumLength());
-                for (int iterator = 0; iterator < m_sky.SpectrumLength(); ++iterator)
-                {
-                    m_sky[i][iterator] -= m_dark[i][iterator];
-                }
+                sky[iterator] -= dark[iterator];
             }
 
             UpdateUserAboutSpectrumAverageIntensity("sky", false);
@@ -244,29 +285,6 @@ void CMeasurement_Traverse::Run()
 #endif
 
         }
-        else if (m_scanNum > SKY_SPECTRUM)
-        {
-            /* -------------- IF THE MEASURED SPECTRUM WAS A NORMAL SPECTRUM ------------- */
-
-            UpdateSpectrumAverageIntensity(scanResult);
-
-            /* Get the information about the spectrum */
-            GetSpectrumInfo(scanResult);
-
-            UpdateUserAboutSpectrumAverageIntensity("", true);
-
-            m_intensityOfMeasuredSpectrum.push_back(m_averageSpectrumIntensity[0]);
-
-            /* Evaluate */
-            GetDark();
-            GetSky();
-            DoEvaluation(m_tmpSky, m_tmpDark, scanResult);
-        }
-
-        if (m_spectrumCounter > 1)
-        {
-            CountFlux(m_windSpeed, m_windAngle);
-        }
 
 #ifdef _DEBUG
         cFinish = clock();
@@ -280,16 +298,202 @@ void CMeasurement_Traverse::Run()
         timerFile = 0;
 #endif
 
-        scanResult.SetToZero();
         m_scanNum++;
     }
 
+    /** --------------------- THE MEASUREMENT PIPELINE, for the normal spectra -------------------------- */
+    if (m_isRunning)
+    {
+        RunPipeline();
+    }
+
     // we have to call this before exiting the application otherwise we'll have trouble next time we start...
     CloseSpectrometerConnection();
 
     return;
 }
 
+void CMeasurement_Traverse::RunPipeline()
+{
+    // The spectra circulate through the stages and back to the acquisition, such that no spectra are allocated while measuring.
+    // The queues can hold all spectra at once, hence adding a spectrum to a queue never waits.
+    std::vector<std::unique_ptr<PipelineSpectrum>> spectra;
+    SpectrumQueue freeSpectra(pipelineDepth);
+    SpectrumQueue acquiredSpectra(pipelineDepth);
+    SpectrumQueue evaluatedSpectra(pipelineDepth);
+    for (int k = 0; k < pipelineDepth; ++k)
+    {
+        spectra.push_back(std::make_unique<PipelineSpectrum>());
+        freeSpectra.Push(spectra.back().get());
+    }
+
+    std::thread acquisitionThread(&CMeasurement_Traverse::AcquireSpectra, this, std::ref(freeSpectra), std::ref(acquiredSpectra));
+    std::thread writerThread(&CMeasurement_Traverse::WriteSpectra, this, std::ref(evaluatedSpectra), std::ref(freeSpectra));
+
+    EvaluateSpectra(acquiredSpectra, evaluatedSpectra);
+
+    acquisitionThread.join();
+    writerThread.join();
+}
+
+void CMeasurement_Traverse::AcquireSpectra(SpectrumQueue& freeSpectra, SpectrumQueue& acquiredSpectra)
+{
+    // The spectra which have come back from the pipeline
+    std::vector<PipelineSpectrum*> idleSpectra;
+
+    // The numbering continues from the spectra collected before the pipeline started.
+    // The evaluation stage increases 'm_scanNum' and 'm_spectrumCounter' in the same way for each spectrum.
+    long scanNum = m_scanNum;
+    long spectrumIndex = m_spectrumCounter;
+
+    while (m_isRunning)
+    {
+        PipelineSpectrum* spectrum = nullptr;
+        while (freeSpectra.TryPop(spectrum))
+        {
+            idleSpectra.push_back(spectrum);
+        }
+        if (idleSpectra.empty())
+        {
+            freeSpectra.Pop(spectrum);
+            idleSpectra.push_back(spectrum);
+        }
+        spectrum = idleSpectra.back();
+        idleSpectra.pop_back();
+
+        SetFileName(scanNum, spectrum->stdfileName);
+        spectrum->numberOfChannels = m_NChannels;
+
+        /* ------------ Get the date, time and position --------------- */
+        spectrum->gpsData = mobiledoas::GpsData();
+        const bool couldReadValidGPSData = (m_useGps) ? ReadGpsData(spectrum->gpsData, spectrumIndex) : false;
+        spectrum->hasGpsData = m_useGps && m_gps != nullptr;
+        GetDateAndTime(spectrum->gpsData, couldReadValidGPSData, spectrum->startDate, spectrum->startTime);
+
+        /** ---------------- if the user wants to change the exposure time,
+                                    calculate a new exposure time. --------------------- */
+        if (m_adjustIntegrationTime && m_fixexptime >= 0)
+        {
+            // The spectra in the pipeline are evaluated and written with the exposure time they were collected with,
+            // wait until all of them have come back.
+            while ((int)idleSpectra.size() < pipelineDepth - 1)
+            {
+                PipelineSpectrum* returnedSpectrum = nullptr;
+                freeSpectra.Pop(returnedSpectrum);
+                idleSpectra.push_back(returnedSpectrum);
+            }
+
+            m_integrationTime = AdjustIntegrationTime();
+            DisplayDialog(CHANGED_EXPOSURETIME);
+            m_adjustIntegrationTime = FALSE;
+            mobiledoas::SpectrumSummation spectrumSummation;
+            m_sumInComputer = CountRound(m_timeResolution, spectrumSummation);
+            m_sumInSpectrometer = spectrumSummation.SumInSpectrometer;
+            OnUpdatedIntegrationTime();
+        }
+
+        /* ----------------  Get the spectrum --------------------  */
+        const clock_t cStart = clock();
+
+        if (Scan(m_sumInComputer, m_sumInSpectrometer, spectrum->scanResult))
+        {
+            break;
+        }
+
+        const clock_t cFinish = clock();
+        spectrum->elapsedSecond = (long)((double)(cFinish - cStart) / (double)CLOCKS_PER_SEC);
+
+        for (int i = 0; i < MAX_N_CHANNELS; ++i)
+        {
+            spectrum->averageIntensity[i] = m_spectrumAccumulator.AverageIntensity(i);
+        }
+
+        ReadSpectrometerTemperatures(spectrum->temperatures);
+
+        acquiredSpectra.Push(spectrum);
+
+        ++scanNum;
+        spectrumIndex = (spectrumIndex + 1 == 65535) ? 0 : spectrumIndex + 1;
+    }
+
+    acquiredSpectra.Close();
+}
+
+void CMeasurement_Traverse::EvaluateSpectra(SpectrumQueue& acquiredSpectra, SpectrumQueue& evaluatedSpectra)
+{
+    PipelineSpectrum* spectrum = nullptr;
+    while (acquiredSpectra.Pop(spectrum))
+    {
+        // The spectrum becomes the last collected spectrum, as if it had been collected on this thread
+        if (spectrum->hasGpsData)
+        {
+            m_spectrumGpsData[m_spectrumCounter] = spectrum->gpsData;
+        }
+        for (int i = 0; i < spectrum->numberOfChannels; ++i)
+        {
+            m_stdfileName[i] = spectrum->stdfileName[i];
+        }
+
+        // Copy the spectrum to the local variables
+        spectrum->scanResult.CopyTo(m_curSpectrum); // for the plot
+
+        /* ----------------- Create the spectrum(-a) to save -------------------- */
+        for (int i = 0; i < spectrum->numberOfChannels; ++i)
+        {
+            CreateSpectrum(spectrum->measuredSpectrum[i], spectrum->scanResult[i], spectrum->startDate, spectrum->startTime, spectrum->elapsedSecond);
+        }
+
+        /* -------------- IF THE MEASURED SPECTRUM WAS A NORMAL SPECTRUM ------------- */
+
+        UpdateSpectrumAverageIntensity(spectrum->averageIntensity);
+
+        /* Get the information about the spectrum */
+        GetSpectrumInfo(spectrum->scanResult, spectrum->temperatures);
+
+        UpdateUserAboutSpectrumAverageIntensity("", true);
+
+        m_intensityOfMeasuredSpectrum.push_back(m_averageSpectrumIntensity[0]);
+
+        /* Evaluate */
+        GetDark();
+        GetSky();
+        spectrum->evaluationLog.clear();
+        DoEvaluation(m_tmpSky, m_tmpDark, spectrum->scanResult, &spectrum->evaluationLog);
+
+        if (m_spectrumCounter > 1)
+        {
+            CountFlux(m_windSpeed, m_windAngle);
+        }
+
+        m_scanNum++;
+
+        evaluatedSpectra.Push(spectrum);
+    }
+
+    evaluatedSpectra.Close();
+}
+
+void CMeasurement_Traverse::WriteSpectra(SpectrumQueue& evaluatedSpectra, SpectrumQueue& freeSpectra)
+{
+    PipelineSpectrum* spectrum = nullptr;
+    while (evaluatedSpectra.Pop(spectrum))
+    {
+        /* ----------------- Save the spectrum(-a) -------------------- */
+        for (int i = 0; i < spectrum->numberOfChannels; ++i)
+        {
+            CSpectrumIO::WriteStdFile(spectrum->stdfileName[i], spectrum->measuredSpectrum[i]);
+        }
+
+        /* ----------------- Save the evaluation results -------------------- */
+        for (const EvaluationLogLine& logLine : spectrum->evaluationLog)
+        {
+            AppendToEvFile(logLine.fileName, logLine.line);
+        }
+
+        freeSpectra.Push(spectrum);
+    }
+}
+
 void CMeasurement_Traverse::Run_Adaptive()
 {
 
@@ -512,7 +716,6 @@ void CMeasurement_Traverse::Run_Adaptive()
             CountFlux(m_windSpeed, m_windAngle);
         }
 
-        scanResult.SetToZero();
         m_scanNum++;
         }
 
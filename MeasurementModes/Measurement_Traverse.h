@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../Spectrometer.h"
+#include <MobileDoasLib/BoundedQueue.h>
 
 /** The class <b>CMeasurement_Traverse</b> is the implementation of the standard
     traverse used in MobileDOAS. It extends the functions found in CSpectrometer.
@@ -25,4 +26,36 @@ public:
         the measurement route
     */
     void Run_Adaptive();
+
+private:
+
+    /** A spectrum on its way from the spectrometer to the files, together with everything which
+        was recorded when it was collected. */
+    struct PipelineSpectrum;
+
+    typedef mobiledoas::BoundedQueue<PipelineSpectrum*> SpectrumQueue;
+
+    /** Collects, evaluates and writes the spectra after the sky spectrum until the measurement is stopped.
+        The three stages run concurrently, such that the next spectrum is collected while the last one
+        is evaluated and the one before is written to file. The stages pass the spectra on in the order
+        they were collected, hence the files and logs are written in the same order as without the pipeline. */
+    void RunPipeline();
+
+    /** The first stage of the pipeline, run on its own thread. This is the only stage which
+        communicates with the spectrometer, it takes free spectra and collects them.
+        Changes of the exposure time wait until all collected spectra have passed the pipeline.
+        @param freeSpectra - the spectra which may be collected.
+        @param acquiredSpectra - receives the collected spectra, closed when the collection stops. */
+    void AcquireSpectra(SpectrumQueue& freeSpectra, SpectrumQueue& acquiredSpectra);
+
+    /** The second stage of the pipeline, run on the measurement thread. This evaluates the collected spectra
+        and updates the results shown to the user, the lines of the evaluation logs are kept with the spectra.
+        @param acquiredSpectra - the collected spectra.
+        @param evaluatedSpectra - receives the evaluated spectra, closed when all spectra are evaluated. */
+    void EvaluateSpectra(SpectrumQueue& acquiredSpectra, SpectrumQueue& evaluatedSpectra);
+
+    /** The third stage of the pipeline, run on its own thread. Writes the .std files and the evaluation logs.
+        @param evaluatedSpectra - the evaluated spectra.
+        @param freeSpectra - receives the written spectra, which may be collected again. */
+    void WriteSpectra(SpectrumQueue& evaluatedSpectra, SpectrumQueue& freeSpectra);
 };
@@ -300,7 +300,6 @@ void CMeasurement_Wind::Run()
         timerFile = 0;
 #endif
 
-        scanResult.SetToZero();
         m_scanNum++;
     }
 
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+namespace mobiledoas
+{
+    /** The AlignedAllocator allocates the values of a std::vector such that the first value starts at a cache line,
+        which allows the loops over the values to use aligned vector instructions. */
+    template<class T>
+    struct AlignedAllocator
+    {
+        typedef T value_type;
+
+        /** The alignment of the allocated values, in bytes. This is the size of a cache line. */
+        static const size_t alignment = 64;
+
+        AlignedAllocator() {}
+
+        template<class U>
+        AlignedAllocator(const AlignedAllocator<U>&) {}
+
+        T* allocate(size_t numberOfValues)
+        {
+            const size_t bytes = (numberOfValues * sizeof(T) + alignment - 1) / alignment * alignment;
+
+            void* buffer = nullptr;
+#ifdef _MSC_VER
+            buffer = _aligned_malloc(bytes, alignment);
+#else
+            if (posix_memalign(&buffer, alignment, bytes) != 0)
+            {
+                buffer = nullptr;
+            }
+#endif
+            if (buffer == nullptr)
+            {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(buffer);
+        }
+
+        void deallocate(T* buffer, size_t)
+        {
+#ifdef _MSC_VER
+            _aligned_free(buffer);
+#else
+            free(buffer);
+#endif
+        }
+    };
+
+    template<class T, class U>
+    bool operator==(const AlignedAllocator<T>&, const AlignedAllocator<U>&) { return true; }
+
+    template<class T, class U>
+    bool operator!=(const AlignedAllocator<T>&, const AlignedAllocator<U>&) { return false; }
+}
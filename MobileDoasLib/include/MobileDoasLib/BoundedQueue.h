@@ -0,0 +1,127 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace mobiledoas
+{
+    /** The BoundedQueue is a first-in first-out queue with a fixed capacity, which passes
+        items from exactly one producing thread to exactly one consuming thread without locking.
+        The producer pushes items and finally closes the queue, the consumer pops the items in
+        the order they were pushed until the queue is closed and empty. */
+    template<class T>
+    class BoundedQueue final
+    {
+    public:
+        /** Creates an empty queue which can hold at most 'capacity' items. */
+        explicit BoundedQueue(size_t capacity)
+            : m_items(capacity + 1), m_head(0), m_tail(0), m_closed(false)
+        {
+        }
+
+        // --- The queue is shared between two threads and is thus neither copyable nor movable
+        BoundedQueue(const BoundedQueue&) = delete;
+        BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+        /** @return the maximum number of items in the queue. */
+        size_t Capacity() const { return m_items.size() - 1; }
+
+        /** Appends an item to the end of the queue. Must only be called from the producing thread.
+            @return false if the queue is full, the item is then not moved. */
+        bool TryPush(T& item)
+        {
+            const size_t tail = m_tail.load(std::memory_order_relaxed);
+            const size_t next = Next(tail);
+            if (next == m_head.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+
+            m_items[tail] = std::move(item);
+            m_tail.store(next, std::memory_order_release);
+            return true;
+        }
+
+        /** Appends an item to the end of the queue, waiting while the queue is full.
+            Must only be called from the producing thread. */
+        void Push(T item)
+        {
+            for (int attempt = 0; !TryPush(item); ++attempt)
+            {
+                Wait(attempt);
+            }
+        }
+
+        /** Removes the first item of the queue. Must only be called from the consuming thread.
+            @return false if the queue is empty. */
+        bool TryPop(T& item)
+        {
+            const size_t head = m_head.load(std::memory_order_relaxed);
+            if (head == m_tail.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+
+            item = std::move(m_items[head]);
+            m_head.store(Next(head), std::memory_order_release);
+            return true;
+        }
+
+        /** Removes the first item of the queue, waiting while the queue is empty.
+            Must only be called from the consuming thread.
+            @return false if the queue has been closed and all items have been removed. */
+        bool Pop(T& item)
+        {
+            for (int attempt = 0; !TryPop(item); ++attempt)
+            {
+                if (m_closed.load(std::memory_order_acquire))
+                {
+                    // the items pushed before the queue was closed are visible now
+                    return TryPop(item);
+                }
+                Wait(attempt);
+            }
+            return true;
+        }
+
+        /** Marks that no more items will be pushed. Must only be called from the producing thread. */
+        void Close()
+        {
+            m_closed.store(true, std::memory_order_release);
+        }
+
+    private:
+        size_t Next(size_t index) const
+        {
+            return (index + 1 == m_items.size()) ? 0 : index + 1;
+        }
+
+        /** Waits for the other thread. The items are spectra which arrive at most every few milliseconds,
+            hence the thread only yields a few times before it starts sleeping. */
+        static void Wait(int attempt)
+        {
+            if (attempt < 16)
+            {
+                std::this_thread::yield();
+            }
+            else
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+
+        /** The ring of items, one slot is always kept empty to distinguish a full from an empty queue */
+        std::vector<T> m_items;
+
+        /** The index of the first item, only changed by the consumer */
+        std::atomic<size_t> m_head;
+
+        /** The index after the last item, only changed by the producer */
+        std::atomic<size_t> m_tail;
+
+        /** Set by the producer when no more items will be pushed */
+        std::atomic<bool> m_closed;
+    };
+}
@@ -2,6 +2,8 @@
 
 #include <vector>
 #include <MobileDoasLib/Definitions.h>
+#include <MobileDoasLib/AlignedAllocator.h>
+#include <MobileDoasLib/Span.h>
 
 namespace mobiledoas
 {
@@ -10,9 +12,11 @@ namespace mobiledoas
 /// MeasuredSpectrum represents a spectrum measured directly from the spectrometer.
 /// This contains multiple channels, for support of the multi channel spectrometer (SD2000),
 /// as well as convenience methods for the most commonly used operations.
+/// The values of all channels are stored in one aligned block of memory, one channel after the other.
 /// </summary>
 struct MeasuredSpectrum
 {
+public:
     MeasuredSpectrum()
     {
         Resize(MAX_N_CHANNELS, MAX_SPECTRUM_LENGTH);
@@ -25,16 +29,40 @@ struct MeasuredSpectrum
 
     void SetToZero();
 
+    /// <summary>
+    /// Changes the number of channels and the length of the spectrum.
+    /// The values of the pixels which exist both before and after are kept, new pixels are set to zero.
+    /// Does nothing, and in particular does not allocate any memory, if the size does not change.
+    /// </summary>
     void Resize(int numberOfChannels, int spectrumLength);
 
     /// <summary>
     /// Brackets operator retrieves the measured data for the given channel index.
     /// </summary>
     /// <param name="channelIdx">The channel to retrieve.</param>
-    /// <returns>The measured data for the given channel.</returns>
-    std::vector<double>& operator[](size_t channelIdx)
+    /// <returns>The measured data for the given channel. This is valid until the spectrum is resized.</returns>
+    Span<double> operator[](size_t channelIdx)
+    {
+        return Span<double>(m_data.data() + channelIdx * m_spectrumLength, m_spectrumLength);
+    }
+
+    Span<const double> operator[](size_t channelIdx) const
     {
-        return data[channelIdx];
+        return Span<const double>(m_data.data() + channelIdx * m_spectrumLength, m_spectrumLength);
+    }
+
+    /// <summary>
+    /// Retrieves the measured data of all channels, one channel after the other.
+    /// This allows the operations which treat all pixels in the same way to run as one loop over all channels.
+    /// </summary>
+    Span<double> AllChannels()
+    {
+        return Span<double>(m_data.data(), m_data.size());
+    }
+
+    Span<const double> AllChannels() const
+    {
+        return Span<const double>(m_data.data(), m_data.size());
     }
 
     /// <summary>
@@ -49,16 +77,28 @@ struct MeasuredSpectrum
     /// <param name="channelNumber">The destination channel number.</param>
     /// <param name="source">The data to copy.</param>
     /// <param name="numberOfElements>The number of elements to copy.</param>
-    void CopyFrom(int channelNumber, double source[], int numberOfElements);
+    void CopyFrom(int channelNumber, const double source[], int numberOfElements);
 
-    int NumberOfChannels() const { return static_cast<int>(data.size()); }
+    /// <summary>
+    /// Copies data from the provided vectors, one for each channel, into this spectrum.
+    /// The spectrum is resized to the number of vectors and the length of the first vector.
+    /// </summary>
+    /// <param name="source">The data to copy.</param>
+    void CopyFrom(const std::vector<std::vector<double>>& source);
 
-    int SpectrumLength() const
-    {
-        return (data.size() == 0) ? 0 : static_cast<int>(data[0].size());
-    }
+    int NumberOfChannels() const { return m_numberOfChannels; }
+
+    int SpectrumLength() const { return m_spectrumLength; }
+
+private:
+    /// <summary>
+    /// The data of all channels, one channel after the other.
+    /// </summary>
+    std::vector<double, AlignedAllocator<double>> m_data;
+
+    int m_numberOfChannels = 0;
 
-    std::vector<std::vector<double>> data;
+    int m_spectrumLength = 0;
 };
 
 }
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <vector>
+#include <MobileDoasLib/Measurement/MeasuredSpectrum.h>
 
 namespace mobiledoas
 {
@@ -112,6 +113,17 @@ namespace mobiledoas
         // Requires that SetSpectrometer has been called successfully.
         virtual int GetNextSpectrum(std::vector<std::vector<double>>& data) = 0;
 
+        // GetNextSpectrum returns the next spectrum readout directly in the provided spectrum. This blocks until there is a spectrum available.
+        // The spectrum is resized to the number of channels and the length of the readout if necessary, which does not allocate
+        // any memory when the spectrum already has this size.
+        // The values of the spectrum are replaced by the readout. The spectrum is not changed if the readout fails.
+        // The default implementation reads out into a buffer which is kept between the calls and then copies the values,
+        // implementations which can read out directly into the spectrum should override this.
+        // @return the number of values read out (the length of the spectrum).
+        // @return zero if something goes wrong while doing the readout (reason can be retrieved using GetLastError()).
+        // Requires that SetSpectrometer has been called successfully.
+        virtual int GetNextSpectrum(MeasuredSpectrum& spectrum);
+
         // SupportsDetectorTemperatureControl returns true if this device is able to set a specific temperature on the detector.
         // Requires that SetSpectrometer has been called successfully.
         virtual bool SupportsDetectorTemperatureControl() = 0;
@@ -139,6 +151,10 @@ namespace mobiledoas
         // Returns the last set error message, if any. Returns empty if no error.
         virtual std::string GetLastError() = 0;
 
+    private:
+        // The buffer of the default implementation of GetNextSpectrum(MeasuredSpectrum&), kept to avoid allocating it for every readout.
+        std::vector<std::vector<double>> m_readoutBuffer;
+
     };
 
 }
\ No newline at end of file
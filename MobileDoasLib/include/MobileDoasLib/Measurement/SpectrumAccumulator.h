@@ -0,0 +1,64 @@
+#pragma once
+
+#include <MobileDoasLib/Definitions.h>
+#include <MobileDoasLib/Measurement/MeasuredSpectrum.h>
+
+namespace mobiledoas
+{
+
+/// <summary>
+/// SpectrumAccumulator co-adds the readouts of a spectrum as they arrive from the spectrometer.
+/// Every readout is passed over once, which updates the sum of each pixel and the sum over the
+/// intensity measurement region of each channel, such that the average intensity need not be calculated from the spectrum afterwards.
+/// </summary>
+class SpectrumAccumulator
+{
+public:
+    /// <summary>
+    /// Starts a new co-addition, discarding all readouts added so far.
+    /// The size of the spectrum is taken from the first readout.
+    /// </summary>
+    /// <param name="specCenter">The index around which the intensity should be measured.</param>
+    /// <param name="specCenterHalfWidth">The half index with of the intensity measurement region.</param>
+    void Start(long specCenter, long specCenterHalfWidth);
+
+    /// <summary>
+    /// Adds one readout. All readouts must have the same size.
+    /// </summary>
+    void Add(const MeasuredSpectrum& readout);
+
+    /// <summary>
+    /// The number of readouts added since Start.
+    /// </summary>
+    int NumberOfReadouts() const { return m_numberOfReadouts; }
+
+    /// <summary>
+    /// Writes the average of the added readouts to the given spectrum, which is resized if necessary.
+    /// If no readouts were added, the spectrum is set to zero and keeps its size.
+    /// </summary>
+    void GetAverage(MeasuredSpectrum& average) const;
+
+    /// <summary>
+    /// The average intensity in the intensity measurement region of the given channel of the average spectrum, see AverageIntensity.
+    /// This is zero if no readouts were added or if the channel does not exist.
+    /// </summary>
+    double AverageIntensity(int channel) const;
+
+private:
+    /// <summary>
+    /// The sum of the readouts
+    /// </summary>
+    MeasuredSpectrum m_sum{ 0, 0 };
+
+    int m_numberOfReadouts = 0;
+
+    long m_specCenter = 0;
+    long m_specCenterHalfWidth = 0;
+
+    /// <summary>
+    /// The sum over the intensity measurement region of the readouts, for each channel
+    /// </summary>
+    double m_intensitySum[MAX_N_CHANNELS];
+};
+
+}
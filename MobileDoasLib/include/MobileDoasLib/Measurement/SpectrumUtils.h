@@ -1,6 +1,7 @@
 #pragma once
 
 #include <MobileDoasLib/Definitions.h>
+#include <MobileDoasLib/Span.h>
 #include<vector>
 
 // SpectrumUtils collects together some commonly used spectrum related functions
@@ -14,7 +15,7 @@ namespace mobiledoas
 /// </summary>
 /// <param name="spectrum">The last measured spectrum.</param>
 /// <returns>True if the measured spectrum is considered 'dark'</returns>
-bool CheckIfDark(const std::vector<double>& spectrum);
+bool CheckIfDark(Span<const double> spectrum);
 
 /// <summary>
 /// Returns the average intensity of the supplied spectrum in the given spectrum region.
@@ -24,7 +25,7 @@ bool CheckIfDark(const std::vector<double>& spectrum);
 /// <param name="specCenter">The index around which the intensity should be measured.</param>
 /// <param name="specCenterHalfWidth">The half index with of the intensity measurement region.</param>
 /// </summary>
-long AverageIntensity(const std::vector<double>& spectrum, long specCenter, long specCenterHalfWidth);
+long AverageIntensity(Span<const double> spectrum, long specCenter, long specCenterHalfWidth);
 
 /// <summary>
 /// Calculates the pixel range over which an intensity measurement should be made with the given settings for spectrum center and half width.
@@ -38,7 +39,7 @@ std::pair<long, long> GetIntensityMeasurementRegion(long specCenter, long specCe
 /// <summary>
 /// Retrieves the (electronic-)offset of the supplied spectrum */
 /// </summary>
-double GetOffset(const std::vector<double>& spectrum);
+double GetOffset(Span<const double> spectrum);
 
 /// <summary>
 /// Basic representation of where spectra should be added, in the spectrometer directly or
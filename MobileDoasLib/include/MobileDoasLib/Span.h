@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace mobiledoas
+{
+    /** A Span is a view of a contiguous range of values owned by someone else, such as one channel of a MeasuredSpectrum.
+        The span does not own the values and must not be used after the owner has been changed in size or destroyed.
+        Span<double> allows changing the values, Span<const double> only reading them. */
+    template<class T>
+    class Span
+    {
+    public:
+        typedef typename std::remove_const<T>::type value_type;
+        typedef T* iterator;
+
+        Span()
+            : m_data(nullptr), m_size(0)
+        {
+        }
+
+        Span(T* data, size_t size)
+            : m_data(data), m_size(size)
+        {
+        }
+
+        /** A Span<double> can be used where a Span<const double> is expected */
+        template<class U, class = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+        Span(const Span<U>& other)
+            : m_data(other.data()), m_size(other.size())
+        {
+        }
+
+        /** A vector can be used where a Span is expected, the span then refers to the values of the vector */
+        template<class Allocator>
+        Span(std::vector<value_type, Allocator>& values)
+            : m_data(values.data()), m_size(values.size())
+        {
+        }
+
+        template<class Allocator, class U = T, class = typename std::enable_if<std::is_const<U>::value>::type>
+        Span(const std::vector<value_type, Allocator>& values)
+            : m_data(values.data()), m_size(values.size())
+        {
+        }
+
+        T* data() const { return m_data; }
+
+        size_t size() const { return m_size; }
+
+        bool empty() const { return m_size == 0; }
+
+        T& operator[](size_t index) const { return m_data[index]; }
+
+        T* begin() const { return m_data; }
+
+        T* end() const { return m_data + m_size; }
+
+        /** @return a copy of the values. */
+        std::vector<value_type> ToVector() const { return std::vector<value_type>(m_data, m_data + m_size); }
+
+    private:
+        T* m_data;
+        size_t m_size;
+    };
+
+    template<class T>
+    T* begin(const Span<T>& span) { return span.begin(); }
+
+    template<class T>
+    T* end(const Span<T>& span) { return span.end(); }
+}
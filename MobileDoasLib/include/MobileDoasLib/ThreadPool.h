@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mobiledoas
+{
+    /** The ThreadPool keeps a fixed set of threads waiting for work, such that a few short tasks
+        may be run in parallel many times without starting a new thread each time. */
+    class ThreadPool final
+    {
+    public:
+        /** Starts the given number of threads. With zero threads, all tasks are run by the calling thread. */
+        explicit ThreadPool(int numberOfThreads);
+
+        /** Stops and joins the threads. */
+        ~ThreadPool();
+
+        // --- This class owns its threads and is thus neither copyable nor movable
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /** @return the number of threads of the pool, not counting the calling thread. */
+        int NumberOfThreads() const { return static_cast<int>(m_threads.size()); }
+
+        /** Runs task(index) for every index from 0 to numberOfTasks - 1 on the threads of the pool and the calling thread.
+            Returns when all tasks are done. The tasks may be run in any order and must hence not depend on each other.
+            Calls from several threads are run one after another.
+            If a task throws, the exception of the task with the lowest index is rethrown here, after all tasks are done. */
+        void ParallelFor(int numberOfTasks, const std::function<void(int)>& task);
+
+    private:
+        /** The loop of the threads of the pool */
+        void WorkerThread();
+
+        /** Runs the tasks of the current call to 'ParallelFor' until no task is left */
+        void RunTasks();
+
+        std::vector<std::thread> m_threads;
+
+        /** Serializes the calls to 'ParallelFor' */
+        std::mutex m_callMutex;
+
+        /** Protects the members below which are not atomic */
+        std::mutex m_mutex;
+        std::condition_variable m_workAvailable;
+        std::condition_variable m_workDone;
+
+        /** Increased for every call to 'ParallelFor', such that the threads know when there is new work */
+        long long m_generation = 0;
+
+        /** Set when the threads should quit */
+        bool m_stop = false;
+
+        /** The tasks of the current call to 'ParallelFor' */
+        const std::function<void(int)>* m_task = nullptr;
+        int m_numberOfTasks = 0;
+
+        /** The index of the next task to run */
+        std::atomic<int> m_nextTask;
+
+        /** The number of threads which are running the tasks of the current call to 'ParallelFor' */
+        int m_activeThreads = 0;
+
+        /** The first exception thrown by the tasks, and the index of its task */
+        std::exception_ptr m_exception;
+        int m_exceptionTask = 0;
+    };
+}
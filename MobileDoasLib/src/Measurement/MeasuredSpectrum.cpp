@@ -1,46 +1,74 @@
 #include <MobileDoasLib/Measurement/MeasuredSpectrum.h>
+#include <algorithm>
+#include <cstring>
 
 namespace mobiledoas
 {
 
 void MeasuredSpectrum::SetToZero()
 {
-    for (size_t chn = 0; chn < data.size(); ++chn)
-    {
-        memset(data[chn].data(), 0, sizeof(double) * data[chn].size());
-    }
+    memset(m_data.data(), 0, sizeof(double) * m_data.size());
 }
 
 void MeasuredSpectrum::Resize(int numberOfChannels, int spectrumLength)
 {
-    data.resize(numberOfChannels);
-    for (int i = 0; i < numberOfChannels; ++i)
+    if (numberOfChannels == m_numberOfChannels && spectrumLength == m_spectrumLength)
+    {
+        return;
+    }
+
+    if (spectrumLength == m_spectrumLength)
     {
-        data[i].resize(spectrumLength);
+        // the channels keep their places, only channels are added or removed at the end
+        m_data.resize(static_cast<size_t>(numberOfChannels) * spectrumLength);
+        m_numberOfChannels = numberOfChannels;
+        return;
     }
+
+    // every channel moves, copy the values which are kept to their new places
+    std::vector<double, AlignedAllocator<double>> newData(static_cast<size_t>(numberOfChannels) * spectrumLength);
+    const int channelsToKeep = std::min(numberOfChannels, m_numberOfChannels);
+    const int lengthToKeep = std::min(spectrumLength, m_spectrumLength);
+    for (int chn = 0; chn < channelsToKeep; ++chn)
+    {
+        memcpy(newData.data() + static_cast<size_t>(chn) * spectrumLength, m_data.data() + static_cast<size_t>(chn) * m_spectrumLength, sizeof(double) * lengthToKeep);
+    }
+
+    m_data.swap(newData);
+    m_numberOfChannels = numberOfChannels;
+    m_spectrumLength = spectrumLength;
 }
 
 void MeasuredSpectrum::CopyTo(MeasuredSpectrum& destination) const
 {
-    const int channels = this->NumberOfChannels();
-    const int length = this->SpectrumLength();
-    destination.Resize(channels, length);
-    for (int chn = 0; chn < channels; ++chn)
-    {
-        memcpy(destination.data[chn].data(), this->data[chn].data(), sizeof(double) * length);
-    }
+    destination.Resize(this->NumberOfChannels(), this->SpectrumLength());
+    memcpy(destination.m_data.data(), this->m_data.data(), sizeof(double) * m_data.size());
 }
 
-void MeasuredSpectrum::CopyFrom(int channelNumber, double source[], int numberOfElements)
+void MeasuredSpectrum::CopyFrom(int channelNumber, const double source[], int numberOfElements)
 {
-    _ASSERT(channelNumber >= 0 && channelNumber < this->data.size());
+    _ASSERT(channelNumber >= 0 && channelNumber < this->NumberOfChannels());
 
     this->Resize(this->NumberOfChannels(), numberOfElements);
 
     memcpy(
-    (void*)this->data[channelNumber].data(),
-    (void*)source, 
+    (void*)(*this)[channelNumber].data(),
+    (const void*)source,
     sizeof(double) * numberOfElements);
 }
 
+void MeasuredSpectrum::CopyFrom(const std::vector<std::vector<double>>& source)
+{
+    const int numberOfChannels = static_cast<int>(source.size());
+    const int spectrumLength = (source.size() == 0) ? 0 : static_cast<int>(source[0].size());
+    this->Resize(numberOfChannels, spectrumLength);
+
+    for (int chn = 0; chn < numberOfChannels; ++chn)
+    {
+        const size_t length = std::min(source[chn].size(), static_cast<size_t>(spectrumLength));
+        memcpy((*this)[chn].data(), source[chn].data(), sizeof(double) * length);
+        memset((*this)[chn].data() + length, 0, sizeof(double) * (spectrumLength - length));
+    }
+}
+
 }
@@ -1,3 +1,23 @@
 #include <MobileDoasLib/Measurement/SpectrometerInterface.h>
+#include <cstring>
 
-using namespace mobiledoas;
\ No newline at end of file
+using namespace mobiledoas;
+
+int SpectrometerInterface::GetNextSpectrum(MeasuredSpectrum& spectrum)
+{
+    const int spectrumLength = GetNextSpectrum(m_readoutBuffer);
+    if (spectrumLength == 0 || m_readoutBuffer.size() == 0)
+    {
+        return 0;
+    }
+
+    const int numberOfChannels = static_cast<int>(m_readoutBuffer.size());
+    spectrum.Resize(numberOfChannels, spectrumLength);
+
+    for (int chn = 0; chn < numberOfChannels; ++chn)
+    {
+        memcpy(spectrum[chn].data(), m_readoutBuffer[chn].data(), sizeof(double) * spectrumLength);
+    }
+
+    return spectrumLength;
+}
@@ -0,0 +1,80 @@
+#include <MobileDoasLib/Measurement/SpectrumAccumulator.h>
+#include <MobileDoasLib/Measurement/SpectrumUtils.h>
+
+namespace mobiledoas
+{
+
+void SpectrumAccumulator::Start(long specCenter, long specCenterHalfWidth)
+{
+    m_numberOfReadouts = 0;
+    m_specCenter = specCenter;
+    m_specCenterHalfWidth = specCenterHalfWidth;
+}
+
+void SpectrumAccumulator::Add(const MeasuredSpectrum& readout)
+{
+    const int numberOfChannels = readout.NumberOfChannels();
+    const int spectrumLength = readout.SpectrumLength();
+
+    ++m_numberOfReadouts;
+    if (m_numberOfReadouts == 1)
+    {
+        m_sum.Resize(numberOfChannels, spectrumLength);
+        m_sum.SetToZero();
+        for (int chn = 0; chn < MAX_N_CHANNELS; ++chn)
+        {
+            m_intensitySum[chn] = 0.0;
+        }
+    }
+    _ASSERT(numberOfChannels == m_sum.NumberOfChannels() && spectrumLength == m_sum.SpectrumLength());
+
+    const std::pair<long, long> intensityRegion = GetIntensityMeasurementRegion(m_specCenter, m_specCenterHalfWidth, spectrumLength);
+
+    for (int chn = 0; chn < numberOfChannels; ++chn)
+    {
+        const double* values = readout[chn].data();
+        double* sum = m_sum[chn].data();
+        for (int pixelIdx = 0; pixelIdx < spectrumLength; ++pixelIdx)
+        {
+            sum[pixelIdx] += values[pixelIdx];
+        }
+
+        if (chn < MAX_N_CHANNELS && intensityRegion.first >= 0 && intensityRegion.second <= spectrumLength)
+        {
+            for (long pixelIdx = intensityRegion.first; pixelIdx < intensityRegion.second; ++pixelIdx)
+            {
+                m_intensitySum[chn] += values[pixelIdx];
+            }
+        }
+    }
+}
+
+void SpectrumAccumulator::GetAverage(MeasuredSpectrum& average) const
+{
+    if (m_numberOfReadouts == 0)
+    {
+        average.SetToZero();
+        return;
+    }
+
+    average.Resize(m_sum.NumberOfChannels(), m_sum.SpectrumLength());
+
+    const Span<const double> sum = m_sum.AllChannels();
+    const Span<double> result = average.AllChannels();
+    for (size_t pixelIdx = 0; pixelIdx < sum.size(); ++pixelIdx)
+    {
+        result[pixelIdx] = sum[pixelIdx] / m_numberOfReadouts;
+    }
+}
+
+double SpectrumAccumulator::AverageIntensity(int channel) const
+{
+    if (m_numberOfReadouts == 0 || channel < 0 || channel >= MAX_N_CHANNELS || channel >= m_sum.NumberOfChannels() || m_specCenterHalfWidth <= 0)
+    {
+        return 0.0;
+    }
+
+    return m_intensitySum[channel] / (2.0 * m_specCenterHalfWidth) / m_numberOfReadouts;
+}
+
+}
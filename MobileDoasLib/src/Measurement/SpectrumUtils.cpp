@@ -5,7 +5,7 @@
 namespace mobiledoas
 {
 
-bool CheckIfDark(const std::vector<double>& spectrum)
+bool CheckIfDark(Span<const double> spectrum)
 {
     int detectorSize = static_cast<int>(spectrum.size());
 
@@ -52,7 +52,7 @@ bool CheckIfDark(const std::vector<double>& spectrum)
 }
 
 // TODO: This needs tests and validation of the input parameters
-long AverageIntensity(const std::vector<double>& spectrum, long specCenter, long specCenterHalfWidth)
+long AverageIntensity(Span<const double> spectrum, long specCenter, long specCenterHalfWidth)
 {
 
     double sum = 0.0;
@@ -104,7 +104,7 @@ double GetOffset(double spectrum[MAX_SPECTRUM_LENGTH])
     return offset;
 }
 
-double GetOffset(const std::vector<double>& spectrum)
+double GetOffset(Span<const double> spectrum)
 {
     double offset = 0.0;
     for (int i = 6; i < 18; ++i)
@@ -0,0 +1,123 @@
+#include <MobileDoasLib/ThreadPool.h>
+
+namespace mobiledoas
+{
+    ThreadPool::ThreadPool(int numberOfThreads)
+        : m_nextTask(0)
+    {
+        for (int threadIdx = 0; threadIdx < numberOfThreads; ++threadIdx)
+        {
+            m_threads.push_back(std::thread(&ThreadPool::WorkerThread, this));
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_workAvailable.notify_all();
+
+        for (std::thread& thread : m_threads)
+        {
+            thread.join();
+        }
+    }
+
+    void ThreadPool::ParallelFor(int numberOfTasks, const std::function<void(int)>& task)
+    {
+        if (numberOfTasks <= 0)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> callLock(m_callMutex);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_task = &task;
+            m_numberOfTasks = numberOfTasks;
+            m_nextTask = 0;
+            m_exception = nullptr;
+            ++m_generation;
+        }
+        m_workAvailable.notify_all();
+
+        // the calling thread takes part instead of only waiting
+        RunTasks();
+
+        // all tasks have been taken, wait until the threads which took them are done
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_workDone.wait(lock, [&]() { return m_activeThreads == 0; });
+        m_task = nullptr;
+
+        if (m_exception != nullptr)
+        {
+            std::exception_ptr exception = m_exception;
+            m_exception = nullptr;
+            std::rethrow_exception(exception);
+        }
+    }
+
+    void ThreadPool::WorkerThread()
+    {
+        long long lastGeneration = 0;
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_workAvailable.wait(lock, [&]() { return m_stop || m_generation != lastGeneration; });
+                if (m_stop)
+                {
+                    return;
+                }
+                lastGeneration = m_generation;
+            }
+
+            RunTasks();
+        }
+    }
+
+    void ThreadPool::RunTasks()
+    {
+        // 'ParallelFor' does not return while this thread is active,
+        // hence 'm_task' and 'm_numberOfTasks' do not change until this thread is done
+        const std::function<void(int)>* task;
+        int numberOfTasks;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            task = m_task;
+            numberOfTasks = m_numberOfTasks;
+            if (task == nullptr)
+            {
+                return;
+            }
+            ++m_activeThreads;
+        }
+
+        for (int taskIdx = m_nextTask++; taskIdx < numberOfTasks; taskIdx = m_nextTask++)
+        {
+            try
+            {
+                (*task)(taskIdx);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_exception == nullptr || taskIdx < m_exceptionTask)
+                {
+                    m_exception = std::current_exception();
+                    m_exceptionTask = taskIdx;
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_activeThreads == 0)
+        {
+            m_workDone.notify_all();
+        }
+    }
+}
@@ -0,0 +1,162 @@
+// The fit library is built here with single precision data (float spectra, references and derivatives).
+// The normal equations, the chi square and the solution of the equations are still calculated in double precision.
+// The expected values of the tests are the results of the default double precision build.
+// MATHFIT_FITDATAFLOAT must be defined for the whole project, since the fit library is header-only and
+// every translation unit of an executable has to see the same instances of its classes.
+#if !defined(MATHFIT_FITDATAFLOAT)
+#error The single precision tests must be built with MATHFIT_FITDATAFLOAT defined for the whole project
+#endif
+
+#include "catch.hpp"
+#include "SyntheticDoasSpectrum.h"
+#include <Fit/StandardMetricFunction.h>
+#include <Fit/StandardFit.h>
+#include <Fit/NormalEquations.h>
+#include <type_traits>
+#include <cmath>
+
+using namespace MathFit;
+using namespace SyntheticDoas;
+
+namespace
+{
+    struct FitResult
+    {
+        double column = 0.0;
+        double columnError = 0.0;
+        double shift = 0.0;
+        double shiftError = 0.0;
+        double interferenceColumn = 0.0;
+        double chiSquare = 0.0;
+    };
+
+    // Evaluates a synthetic measured spectrum with the shared DOAS model.
+    FitResult EvaluateSyntheticSpectrum(const SpectrumParameters& spectrum, CStandardFit::ENonlinearMinimizer minimizer, IMinimizer::EEquationSolver solver)
+    {
+        FitSetup setup;
+        setup.SetSpectrum(spectrum);
+
+        CStandardMetricFunction difference(setup.target, setup.model);
+
+        CStandardFit fit(difference, minimizer);
+        fit.SetFitRange(setup.fitRange);
+        fit.SetEquationSolver(solver);
+        fit.GetNonlinearMinimizer().SetMaxFitSteps(1000);
+        fit.PrepareMinimize();
+        fit.Minimize();
+        fit.FinishMinimize();
+
+        FitResult result;
+        result.column = setup.references[0].GetModelParameter(CReferenceSpectrumFunction::CONCENTRATION);
+        result.columnError = setup.references[0].GetModelParameterError(CReferenceSpectrumFunction::CONCENTRATION);
+        result.shift = setup.references[0].GetModelParameter(CReferenceSpectrumFunction::SHIFT);
+        result.shiftError = setup.references[0].GetModelParameterError(CReferenceSpectrumFunction::SHIFT);
+        result.interferenceColumn = setup.references[1].GetModelParameter(CReferenceSpectrumFunction::CONCENTRATION);
+        result.chiSquare = fit.GetChiSquare();
+        return result;
+    }
+
+    // The results of the default double precision build for the spectra used below.
+    struct ExpectedResult
+    {
+        SpectrumParameters spectrum;
+        FitResult doubleBuild;
+    };
+
+    ExpectedResult Expected(double column, double shift, double interferenceColumn, const FitResult& doubleBuild)
+    {
+        ExpectedResult expected;
+        expected.spectrum.column = column;
+        expected.spectrum.shift = shift;
+        expected.spectrum.interferenceColumn = interferenceColumn;
+        expected.doubleBuild = doubleBuild;
+        return expected;
+    }
+}
+
+TEST_CASE("FitPrecision - Single precision build stores the fit data as float and the normal equations as double", "[FitPrecision]")
+{
+    REQUIRE(std::is_same<TFitData, float>::value);
+    REQUIRE(std::is_same<CVector, CBasicVector<float>>::value);
+    REQUIRE(std::is_same<CMatrix, CBasicMatrix<float>>::value);
+    REQUIRE(std::is_same<CDoubleVector, CBasicVector<double>>::value);
+    REQUIRE(std::is_same<CDoubleMatrix, CBasicMatrix<double>>::value);
+}
+
+TEST_CASE("FitPrecision - Normal equations are accumulated in double precision", "[FitPrecision]")
+{
+    // Arrange. Summing this many values in single precision would lose about three significant digits.
+    const int length = 100000;
+    CMatrix jacobian(2, length);
+    CVector residual(length);
+    CVector error(length);
+    double expectedChiSquare = 0.0;
+    double expectedBeta[2] = { 0.0, 0.0 };
+    double expectedAlpha[2][2] = { { 0.0, 0.0 }, { 0.0, 0.0 } };
+    for (int i = 0; i < length; ++i)
+    {
+        const float r = 0.1f + 1e-3f * (float)(i % 7);
+        const float e = 0.5f + 1e-2f * (float)(i % 3);
+        const float d[2] = { 1.0f + 1e-4f * (float)(i % 11), -0.3f };
+        residual.SetAt(i, r);
+        error.SetAt(i, e);
+        jacobian.SetAt(i, 0, d[0]);
+        jacobian.SetAt(i, 1, d[1]);
+
+        const double weight = 1.0 / ((double)e * (double)e);
+        expectedChiSquare += (double)r * r * weight;
+        for (int j = 0; j < 2; ++j)
+        {
+            expectedBeta[j] += (double)d[j] * r * weight;
+            for (int k = 0; k < 2; ++k)
+            {
+                expectedAlpha[j][k] += (double)d[j] * d[k] * weight;
+            }
+        }
+    }
+    CDoubleMatrix alpha(2, 2);
+    CDoubleVector beta(2);
+
+    // Act
+    const double chiSquare = CNormalEquations::Build(jacobian, residual, error, alpha, beta);
+
+    // Assert
+    REQUIRE(chiSquare == Approx(expectedChiSquare).epsilon(1e-7));
+    REQUIRE(beta.GetAt(0) == Approx(expectedBeta[0]).epsilon(1e-7));
+    REQUIRE(beta.GetAt(1) == Approx(expectedBeta[1]).epsilon(1e-7));
+    REQUIRE(alpha.GetAt(0, 0) == Approx(expectedAlpha[0][0]).epsilon(1e-7));
+    REQUIRE(alpha.GetAt(1, 0) == Approx(expectedAlpha[1][0]).epsilon(1e-7));
+    REQUIRE(alpha.GetAt(1, 1) == Approx(expectedAlpha[1][1]).epsilon(1e-7));
+}
+
+TEST_CASE("FitPrecision - Evaluated columns agree with the double precision build", "[FitPrecision]")
+{
+    const ExpectedResult spectra[] = {
+        Expected(2.5, 0.37, -0.7, { 2.50000024, 5.2269474e-05, 0.369978663, 0.000704473035, -0.700000392, 0.000349830725 }),
+        Expected(0.8, 0, 0.3, { 0.799999454, 5.22694361e-05, -6.06918477e-05, 0.00220278326, 0.299999794, 0.000349829745 }),
+        Expected(1.7, -0.52, -1.2, { 1.70000016, 5.22701442e-05, -0.520032866, 0.00103741562, -1.20000048, 0.000349831257 })
+    };
+
+    const CStandardFit::ENonlinearMinimizer minimizers[] = { CStandardFit::LEVENBERGMARQUARDT, CStandardFit::VARIABLEPROJECTION };
+    const IMinimizer::EEquationSolver solvers[] = { IMinimizer::GAUSSJORDAN, IMinimizer::LUDECOMPOSITION, IMinimizer::CHOLESKY };
+
+    for (const CStandardFit::ENonlinearMinimizer minimizer : minimizers)
+    {
+        for (const IMinimizer::EEquationSolver solver : solvers)
+        {
+            for (const ExpectedResult& spectrum : spectra)
+            {
+                // Act
+                const FitResult result = EvaluateSyntheticSpectrum(spectrum.spectrum, minimizer, solver);
+
+                // Assert. The shift is correlated with the squeeze, so its error is less accurate in single precision.
+                REQUIRE(result.column == Approx(spectrum.doubleBuild.column).epsilon(1e-5));
+                REQUIRE(result.columnError == Approx(spectrum.doubleBuild.columnError).epsilon(1e-3));
+                REQUIRE(result.shift == Approx(spectrum.doubleBuild.shift).margin(1e-4));
+                REQUIRE(result.shiftError == Approx(spectrum.doubleBuild.shiftError).epsilon(1e-2));
+                REQUIRE(result.interferenceColumn == Approx(spectrum.doubleBuild.interferenceColumn).epsilon(1e-5));
+                REQUIRE(result.chiSquare == Approx(spectrum.doubleBuild.chiSquare).epsilon(1e-3));
+            }
+        }
+    }
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+// A synthetic DOAS fit which is shared by the tests of the fit library: three reference spectra,
+// a polynomial, and measured spectra which are created from these with known columns, shifts and squeezes.
+
+#include <Fit/ReferenceSpectrumFunction.h>
+#include <Fit/SimpleDOASFunction.h>
+#include <Fit/PolynomialFunction.h>
+#include <Fit/DiscreteFunction.h>
+#include <cmath>
+
+namespace SyntheticDoas
+{
+    const int spectrumLength = 1000;
+    const int fitLow = 150;
+    const int fitHigh = 850;
+    const int referenceCount = 3;
+    const int polynomialOrder = 3;
+
+    // The reference spectra. The first one is the absorber, the other two interfere with it.
+    inline double ReferenceSpectrum(int index, double x)
+    {
+        switch (index)
+        {
+        case 0: return sin(x * 0.11) * exp(-pow((x - 500.0) / 300.0, 2));
+        case 1: return cos(x * 0.037) + 0.3 * sin(x * 0.2);
+        default: return 0.5 * sin(x * 0.05 + 1.0) + 0.2 * cos(x * 0.31);
+        }
+    }
+
+    // The properties of a measured spectrum. The third reference always has a column of 0.4.
+    struct SpectrumParameters
+    {
+        double column = 2.5;
+        double shift = -0.3;
+        double squeeze = 1.0;
+        double interferenceColumn = -0.7;
+        double interferenceShift = 0.2;
+
+        // The phase of the small structured residual which is added to the spectrum
+        double residualPhase = 0.0;
+    };
+
+    // The measured spectrum at the given pixel, together with a linear baseline and a structured residual.
+    inline double MeasuredSpectrum(const SpectrumParameters& parameters, double x)
+    {
+        return parameters.column * ReferenceSpectrum(0, (x + parameters.shift - fitLow) * parameters.squeeze + fitLow) +
+            parameters.interferenceColumn * ReferenceSpectrum(1, x + parameters.interferenceShift) +
+            0.4 * ReferenceSpectrum(2, x) + 0.1 + 1e-4 * x + 1e-3 * sin(x * 1.3 + parameters.residualPhase);
+    }
+
+    // The DOAS model of the synthetic spectra. The first reference is shifted and squeezed, the second one is
+    // shifted and the third one has a fixed column. The measured spectrum is the target of the model.
+    struct FitSetup
+    {
+        MathFit::CVector xData;
+        MathFit::CVector measured;
+        MathFit::CVector error;
+        MathFit::CVector fitRange;
+        MathFit::CDiscreteFunction target;
+        MathFit::CSimpleDOASFunction model;
+        MathFit::CReferenceSpectrumFunction references[referenceCount];
+        MathFit::CPolynomialFunction polynomial;
+
+        FitSetup()
+            : xData(spectrumLength), measured(spectrumLength), error(spectrumLength), fitRange(fitHigh - fitLow), polynomial(polynomialOrder)
+        {
+            using MathFit::CReferenceSpectrumFunction;
+            using MathFit::TFitData;
+
+            error.Wedge(1, 0);
+            for (int i = 0; i < spectrumLength; ++i)
+            {
+                xData.SetAt(i, (TFitData)(i + 1.0));
+            }
+            for (int i = 0; i < fitRange.GetSize(); ++i)
+            {
+                fitRange.SetAt(i, (TFitData)(fitLow + i));
+            }
+
+            for (int k = 0; k < referenceCount; ++k)
+            {
+                MathFit::CVector spectrum(spectrumLength);
+                for (int i = 0; i < spectrumLength; ++i)
+                {
+                    spectrum.SetAt(i, (TFitData)ReferenceSpectrum(k, i + 1.0));
+                }
+                references[k].SetNormalize(true);
+                references[k].SetData(xData, spectrum);
+                model.AddReference(references[k]);
+            }
+            references[1].FixParameter(CReferenceSpectrumFunction::SQUEEZE, 1.0);
+            references[2].FixParameter(CReferenceSpectrumFunction::SQUEEZE, 1.0);
+            references[2].FixParameter(CReferenceSpectrumFunction::SHIFT, 0.0);
+            references[2].FixParameter(CReferenceSpectrumFunction::CONCENTRATION, (TFitData)0.4 * references[2].GetAmplitudeScale());
+            model.AddReference(polynomial);
+
+            SetSpectrum(SpectrumParameters());
+        }
+
+        // Creates the measured spectrum and sets it as the target of the model.
+        void SetSpectrum(const SpectrumParameters& parameters)
+        {
+            for (int i = 0; i < spectrumLength; ++i)
+            {
+                measured.SetAt(i, (MathFit::TFitData)MeasuredSpectrum(parameters, i + 1.0));
+            }
+            target.SetData(xData, measured, error);
+        }
+    };
+}
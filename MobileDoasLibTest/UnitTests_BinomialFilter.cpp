@@ -0,0 +1,107 @@
+#include "catch.hpp"
+#include <Fit/BinomialFilter.h>
+#include <cmath>
+#include <vector>
+
+using namespace MathFit;
+
+namespace
+{
+    std::vector<double> Spectrum(int length)
+    {
+        std::vector<double> spectrum(length);
+        for (int i = 0; i < length; ++i)
+        {
+            spectrum[i] = 1000.0 + 500.0 * sin(i * 0.01) + 30.0 * cos(i * 0.8) + (i % 3);
+        }
+        return spectrum;
+    }
+}
+
+TEST_CASE("BinomialFilter - Frequency domain gives the same result as the iterations", "[BinomialFilter]")
+{
+    for (int length : { 1, 2, 7, 1024, 3648 })
+    {
+        for (int iterations : { 0, 1, 5, 500 })
+        {
+            // Arrange
+            std::vector<double> iterated = Spectrum(length);
+            std::vector<double> fourier = iterated;
+            CBinomialFilter filter;
+
+            // Act
+            filter.LowPass(iterated.data(), length, iterations, CBinomialFilter::ITERATED);
+            filter.LowPass(fourier.data(), length, iterations, CBinomialFilter::FOURIER);
+
+            // Assert
+            for (int i = 0; i < length; ++i)
+            {
+                REQUIRE(fourier[i] == Approx(iterated[i]).epsilon(1e-12));
+            }
+        }
+    }
+}
+
+TEST_CASE("BinomialFilter - Edge values are replicated", "[BinomialFilter]")
+{
+    // Arrange
+    double data[] = { 4.0, 0.0, 0.0, 8.0 };
+    CBinomialFilter filter;
+
+    // Act
+    filter.LowPass(data, 4, 1, CBinomialFilter::FOURIER);
+
+    // Assert
+    REQUIRE(data[0] == Approx(3.0));
+    REQUIRE(data[1] == Approx(1.0));
+    REQUIRE(data[2] == Approx(2.0));
+    REQUIRE(data[3] == Approx(6.0));
+}
+
+TEST_CASE("BinomialFilter - Automatic method uses the frequency domain for many iterations", "[BinomialFilter]")
+{
+    // Arrange
+    std::vector<double> automatic = Spectrum(3648);
+    std::vector<double> fourier = automatic;
+    CBinomialFilter filter;
+
+    // Act
+    filter.LowPass(automatic.data(), 3648, 500);
+    filter.LowPass(fourier.data(), 3648, 500, CBinomialFilter::FOURIER);
+
+    // Assert
+    REQUIRE(automatic == fourier);
+}
+
+TEST_CASE("BinomialFilter - Support is the number of iterations for few iterations", "[BinomialFilter]")
+{
+    REQUIRE(CBinomialFilter::GetSupport(0) == 0);
+    REQUIRE(CBinomialFilter::GetSupport(1) == 1);
+    REQUIRE(CBinomialFilter::GetSupport(5) == 5);
+    REQUIRE(CBinomialFilter::GetSupport(500) < 500);
+}
+
+TEST_CASE("BinomialFilter - Filtering a part extended by the support gives the same values inside the part", "[BinomialFilter]")
+{
+    for (int iterations : { 5, 500 })
+    {
+        // Arrange
+        const int length = 3648;
+        const int partLow = 1200;
+        const int partHigh = 1450;
+        const int support = CBinomialFilter::GetSupport(iterations);
+        std::vector<double> whole = Spectrum(length);
+        std::vector<double> part(whole.begin() + partLow - support, whole.begin() + partHigh + support);
+        CBinomialFilter filter;
+
+        // Act
+        filter.LowPass(whole.data(), length, iterations, CBinomialFilter::ITERATED);
+        filter.LowPass(part.data(), (int)part.size(), iterations, CBinomialFilter::ITERATED);
+
+        // Assert
+        for (int i = partLow; i < partHigh; ++i)
+        {
+            REQUIRE(part[i - partLow + support] == Approx(whole[i]).epsilon(1e-14));
+        }
+    }
+}
@@ -0,0 +1,112 @@
+#include "catch.hpp"
+#include <MobileDoasLib/BoundedQueue.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace mobiledoas;
+
+TEST_CASE("BoundedQueue - Items are popped in the order they were pushed", "[BoundedQueue]")
+{
+    // Arrange
+    BoundedQueue<int> sut(3);
+
+    // Act
+    for (int round = 0; round < 5; ++round)
+    {
+        // Assert
+        int value = 10 * round;
+        REQUIRE(sut.TryPush(value));
+        value = 10 * round + 1;
+        REQUIRE(sut.TryPush(value));
+
+        int popped = -1;
+        REQUIRE(sut.TryPop(popped));
+        REQUIRE(popped == 10 * round);
+        REQUIRE(sut.TryPop(popped));
+        REQUIRE(popped == 10 * round + 1);
+    }
+}
+
+TEST_CASE("BoundedQueue - Push fails when the queue is full and pop fails when it is empty", "[BoundedQueue]")
+{
+    // Arrange
+    BoundedQueue<int> sut(2);
+    int value = 1;
+    int popped = 0;
+
+    // Act & Assert
+    REQUIRE(sut.Capacity() == 2);
+    REQUIRE_FALSE(sut.TryPop(popped));
+    REQUIRE(sut.TryPush(value));
+    REQUIRE(sut.TryPush(value));
+    REQUIRE_FALSE(sut.TryPush(value));
+    REQUIRE(sut.TryPop(popped));
+    REQUIRE(sut.TryPush(value));
+}
+
+TEST_CASE("BoundedQueue - Pushed items are moved", "[BoundedQueue]")
+{
+    // Arrange
+    BoundedQueue<std::unique_ptr<int>> sut(1);
+    std::unique_ptr<int> item(new int(42));
+    std::unique_ptr<int> popped;
+
+    // Act
+    REQUIRE(sut.TryPush(item));
+    REQUIRE(sut.TryPop(popped));
+
+    // Assert
+    REQUIRE(item == nullptr);
+    REQUIRE(*popped == 42);
+}
+
+TEST_CASE("BoundedQueue - Pop returns the remaining items after the queue is closed", "[BoundedQueue]")
+{
+    // Arrange
+    BoundedQueue<int> sut(4);
+    sut.Push(7);
+    sut.Push(8);
+
+    // Act
+    sut.Close();
+
+    // Assert
+    int popped = 0;
+    REQUIRE(sut.Pop(popped));
+    REQUIRE(popped == 7);
+    REQUIRE(sut.Pop(popped));
+    REQUIRE(popped == 8);
+    REQUIRE_FALSE(sut.Pop(popped));
+}
+
+TEST_CASE("BoundedQueue - Items are passed between two threads in order", "[BoundedQueue]")
+{
+    // Arrange
+    const int numberOfItems = 100000;
+    BoundedQueue<int> sut(4);
+    std::vector<int> received;
+
+    // Act
+    std::thread consumer([&]()
+        {
+            int item;
+            while (sut.Pop(item))
+            {
+                received.push_back(item);
+            }
+        });
+    for (int i = 0; i < numberOfItems; ++i)
+    {
+        sut.Push(i);
+    }
+    sut.Close();
+    consumer.join();
+
+    // Assert
+    REQUIRE(received.size() == numberOfItems);
+    for (int i = 0; i < numberOfItems; ++i)
+    {
+        REQUIRE(received[i] == i);
+    }
+}
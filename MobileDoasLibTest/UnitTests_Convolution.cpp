@@ -0,0 +1,162 @@
+#include "catch.hpp"
+#include <Fit/Convolution.h>
+#include <Fit/ConvoluteFunction.h>
+#include <Fit/DiscreteFunction.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace MathFit;
+
+namespace
+{
+    std::vector<double> Spectrum(int length)
+    {
+        std::vector<double> spectrum(length);
+        for (int i = 0; i < length; ++i)
+        {
+            spectrum[i] = 1000.0 + 800.0 * sin(i * 0.013) + 50.0 * cos(i * 0.41);
+        }
+        return spectrum;
+    }
+
+    std::vector<double> GaussCore(int length)
+    {
+        std::vector<double> core(length);
+        for (int i = 0; i < length; ++i)
+        {
+            core[i] = exp(-pow((i - length / 2.0) / (length / 6.0 + 0.5), 2));
+        }
+        return core;
+    }
+
+    // A gaussian slit function whose shape does not depend on its position.
+    class GaussCoreFunction : public IConvolutionCoreFunction
+    {
+    public:
+        GaussCoreFunction(double width, bool shiftInvariant)
+            : m_width(width), m_shiftInvariant(shiftInvariant)
+        {
+        }
+
+        virtual TFitData GetValue(TFitData fXValue) { return (TFitData)exp(-0.5 * fXValue * fXValue / (m_width * m_width)); }
+        virtual TFitData GetSlope(TFitData fXValue) { return (TFitData)(-fXValue / (m_width * m_width)) * GetValue(fXValue); }
+        virtual TFitData GetLinearBasisFunction(TFitData /*fXValue*/, int /*iParamID*/, bool /*bFixedID*/ = true) { return 0; }
+        virtual TFitData GetCoreLowBound() { return (TFitData)(-5.0 * m_width); }
+        virtual TFitData GetCoreHighBound() { return (TFitData)(5.0 * m_width); }
+        virtual bool IsShiftInvariant() { return m_shiftInvariant; }
+
+    private:
+        double m_width;
+        bool m_shiftInvariant;
+    };
+}
+
+TEST_CASE("Convolution - Boundaries are extended", "[Convolution]")
+{
+    // Arrange
+    const double data[] = { 1, 2, 4 };
+    const double core[] = { 1, 10, 100 };
+    double result[3];
+
+    SECTION("Constant extension")
+    {
+        // Act
+        CConvolution::Convolute(data, 3, core, 3, 1, result, CConvolution::CONSTANTEXTENSION);
+
+        // Assert
+        REQUIRE(result[0] == 1 + 10 + 200);
+        REQUIRE(result[1] == 1 + 20 + 400);
+        REQUIRE(result[2] == 2 + 40 + 400);
+    }
+
+    SECTION("Zero extension")
+    {
+        // Act
+        CConvolution::Convolute(data, 3, core, 3, 1, result, CConvolution::ZEROEXTENSION);
+
+        // Assert
+        REQUIRE(result[0] == 10 + 200);
+        REQUIRE(result[1] == 1 + 20 + 400);
+        REQUIRE(result[2] == 2 + 40);
+    }
+}
+
+TEST_CASE("Convolution - Fourier transform gives the same result as the direct sums", "[Convolution]")
+{
+    for (int length : { 1, 7, 1000, 3648 })
+    {
+        for (int coreLength : { 1, 4, 31, 301, 5000 })
+        {
+            for (int boundary = 0; boundary < 2; ++boundary)
+            {
+                // Arrange
+                const std::vector<double> data = Spectrum(length);
+                const std::vector<double> core = GaussCore(coreLength);
+                std::vector<double> direct(length);
+                std::vector<double> fourier(length);
+
+                // Act
+                CConvolution::Convolute(data.data(), length, core.data(), coreLength, coreLength / 2, direct.data(), (CConvolution::EBoundary)boundary, CConvolution::DIRECT);
+                CConvolution::Convolute(data.data(), length, core.data(), coreLength, coreLength / 2, fourier.data(), (CConvolution::EBoundary)boundary, CConvolution::FOURIER);
+
+                // Assert
+                const double scale = *std::max_element(direct.begin(), direct.end());
+                for (int i = 0; i < length; ++i)
+                {
+                    REQUIRE(fourier[i] == Approx(direct[i]).margin(1e-12 * scale));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Convolution - The Fourier transform is only used for large cores", "[Convolution]")
+{
+    REQUIRE_FALSE(CConvolution::IsFourierFaster(3648, 5));
+    REQUIRE(CConvolution::IsFourierFaster(3648, 200));
+    REQUIRE_FALSE(CConvolution::IsFourierFaster(3648, 200, 10));
+}
+
+TEST_CASE("ConvoluteFunction - Shift invariant cores give the same values as the direct convolution", "[Convolution]")
+{
+    // Arrange
+    const int length = 2000;
+    const std::vector<double> spectrum = Spectrum(length);
+    CVector xData(length);
+    CVector yData(length);
+    for (int i = 0; i < length; ++i)
+    {
+        xData.SetAt(i, (TFitData)(300.0 + 0.05 * i));
+        yData.SetAt(i, (TFitData)spectrum[i]);
+    }
+    CDiscreteFunction base;
+    base.SetData(xData, yData);
+    GaussCoreFunction fourierCore(1.5, true);
+    GaussCoreFunction directCore(1.5, false);
+    CConvoluteFunction fourierConvolution(base, fourierCore);
+    CConvoluteFunction directConvolution(base, directCore);
+
+    // every second base sample and some values between the samples
+    CVector xValues(length / 2 + 3);
+    for (int i = 0; i < length / 2; ++i)
+    {
+        xValues.SetAt(i, xData.GetAt(2 * i));
+    }
+    xValues.SetAt(length / 2, (TFitData)310.0125);
+    xValues.SetAt(length / 2 + 1, (TFitData)330.0375);
+    xValues.SetAt(length / 2 + 2, (TFitData)350.0);
+    CVector fourier(xValues.GetSize());
+    CVector direct(xValues.GetSize());
+
+    // Act
+    fourierConvolution.GetValues(xValues, fourier);
+    directConvolution.GetValues(xValues, direct);
+
+    // Assert
+    for (int i = 0; i < xValues.GetSize(); ++i)
+    {
+        REQUIRE(fourier.GetAt(i) == Approx(direct.GetAt(i)).epsilon(std::numeric_limits<TFitData>::epsilon() * 1e4));
+    }
+}
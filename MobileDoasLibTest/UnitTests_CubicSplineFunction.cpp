@@ -0,0 +1,121 @@
+#include "catch.hpp"
+#include <Fit/CubicSplineFunction.h>
+#include <cmath>
+
+using namespace MathFit;
+
+namespace
+{
+    const int nodeCount = 500;
+
+    // A spline through a spectrum-like curve, sampled at the pixels 1..nodeCount or at the given pixel distance.
+    struct SplineSetup
+    {
+        CVector xData;
+        CVector yData;
+        CCubicSplineFunction spline;
+
+        explicit SplineSetup(double step = 1.0)
+            : xData(nodeCount), yData(nodeCount)
+        {
+            for (int i = 0; i < nodeCount; ++i)
+            {
+                const double x = 1.0 + i * step;
+                xData.SetAt(i, (TFitData)x);
+                yData.SetAt(i, (TFitData)(sin(x * 0.11) + 0.3 * cos(x * 0.037)));
+            }
+            spline.SetData(xData, yData);
+        }
+    };
+
+    // The X values at which the splines are evaluated, these include the nodes and values outside of the nodes.
+    CVector EvaluationPoints(double first, double last, int count)
+    {
+        CVector points(count);
+        for (int i = 0; i < count; ++i)
+        {
+            points.SetAt(i, (TFitData)(first + (last - first) * i / (count - 1)));
+        }
+        return points;
+    }
+}
+
+TEST_CASE("CubicSplineFunction - Equidistant nodes are detected", "[CubicSplineFunction]")
+{
+    SECTION("Pixel grid")
+    {
+        SplineSetup setup;
+
+        REQUIRE(setup.spline.IsUniform());
+    }
+
+    SECTION("Equidistant grid with a fractional step")
+    {
+        SplineSetup setup(0.1);
+
+        REQUIRE(setup.spline.IsUniform());
+    }
+
+    SECTION("One node moved")
+    {
+        SplineSetup setup;
+        setup.xData.SetAt(200, (TFitData)200.5);
+        setup.spline.SetData(setup.xData, setup.yData);
+
+        REQUIRE_FALSE(setup.spline.IsUniform());
+    }
+}
+
+TEST_CASE("CubicSplineFunction - Equidistant nodes give the same values and slopes as single evaluations", "[CubicSplineFunction]")
+{
+    for (double step : { 1.0, 0.1 })
+    {
+        // Arrange
+        SplineSetup setup(step);
+        const double last = 1.0 + (nodeCount - 1) * step;
+        CVector points = EvaluationPoints(-3.0 * step, last + 2.0 * step, 4 * nodeCount + 1);
+        CVector values(points.GetSize());
+        CVector slopes(points.GetSize());
+        CVector fusedValues(points.GetSize());
+        CVector fusedSlopes(points.GetSize());
+
+        // Act
+        setup.spline.GetValues(points, values);
+        setup.spline.GetSlopes(points, slopes);
+        setup.spline.GetValuesAndSlopes(points, fusedValues, fusedSlopes);
+
+        // Assert
+        for (int i = 0; i < points.GetSize(); ++i)
+        {
+            const TFitData x = points.GetAt(i);
+            REQUIRE(values.GetAt(i) == Approx(setup.spline.GetValue(x)).margin(1e-5));
+            REQUIRE(slopes.GetAt(i) == Approx(setup.spline.GetSlope(x)).margin(1e-5));
+            REQUIRE(fusedValues.GetAt(i) == values.GetAt(i));
+            REQUIRE(fusedSlopes.GetAt(i) == slopes.GetAt(i));
+        }
+    }
+}
+
+TEST_CASE("CubicSplineFunction - Equidistant nodes do not need sorted X values", "[CubicSplineFunction]")
+{
+    // Arrange
+    SplineSetup setup;
+    CVector points = EvaluationPoints(-2.0, nodeCount + 3.0, 1001);
+    CVector reversedPoints(points.GetSize());
+    for (int i = 0; i < points.GetSize(); ++i)
+    {
+        reversedPoints.SetAt(i, points.GetAt(points.GetSize() - 1 - i));
+    }
+    CVector values(points.GetSize());
+    CVector reversedValues(points.GetSize());
+
+    // Act
+    setup.spline.GetValues(points, values);
+    setup.spline.GetValues(reversedPoints, reversedValues);
+
+    // Assert
+    for (int i = 0; i < points.GetSize(); ++i)
+    {
+        REQUIRE(reversedValues.GetAt(points.GetSize() - 1 - i) == values.GetAt(i));
+    }
+}
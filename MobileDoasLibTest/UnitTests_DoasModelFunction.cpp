@@ -0,0 +1,238 @@
+#include "catch.hpp"
+#include "SyntheticDoasSpectrum.h"
+#include <Fit/StandardMetricFunction.h>
+#include <Fit/DoasModelFunction.h>
+#include <Fit/StandardFit.h>
+#include <memory>
+#include <cmath>
+
+using namespace MathFit;
+using namespace SyntheticDoas;
+
+namespace
+{
+    // The synthetic fit with a squeezed measured spectrum, together with the difference between the measured spectrum
+    // and the model. The difference is either the generic CStandardMetricFunction or the compiled model created by CDoasModel.
+    struct DoasModelSetup : public FitSetup
+    {
+        std::unique_ptr<CStandardMetricFunction> difference;
+
+        DoasModelSetup(bool compiled)
+        {
+            SpectrumParameters spectrum;
+            spectrum.squeeze = 1.01;
+            SetSpectrum(spectrum);
+
+            if (compiled)
+            {
+                difference.reset(CDoasModel::Create(target, model, references, referenceCount, polynomial));
+            }
+            else
+            {
+                difference.reset(new CStandardMetricFunction(target, model));
+            }
+            difference->SetFitRange(fitRange);
+        }
+
+        void SetParameters()
+        {
+            references[0].SetParameter(CReferenceSpectrumFunction::CONCENTRATION, 1.7);
+            references[0].SetParameter(CReferenceSpectrumFunction::SHIFT, 0.21);
+            references[0].SetParameter(CReferenceSpectrumFunction::SQUEEZE, 1.013);
+            references[1].SetParameter(CReferenceSpectrumFunction::CONCENTRATION, -0.3);
+            references[1].SetParameter(CReferenceSpectrumFunction::SHIFT, -0.4);
+            for (int k = 0; k <= polynomialOrder; ++k)
+            {
+                polynomial.SetCoefficient(k, (TFitData)(0.01 / (k + 1) / pow(500.0, k)));
+            }
+        }
+    };
+}
+
+TEST_CASE("DoasModelFunction - Create returns NULL for unsupported models", "[DoasModelFunction]")
+{
+    CDiscreteFunction target;
+    CSimpleDOASFunction model;
+    CReferenceSpectrumFunction references[7];
+
+    SECTION("Too few or too many references")
+    {
+        CPolynomialFunction polynomial(3);
+
+        REQUIRE(CDoasModel::Create(target, model, references, 0, polynomial) == NULL);
+        REQUIRE(CDoasModel::Create(target, model, references, 7, polynomial) == NULL);
+    }
+
+    SECTION("Polynomial order out of range")
+    {
+        CPolynomialFunction lowOrderPolynomial(1);
+        CPolynomialFunction highOrderPolynomial(6);
+
+        REQUIRE(CDoasModel::Create(target, model, references, 2, lowOrderPolynomial) == NULL);
+        REQUIRE(CDoasModel::Create(target, model, references, 2, highOrderPolynomial) == NULL);
+    }
+
+    SECTION("Supported model")
+    {
+        CPolynomialFunction polynomial(3);
+
+        std::unique_ptr<CStandardMetricFunction> difference(CDoasModel::Create(target, model, references, 6, polynomial));
+
+        REQUIRE(dynamic_cast<CDoasModelFunction<6, 3>*>(difference.get()) != NULL);
+    }
+}
+
+TEST_CASE("DoasModelFunction - Values, derivatives and A matrix are the same as those of the generic model", "[DoasModelFunction]")
+{
+    // Arrange
+    DoasModelSetup generic(false);
+    DoasModelSetup compiled(true);
+    generic.SetParameters();
+    compiled.SetParameters();
+    const int length = generic.fitRange.GetSize();
+    const int nonlinearCount = generic.model.GetNonlinearParameter().GetSize();
+    const int linearCount = generic.model.GetLinearParameter().GetSize();
+
+    CVector genericValues(length), compiledValues(length);
+    CMatrix genericDyDa(nonlinearCount, length), compiledDyDa(nonlinearCount, length);
+    CMatrix genericA(linearCount, length), compiledA(linearCount, length);
+    CVector genericB(length), compiledB(length);
+
+    // Act
+    generic.difference->GetValues(generic.fitRange, genericValues);
+    compiled.difference->GetValues(compiled.fitRange, compiledValues);
+    generic.difference->GetNonlinearDyDa(generic.fitRange, genericDyDa);
+    compiled.difference->GetNonlinearDyDa(compiled.fitRange, compiledDyDa);
+    generic.difference->GetLinearAMatrix(generic.fitRange, genericA, genericB);
+    compiled.difference->GetLinearAMatrix(compiled.fitRange, compiledA, compiledB);
+
+    // Assert
+    REQUIRE(nonlinearCount == 3);
+    REQUIRE(linearCount == 2 + polynomialOrder + 1);
+    for (int i = 0; i < length; ++i)
+    {
+        REQUIRE(compiledValues.GetAt(i) == Approx(genericValues.GetAt(i)).margin(1e-12));
+        REQUIRE(compiledB.GetAt(i) == Approx(genericB.GetAt(i)).margin(1e-12));
+        for (int k = 0; k < nonlinearCount; ++k)
+        {
+            REQUIRE(compiledDyDa.GetAt(i, k) == Approx(genericDyDa.GetAt(i, k)).margin(1e-12));
+        }
+        for (int k = 0; k < linearCount; ++k)
+        {
+            REQUIRE(compiledA.GetAt(i, k) == Approx(genericA.GetAt(i, k)).epsilon(1e-12));
+        }
+    }
+}
+
+TEST_CASE("DoasModelFunction - Fit results are the same as those of the generic model", "[DoasModelFunction]")
+{
+    const CStandardFit::ENonlinearMinimizer minimizers[] = { CStandardFit::LEVENBERGMARQUARDT, CStandardFit::VARIABLEPROJECTION };
+
+    for (const CStandardFit::ENonlinearMinimizer minimizer : minimizers)
+    {
+        // Arrange
+        DoasModelSetup generic(false);
+        DoasModelSetup compiled(true);
+        CStandardFit genericFit(*generic.difference, minimizer);
+        CStandardFit compiledFit(*compiled.difference, minimizer);
+        genericFit.SetFitRange(generic.fitRange);
+        compiledFit.SetFitRange(compiled.fitRange);
+
+        // Act
+        genericFit.PrepareMinimize();
+        genericFit.Minimize();
+        genericFit.FinishMinimize();
+        compiledFit.PrepareMinimize();
+        compiledFit.Minimize();
+        compiledFit.FinishMinimize();
+
+        // Assert
+        REQUIRE(compiledFit.GetFitSteps() == genericFit.GetFitSteps());
+        REQUIRE(compiledFit.GetChiSquare() == Approx(genericFit.GetChiSquare()).epsilon(1e-9));
+        for (int k = 0; k < 2; ++k)
+        {
+            REQUIRE(compiled.references[k].GetModelParameter(CReferenceSpectrumFunction::CONCENTRATION) == Approx(generic.references[k].GetModelParameter(CReferenceSpectrumFunction::CONCENTRATION)).epsilon(1e-9));
+            REQUIRE(compiled.references[k].GetModelParameter(CReferenceSpectrumFunction::SHIFT) == Approx(generic.references[k].GetModelParameter(CReferenceSpectrumFunction::SHIFT)).margin(1e-9));
+            REQUIRE(compiled.references[k].GetModelParameterError(CReferenceSpectrumFunction::CONCENTRATION) == Approx(generic.references[k].GetModelParameterError(CReferenceSpectrumFunction::CONCENTRATION)).epsilon(1e-9));
+        }
+        REQUIRE(compiled.references[0].GetModelParameter(CReferenceSpectrumFunction::SQUEEZE) == Approx(generic.references[0].GetModelParameter(CReferenceSpectrumFunction::SQUEEZE)).epsilon(1e-9));
+        REQUIRE(compiled.references[0].GetModelParameter(CReferenceSpectrumFunction::CONCENTRATION) == Approx(2.5).epsilon(1e-4));
+    }
+}
+
+TEST_CASE("DoasModelFunction - Fused values, errors and derivatives are the same as the separate calls", "[DoasModelFunction]")
+{
+    for (bool compiledModel : { false, true })
+    {
+        // Arrange
+        DoasModelSetup setup(compiledModel);
+        setup.SetParameters();
+        const int length = setup.fitRange.GetSize();
+        const int nonlinearCount = setup.model.GetNonlinearParameter().GetSize();
+
+        CVector separateValues(length), fusedValues(length);
+        CVector separateErrors(length), fusedErrors(length);
+        CMatrix separateDyDa(nonlinearCount, length), fusedDyDa(nonlinearCount, length);
+
+        setup.difference->GetValues(setup.fitRange, separateValues);
+        setup.difference->GetFunctionErrors(setup.fitRange, separateErrors);
+        setup.difference->GetNonlinearDyDa(setup.fitRange, separateDyDa);
+
+        // Act
+        setup.difference->GetValuesErrorsAndDyDa(setup.fitRange, fusedValues, fusedErrors, fusedDyDa);
+
+        // Assert
+        for (int i = 0; i < length; ++i)
+        {
+            REQUIRE(fusedValues.GetAt(i) == Approx(separateValues.GetAt(i)).margin(1e-12));
+            REQUIRE(fusedErrors.GetAt(i) == separateErrors.GetAt(i));
+            for (int k = 0; k < nonlinearCount; ++k)
+            {
+                REQUIRE(fusedDyDa.GetAt(i, k) == Approx(separateDyDa.GetAt(i, k)).margin(1e-12));
+            }
+        }
+    }
+}
+
+TEST_CASE("DoasModelFunction - Fitting the next spectrum with the same fit objects does not allocate memory", "[DoasModelFunction]")
+{
+    const CStandardFit::ENonlinearMinimizer minimizers[] = { CStandardFit::LEVENBERGMARQUARDT, CStandardFit::VARIABLEPROJECTION };
+
+    for (const CStandardFit::ENonlinearMinimizer minimizer : minimizers)
+    {
+        for (bool compiledModel : { false, true })
+        {
+            // Arrange. The fit objects and the equation solver are the ones of the fit workspace of CEvaluation
+            DoasModelSetup setup(compiledModel);
+            CStandardFit fit(*setup.difference, minimizer);
+            fit.SetFitRange(setup.fitRange);
+            fit.SetEquationSolver(IMinimizer::CHOLESKY);
+
+            SpectrumParameters spectrum;
+            long allocations[2];
+
+            // Act. The first fit brings the buffers of the fit objects to their size.
+            for (int run = 0; run < 2; ++run)
+            {
+                spectrum.column = 2.5 - 0.4 * run;
+                spectrum.shift = -0.3 + 0.1 * run;
+                setup.SetSpectrum(spectrum);
+
+                const long allocationsBefore = CAllocationCounter::GetCount();
+                setup.difference->SetData(setup.xData, setup.measured, setup.error);
+                setup.model.ResetLinearParameter();
+                setup.model.ResetNonlinearParameter();
+                fit.PrepareMinimize();
+                fit.Minimize();
+                fit.FinishMinimize();
+                fit.GetResiduum();
+                allocations[run] = CAllocationCounter::GetCount() - allocationsBefore;
+            }
+
+            // Assert
+            REQUIRE(allocations[0] > 0);
+            REQUIRE(allocations[1] == 0);
+            REQUIRE(setup.references[0].GetModelParameter(CReferenceSpectrumFunction::CONCENTRATION) == Approx(2.1).epsilon(1e-4));
+        }
+    }
+}
@@ -0,0 +1,112 @@
+#include "catch.hpp"
+#include <Fit/FourierTransform.h>
+#include <cmath>
+#include <vector>
+
+using namespace MathFit;
+
+namespace
+{
+    const double twoPi = 6.283185307179586476925;
+
+    std::vector<double> RealData(int length)
+    {
+        std::vector<double> data(length);
+        for (int i = 0; i < length; ++i)
+        {
+            data[i] = 1000.0 + 300.0 * sin(i * 0.021) + 20.0 * cos(i * 0.73) + (i % 7);
+        }
+        return data;
+    }
+
+    // The spectrum calculated directly from the definition, as interleaved complex values.
+    std::vector<double> DirectTransform(const std::vector<double>& complexData)
+    {
+        const int length = (int)complexData.size() / 2;
+        std::vector<double> spectrum(2 * length);
+        for (int k = 0; k < length; ++k)
+        {
+            double sumRe = 0.0;
+            double sumIm = 0.0;
+            for (int j = 0; j < length; ++j)
+            {
+                const double angle = -twoPi * (double)(((long long)j * k) % length) / length;
+                sumRe += complexData[2 * j] * cos(angle) - complexData[2 * j + 1] * sin(angle);
+                sumIm += complexData[2 * j] * sin(angle) + complexData[2 * j + 1] * cos(angle);
+            }
+            spectrum[2 * k] = sumRe;
+            spectrum[2 * k + 1] = sumIm;
+        }
+        return spectrum;
+    }
+}
+
+TEST_CASE("FourierTransform - Complex transform gives the direct sums", "[FourierTransform]")
+{
+    for (int length : { 1, 2, 3, 12, 19, 45, 49, 1024, 3648 })
+    {
+        // Arrange
+        std::vector<double> data(2 * length);
+        for (int i = 0; i < length; ++i)
+        {
+            data[2 * i] = sin(i * 0.37) + (i % 5);
+            data[2 * i + 1] = cos(i * 1.3);
+        }
+        const std::vector<double> expected = DirectTransform(data);
+        CFourierTransform transform(length);
+
+        // Act
+        std::vector<double> spectrum = data;
+        transform.Forward(spectrum.data());
+        std::vector<double> inverse = spectrum;
+        transform.Inverse(inverse.data());
+
+        // Assert
+        for (int i = 0; i < 2 * length; ++i)
+        {
+            REQUIRE(spectrum[i] == Approx(expected[i]).margin(1e-10 * length));
+            REQUIRE(inverse[i] / length == Approx(data[i]).margin(1e-12));
+        }
+    }
+}
+
+TEST_CASE("FourierTransform - Real transform gives the lower half of the complex transform", "[FourierTransform]")
+{
+    for (int length : { 1, 2, 7, 38, 1024, 2048, 3648 })
+    {
+        // Arrange
+        const std::vector<double> data = RealData(length);
+        std::vector<double> complexData(2 * length);
+        for (int i = 0; i < length; ++i)
+        {
+            complexData[2 * i] = data[i];
+        }
+        CFourierTransform::GetPlan(length)->Forward(complexData.data());
+        std::shared_ptr<const CRealFourierTransform> transform = CRealFourierTransform::GetPlan(length);
+
+        // Act
+        std::vector<double> spectrum(2 * transform->GetSpectrumSize());
+        transform->Forward(data.data(), spectrum.data());
+        std::vector<double> inverse(length);
+        transform->Inverse(spectrum.data(), inverse.data());
+
+        // Assert
+        REQUIRE(transform->GetSpectrumSize() == length / 2 + 1);
+        for (int i = 0; i < 2 * transform->GetSpectrumSize(); ++i)
+        {
+            REQUIRE(spectrum[i] == Approx(complexData[i]).margin(1e-8 * length));
+        }
+        for (int i = 0; i < length; ++i)
+        {
+            REQUIRE(inverse[i] / length == Approx(data[i]).epsilon(1e-12));
+        }
+    }
+}
+
+TEST_CASE("FourierTransform - Fast sizes contain only the factors 2, 3 and 5", "[FourierTransform]")
+{
+    REQUIRE(CFourierTransform::GetFastSize(0) == 1);
+    REQUIRE(CFourierTransform::GetFastSize(7) == 8);
+    REQUIRE(CFourierTransform::GetFastSize(1000) == 1000);
+    REQUIRE(CFourierTransform::GetFastSize(3649) == 3750);
+}
@@ -1,5 +1,6 @@
 #include "catch.hpp"
 #include <MobileDoasLib/Measurement/MeasuredSpectrum.h>
+#include <cstdint>
 #include <numeric>
 
 using namespace mobiledoas;
@@ -34,11 +35,11 @@ TEST_CASE("MeasuredSpectrum - Resize changes both channel size and spectrum leng
     sut.Resize(7, 1796);
 
     // Assert
-    REQUIRE(7 == sut.data.size());
-    REQUIRE(1796 == sut.data[0].size());
-    REQUIRE(1796 == sut.data[1].size());
-    REQUIRE(1796 == sut.data[2].size());
-    REQUIRE(1796 == sut.data[6].size());
+    REQUIRE(7 == sut.NumberOfChannels());
+    REQUIRE(1796 == sut[0].size());
+    REQUIRE(1796 == sut[1].size());
+    REQUIRE(1796 == sut[2].size());
+    REQUIRE(1796 == sut[6].size());
     REQUIRE(sut.NumberOfChannels() == 7);
     REQUIRE(sut.SpectrumLength() == 1796);
 }
@@ -85,9 +86,9 @@ TEST_CASE("MeasuredSpectrum - CopyTo resizes destination to this and copies data
     source.CopyTo(destination);
 
     // Assert
-    REQUIRE(2 == destination.data.size());
-    REQUIRE(67 == destination.data[0].size());
-    REQUIRE(67 == destination.data[1].size());
+    REQUIRE(2 == destination.NumberOfChannels());
+    REQUIRE(67 == destination[0].size());
+    REQUIRE(67 == destination[1].size());
 
     REQUIRE(Approx(2) == destination[0][0]);
     REQUIRE(Approx(2 + 66) == destination[0][66]);
@@ -108,12 +109,12 @@ TEST_CASE("MeasuredSpectrum - CopyFrom copies all data from source", "[MeasuredS
         destination.CopyFrom(0, sourceData, 10);
 
         // Assert, the destination was resized and all values copied over
-        REQUIRE(2 == destination.data.size());
-        REQUIRE(10 == destination.data[0].size());
-        REQUIRE(10 == destination.data[1].size());
+        REQUIRE(2 == destination.NumberOfChannels());
+        REQUIRE(10 == destination[0].size());
+        REQUIRE(10 == destination[1].size());
 
-        REQUIRE(Approx(11) == destination.data[0][0]);
-        REQUIRE(Approx(101) == destination.data[0][9]);
+        REQUIRE(Approx(11) == destination[0][0]);
+        REQUIRE(Approx(101) == destination[0][9]);
     }
 
     SECTION("destination longer than source")
@@ -124,11 +125,81 @@ TEST_CASE("MeasuredSpectrum - CopyFrom copies all data from source", "[MeasuredS
         destination.CopyFrom(0, sourceData, 10);
 
         // Assert, the destination was resized and all values copied over
-        REQUIRE(2 == destination.data.size());
-        REQUIRE(10 == destination.data[0].size());
-        REQUIRE(10 == destination.data[1].size());
+        REQUIRE(2 == destination.NumberOfChannels());
+        REQUIRE(10 == destination[0].size());
+        REQUIRE(10 == destination[1].size());
 
-        REQUIRE(Approx(11) == destination.data[0][0]);
-        REQUIRE(Approx(101) == destination.data[0][9]);
+        REQUIRE(Approx(11) == destination[0][0]);
+        REQUIRE(Approx(101) == destination[0][9]);
     }
-}
\ No newline at end of file
+}
+TEST_CASE("MeasuredSpectrum - Resize keeps the values of the remaining pixels", "[MeasuredSpectrum]")
+{
+    // Arrange
+    MeasuredSpectrum sut(2, 5);
+    std::iota(begin(sut[0]), end(sut[0]), 1);
+    std::iota(begin(sut[1]), end(sut[1]), 11);
+
+    SECTION("longer spectrum and more channels")
+    {
+        // Act
+        sut.Resize(3, 7);
+
+        // Assert, the old values are kept and the new values are zero
+        REQUIRE(sut[0].ToVector() == std::vector<double>{ 1, 2, 3, 4, 5, 0, 0 });
+        REQUIRE(sut[1].ToVector() == std::vector<double>{ 11, 12, 13, 14, 15, 0, 0 });
+        REQUIRE(sut[2].ToVector() == std::vector<double>{ 0, 0, 0, 0, 0, 0, 0 });
+    }
+
+    SECTION("shorter spectrum")
+    {
+        // Act
+        sut.Resize(2, 3);
+
+        // Assert
+        REQUIRE(sut[0].ToVector() == std::vector<double>{ 1, 2, 3 });
+        REQUIRE(sut[1].ToVector() == std::vector<double>{ 11, 12, 13 });
+    }
+
+    SECTION("fewer channels")
+    {
+        // Act
+        sut.Resize(1, 5);
+
+        // Assert
+        REQUIRE(sut.NumberOfChannels() == 1);
+        REQUIRE(sut[0].ToVector() == std::vector<double>{ 1, 2, 3, 4, 5 });
+    }
+}
+
+TEST_CASE("MeasuredSpectrum - Channels are stored aligned one after the other", "[MeasuredSpectrum]")
+{
+    // Arrange
+    MeasuredSpectrum sut(3, 1468);
+
+    // Act
+    const Span<double> allChannels = sut.AllChannels();
+
+    // Assert
+    REQUIRE(allChannels.size() == 3 * 1468);
+    REQUIRE(reinterpret_cast<uintptr_t>(allChannels.data()) % 64 == 0);
+    REQUIRE(sut[0].data() == allChannels.data());
+    REQUIRE(sut[1].data() == allChannels.data() + 1468);
+    REQUIRE(sut[2].data() == allChannels.data() + 2 * 1468);
+}
+
+TEST_CASE("MeasuredSpectrum - CopyFrom vectors resizes to the vectors and copies data", "[MeasuredSpectrum]")
+{
+    // Arrange
+    MeasuredSpectrum sut;
+    const std::vector<std::vector<double>> source = { { 1, 2, 3 }, { 4, 5, 6 } };
+
+    // Act
+    sut.CopyFrom(source);
+
+    // Assert
+    REQUIRE(sut.NumberOfChannels() == 2);
+    REQUIRE(sut.SpectrumLength() == 3);
+    REQUIRE(sut[0].ToVector() == source[0]);
+    REQUIRE(sut[1].ToVector() == source[1]);
+}
@@ -0,0 +1,92 @@
+#include "catch.hpp"
+#include <MobileDoasLib/Measurement/SpectrometerInterface.h>
+
+using namespace mobiledoas;
+
+/** Returns the spectra given to it, as if they were read out from a spectrometer */
+class FakeSpectrometerInterface : public SpectrometerInterface
+{
+public:
+    std::vector<std::vector<double>> nextSpectrum;
+
+    virtual int GetNextSpectrum(std::vector<std::vector<double>>& data) override
+    {
+        data = nextSpectrum;
+        return nextSpectrum.empty() ? 0 : static_cast<int>(nextSpectrum[0].size());
+    }
+
+    using SpectrometerInterface::GetNextSpectrum;
+
+    virtual SpectrometerConnectionType ConnectionType() override { return SpectrometerConnectionType::USB; }
+    virtual std::vector<std::string> ScanForDevices() override { return {}; }
+    virtual std::vector<std::string> ListDevices() const override { return {}; }
+    virtual void Close() override {}
+    virtual bool Start() override { return true; }
+    virtual bool Stop() override { return true; }
+    virtual bool SetSpectrometer(int) override { return true; }
+    virtual bool SetSpectrometer(int, const std::vector<int>&) override { return true; }
+    virtual int GetReadoutDelay() override { return 0; }
+    virtual std::string GetSerial() override { return "fake"; }
+    virtual std::string GetModel() override { return "fake"; }
+    virtual int GetNumberOfChannels() override { return static_cast<int>(nextSpectrum.size()); }
+    virtual int GetWavelengths(std::vector<std::vector<double>>&) override { return 0; }
+    virtual int GetSaturationIntensity() override { return 4095; }
+    virtual void SetIntegrationTime(int) override {}
+    virtual int GetIntegrationTime() override { return 0; }
+    virtual void SetScansToAverage(int) override {}
+    virtual int GetScansToAverage() override { return 1; }
+    virtual bool SupportsDetectorTemperatureControl() override { return false; }
+    virtual bool EnableDetectorTemperatureControl(bool, double) override { return false; }
+    virtual double GetDetectorTemperature() override { return 0.0; }
+    virtual bool SupportsBoardTemperature() override { return false; }
+    virtual double GetBoardTemperature() override { return 0.0; }
+    virtual std::string GetLastError() override { return ""; }
+};
+
+TEST_CASE("SpectrometerInterface - GetNextSpectrum into MeasuredSpectrum replaces the values", "[SpectrometerInterface]")
+{
+    // Arrange
+    FakeSpectrometerInterface sut;
+    sut.nextSpectrum = { { 1.0, 2.0, 3.0 }, { 4.0, 5.0, 6.0 } };
+    MeasuredSpectrum spectrum;
+    spectrum.CopyFrom({ { 10.0, 10.0, 10.0 }, { 10.0, 10.0, 10.0 } });
+
+    // Act
+    const int spectrumLength = sut.GetNextSpectrum(spectrum);
+
+    // Assert
+    REQUIRE(spectrumLength == 3);
+    REQUIRE(spectrum[0].ToVector() == std::vector<double>{ 1.0, 2.0, 3.0 });
+    REQUIRE(spectrum[1].ToVector() == std::vector<double>{ 4.0, 5.0, 6.0 });
+}
+
+TEST_CASE("SpectrometerInterface - GetNextSpectrum into MeasuredSpectrum resizes the spectrum to the readout", "[SpectrometerInterface]")
+{
+    // Arrange
+    FakeSpectrometerInterface sut;
+    sut.nextSpectrum = { { 1.0, 2.0, 3.0, 4.0 } };
+    MeasuredSpectrum spectrum;
+
+    // Act
+    sut.GetNextSpectrum(spectrum);
+
+    // Assert
+    REQUIRE(spectrum.NumberOfChannels() == 1);
+    REQUIRE(spectrum.SpectrumLength() == 4);
+    REQUIRE(spectrum[0].ToVector() == std::vector<double>{ 1.0, 2.0, 3.0, 4.0 });
+}
+
+TEST_CASE("SpectrometerInterface - GetNextSpectrum into MeasuredSpectrum leaves the spectrum unchanged if the readout fails", "[SpectrometerInterface]")
+{
+    // Arrange
+    FakeSpectrometerInterface sut;
+    MeasuredSpectrum spectrum;
+    spectrum.CopyFrom({ { 7.0, 8.0 } });
+
+    // Act
+    const int spectrumLength = sut.GetNextSpectrum(spectrum);
+
+    // Assert
+    REQUIRE(spectrumLength == 0);
+    REQUIRE(spectrum[0].ToVector() == std::vector<double>{ 7.0, 8.0 });
+}
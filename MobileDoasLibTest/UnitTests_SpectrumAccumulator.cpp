@@ -0,0 +1,80 @@
+#include "catch.hpp"
+#include <MobileDoasLib/Measurement/SpectrumAccumulator.h>
+#include <MobileDoasLib/Measurement/SpectrumUtils.h>
+
+using namespace mobiledoas;
+
+static MeasuredSpectrum CreateReadout(double firstValue, double step)
+{
+    MeasuredSpectrum readout(2, 100);
+    for (int chn = 0; chn < 2; ++chn)
+    {
+        for (int pixelIdx = 0; pixelIdx < 100; ++pixelIdx)
+        {
+            readout[chn][pixelIdx] = firstValue + chn * 1000.0 + pixelIdx * step;
+        }
+    }
+    return readout;
+}
+
+TEST_CASE("SpectrumAccumulator - GetAverage returns the average of the readouts", "[SpectrumAccumulator]")
+{
+    // Arrange
+    SpectrumAccumulator sut;
+    sut.Start(50, 10);
+
+    // Act
+    sut.Add(CreateReadout(100.0, 1.0));
+    sut.Add(CreateReadout(200.0, 2.0));
+    sut.Add(CreateReadout(300.0, 3.0));
+    MeasuredSpectrum average;
+    sut.GetAverage(average);
+
+    // Assert
+    REQUIRE(sut.NumberOfReadouts() == 3);
+    REQUIRE(average.NumberOfChannels() == 2);
+    REQUIRE(average.SpectrumLength() == 100);
+    REQUIRE(average[0][0] == Approx(200.0));
+    REQUIRE(average[0][99] == Approx(200.0 + 99 * 2.0));
+    REQUIRE(average[1][0] == Approx(1200.0));
+    REQUIRE(average[1][99] == Approx(1200.0 + 99 * 2.0));
+}
+
+TEST_CASE("SpectrumAccumulator - Start discards the previous readouts", "[SpectrumAccumulator]")
+{
+    // Arrange
+    SpectrumAccumulator sut;
+    sut.Start(50, 10);
+    sut.Add(CreateReadout(100.0, 1.0));
+    sut.Add(CreateReadout(500.0, 1.0));
+
+    // Act
+    sut.Start(50, 10);
+    sut.Add(CreateReadout(300.0, 1.0));
+    MeasuredSpectrum average;
+    sut.GetAverage(average);
+
+    // Assert
+    REQUIRE(sut.NumberOfReadouts() == 1);
+    REQUIRE(average[0][0] == Approx(300.0));
+    REQUIRE(sut.AverageIntensity(0) == Approx(AverageIntensity(average[0], 50, 10)).margin(1.0));
+}
+
+TEST_CASE("SpectrumAccumulator - AverageIntensity matches the average intensity of the average spectrum", "[SpectrumAccumulator]")
+{
+    // Arrange
+    SpectrumAccumulator sut;
+    sut.Start(50, 10);
+
+    // Act
+    sut.Add(CreateReadout(100.0, 1.0));
+    sut.Add(CreateReadout(200.0, 3.0));
+    MeasuredSpectrum average;
+    sut.GetAverage(average);
+
+    // Assert
+    for (int chn = 0; chn < 2; ++chn)
+    {
+        REQUIRE(sut.AverageIntensity(chn) == Approx(AverageIntensity(average[chn], 50, 10)).margin(1.0));
+    }
+}
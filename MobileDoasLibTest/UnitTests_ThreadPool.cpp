@@ -0,0 +1,72 @@
+#include "catch.hpp"
+#include <MobileDoasLib/ThreadPool.h>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace mobiledoas;
+
+TEST_CASE("ThreadPool - Every task is run exactly once", "[ThreadPool]")
+{
+    for (int numberOfThreads : { 0, 1, 3 })
+    {
+        // Arrange
+        ThreadPool sut(numberOfThreads);
+        std::vector<std::atomic<int>> runs(17);
+        for (auto& run : runs)
+        {
+            run = 0;
+        }
+
+        // Act
+        sut.ParallelFor(static_cast<int>(runs.size()), [&](int taskIdx) { ++runs[taskIdx]; });
+
+        // Assert
+        REQUIRE(sut.NumberOfThreads() == numberOfThreads);
+        for (auto& run : runs)
+        {
+            REQUIRE(run == 1);
+        }
+    }
+}
+
+TEST_CASE("ThreadPool - The threads are reused for many calls", "[ThreadPool]")
+{
+    // Arrange
+    ThreadPool sut(2);
+    std::vector<double> results(3);
+
+    // Act & Assert
+    for (int call = 0; call < 10000; ++call)
+    {
+        sut.ParallelFor(3, [&](int taskIdx) { results[taskIdx] = call * 10.0 + taskIdx; });
+
+        REQUIRE(results[0] == call * 10.0);
+        REQUIRE(results[1] == call * 10.0 + 1);
+        REQUIRE(results[2] == call * 10.0 + 2);
+    }
+}
+
+TEST_CASE("ThreadPool - The exception of the first failing task is rethrown after all tasks are done", "[ThreadPool]")
+{
+    // Arrange
+    ThreadPool sut(2);
+    std::atomic<int> tasksRun(0);
+
+    // Act & Assert
+    REQUIRE_THROWS_WITH(
+        sut.ParallelFor(8, [&](int taskIdx)
+            {
+                ++tasksRun;
+                if (taskIdx == 3 || taskIdx == 6)
+                {
+                    throw std::runtime_error(taskIdx == 3 ? "three" : "six");
+                }
+            }),
+        "three");
+    REQUIRE(tasksRun == 8);
+
+    // the pool is still usable
+    sut.ParallelFor(4, [&](int) { ++tasksRun; });
+    REQUIRE(tasksRun == 12);
+}
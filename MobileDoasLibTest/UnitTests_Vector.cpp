@@ -0,0 +1,285 @@
+#include "catch.hpp"
+#include <Fit/Vector.h>
+#include <Fit/Matrix.h>
+#include <Fit/DOASVector.h>
+#include <Fit/VectorView.h>
+#include <cmath>
+#include <string>
+#include <utility>
+
+using namespace MathFit;
+
+TEST_CASE("Vector - Append grows the capacity geometrically", "[Vector]")
+{
+    // Arrange
+    const int valueCount = 10000;
+    CVector vector;
+    int reallocationCount = 0;
+
+    // Act
+    for (int i = 0; i < valueCount; ++i)
+    {
+        const int capacityBefore = vector.GetCapacity();
+        vector.Append((TFitData)i);
+        if (vector.GetCapacity() != capacityBefore)
+        {
+            ++reallocationCount;
+        }
+    }
+
+    // Assert
+    REQUIRE(vector.GetSize() == valueCount);
+    REQUIRE(vector.GetCapacity() >= valueCount);
+    REQUIRE(reallocationCount < 20);
+    for (int i = 0; i < valueCount; ++i)
+    {
+        REQUIRE(vector.GetAt(i) == (TFitData)i);
+    }
+}
+
+TEST_CASE("Vector - Reserve and Resize keep the content", "[Vector]")
+{
+    CVector vector(4);
+    vector.Wedge(1, 1);
+
+    SECTION("Reserve does not change the size")
+    {
+        vector.Reserve(100);
+
+        REQUIRE(vector.GetSize() == 4);
+        REQUIRE(vector.GetCapacity() == 100);
+        REQUIRE(vector.GetAt(3) == 4);
+    }
+
+    SECTION("Resize within the capacity zeroes the new elements")
+    {
+        vector.Reserve(100);
+        vector.Resize(2);
+
+        vector.Resize(6);
+
+        REQUIRE(vector.GetCapacity() == 100);
+        REQUIRE(vector.GetAt(1) == 2);
+        REQUIRE(vector.GetAt(2) == 0);
+        REQUIRE(vector.GetAt(5) == 0);
+    }
+
+    SECTION("Resize of an attached vector copies the content")
+    {
+        TFitData data[] = { 1, 2, 3 };
+        CVector attached(data, 3, 1, false);
+
+        attached.Resize(5);
+        attached.SetAt(0, 7);
+
+        REQUIRE(attached.GetAt(2) == 3);
+        REQUIRE(attached.GetAt(4) == 0);
+        REQUIRE(data[0] == 1);
+    }
+}
+
+TEST_CASE("Vector - Move takes over the content", "[Vector]")
+{
+    // Arrange
+    CVector original(5);
+    original.Wedge(1, 1);
+    const TFitData* data = original.GetSafePtr();
+
+    // Act
+    CVector moved(std::move(original));
+    CVector assigned;
+    assigned = std::move(moved);
+
+    // Assert
+    REQUIRE(original.GetSize() == 0);
+    REQUIRE(moved.GetSize() == 0);
+    REQUIRE(assigned.GetSize() == 5);
+    REQUIRE(assigned.GetSafePtr() == data);
+    REQUIRE(assigned.GetAt(4) == 5);
+}
+
+namespace
+{
+    // Fills the vector with a spectrum-like curve, which is positive and has some structure.
+    void FillSpectrum(CVector& vector, int length, double phase)
+    {
+        vector.SetSize(length);
+        for (int i = 0; i < length; ++i)
+        {
+            vector.SetAt(i, (TFitData)(1000.0 + 800.0 * sin(i * 0.013 + phase) + 50.0 * cos(i * 0.41)));
+        }
+    }
+
+    // Restores the automatic selection of the vector instructions when it goes out of scope.
+    struct VectorizationScope
+    {
+        ~VectorizationScope()
+        {
+            CVectorKernels::SetVectorized(true);
+        }
+    };
+}
+
+TEST_CASE("Vector - Vectorized operations are the same as the scalar ones", "[Vector]")
+{
+    VectorizationScope scope;
+
+    for (int length : { 1, 7, 2048, 3648, 3651 })
+    {
+        // Arrange
+        CVector first, second;
+        FillSpectrum(first, length, 0.0);
+        FillSpectrum(second, length, 1.0);
+        CVector results[2][7];
+
+        // Act
+        for (int vectorized = 0; vectorized < 2; ++vectorized)
+        {
+            CVectorKernels::SetVectorized(vectorized != 0);
+            CVector* result = results[vectorized];
+            result[0].Copy(first).Add(second);
+            result[1].Copy(first).Sub(second);
+            result[2].Copy(first).MulSimple(second);
+            result[3].Copy(first).Add(second, (TFitData)0.3);
+            result[4].Copy(first).Sub(second, (TFitData)0.3);
+            result[5].Copy(first).Sub((TFitData)17.5).Mul((TFitData)1.7).Div((TFitData)3.1);
+            result[6].Copy(first);
+            result[6].Normalize();
+        }
+
+        // Assert
+        for (int k = 0; k < 7; ++k)
+        {
+            for (int i = 0; i < length; ++i)
+            {
+                REQUIRE(results[1][k].GetAt(i) == results[0][k].GetAt(i));
+            }
+        }
+
+        CDOASVector spectrum;
+        spectrum.Copy(second);
+        CVectorKernels::SetVectorized(false);
+        const TFitData scalarDelta = spectrum.Delta();
+        const TFitData scalarSum = spectrum.Sum();
+        const TFitData scalarMin = spectrum.Min(length / 3, length - length / 3);
+        const TFitData scalarMax = spectrum.Max(length / 3, length - length / 3);
+        CVectorKernels::SetVectorized(true);
+        REQUIRE(spectrum.Delta() == scalarDelta);
+        REQUIRE(spectrum.Min(length / 3, length - length / 3) == scalarMin);
+        REQUIRE(spectrum.Max(length / 3, length - length / 3) == scalarMax);
+        REQUIRE(spectrum.Sum() == Approx(scalarSum).epsilon(1e-6));
+    }
+}
+
+TEST_CASE("Vector - Buffers are aligned", "[Vector]")
+{
+    CVector vector(3648);
+    CMatrix matrix(7, 2048);
+
+    REQUIRE(reinterpret_cast<size_t>(vector.GetSafePtr()) % CVectorKernels::ALIGNMENT == 0);
+    REQUIRE(reinterpret_cast<size_t>(matrix.GetSafePtr()) % CVectorKernels::ALIGNMENT == 0);
+}
+
+TEST_CASE("VectorView - Refers to the elements of the viewed vector", "[Vector]")
+{
+    // Arrange
+    CVector vector(10);
+    vector.Wedge(1, 1);
+
+    // Act
+    {
+        CVectorView view(vector, 2, 5);
+        view.Mul((TFitData)2);
+
+        REQUIRE(view.GetSize() == 5);
+        REQUIRE(view.GetCapacity() == 0);
+        REQUIRE(view.GetSafePtr() == vector.GetSafePtr() + 2);
+    }
+
+    // Assert
+    REQUIRE(vector.GetSize() == 10);
+    REQUIRE(vector.GetAt(1) == 2);
+    REQUIRE(vector.GetAt(2) == 6);
+    REQUIRE(vector.GetAt(6) == 14);
+    REQUIRE(vector.GetAt(7) == 8);
+}
+
+TEST_CASE("ScratchVector - Memory is reused in stack order", "[Vector]")
+{
+    CScratchArena arena;
+
+    SECTION("Released memory is handed out again")
+    {
+        const TFitData* first;
+        {
+            CScratchVector vector(3648, arena);
+            first = vector.GetSafePtr();
+        }
+
+        CScratchVector vector(2048, arena);
+
+        REQUIRE(vector.GetSafePtr() == first);
+        REQUIRE(vector.GetSize() == 2048);
+    }
+
+    SECTION("Nested vectors do not overlap and are aligned")
+    {
+        CScratchVector outer(7, arena);
+        outer.Wedge(1, 1);
+        {
+            CScratchVector inner(100000, arena);
+            CScratchVector last(3, arena);
+            inner.Zero();
+            last.Zero();
+
+            REQUIRE(reinterpret_cast<size_t>(inner.GetSafePtr()) % CVectorKernels::ALIGNMENT == 0);
+            REQUIRE(reinterpret_cast<size_t>(last.GetSafePtr()) % CVectorKernels::ALIGNMENT == 0);
+        }
+        CScratchVector next(5, arena);
+        next.Zero();
+
+        REQUIRE(outer.GetAt(6) == 7);
+        REQUIRE(next.GetSafePtr() == outer.GetSafePtr() + CVectorKernels::ALIGNMENT / sizeof(TFitData));
+    }
+}
+
+TEST_CASE("Vector - Benchmark of the element-wise operations", "[.][benchmark]")
+{
+    VectorizationScope scope;
+
+    for (int length : { 2048, 3648 })
+    {
+        CVector first, second;
+        FillSpectrum(first, length, 0.0);
+        FillSpectrum(second, length, 1.0);
+        CDOASVector spectrum;
+        spectrum.Copy(first);
+
+        for (int vectorized = 0; vectorized < 2; ++vectorized)
+        {
+            CVectorKernels::SetVectorized(vectorized != 0);
+            const std::string name = std::to_string(length) + (vectorized ? " vectorized" : " scalar");
+
+            BENCHMARK("Add " + name)
+            {
+                first.Add(second);
+            }
+            BENCHMARK("MulSimple " + name)
+            {
+                first.MulSimple(second);
+            }
+            BENCHMARK("Sum " + name)
+            {
+                first.SetAt(0, spectrum.Sum());
+            }
+            BENCHMARK("Delta " + name)
+            {
+                first.SetAt(0, spectrum.Delta());
+            }
+            BENCHMARK("Normalize " + name)
+            {
+                spectrum.Normalize();
+            }
+        }
+    }
+}
@@ -0,0 +1,272 @@
+#include "catch.hpp"
+#include <Fit/VectorKernels.h>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace MathFit;
+
+namespace
+{
+    // A spectrum-like curve with some zero, negative and special values at the given positions.
+    std::vector<double> Spectrum(int length, double phase)
+    {
+        std::vector<double> spectrum(length);
+        for (int i = 0; i < length; ++i)
+        {
+            spectrum[i] = 1000.0 + 800.0 * sin(i * 0.013 + phase) + 50.0 * cos(i * 0.41);
+        }
+        return spectrum;
+    }
+
+    std::vector<double> SpecialValues()
+    {
+        const double infinity = std::numeric_limits<double>::infinity();
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        return { 0.0, -0.0, -3.0, 1.0, DBL_MIN, DBL_MIN / 16, DBL_MAX, infinity, -infinity, nan, 1e-300, 1e300, 2.5, 0.5, -1e-10, 700.0 };
+    }
+
+    // Restores the automatic selection of the vector instructions when it goes out of scope.
+    struct VectorizationScope
+    {
+        ~VectorizationScope()
+        {
+            CVectorKernels::SetVectorized(true);
+        }
+    };
+
+    // True if both are NaN or the same value.
+    bool IsSame(double first, double second)
+    {
+        return (first != first && second != second) || first == second;
+    }
+
+    // True if both are NaN, the same value or differ by at most one unit in the last place.
+    bool IsWithinOneUlp(double first, double second)
+    {
+        return IsSame(first, second) || nextafter(first, second) == second;
+    }
+}
+
+TEST_CASE("VectorKernels - Division, reciprocal and maximum are the same as the scalar ones", "[VectorKernels]")
+{
+    VectorizationScope scope;
+
+    for (int length : { 1, 7, 16, 3648, 3651 })
+    {
+        // Arrange
+        const std::vector<double> first = Spectrum(length, 0.0);
+        std::vector<double> second = Spectrum(length, 1.0);
+        const std::vector<double> special = SpecialValues();
+        for (int i = 0; i < length; i += 5)
+        {
+            second[i] = special[(i / 5) % special.size()];
+        }
+        std::vector<double> results[2][5];
+        double maximum[2];
+
+        // Act
+        for (int vectorized = 0; vectorized < 2; ++vectorized)
+        {
+            CVectorKernels::SetVectorized(vectorized != 0);
+            std::vector<double>* result = results[vectorized];
+            for (int k = 0; k < 5; ++k)
+            {
+                result[k].resize(length);
+            }
+            CVectorKernels::Div(first.data(), second.data(), result[0].data(), length);
+            CVectorKernels::DivScaled(first.data(), second.data(), 0.3, result[1].data(), length);
+            CVectorKernels::MulScaled(first.data(), second.data(), 0.3, result[2].data(), length);
+            CVectorKernels::Reciprocal(second.data(), result[3].data(), length);
+            CVectorKernels::MulScalar(second.data(), -1.0, result[4].data(), length);
+            maximum[vectorized] = CVectorKernels::MaxAbs(second.data(), length);
+        }
+
+        // Assert
+        for (int k = 0; k < 5; ++k)
+        {
+            for (int i = 0; i < length; ++i)
+            {
+                REQUIRE(IsSame(results[1][k][i], results[0][k][i]));
+            }
+        }
+        for (int i = 0; i < length; ++i)
+        {
+            if (second[i] == 0.0)
+            {
+                REQUIRE(results[1][0][i] == 0.0);
+                REQUIRE(results[1][1][i] == 0.0);
+            }
+        }
+        REQUIRE(maximum[1] == maximum[0]);
+    }
+}
+
+TEST_CASE("VectorKernels - Dot product agrees with the scalar one", "[VectorKernels]")
+{
+    VectorizationScope scope;
+
+    for (int length : { 1, 7, 16, 3648, 3651 })
+    {
+        // Arrange
+        const std::vector<double> first = Spectrum(length, 0.0);
+        const std::vector<double> second = Spectrum(length, 1.0);
+        const std::vector<float> firstFloat(first.begin(), first.end());
+        const std::vector<float> secondFloat(second.begin(), second.end());
+        double product[2];
+        double productFloat[2];
+
+        // Act
+        for (int vectorized = 0; vectorized < 2; ++vectorized)
+        {
+            CVectorKernels::SetVectorized(vectorized != 0);
+            product[vectorized] = CVectorKernels::Dot(first.data(), second.data(), length);
+            productFloat[vectorized] = CVectorKernels::Dot(firstFloat.data(), secondFloat.data(), length);
+        }
+
+        // Assert, the sums are only built in a different order. The single precision values are summed up in double precision.
+        REQUIRE(product[1] == Approx(product[0]).epsilon(1e-13));
+        REQUIRE(productFloat[1] == Approx(productFloat[0]).epsilon(1e-13));
+    }
+}
+
+TEST_CASE("VectorKernels - Logarithm and exponential function are within one unit in the last place", "[VectorKernels]")
+{
+    VectorizationScope scope;
+
+    for (int length : { 1, 7, 16, 3648, 3651 })
+    {
+        // Arrange
+        std::vector<double> data = Spectrum(length, 0.0);
+        for (int i = 0; i < length; ++i)
+        {
+            data[i] = (data[i] - 1000.0) / 10.0;
+        }
+        const std::vector<double> special = SpecialValues();
+        for (int i = 0; i < length; i += 7)
+        {
+            data[i] = special[(i / 7) % special.size()];
+        }
+        std::vector<double> logarithm(length);
+        std::vector<double> exponential(length);
+
+        // Act
+        CVectorKernels::Log(data.data(), logarithm.data(), length);
+        CVectorKernels::Exp(data.data(), exponential.data(), length);
+
+        // Assert
+        for (int i = 0; i < length; ++i)
+        {
+            REQUIRE(IsWithinOneUlp(logarithm[i], data[i] <= 0 ? 0.0 : log(data[i])));
+            REQUIRE(IsWithinOneUlp(exponential[i], exp(data[i])));
+        }
+    }
+}
+
+TEST_CASE("VectorKernels - Logarithm and exponential function of spectra are within one unit in the last place of the scalar ones", "[VectorKernels]")
+{
+    VectorizationScope scope;
+    const int length = 100000;
+
+    // Arrange. The logarithm is taken of intensities between 1 and 1e7 counts and of
+    //  spectra divided by their low pass filtered spectrum, the exponential function of optical densities.
+    std::vector<double> intensities(length);
+    std::vector<double> ratios(length);
+    std::vector<double> opticalDensities(length);
+    for (int i = 0; i < length; ++i)
+    {
+        intensities[i] = pow(10.0, 7.0 * i / (length - 1));
+        ratios[i] = 0.5 + 1.5 * i / (length - 1);
+        opticalDensities[i] = -5.0 + 10.0 * i / (length - 1);
+    }
+    const std::vector<double>* logarithmData[] = { &intensities, &ratios };
+    std::vector<double> results[2][3];
+
+    // Act
+    for (int vectorized = 0; vectorized < 2; ++vectorized)
+    {
+        CVectorKernels::SetVectorized(vectorized != 0);
+        std::vector<double>* result = results[vectorized];
+        for (int k = 0; k < 3; ++k)
+        {
+            result[k].resize(length);
+        }
+        CVectorKernels::Log(intensities.data(), result[0].data(), length);
+        CVectorKernels::Log(ratios.data(), result[1].data(), length);
+        CVectorKernels::Exp(opticalDensities.data(), result[2].data(), length);
+    }
+
+    // Assert, the scalar results are the ones of the C library
+    for (int i = 0; i < length; ++i)
+    {
+        for (int k = 0; k < 2; ++k)
+        {
+            REQUIRE(results[0][k][i] == log((*logarithmData[k])[i]));
+            REQUIRE(IsWithinOneUlp(results[1][k][i], results[0][k][i]));
+        }
+        REQUIRE(results[0][2][i] == exp(opticalDensities[i]));
+        REQUIRE(IsWithinOneUlp(results[1][2][i], results[0][2][i]));
+    }
+}
+
+TEST_CASE("VectorKernels - Non-positive values have a logarithm of zero", "[VectorKernels]")
+{
+    // Arrange
+    const double data[] = { 0.0, -0.0, -1.0, -std::numeric_limits<double>::infinity(), 1.0, -2.0, 0.0, -1e-300 };
+    double result[8];
+
+    // Act
+    CVectorKernels::Log(data, result, 8);
+
+    // Assert
+    for (int i = 0; i < 8; ++i)
+    {
+        REQUIRE(result[i] == 0.0);
+    }
+}
+
+TEST_CASE("VectorKernels - Benchmark of the spectrum operations", "[.][benchmark]")
+{
+    VectorizationScope scope;
+
+    for (int length : { 2048, 3648 })
+    {
+        const std::vector<double> first = Spectrum(length, 0.0);
+        const std::vector<double> second = Spectrum(length, 1.0);
+        std::vector<double> opticalDepth(length);
+        for (int i = 0; i < length; ++i)
+        {
+            opticalDepth[i] = (second[i] - 1000.0) / 1000.0;
+        }
+        std::vector<double> result(length);
+
+        for (int vectorized = 0; vectorized < 2; ++vectorized)
+        {
+            CVectorKernels::SetVectorized(vectorized != 0);
+            const std::string name = std::to_string(length) + (vectorized ? " vectorized" : " scalar");
+
+            BENCHMARK("Div " + name)
+            {
+                CVectorKernels::Div(first.data(), second.data(), result.data(), length);
+            }
+            BENCHMARK("Reciprocal " + name)
+            {
+                CVectorKernels::Reciprocal(first.data(), result.data(), length);
+            }
+            BENCHMARK("MaxAbs " + name)
+            {
+                result[0] = CVectorKernels::MaxAbs(first.data(), length);
+            }
+            BENCHMARK("Log " + name)
+            {
+                CVectorKernels::Log(first.data(), result.data(), length);
+            }
+            BENCHMARK("Exp " + name)
+            {
+                CVectorKernels::Exp(opticalDepth.data(), result.data(), length);
+            }
+        }
+    }
+}
@@ -46,6 +46,7 @@ int CReEvalSettingsFileHandler::WriteFile(const ReEvaluation::CReEvaluationSetti
     fprintf(f, "<MobileDOAS_ReEvalSettings>\n");
 
     fprintf(f, "\t<Average>%ld</Average>\n", settings.m_nAverageSpectra);
+    fprintf(f, "\t<WarmStart>%d</WarmStart>\n", settings.m_warmStart);
 
     // settings for ignoring dark spectra
     fprintf(f, "\t<IgnoreDark>\n");
@@ -166,6 +167,12 @@ int CReEvalSettingsFileHandler::Parse(ReEvaluation::CReEvaluationSettings& setti
             continue;
         }
 
+        // Whether each fit should start from the result of the previous spectrum
+        if (Equals(szToken, "WarmStart")) {
+            Parse_IntItem("/WarmStart", settings.m_warmStart);
+            continue;
+        }
+
         // The settings for ignoring dark spectra
         if (Equals(szToken, "IgnoreDark")) {
             Parse_IgnoreDark(settings);
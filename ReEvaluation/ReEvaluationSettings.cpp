@@ -6,6 +6,7 @@ using namespace ReEvaluation;
 CReEvaluationSettings::CReEvaluationSettings(void)
 {
 	m_nAverageSpectra = 1;
+	m_warmStart = 0;
 	m_fInterpolateDark	= 0;
 
 	// Options for ignoring dark spectra
@@ -30,6 +30,10 @@ namespace ReEvaluation{
 		
 		/** the number of spectra to average together */
 		long    m_nAverageSpectra;
+
+		/** whether each fit should start from the shifts and squeezes
+			of the previous spectrum (1=true, 0=false) */
+		int     m_warmStart;
 		
 		/** Options for which spectra to ignore */
 		IgnoreOptions m_ignoreDark;
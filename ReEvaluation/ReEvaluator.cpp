@@ -533,6 +533,9 @@ bool CReEvaluator::DoEvaluation()
             }
             evaluator.SetFitWindow(m_settings.m_window);
 
+            // the spectra are evaluated in the order they were collected, so each fit may start from the result of the previous one
+            evaluator.SetWarmStart(m_settings.m_warmStart != 0);
+
             int fitLow = m_settings.m_window.fitLow;
             int fitHigh = m_settings.m_window.fitHigh;
 
@@ -87,8 +87,8 @@ CSpectrometer::CSpectrometer(
     m_wavelength.Resize(2, MAX_SPECTRUM_LENGTH);
     for (int k = 0; k < MAX_SPECTRUM_LENGTH; ++k)
     {
-        m_wavelength.data[0][k] = k;
-        m_wavelength.data[1][k] = k;
+        m_wavelength[0][k] = k;
+        m_wavelength[1][k] = k;
     }
 }
 
@@ -134,8 +134,6 @@ long CSpectrometer::GetTimeValue_UMT()
 
 int CSpectrometer::Scan(int sumInComputer, int sumInSpectrometer, mobiledoas::MeasuredSpectrum& result)
 {
-    result.SetToZero();
-
     // set point temperature for CCD if supported.
     if (m_spectrometer->SupportsDetectorTemperatureControl())
     {
@@ -146,6 +144,8 @@ int CSpectrometer::Scan(int sumInComputer, int sumInSpectrometer, mobiledoas::Me
     m_spectrometer->SetIntegrationTime(m_integrationTime * 1000);
     m_spectrometer->SetScansToAverage(sumInSpectrometer);
 
+    m_spectrumAccumulator.Start(m_conf->m_specCenter, m_conf->m_specCenterHalfWidth);
+
     // Get the spectrum
     for (int readoutNumber = 0; readoutNumber < sumInComputer; ++readoutNumber)
     {
@@ -154,13 +154,13 @@ int CSpectrometer::Scan(int sumInComputer, int sumInSpectrometer, mobiledoas::Me
             return 1; // abort the spectrum collection
         }
 
-        // Retreives the spectra from the spectrometer, one vector per channel.
-        std::vector<std::vector<double>> spectrumData;
-        const int spectrumLength = m_spectrometer->GetNextSpectrum(spectrumData);
+        // Retreives the spectra from the spectrometer, one channel after the other.
+        const int spectrumLength = m_spectrometer->GetNextSpectrum(m_readout);
 
         // Handle errors while reading out the spectrum
         if (spectrumLength == 0)
         {
+            m_spectrumAccumulator.GetAverage(result);
             if (IsSpectrometerDisconnected())
             {
                 ReconnectWithSpectrometer();
@@ -168,28 +168,12 @@ int CSpectrometer::Scan(int sumInComputer, int sumInSpectrometer, mobiledoas::Me
             return 0;
         }
 
-        // copies the spectrum-values to the output array
-        result.Resize((int)spectrumData.size(), (int)spectrumData[0].size());
-        for (size_t chn = 0; chn < spectrumData.size(); ++chn)
-        {
-            for (size_t pixelIdx = 0; pixelIdx < spectrumData[chn].size(); ++pixelIdx)
-            {
-                result.data[chn][pixelIdx] += spectrumData[chn][pixelIdx];
-            }
-        }
+        // adds the readout to the sum and to the intensity of the spectrum, in one pass over the readout
+        m_spectrumAccumulator.Add(m_readout);
     }
 
-    // make the spectrum an average 
-    if (sumInComputer > 0)
-    {
-        for (int chn = 0; chn < result.NumberOfChannels(); ++chn)
-        {
-            for (int pixelIdx = 0; pixelIdx < result.SpectrumLength(); ++pixelIdx)
-            {
-                result.data[chn][pixelIdx] /= sumInComputer;
-            }
-        }
-    }
+    // make the spectrum an average
+    m_spectrumAccumulator.GetAverage(result);
 
     // Check the status of the last readout
     // TODO: Check how to do this with the SpectrometerInterface
@@ -390,41 +374,55 @@ int CSpectrometer::CheckSettings()
 
 void CSpectrometer::WriteEvFile(CString filename, FitRegion* fitRegion)
 {
-    int channel = fitRegion->window.channel;
+    AppendToEvFile(filename, FormatEvFileLine(*fitRegion));
+}
 
-    FILE* f;
-    CString wholePath = m_subFolder + "\\" + m_measurementBaseName + "_" + m_measurementStartTimeStr + filename;
-    f = fopen(wholePath, "a+");
-    if (f < (FILE*)1)
-    {
-        ShowMessageBox("Could not open evaluation log file. No data was written!", "Error");
-        return;
-    }
+CString CSpectrometer::FormatEvFileLine(const FitRegion& fitRegion) const
+{
+    int channel = fitRegion.window.channel;
+
+    CString line;
 
     int hr, min, sec;
     mobiledoas::ExtractTime(m_spectrumGpsData[m_spectrumCounter], hr, min, sec);
 
     // 1. Write the time of the spectrum
-    fprintf(f, "%02d:%02d:%02d\t", hr, min, sec);
+    line.AppendFormat("%02d:%02d:%02d\t", hr, min, sec);
 
     // 2. Write the GPS-information about the spectrum
-    fprintf(f, "%f\t%f\t%.1f\t", m_spectrumGpsData[m_spectrumCounter].latitude, m_spectrumGpsData[m_spectrumCounter].longitude, m_spectrumGpsData[m_spectrumCounter].altitude);
+    line.AppendFormat("%f\t%f\t%.1f\t", m_spectrumGpsData[m_spectrumCounter].latitude, m_spectrumGpsData[m_spectrumCounter].longitude, m_spectrumGpsData[m_spectrumCounter].altitude);
 
     // 3. The number of spectra averaged and the exposure-time
-    fprintf(f, "%ld\t%d\t", NumberOfSpectraToAverage(), m_integrationTime);
+    line.AppendFormat("%ld\t%d\t", NumberOfSpectraToAverage(), m_integrationTime);
 
     // 4. The intensity
-    fprintf(f, "%ld\t", m_averageSpectrumIntensity[channel]);
+    line.AppendFormat("%ld\t", m_averageSpectrumIntensity[channel]);
 
     // 5. The evaluated column values
-    for (int k = 0; k < fitRegion->window.nRef; ++k)
+    for (int k = 0; k < fitRegion.window.nRef; ++k)
     {
-        Evaluation::EvaluationResult result = fitRegion->eval[channel]->GetResult(k);
-        fprintf(f, "%lf\t%lf\t", result.column, result.columnError);
+        Evaluation::EvaluationResult result = fitRegion.eval[channel]->GetResult(k);
+        line.AppendFormat("%lf\t%lf\t", result.column, result.columnError);
     }
 
     // 6. The std-file
-    fprintf(f, "%s\n", (LPCTSTR)m_stdfileName[channel]);
+    line.AppendFormat("%s\n", (LPCTSTR)m_stdfileName[channel]);
+
+    return line;
+}
+
+void CSpectrometer::AppendToEvFile(const CString& filename, const CString& line) const
+{
+    FILE* f;
+    CString wholePath = m_subFolder + "\\" + m_measurementBaseName + "_" + m_measurementStartTimeStr + filename;
+    f = fopen(wholePath, "a+");
+    if (f < (FILE*)1)
+    {
+        ShowMessageBox("Could not open evaluation log file. No data was written!", "Error");
+        return;
+    }
+
+    fputs((LPCTSTR)line, f);
 
     fclose(f);
 }
@@ -551,7 +549,7 @@ void CSpectrometer::GetDark()
         {
             for (int i = 0; i < m_offset.SpectrumLength(); ++i)
             {
-                m_tmpDark.data[j][i] += m_darkCur.data[j][i] * (m_integrationTime / DARK_CURRENT_EXPTIME);
+                m_tmpDark[j][i] += m_darkCur[j][i] * (m_integrationTime / DARK_CURRENT_EXPTIME);
             }
         }
     }
@@ -629,34 +627,46 @@ int CSpectrometer::ReadReferenceFiles()
             return 1;
         }
 
-        /* Init the 1:st Slave Channel Evaluator */
+        /* Init the 1:st Slave Channel Evaluator, this shares the references with the master channel */
         if (m_fitRegion[fitRegionIdx].eval[1] == nullptr)
         {
             m_fitRegion[fitRegionIdx].eval[1] = new Evaluation::CEvaluation(); // should in fact not happen as this should have been done in ApplyEvaluationSettings()
         }
-        if (!(m_fitRegion[fitRegionIdx].eval[1]->ReadRefList(refFileList, m_fitRegion[fitRegionIdx].window.nRef, m_detectorSize)))
-        {
-            ShowMessageBox("Can not read reference file\n Please check the file location and restart collection", "Error");
-            return 1;
-        }
+        m_fitRegion[fitRegionIdx].eval[1]->UseReferences(*m_fitRegion[fitRegionIdx].eval[0]);
     }
 
     return 0;
 }
 
-void CSpectrometer::DoEvaluation(mobiledoas::MeasuredSpectrum& sky, mobiledoas::MeasuredSpectrum& dark, mobiledoas::MeasuredSpectrum& spectrum)
+void CSpectrometer::DoEvaluation(mobiledoas::MeasuredSpectrum& sky, mobiledoas::MeasuredSpectrum& dark, mobiledoas::MeasuredSpectrum& spectrum, std::vector<EvaluationLogLine>* evaluationLog)
 {
     double curColumn[8];
     double curColumnError[8];
 
     m_fitResult.SetToZero();
 
-    for (int fitRegionIdx = 0; fitRegionIdx < m_fitRegionNum; ++fitRegionIdx)
+    // Evaluate. The fit regions have separate evaluators and only read the spectra, hence they can be evaluated in parallel
+    auto evaluateFitRegion = [&](int fitRegionIdx)
     {
         const int chn = m_fitRegion[fitRegionIdx].window.channel;
-
-        // Evaluate
         m_fitRegion[fitRegionIdx].eval[chn]->Evaluate(dark[chn].data(), sky[chn].data(), spectrum[chn].data());
+    };
+    if (m_evaluationThreads != nullptr && m_fitRegionNum > 1)
+    {
+        m_evaluationThreads->ParallelFor(m_fitRegionNum, evaluateFitRegion);
+    }
+    else
+    {
+        for (int fitRegionIdx = 0; fitRegionIdx < m_fitRegionNum; ++fitRegionIdx)
+        {
+            evaluateFitRegion(fitRegionIdx);
+        }
+    }
+
+    // Collect the results in the order of the fit regions
+    for (int fitRegionIdx = 0; fitRegionIdx < m_fitRegionNum; ++fitRegionIdx)
+    {
+        const int chn = m_fitRegion[fitRegionIdx].window.channel;
 
         // Store the results
         const auto evaluationResult = m_fitRegion[fitRegionIdx].eval[chn]->GetResult();
@@ -677,7 +687,8 @@ void CSpectrometer::DoEvaluation(mobiledoas::MeasuredSpectrum& sky, mobiledoas::
         }
 
         // copy the high pass filtered spectrum
-        m_spectrum.data[chn] = m_fitRegion[fitRegionIdx].eval[chn]->m_filteredSpectrum;
+        const std::vector<double>& filteredSpectrum = m_fitRegion[fitRegionIdx].eval[chn]->m_filteredSpectrum;
+        m_spectrum.CopyFrom(chn, filteredSpectrum.data(), static_cast<int>(filteredSpectrum.size()));
 
         // copy the fitted reference
         for (int referenceIdx = 0; referenceIdx < m_fitRegion[fitRegionIdx].window.nRef + 1; ++referenceIdx)
@@ -690,7 +701,14 @@ void CSpectrometer::DoEvaluation(mobiledoas::MeasuredSpectrum& sky, mobiledoas::
 
         CString fileName;
         fileName.Format("evaluationLog_%s.txt", (LPCSTR)m_fitRegion[fitRegionIdx].window.name);
-        WriteEvFile(fileName, &m_fitRegion[fitRegionIdx]);
+        if (evaluationLog != nullptr)
+        {
+            evaluationLog->push_back({ fileName, FormatEvFileLine(m_fitRegion[fitRegionIdx]) });
+        }
+        else
+        {
+            WriteEvFile(fileName, &m_fitRegion[fitRegionIdx]);
+        }
 
     }
     if (m_useAudio)
@@ -779,54 +797,64 @@ void CSpectrometer::CreateDirectories()
 
 void CSpectrometer::SetFileName()
 {
-    static long lastidx = 0; /* The number of the last std-file written */
+    SetFileName(m_scanNum, m_stdfileName);
+}
+
+void CSpectrometer::SetFileName(long scanNum, CString stdfileName[MAX_N_CHANNELS])
+{
+    static long lastidx = 0; /* The number of the next std-file to write */
 
     int i, j;
+    bool isNumbered;
 
     if (m_fixexptime >= 0)
     {
         // Normal mode, fixed exposure time
+        isNumbered = scanNum > 2;
         for (j = 0; j < m_NChannels; ++j)
         {
             i = lastidx;
             do
             {
-                if (m_scanNum == 1)
-                    m_stdfileName[j].Format("\\dark_%d.STD", j);
-                else if (m_scanNum == 2)
-                    m_stdfileName[j].Format("\\sky_%d.STD", j);
+                if (scanNum == 1)
+                    stdfileName[j].Format("\\dark_%d.STD", j);
+                else if (scanNum == 2)
+                    stdfileName[j].Format("\\sky_%d.STD", j);
                 else
-                    m_stdfileName[j].Format("\\%05d_%d.STD", i, j);
+                    stdfileName[j].Format("\\%05d_%d.STD", i, j);
 
-                m_stdfileName[j] = m_subFolder + m_stdfileName[j];
+                stdfileName[j] = m_subFolder + stdfileName[j];
                 i++;
-            } while (IsExistingFile(m_stdfileName[j]));
+            } while (IsExistingFile(stdfileName[j]));
         }
     }
     else
     {
         // Automatic adjustment of the exposure-time
+        isNumbered = scanNum > 3;
         for (j = 0; j < m_NChannels; ++j)
         {
             i = lastidx;
             do
             {
-                if (m_scanNum == 1)
-                    m_stdfileName[j].Format("\\offset_%d.STD", j);
-                else if (m_scanNum == 2)
-                    m_stdfileName[j].Format("\\darkcur_%d.STD", j);
-                else if (m_scanNum == 3)
-                    m_stdfileName[j].Format("\\sky_%d.STD", j);
+                if (scanNum == 1)
+                    stdfileName[j].Format("\\offset_%d.STD", j);
+                else if (scanNum == 2)
+                    stdfileName[j].Format("\\darkcur_%d.STD", j);
+                else if (scanNum == 3)
+                    stdfileName[j].Format("\\sky_%d.STD", j);
                 else
-                    m_stdfileName[j].Format("\\%05d_%d.STD", i, j);
+                    stdfileName[j].Format("\\%05d_%d.STD", i, j);
 
-                m_stdfileName[j] = m_subFolder + m_stdfileName[j];
+                stdfileName[j] = m_subFolder + stdfileName[j];
                 i++;
-            } while (IsExistingFile(m_stdfileName[j]));
+            } while (IsExistingFile(stdfileName[j]));
         }
     }
 
-    lastidx = i - 1;
+    // The next number follows the one just used, such that the name does not depend on whether
+    // the file of this spectrum has been written yet (it may still be waiting to be written).
+    lastidx = isNumbered ? i : i - 1;
 }
 
 long CSpectrometer::GetColumns(std::vector<double>& list, long maxNumberOfValues, int fitRegion) const
@@ -998,9 +1026,22 @@ bool CSpectrometer::UpdateGpsData(mobiledoas::GpsData& gpsInfo)
         return false;
     }
 
+    const bool gpsDataIsValid = ReadGpsData(gpsInfo, m_spectrumCounter);
+    m_spectrumGpsData[m_spectrumCounter] = gpsInfo;
+
+    return gpsDataIsValid;
+}
+
+bool CSpectrometer::ReadGpsData(mobiledoas::GpsData& gpsInfo, long spectrumIndex)
+{
+    // If GPS thread does not exist or is not running
+    if (nullptr == m_gps)
+    {
+        return false;
+    }
+
     // Read the data from the GPS
     m_gps->Get(gpsInfo);
-    m_spectrumGpsData[m_spectrumCounter] = gpsInfo;
 
     // check for valid lat/lon
     bool gpsDataIsValid = IsValidGpsData(gpsInfo);
@@ -1013,7 +1054,7 @@ bool CSpectrometer::UpdateGpsData(mobiledoas::GpsData& gpsInfo)
     // Check if the gps-readout seems to be stuck, which can happen at times.
     // Previously this check was done on two consecutive data-points, however that does not work if the time resolution is 
     // so high that multiple spectra are read out on a given second. Current check should be good for readouts up to 10 spectra/second
-    if (m_spectrumCounter >= 10 && (m_spectrumGpsData[m_spectrumCounter].time == m_spectrumGpsData[m_spectrumCounter - 10].time))
+    if (spectrumIndex >= 10 && (gpsInfo.time == m_spectrumGpsData[spectrumIndex - 10].time))
     {
         gpsDataIsValid = false;
     }
@@ -1027,18 +1068,23 @@ void CSpectrometer::GetCurrentDateAndTime(std::string& currentDate, long& curren
 {
     mobiledoas::GpsData currentGpsInfo;
     const bool couldReadValidGPSData = (m_useGps) ? UpdateGpsData(currentGpsInfo) : false;
-    if (couldReadValidGPSData)
+    GetDateAndTime(currentGpsInfo, couldReadValidGPSData, currentDate, currentTime);
+}
+
+void CSpectrometer::GetDateAndTime(const mobiledoas::GpsData& gpsInfo, bool gpsDataIsValid, std::string& currentDate, long& currentTime)
+{
+    if (gpsDataIsValid)
     {
-        currentDate = GetDate(currentGpsInfo, '.');
-        currentTime = GetTime(currentGpsInfo);
+        currentDate = GetDate(gpsInfo, '.');
+        currentTime = GetTime(gpsInfo);
     }
     else
     {
         currentDate = mobiledoas::GetCurrentDateFromComputerClock('.');
-        currentTime = GetCurrentTimeFromComputerClock();
+        currentTime = GetCurrentTimeFromComputerClock(gpsInfo);
     }
 
-    if (currentGpsInfo.date == 0)
+    if (gpsInfo.date == 0)
     {
         currentDate = mobiledoas::GetCurrentDateFromComputerClock('.');
     }
@@ -1158,7 +1204,7 @@ std::vector<double> CSpectrometer::GetSpectrum(int channel) const
     {
         return std::vector<double>(MAX_SPECTRUM_LENGTH, 0.0);
     }
-    return m_curSpectrum.data[channel];
+    return m_curSpectrum[channel].ToVector();
 }
 
 std::vector<std::string> CSpectrometer::GetConnectedSpectrometers() const
@@ -1350,7 +1396,7 @@ int CSpectrometer::ChangeSpectrometer(int selectedspec, const std::vector<int>&
     m_spectrometer->GetWavelengths(wavelengthData);
     ASSERT(wavelengthData.size() == m_NChannels);
 
-    m_wavelength.data = wavelengthData;
+    m_wavelength.CopyFrom(wavelengthData);
 
     UpdateStatusBarMessage("Detector size is %d", m_detectorSize);
 
@@ -1364,6 +1410,47 @@ void CSpectrometer::CloseSpectrometerConnection()
 }
 
 void CSpectrometer::GetSpectrumInfo(const mobiledoas::MeasuredSpectrum& spectrum)
+{
+    SpectrometerTemperatures temperatures;
+    ReadSpectrometerTemperatures(temperatures);
+
+    GetSpectrumInfo(spectrum, temperatures);
+}
+
+void CSpectrometer::ReadSpectrometerTemperatures(SpectrometerTemperatures& temperatures)
+{
+    /** If possible, get the board temperature of the spectrometer */
+    if (m_spectrometer->SupportsBoardTemperature())
+    {
+        temperatures.board = m_spectrometer->GetBoardTemperature();
+    }
+    else
+    {
+        temperatures.board = std::numeric_limits<double>::quiet_NaN();
+    }
+
+    /** If possible, get the detector temperature of the spectrometer */
+
+    if (m_spectrometer->SupportsDetectorTemperatureControl())
+    {
+        temperatures.detector = m_spectrometer->GetDetectorTemperature();;
+        if (abs(temperatures.detector - m_conf->m_setPointTemperature) <= 2.0)
+        {
+            temperatures.detectorIsAtSetPoint = true;
+        }
+        else
+        {
+            temperatures.detectorIsAtSetPoint = false;
+        }
+    }
+    else
+    {
+        temperatures.detector = std::numeric_limits<double>::quiet_NaN();
+        temperatures.detectorIsAtSetPoint = false;
+    }
+}
+
+void CSpectrometer::GetSpectrumInfo(const mobiledoas::MeasuredSpectrum& spectrum, const SpectrometerTemperatures& temperatures)
 {
     /* The nag flag makes sure that we dont remind the user to take a new dark
         spectrum too many times in a row. */
@@ -1393,10 +1480,10 @@ void CSpectrometer::GetSpectrumInfo(const mobiledoas::MeasuredSpectrum& spectrum
   /* The offset is judged as the average intensity in pixels 6 - 18 */
     for (int n = 0; n < m_NChannels; ++n)
     {
-        m_specInfo[n].offset = mobiledoas::GetOffset(spectrum.data[n]);
+        m_specInfo[n].offset = mobiledoas::GetOffset(spectrum[n]);
 
         // Check if this spectrum is dark
-        const bool isDark = mobiledoas::CheckIfDark(spectrum.data[n]);
+        const bool isDark = mobiledoas::CheckIfDark(spectrum[n]);
 
         if (isDark)
         {
@@ -1429,35 +1516,9 @@ void CSpectrometer::GetSpectrumInfo(const mobiledoas::MeasuredSpectrum& spectrum
         }
     }
 
-    /** If possible, get the board temperature of the spectrometer */
-    if (m_spectrometer->SupportsBoardTemperature())
-    {
-        m_boardTemperature = m_spectrometer->GetBoardTemperature();
-    }
-    else
-    {
-        m_boardTemperature = std::numeric_limits<double>::quiet_NaN();
-    }
-
-    /** If possible, get the detector temperature of the spectrometer */
-
-    if (m_spectrometer->SupportsDetectorTemperatureControl())
-    {
-        detectorTemperature = m_spectrometer->GetDetectorTemperature();;
-        if (abs(detectorTemperature - m_conf->m_setPointTemperature) <= 2.0)
-        {
-            detectorTemperatureIsSetPointTemp = true;
-        }
-        else
-        {
-            detectorTemperatureIsSetPointTemp = false;
-        }
-    }
-    else
-    {
-        detectorTemperature = std::numeric_limits<double>::quiet_NaN();
-        detectorTemperatureIsSetPointTemp = false;
-    }
+    m_boardTemperature = temperatures.board;
+    detectorTemperature = temperatures.detector;
+    detectorTemperatureIsSetPointTemp = temperatures.detectorIsAtSetPoint;
 
     /* Print the information to a file */
     CString fileName = m_subFolder + "\\" + m_measurementBaseName + "_" + m_measurementStartTimeStr + "AdditionalLog.txt";
@@ -1611,8 +1672,8 @@ short CSpectrometer::AdjustIntegrationTime()
         }
 
         // Get the intensity of the sky and the dark spectra
-        skyInt = mobiledoas::AverageIntensity(skySpec.data[0], m_conf->m_specCenter, m_conf->m_specCenterHalfWidth);
-        darkInt = (long)mobiledoas::GetOffset(skySpec.data[0]);
+        skyInt = mobiledoas::AverageIntensity(skySpec[0], m_conf->m_specCenter, m_conf->m_specCenterHalfWidth);
+        darkInt = (long)mobiledoas::GetOffset(skySpec[0]);
 
         // Draw the measured sky spectrum on the screen.
         skySpec.CopyTo(m_curSpectrum);
@@ -1681,7 +1742,7 @@ short CSpectrometer::AdjustIntegrationTime_Calculate(long minExpTime, long maxEx
     {
         return -1;
     }
-    const int intensityAtShortIntegrationTime = mobiledoas::AverageIntensity(skySpec.data[0], m_conf->m_specCenter, m_conf->m_specCenterHalfWidth);
+    const int intensityAtShortIntegrationTime = mobiledoas::AverageIntensity(skySpec[0], m_conf->m_specCenter, m_conf->m_specCenterHalfWidth);
 
     m_integrationTime = (short)maxExpTime;
     // measure the intensity
@@ -1689,7 +1750,7 @@ short CSpectrometer::AdjustIntegrationTime_Calculate(long minExpTime, long maxEx
     {
         return -1;
     }
-    const int intensityAtLongIntegrationTime = mobiledoas::AverageIntensity(skySpec.data[0], m_conf->m_specCenter, m_conf->m_specCenterHalfWidth);
+    const int intensityAtLongIntegrationTime = mobiledoas::AverageIntensity(skySpec[0], m_conf->m_specCenter, m_conf->m_specCenterHalfWidth);
 
     // This will only work if the spectrum is not saturated at the maximum exposure-time
     if (intensityAtLongIntegrationTime > 0.9 * m_spectrometerDynRange)
@@ -1711,7 +1772,7 @@ short CSpectrometer::AdjustIntegrationTime_Calculate(long minExpTime, long maxEx
     {
         return -1;
     }
-    int finalInt = mobiledoas::AverageIntensity(skySpec.data[0], m_conf->m_specCenter, m_conf->m_specCenterHalfWidth);
+    int finalInt = mobiledoas::AverageIntensity(skySpec[0], m_conf->m_specCenter, m_conf->m_specCenterHalfWidth);
 
     // TODO: There is a range of allowed intensities, use that instead!
     int desiredInt = (int)(m_spectrometerDynRange * m_desiredSaturationRatio);
@@ -1738,6 +1799,11 @@ long CSpectrometer::GetCurrentTimeFromComputerClock()
 {
     const int currentSpectrumCounter = this->m_spectrumCounter; // local copy to prevent race conditions
 
+    return GetCurrentTimeFromComputerClock(m_spectrumGpsData[currentSpectrumCounter]);
+}
+
+long CSpectrometer::GetCurrentTimeFromComputerClock(const mobiledoas::GpsData& gpsInfo)
+{
     long startTime = GetTimeValue_UMT();
 
     if (m_timeDiffToUtc == 0)
@@ -1746,10 +1812,8 @@ long CSpectrometer::GetCurrentTimeFromComputerClock()
         time(&t);
         struct tm* localTime = localtime(&t);
 
-        const mobiledoas::GpsData curGpsInfo = m_spectrumGpsData[currentSpectrumCounter];
-
         int hr, min, sec;
-        ExtractTime(curGpsInfo, hr, min, sec);
+        ExtractTime(gpsInfo, hr, min, sec);
 
         /* get the difference between the local time and the GPS-time */
         m_timeDiffToUtc = 3600 * (hr - localTime->tm_hour) + 60 * (min - localTime->tm_min) + (sec - localTime->tm_sec);
@@ -1778,7 +1842,7 @@ unsigned int CSpectrometer::GetProcessedSpectrum(double* dst, unsigned int maxNo
     }
 
     const unsigned int length = std::min(maxNofElements, (unsigned int)m_spectrum.SpectrumLength());
-    memcpy(dst, this->m_spectrum.data[chn].data(), MAX_SPECTRUM_LENGTH * sizeof(double));
+    memcpy(dst, this->m_spectrum[chn].data(), length * sizeof(double));
     return length;
 }
 
@@ -1791,7 +1855,7 @@ void CSpectrometer::ShowMessageBox(CString message, CString label) const
     }
 }
 
-void CSpectrometer::CreateSpectrum(CSpectrum& spectrum, const std::vector<double>& spec, const std::string& startDate, long startTime, long elapsedSecond)
+void CSpectrometer::CreateSpectrum(CSpectrum& spectrum, mobiledoas::Span<const double> spec, const std::string& startDate, long startTime, long elapsedSecond)
 {
     memcpy((void*)spectrum.I, (void*)spec.data(), sizeof(double) * std::min((size_t)MAX_SPECTRUM_LENGTH, spec.size()));
     spectrum.length = m_detectorSize;
@@ -1834,8 +1898,21 @@ void CSpectrometer::InitializeEvaluators(bool skySpectrumIsDarkCorrected)
             m_fitRegion[fitRgnIdx].eval[channelIdx]->SetFitWindow(m_fitRegion[fitRgnIdx].window);
 
             m_fitRegion[fitRgnIdx].eval[channelIdx]->m_subtractDarkFromSky = !skySpectrumIsDarkCorrected;
+
+            m_fitRegion[fitRgnIdx].eval[channelIdx]->SetWarmStart(m_conf->m_warmStart != 0);
         }
     }
+
+    // The measurement thread evaluates one of the fit regions itself
+    const int numberOfThreads = std::min(static_cast<int>(m_fitRegionNum), static_cast<int>(std::thread::hardware_concurrency())) - 1;
+    if (numberOfThreads <= 0)
+    {
+        m_evaluationThreads.reset();
+    }
+    else if (m_evaluationThreads == nullptr || m_evaluationThreads->NumberOfThreads() != numberOfThreads)
+    {
+        m_evaluationThreads.reset(new mobiledoas::ThreadPool(numberOfThreads));
+    }
 }
 
 void CSpectrometer::WriteEvaluationLogFileHeaders()
@@ -1894,6 +1971,14 @@ void CSpectrometer::UpdateSpectrumAverageIntensity(mobiledoas::MeasuredSpectrum&
     }
 }
 
+void CSpectrometer::UpdateSpectrumAverageIntensity(const double averageIntensity[MAX_N_CHANNELS])
+{
+    for (int i = 0; i < m_NChannels; ++i)
+    {
+        m_averageSpectrumIntensity[i] = (long)fabs(averageIntensity[i]);
+    }
+}
+
 void CSpectrometer::UpdateUserAboutSpectrumAverageIntensity(const std::string& spectrumName, bool checkIfDark)
 {
     std::string fullSpectrumName = spectrumName.length() > 0 ? "(" + spectrumName + ")" : "";
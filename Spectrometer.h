@@ -5,6 +5,8 @@
 #include <MobileDoasLib/Measurement/SpectrumUtils.h>
 #include <MobileDoasLib/ReferenceFitResult.h>
 #include <MobileDoasLib/Measurement/MeasuredSpectrum.h>
+#include <MobileDoasLib/Measurement/SpectrumAccumulator.h>
+#include <MobileDoasLib/ThreadPool.h>
 
 #include <memory>
 #include <limits>
@@ -187,7 +189,7 @@ public:
     void GetNSpecAverage(int& averageInSpectrometer, int& averageInComputer);
 
     /* Create Spectrum data object. */
-    void CreateSpectrum(CSpectrum& spectrum, const std::vector<double>& spec, const std::string& startDate, long startTime, long elapsedSecond);
+    void CreateSpectrum(CSpectrum& spectrum, mobiledoas::Span<const double> spec, const std::string& startDate, long startTime, long elapsedSecond);
 
     /** This retrieves a list of all spectrometers that are connected to this computer
         Notice that this will not attempt to rebuild the list. */
@@ -270,6 +272,7 @@ protected:
         @param sumInSpectrometer - the number of spectra to add together in the spectrometer
         @param pResult - will on successful return be filled with the measured spectrum. Returned spectrum
             is an average of the (sumInComputer*sumInSpectrometer) collected spectra.
+            The average intensity of each channel of the spectrum is left in m_spectrumAccumulator.
         @return 0 on success
         @return 1 if the collection failed or the collection should stop
          */
@@ -321,9 +324,25 @@ protected:
     /** True if the user wants us to update the integration time. */
     BOOL  m_adjustIntegrationTime;
 
+    /** The temperatures reported by the spectrometer. Each is set to NaN if it could not be read. */
+    struct SpectrometerTemperatures
+    {
+        double board = std::numeric_limits<double>::quiet_NaN();
+        double detector = std::numeric_limits<double>::quiet_NaN();
+        bool detectorIsAtSetPoint = false;
+    };
+
+    /** Reads out the temperatures from the spectrometer, if it supports this.
+        This communicates with the spectrometer and must hence be called from the thread which reads out the spectra. */
+    void ReadSpectrometerTemperatures(SpectrometerTemperatures& temperatures);
+
     /** fills up the 'specInfo' structure with information from the supplied spectrum */
     void GetSpectrumInfo(const mobiledoas::MeasuredSpectrum& spectrum);
 
+    /** fills up the 'specInfo' structure with information from the supplied spectrum
+        and the temperatures which were read out together with the spectrum. */
+    void GetSpectrumInfo(const mobiledoas::MeasuredSpectrum& spectrum, const SpectrometerTemperatures& temperatures);
+
     /* -------  The spectra ----------- */
 
     /** The exposure time that we should use to collect the dark current spectrum */
@@ -348,12 +367,21 @@ protected:
         Set to 2.66 (SO2) */
     double m_gasFactor;
 
+    /** One line of an evaluation log file, which is written after the evaluation. */
+    struct EvaluationLogLine
+    {
+        CString fileName;
+        CString line;
+    };
+
     /** Evaluates the given spectrum using the given dark and sky spectra
         @param pSky - the sky spectrum(-a) to use. Should already be dark-corrected!
         @param pDark - the dark spectrum(-a) to use (for the measured spectrum,
             the sky should already be dark-corrected
-        @param pSpectrum - the spectrum to evaluate.  */
-    void DoEvaluation(mobiledoas::MeasuredSpectrum& sky, mobiledoas::MeasuredSpectrum& dark, mobiledoas::MeasuredSpectrum& spectrum);
+        @param pSpectrum - the spectrum to evaluate.
+        @param evaluationLog - if not null, the lines of the evaluation log files are appended to this
+            instead of being written to the files. */
+    void DoEvaluation(mobiledoas::MeasuredSpectrum& sky, mobiledoas::MeasuredSpectrum& dark, mobiledoas::MeasuredSpectrum& spectrum, std::vector<EvaluationLogLine>* evaluationLog = nullptr);
 
     /** Copies the current sky-spectrum to 'tmpSky' */
     void GetSky();
@@ -406,6 +434,11 @@ protected:
         Sets the member variable 'm_stdfileName'*/
     void SetFileName();
 
+    /** Sets the names of the next .std files for the spectrum with the given number.
+        @param scanNum - the number of the spectrum, as 'm_scanNum'.
+        @param stdfileName - will on return be filled with one file-name for each channel. */
+    void SetFileName(long scanNum, CString stdfileName[MAX_N_CHANNELS]);
+
     /** Takes care of creating the correct structure of directories
         in the output directory
         Sets the variable 'm_subFolder' */
@@ -415,6 +448,12 @@ protected:
         to the specified file-name */
     void WriteEvFile(CString filename, FitRegion* fitRegion);
 
+    /** @return the line of the evaluation log file with the last evaluation result from the given fit region */
+    CString FormatEvFileLine(const FitRegion& fitRegion) const;
+
+    /** Appends the given line to the evaluation log file with the specified file-name */
+    void AppendToEvFile(const CString& filename, const CString& line) const;
+
     /** The directory that we're currently writing to.
     *   Notice that this does NOT end with a trailing (forward/backward) slash.
         Set by calling 'CreateDirectories' */
@@ -437,9 +476,21 @@ protected:
         @return false if the data is not valid or the GPS isn't used. */
     bool UpdateGpsData(mobiledoas::GpsData& gpsInfo);
 
+    /** Reads the last data from the GPS-thread, without storing it in 'm_spectrumGpsData'.
+        @param spectrumIndex - the index into 'm_spectrumGpsData' which the data belongs to.
+        @return true if the data is valid (i.e. if the GPS can retrieve lat/long).
+        @return false if the data is not valid or the GPS isn't used. */
+    bool ReadGpsData(mobiledoas::GpsData& gpsInfo, long spectrumIndex);
+
+    /** Retrieves the date and time from the given GPS data, or from the computer time if the GPS data is not valid. */
+    void GetDateAndTime(const mobiledoas::GpsData& gpsInfo, bool gpsDataIsValid, std::string& currentDate, long& currentTime);
+
     /** Retrieves the current time from the system time */
     long GetCurrentTimeFromComputerClock();
 
+    /** Retrieves the current time from the system time, the difference to UTC is taken from the given GPS data */
+    long GetCurrentTimeFromComputerClock(const mobiledoas::GpsData& gpsInfo);
+
     /** Retrieves the current time from the system time */
     void GetCurrentTimeFromComputerClock(novac::CDateTime& time);
 
@@ -539,6 +590,13 @@ protected:
     This is used for plotting mostly */
     mobiledoas::MeasuredSpectrum m_spectrum;
 
+    /** Adds together the readouts in 'Scan' and sums up the intensity of the spectrum while doing so.
+        After 'Scan' this holds the average intensity of the last collected spectrum. */
+    mobiledoas::SpectrumAccumulator m_spectrumAccumulator;
+
+    /** The last readout from the spectrometer, kept between the calls to 'Scan' to reuse its memory */
+    mobiledoas::MeasuredSpectrum m_readout;
+
 
     // ---------------------------------------------------------------------------------------
     // --------------------- Keeping track of the route... -------------
@@ -597,13 +655,18 @@ protected:
         Must be >= 0 and <= MAX_FIT_WINDOWS */
     long m_fitRegionNum;
 
+    /** The threads which evaluate the fit regions in parallel, together with the measurement thread.
+        Null if there is only one fit region or only one processor. Set up in 'InitializeEvaluators' */
+    std::unique_ptr<mobiledoas::ThreadPool> m_evaluationThreads;
+
     // ---------------------------------------------------------------------------------------
     // -------------------- Collecting common behavior between subclasses --------------------
     // ---------------------------------------------------------------------------------------
 
     /** Sets up the evaluation objects.
         @param skySpectrumIsDarkCorrected set to true if the sky-spectrum used in the evaluation
-            has already been dark-corrected before doing the evaluation (normally: true) */
+            has already been dark-corrected before doing the evaluation (normally: true).
+        Also starts the threads which evaluate the fit regions in parallel. */
     void InitializeEvaluators(bool skySpectrumIsDarkCorrected);
 
     void WriteEvaluationLogFileHeaders();
@@ -625,6 +688,10 @@ protected:
         If 'checkIfDark' is set to true, the user will be informed if 'm_specInfo->isDark' is true (i.e. the spectrum is judged to be dark). */
     void UpdateSpectrumAverageIntensity(mobiledoas::MeasuredSpectrum& scanResult);
 
+    /* Updates m_averageSpectrumIntensity from the average intensities summed up by 'Scan', one for each channel,
+        without passing over the spectrum again. */
+    void UpdateSpectrumAverageIntensity(const double averageIntensity[MAX_N_CHANNELS]);
+
     /* UpdateUserAboutSpectrumAverageIntensity informs the user about the value of m_averageSpectrumIntensity and
         should hence only be called _after_ UpdateSpectrumAverageIntensity has been called.
         If 'checkIfDark' is set to true, the user will be informed if 'm_specInfo->isDark' is true (i.e.the spectrum is judged to be dark). */
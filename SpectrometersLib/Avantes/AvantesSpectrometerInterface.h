@@ -62,6 +62,8 @@ public:
 
     virtual int GetNextSpectrum(std::vector<std::vector<double>>& data) override;
 
+    using SpectrometerInterface::GetNextSpectrum;
+
     virtual bool SupportsDetectorTemperatureControl() override;
 
     virtual bool EnableDetectorTemperatureControl(bool enable, double temperatureInCelsius) override;
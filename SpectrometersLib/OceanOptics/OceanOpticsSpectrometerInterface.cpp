@@ -218,6 +218,39 @@ int OceanOpticsSpectrometerInterface::GetNextSpectrum(std::vector<std::vector<do
     return spectrumLength;
 }
 
+int OceanOpticsSpectrometerInterface::GetNextSpectrum(MeasuredSpectrum& spectrum)
+{
+    const int numberOfChannels = (m_spectrometerChannels.size() < MAX_N_CHANNELS) ? static_cast<int>(m_spectrometerChannels.size()) : MAX_N_CHANNELS;
+
+    // Read out all channels before changing the spectrum, such that it is left unchanged if the readout is not valid
+    DoubleArray spectrumArrays[MAX_N_CHANNELS];
+    for (int channelIdx = 0; channelIdx < numberOfChannels; ++channelIdx)
+    {
+        spectrumArrays[channelIdx] = m_wrapper->getSpectrum(m_spectrometerIndex, m_spectrometerChannels[channelIdx]);
+    }
+
+    // Check the status of the last readout
+    WrapperExtensions ext = m_wrapper->getWrapperExtensions();
+    if (numberOfChannels == 0 || !ext.isSpectrumValid(m_spectrometerIndex))
+    {
+        m_lastErrorMessage = "Error reading out spectrum, last spectrum may not be valid";
+        return 0;
+    }
+
+    // copies the spectrum-values directly from the driver to the output spectrum
+    const int spectrumLength = spectrumArrays[0].getLength();
+    spectrum.Resize(numberOfChannels, spectrumLength);
+    for (int channelIdx = 0; channelIdx < numberOfChannels; ++channelIdx)
+    {
+        const int length = (spectrumArrays[channelIdx].getLength() < spectrumLength) ? spectrumArrays[channelIdx].getLength() : spectrumLength;
+        memcpy(spectrum[channelIdx].data(), spectrumArrays[channelIdx].getDoubleValues(), length * sizeof(double));
+    }
+
+    m_lastErrorMessage.clear();
+
+    return spectrumLength;
+}
+
 bool OceanOpticsSpectrometerInterface::SupportsDetectorTemperatureControl()
 {
     return m_wrapper->isFeatureSupportedThermoElectric(m_spectrometerIndex);
@@ -76,6 +76,8 @@ public:
 
     virtual int GetNextSpectrum(std::vector<std::vector<double>>& data) override;
 
+    virtual int GetNextSpectrum(mobiledoas::MeasuredSpectrum& spectrum) override;
+
     virtual bool SupportsDetectorTemperatureControl() override;
 
     virtual bool EnableDetectorTemperatureControl(bool enable, double temperatureInCelsius) override;